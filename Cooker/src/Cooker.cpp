@@ -0,0 +1,553 @@
+#include "Cooker.h"
+
+#include "pblpch.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <thread>
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "Core/Base.h"
+
+#include "Asset/AssetArchive.h"
+#include "Asset/CookedRegistry.h"
+#include "Asset/CookedTexture.h"
+#include "Asset/EffectLoadInfo.h"
+#include "Asset/MaterialLoadInfo.h"
+#include "Asset/TextureEncoder.h"
+
+#include "Platform/Vulkan/Mesh/MeshData.h"
+#include "Platform/Vulkan/Texture/TextureData.h"
+
+#include "Util/Hash.h"
+#include "Util/MappedFile.h"
+
+namespace Parable
+{
+
+
+constexpr const char* COOKED_REGISTRY_NAME = "registry.json";
+constexpr const char* BINARY_REGISTRY_NAME = "registry.pblreg";
+constexpr const char* ARCHIVE_NAME = "assets.pblpak";
+constexpr const char* MANIFEST_NAME = "manifest.json";
+constexpr uint32_t MANIFEST_VERSION = 1;
+
+/**
+ * Parse a json file, throwing a descriptive error if it cannot be.
+ */
+static rapidjson::Document read_json(const std::string& path)
+{
+    Util::MappedFile file(path, Util::AccessHint::WillNeed);
+    std::string_view json = file.chars();
+
+    rapidjson::Document document;
+    document.Parse(json.data(), json.size());
+
+    if (document.HasParseError())
+    {
+        throw std::runtime_error(std::format("{}: parse error at offset {}, {}", path, document.GetErrorOffset(), rapidjson::GetParseError_En(document.GetParseError())));
+    }
+
+    return document;
+}
+
+static void write_json(const rapidjson::Document& document, const std::string& path)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error(std::format("Failed to open {} for writing.", path));
+    }
+
+    rapidjson::OStreamWrapper stream(file);
+    rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+    document.Accept(writer);
+}
+
+static std::string to_json_string(const rapidjson::Value& value)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+static uint64_t hash_json(const rapidjson::Value& value)
+{
+    std::string json = to_json_string(value);
+    return Util::hash_bytes(json.data(), json.size());
+}
+
+Cooker::Cooker(Options options) : m_options(std::move(options))
+{
+    m_options.output_dir = std::filesystem::absolute(m_options.output_dir).string();
+
+    if (m_options.num_threads == 0)
+    {
+        m_options.num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+}
+
+/**
+ * Cook every asset in the registry, then write the cooked registry and manifest.
+ *
+ * @return the number of assets which failed to cook
+ *
+ * @throws std::exception if the registry cannot be read or the outputs cannot be written
+ */
+int Cooker::run()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::filesystem::create_directories(m_options.output_dir);
+
+    load_registry();
+    load_manifest();
+
+    cook_all();
+
+    write_registry();
+    write_cooked_registry();
+    write_archive();
+    write_manifest();
+
+    int cooked = 0, up_to_date = 0, failed = 0;
+    for (const Job& job : m_jobs)
+    {
+        if (job.result == Result::Cooked) ++cooked;
+        if (job.result == Result::UpToDate) ++up_to_date;
+        if (job.result == Result::Failed)
+        {
+            PBL_CORE_ERROR("Asset {} ({}) failed: {}", job.descriptor, job.type, job.error);
+            ++failed;
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    PBL_CORE_INFO("Cooked {} assets, {} up to date, {} failed, in {:.2f}s on {} threads.", cooked, up_to_date, failed, elapsed.count(), m_options.num_threads);
+
+    return failed;
+}
+
+void Cooker::load_registry()
+{
+    m_registry = read_json(m_options.registry_path);
+
+    if (!m_registry.IsArray())
+    {
+        throw std::runtime_error(std::format("{}: registry json is not an array.", m_options.registry_path));
+    }
+
+    const auto& entries = m_registry.GetArray();
+    m_jobs.reserve(entries.Size());
+
+    for (rapidjson::SizeType i = 0; i < entries.Size(); ++i)
+    {
+        Job job = make_job(i, entries[i]);
+
+        // two names hashing alike is as fatal as a repeated name, as references could not tell them apart
+        auto [it, inserted] = m_job_indices.try_emplace(job.descriptor, m_jobs.size());
+        if (!inserted && job.result != Result::Failed)
+        {
+            const Job& existing = m_jobs[it->second];
+            job.result = Result::Failed;
+            job.error = std::format("descriptor {} of \"{}\" is already used by entry {} \"{}\"", job.descriptor, job.name, existing.index, existing.name);
+        }
+
+        m_jobs.push_back(std::move(job));
+    }
+}
+
+/**
+ * Read the manifest of a previous run into the output directory, if there is one.
+ *
+ * A manifest which cannot be read only means every asset is cooked again.
+ */
+void Cooker::load_manifest()
+{
+    std::string path = (std::filesystem::path(m_options.output_dir) / MANIFEST_NAME).string();
+    if (m_options.force || !std::filesystem::exists(path)) return;
+
+    try
+    {
+        rapidjson::Document manifest = read_json(path);
+
+        if (!manifest.IsObject() || !manifest.HasMember("version") || !manifest["version"].IsUint() || manifest["version"].GetUint() != MANIFEST_VERSION || !manifest.HasMember("assets") || !manifest["assets"].IsArray())
+        {
+            PBL_CORE_WARN("Ignoring manifest {} from an incompatible version.", path);
+            return;
+        }
+
+        for (const auto& asset : manifest["assets"].GetArray())
+        {
+            if (!asset.IsObject() || !asset.HasMember("descriptor") || !asset["descriptor"].IsUint64() || !asset.HasMember("hash") || !asset["hash"].IsUint64()) continue;
+
+            ManifestEntry entry { asset["hash"].GetUint64(), "" };
+            if (asset.HasMember("output") && asset["output"].IsString()) entry.output = asset["output"].GetString();
+
+            m_previous.insert_or_assign(asset["descriptor"].GetUint64(), std::move(entry));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        PBL_CORE_WARN("Ignoring unreadable manifest: {}", e.what());
+    }
+}
+
+/**
+ * The pixel format a texture entry asks to be cooked to, by its optional "format" string.
+ *
+ * @throws std::runtime_error if the format is not recognised
+ */
+static TextureFormat::PixelFormat get_texture_format(const rapidjson::Value& entry)
+{
+    if (!entry.HasMember("format")) return TextureFormat::PixelFormat::RGBA8Srgb;
+    if (!entry["format"].IsString()) throw std::runtime_error("texture format is not a string");
+
+    std::string_view name = entry["format"].GetString();
+    if (name == "rgba8") return TextureFormat::PixelFormat::RGBA8Srgb;
+    if (name == "bc1") return TextureFormat::PixelFormat::BC1RgbSrgb;
+    if (name == "bc3") return TextureFormat::PixelFormat::BC3Srgb;
+    if (name == "bc5") return TextureFormat::PixelFormat::BC5Unorm;
+    if (name == "bc7") return TextureFormat::PixelFormat::BC7Srgb;
+
+    throw std::runtime_error(std::format("unrecognised texture format {}", name));
+}
+
+/**
+ * Work out what cooking a registry entry involves, without touching the source.
+ *
+ * An entry which cannot be cooked gives a job which has already failed.
+ */
+Cooker::Job Cooker::make_job(rapidjson::SizeType index, const rapidjson::Value& entry) const
+{
+    Job job;
+    job.index = index;
+    job.descriptor = AssetLoadInfoFactory::get_descriptor(entry, index);
+    if (entry.IsObject() && entry.HasMember("name") && entry["name"].IsString()) job.name = entry["name"].GetString();
+
+    if (!entry.IsObject() || !entry.HasMember("type") || !entry["type"].IsString())
+    {
+        job.result = Result::Failed;
+        job.error = "registry entry is not an object with a type string";
+        return job;
+    }
+
+    job.type = entry["type"].GetString();
+
+    const char* extension = nullptr;
+    if (job.type == "mesh")
+    {
+        job.source_key = "obj_path";
+        job.output_key = "pblmesh_path";
+        extension = ".pblmesh";
+    }
+    else if (job.type == "texture")
+    {
+        job.source_key = "png_path";
+        job.output_key = "pbltex_path";
+        extension = ".pbltex";
+    }
+    else if (job.type == "shader")
+    {
+        job.source_key = "spv_path";
+        job.output_key = "spv_path";
+        extension = ".spv";
+    }
+    else if (job.type != "effect" && job.type != "material")
+    {
+        job.result = Result::Failed;
+        job.error = "unrecognised asset type";
+        return job;
+    }
+
+    if (extension)
+    {
+        if (!entry.HasMember(job.source_key.c_str()) || !entry[job.source_key.c_str()].IsString())
+        {
+            job.result = Result::Failed;
+            job.error = std::format("missing {} string", job.source_key);
+            return job;
+        }
+
+        job.source = entry[job.source_key.c_str()].GetString();
+
+        // prefixed with the descriptor, as sources in different directories may share a name
+        std::string name = std::format("{}_{}{}", job.descriptor, std::filesystem::path(job.source).stem().string(), extension);
+        job.output = (std::filesystem::path(m_options.output_dir) / name).string();
+    }
+
+    return job;
+}
+
+/**
+ * Check the assets an entry references exist and are of the expected type, and record them as dependencies.
+ *
+ * @throws std::runtime_error if a reference is invalid
+ */
+void Cooker::check_dependencies(Job& job, const std::vector<AssetDescriptor>& referenced, std::string_view expected_type) const
+{
+    for (AssetDescriptor dependency : referenced)
+    {
+        auto it = m_job_indices.find(dependency);
+        if (it == m_job_indices.end())
+        {
+            throw std::runtime_error(std::format("references asset {}, which is not in the registry", dependency));
+        }
+        if (m_jobs[it->second].type != expected_type)
+        {
+            throw std::runtime_error(std::format("references asset {}, which is a {} rather than a {}", dependency, m_jobs[it->second].type, expected_type));
+        }
+
+        job.dependencies.push_back(dependency);
+    }
+}
+
+/**
+ * Cook every job, spread over the worker threads.
+ *
+ * Each worker takes the next job until none are left. Jobs do not depend on each other's results,
+ * so need no ordering.
+ */
+void Cooker::cook_all()
+{
+    std::atomic<size_t> next = 0;
+
+    auto worker = [this, &next]()
+    {
+        for (size_t i = next++; i < m_jobs.size(); i = next++)
+        {
+            cook(m_jobs[i]);
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    unsigned num_workers = std::min<unsigned>(m_options.num_threads, (unsigned)std::max<size_t>(m_jobs.size(), 1));
+    for (unsigned i = 1; i < num_workers; ++i) workers.emplace_back(worker);
+    worker();
+}
+
+/**
+ * Cook one asset, unless it is unchanged since the last run.
+ *
+ * Any error is stored in the job rather than thrown, so one bad asset does not stop the rest.
+ */
+void Cooker::cook(Job& job)
+{
+    if (job.result == Result::Failed) return;
+
+    try
+    {
+        const rapidjson::Value& entry = m_registry[job.index];
+
+        job.hash = hash_json(entry);
+        if (!job.source.empty())
+        {
+            Util::MappedFile source(job.source, Util::AccessHint::Sequential);
+            job.hash = Util::hash_combine(job.hash, Util::hash_bytes(source.data().data(), source.size()));
+        }
+
+        // references are checked every run, as the assets they point to may have changed
+        if (job.type == "effect")
+        {
+            EffectLoadInfo effect(entry);
+
+            std::vector<AssetDescriptor> shaders;
+            for (const auto& pass : effect.get_passes())
+            {
+                for (const auto& stage : pass.get_shader_stages()) shaders.push_back(stage.shader);
+            }
+            check_dependencies(job, shaders, "shader");
+        }
+        else if (job.type == "material")
+        {
+            MaterialLoadInfo material(entry);
+
+            check_dependencies(job, { material.get_effect_descriptor() }, "effect");
+            check_dependencies(job, material.get_material_parameters_info().get_texture_descriptors(), "texture");
+        }
+
+        if (auto it = m_previous.find(job.descriptor); it != m_previous.end())
+        {
+            const ManifestEntry& previous = it->second;
+            if (previous.hash == job.hash && previous.output == job.output && (job.output.empty() || std::filesystem::exists(job.output)))
+            {
+                job.result = Result::UpToDate;
+                return;
+            }
+        }
+
+        if (job.type == "mesh")
+        {
+            Vulkan::MeshData mesh = Vulkan::MeshData::from_obj(job.source);
+            if (mesh.get_indices().empty())
+            {
+                throw std::runtime_error("mesh has no faces");
+            }
+
+            mesh.write_cooked(job.output);
+        }
+        else if (job.type == "texture")
+        {
+            TextureFormat::PixelFormat format = get_texture_format(entry);
+            bool mips = !entry.HasMember("mips") || !entry["mips"].IsBool() || entry["mips"].GetBool();
+
+            Vulkan::TextureData texture = Vulkan::TextureData::from_png(job.source);
+            if (!texture.get_pixels())
+            {
+                throw std::runtime_error("failed to decode png");
+            }
+
+            if (mips) texture.generate_mips(TextureFormat::is_srgb(format));
+
+            CookedTextureData data;
+            data.width = texture.get_dimensions().width;
+            data.height = texture.get_dimensions().height;
+            data.format = format;
+
+            std::vector<std::vector<std::byte>> levels;
+            for (uint32_t mip = 0; mip < texture.get_mip_count(); ++mip)
+            {
+                levels.push_back(TextureEncoder::encode(format, texture.get_mip(mip), std::max(data.width >> mip, 1u), std::max(data.height >> mip, 1u)));
+            }
+            for (const auto& level : levels) data.mips.push_back(level);
+
+            CookedTexture::write(job.output, data);
+        }
+        else if (job.type == "shader")
+        {
+            // already compiled to spirv, copied so the cooked directory is self contained
+            std::filesystem::copy_file(job.source, job.output, std::filesystem::copy_options::overwrite_existing);
+        }
+
+        job.result = Result::Cooked;
+        PBL_CORE_TRACE("Cooked asset {} ({}).", job.descriptor, job.type);
+    }
+    catch (const std::exception& e)
+    {
+        job.result = Result::Failed;
+        job.error = e.what();
+    }
+}
+
+/**
+ * Write the source registry with each cooked asset pointing at its cooked file instead of its source.
+ *
+ * Entries keep their positions, so descriptors are unchanged. An asset which failed to cook keeps
+ * its source path, which the runtime can still load.
+ */
+void Cooker::write_registry() const
+{
+    rapidjson::Document registry;
+    registry.CopyFrom(m_registry, registry.GetAllocator());
+
+    for (const Job& job : m_jobs)
+    {
+        if (job.output.empty() || (job.result != Result::Cooked && job.result != Result::UpToDate)) continue;
+
+        rapidjson::Value& entry = registry[job.index];
+        entry.RemoveMember(job.source_key.c_str());
+        entry.RemoveMember(job.output_key.c_str());
+        entry.AddMember(
+            rapidjson::Value(job.output_key.c_str(), registry.GetAllocator()),
+            rapidjson::Value(job.output.c_str(), registry.GetAllocator()),
+            registry.GetAllocator()
+        );
+    }
+
+    write_json(registry, (std::filesystem::path(m_options.output_dir) / COOKED_REGISTRY_NAME).string());
+}
+
+/**
+ * Write the cooked registry as a .pblreg, holding the same load info as the written registry.json.
+ *
+ * Effects and materials keep their registry entry as json, parsed only when the runtime resolves them.
+ * Entries which could not be understood at all are left out.
+ */
+void Cooker::write_cooked_registry() const
+{
+    CookedRegistryWriter registry;
+
+    for (const Job& job : m_jobs)
+    {
+        AssetType type = asset_type_from_string(job.type);
+        if (type == AssetType::None || m_job_indices.at(job.descriptor) != job.index) continue;
+
+        // as in registry.json, a cooked asset points only at its cooked file
+        bool cooked = !job.output.empty() && (job.result == Result::Cooked || job.result == Result::UpToDate);
+        std::string_view source = cooked ? std::string_view() : std::string_view(job.source);
+        std::string_view output = cooked ? std::string_view(job.output) : std::string_view();
+
+        std::string definition;
+        if (job.source.empty()) definition = to_json_string(m_registry[job.index]);
+
+        registry.add(job.descriptor, type, job.name, source, output, definition);
+    }
+
+    registry.write((std::filesystem::path(m_options.output_dir) / BINARY_REGISTRY_NAME).string());
+}
+
+/**
+ * Pack every cooked file into one archive, keyed by descriptor, compressed if asked for.
+ */
+void Cooker::write_archive() const
+{
+    AssetArchiveWriter archive;
+    ArchiveFormat::Compression compression = m_options.compress ? ArchiveFormat::Compression::LZ4 : ArchiveFormat::Compression::None;
+
+    for (const Job& job : m_jobs)
+    {
+        if (job.output.empty() || (job.result != Result::Cooked && job.result != Result::UpToDate)) continue;
+
+        archive.add(job.descriptor, job.output, compression);
+    }
+
+    archive.write((std::filesystem::path(m_options.output_dir) / ARCHIVE_NAME).string());
+}
+
+/**
+ * Write the inputs, output and dependencies of every asset which cooked successfully.
+ *
+ * Failed assets are left out, so they are always retried.
+ */
+void Cooker::write_manifest() const
+{
+    rapidjson::Document manifest(rapidjson::kObjectType);
+    auto& allocator = manifest.GetAllocator();
+
+    manifest.AddMember("version", MANIFEST_VERSION, allocator);
+    manifest.AddMember("registry", rapidjson::Value(std::filesystem::absolute(m_options.registry_path).string().c_str(), allocator), allocator);
+
+    rapidjson::Value assets(rapidjson::kArrayType);
+    for (const Job& job : m_jobs)
+    {
+        if (job.result != Result::Cooked && job.result != Result::UpToDate) continue;
+
+        rapidjson::Value asset(rapidjson::kObjectType);
+        asset.AddMember("descriptor", job.descriptor, allocator);
+        asset.AddMember("type", rapidjson::Value(job.type.c_str(), allocator), allocator);
+        asset.AddMember("hash", job.hash, allocator);
+        if (!job.source.empty()) asset.AddMember("source", rapidjson::Value(job.source.c_str(), allocator), allocator);
+        if (!job.output.empty()) asset.AddMember("output", rapidjson::Value(job.output.c_str(), allocator), allocator);
+
+        rapidjson::Value dependencies(rapidjson::kArrayType);
+        for (AssetDescriptor dependency : job.dependencies) dependencies.PushBack(dependency, allocator);
+        asset.AddMember("dependencies", dependencies, allocator);
+
+        assets.PushBack(asset, allocator);
+    }
+    manifest.AddMember("assets", assets, allocator);
+
+    write_json(manifest, (std::filesystem::path(m_options.output_dir) / MANIFEST_NAME).string());
+}
+
+
+}
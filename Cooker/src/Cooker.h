@@ -0,0 +1,143 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <unordered_map>
+
+#include <rapidjson/document.h>
+
+#include "Asset/AssetDescriptor.h"
+
+namespace Parable
+{
+
+
+/**
+ * Converts the assets of a source registry into runtime formats, offline.
+ *
+ * Meshes are cooked to .pblmesh, textures to .pbltex and shaders are copied alongside them.
+ * A texture entry may set "format" to one of rgba8 (the default), bc1, bc3, bc5 or bc7, and
+ * "mips" to false to cook only the base level.
+ * Effects and materials are validated, including that the assets they reference exist and
+ * have the right types. Assets are cooked in parallel.
+ *
+ * An entry may set "name", so its descriptor is the FNV-1a hash of the name rather than its
+ * position, and other entries may refer to it by name.
+ *
+ * Writes to the output directory:
+ *  - registry.json, the source registry with each source path replaced by its cooked file
+ *  - registry.pblreg, the same as a cooked registry, which the runtime maps rather than parses
+ *  - assets.pblpak, an archive of every cooked file keyed by descriptor, so the runtime can
+ *    load them all from one mapping
+ *  - manifest.json, the inputs, output and dependencies of each asset, so an unchanged asset
+ *    is skipped on the next run and a build system can track what to re-cook
+ */
+class Cooker
+{
+public:
+    struct Options
+    {
+        std::string registry_path;
+        std::string output_dir;
+        /**
+         * Number of assets to cook at once, 0 for one per hardware thread.
+         */
+        unsigned num_threads = 0;
+        /**
+         * Cook every asset, even when the manifest shows it is up to date.
+         */
+        bool force = false;
+        /**
+         * LZ4 compress the entries of the archive, trading decode time for a smaller read.
+         */
+        bool compress = false;
+    };
+
+    Cooker(Options options);
+
+    int run();
+
+private:
+    enum class Result
+    {
+        Pending,
+        Cooked,
+        UpToDate,
+        Failed
+    };
+
+    /**
+     * One registry entry to cook.
+     */
+    struct Job
+    {
+        AssetDescriptor descriptor;
+        /**
+         * The position of the entry in the source registry.
+         */
+        rapidjson::SizeType index;
+        std::string name;
+        std::string type;
+
+        /**
+         * The source file to convert, empty for assets defined entirely by their registry entry.
+         */
+        std::string source;
+        /**
+         * The cooked file, empty if there is no source.
+         */
+        std::string output;
+        /**
+         * The registry key holding the source path, and the key to store the cooked path under.
+         */
+        std::string source_key;
+        std::string output_key;
+
+        std::vector<AssetDescriptor> dependencies;
+
+        /**
+         * Hash of the registry entry and source file, to detect changes between runs.
+         */
+        uint64_t hash = 0;
+
+        Result result = Result::Pending;
+        std::string error;
+    };
+
+    struct ManifestEntry
+    {
+        uint64_t hash;
+        std::string output;
+    };
+
+    void load_registry();
+    void load_manifest();
+
+    Job make_job(rapidjson::SizeType index, const rapidjson::Value& entry) const;
+    void check_dependencies(Job& job, const std::vector<AssetDescriptor>& referenced, std::string_view expected_type) const;
+
+    void cook_all();
+    void cook(Job& job);
+
+    void write_registry() const;
+    void write_cooked_registry() const;
+    void write_archive() const;
+    void write_manifest() const;
+
+    Options m_options;
+
+    rapidjson::Document m_registry;
+    std::vector<Job> m_jobs;
+    /**
+     * The index of each job by descriptor, for checking references.
+     */
+    std::unordered_map<AssetDescriptor, size_t> m_job_indices;
+
+    /**
+     * The results of the last run, by descriptor.
+     */
+    std::unordered_map<AssetDescriptor, ManifestEntry> m_previous;
+};
+
+
+}
@@ -0,0 +1,62 @@
+#include "Cooker.h"
+
+#include "Core/Log.h"
+
+#include <charconv>
+
+/**
+ * parable-cook: converts the assets of a registry into runtime formats.
+ *
+ * Usage: parable-cook <registry.json> <output dir> [--jobs N] [--force] [--compress]
+ *
+ * Exits with 0 if every asset cooked, 1 if any failed, and 2 on bad arguments.
+ */
+int main(int argc, char** argv)
+{
+    constexpr const char* usage = "Usage: parable-cook <registry.json> <output dir> [--jobs N] [--force] [--compress]";
+
+    Parable::Log::init();
+
+    Parable::Cooker::Options options;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg(argv[i]);
+
+        if (arg == "--force") options.force = true;
+        else if (arg == "--compress") options.compress = true;
+        else if (arg == "--jobs" && i + 1 < argc)
+        {
+            std::string_view value(argv[++i]);
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), options.num_threads);
+            if (error != std::errc() || end != value.data() + value.size() || options.num_threads == 0)
+            {
+                PBL_CORE_ERROR("--jobs expects a positive number of threads, got '{}'.", value);
+                PBL_CORE_ERROR(usage);
+                return 2;
+            }
+        }
+        else positional.emplace_back(arg);
+    }
+
+    if (positional.size() != 2)
+    {
+        PBL_CORE_ERROR(usage);
+        return 2;
+    }
+
+    options.registry_path = positional[0];
+    options.output_dir = positional[1];
+
+    try
+    {
+        Parable::Cooker cooker(std::move(options));
+        return cooker.run() == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e)
+    {
+        PBL_CORE_CRITICAL("Cooking failed: {}", e.what());
+        return 1;
+    }
+}
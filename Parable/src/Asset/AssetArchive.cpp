@@ -0,0 +1,331 @@
+#include "AssetArchive.h"
+
+#include "pblpch.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+#include "Exception/IOExceptions.h"
+
+#include "Jobs/JobSystem.h"
+
+#include "Util/Hash.h"
+#include "Util/LZ4.h"
+
+namespace Parable
+{
+
+
+/**
+ * Map a .pblpak archive and validate its header and table of contents.
+ *
+ * @param path the archive to read
+ *
+ * @throws Parable::FileOpenException if the file cannot be opened
+ * @throws Parable::FileFormatException if the file is not a valid .pblpak
+ */
+AssetArchive::AssetArchive(const std::string& path) : m_file(path, Util::AccessHint::Normal), m_io_file(path)
+{
+    if (m_file.size() < sizeof(ArchiveFormat::Header))
+    {
+        PBL_CORE_ERROR("{} is too small to be an asset archive.", path);
+        throw FileFormatException("File is too small to be an asset archive.");
+    }
+
+    std::memcpy(&m_header, m_file.data().data(), sizeof(m_header));
+
+    validate();
+
+    // the mapping is page aligned and the table TOC_ALIGNMENT aligned, so it is viewed in place
+    m_toc = { reinterpret_cast<const ArchiveFormat::TocEntry*>(m_file.data().data() + m_header.toc_offset), m_header.slot_count };
+}
+
+/**
+ * @throws Parable::FileFormatException if the header or any table entry is invalid
+ */
+void AssetArchive::validate() const
+{
+    auto fail = [this](const char* reason)
+    {
+        PBL_CORE_ERROR("Asset archive {} is invalid: {}", m_file.get_path(), reason);
+        throw FileFormatException("Invalid asset archive.");
+    };
+
+    if (std::memcmp(m_header.magic, ArchiveFormat::MAGIC, sizeof(ArchiveFormat::MAGIC)) != 0) fail("bad magic");
+    if (m_header.version != ArchiveFormat::VERSION) fail("unsupported version");
+    if (!std::has_single_bit(m_header.slot_count) || m_header.entry_count >= m_header.slot_count) fail("bad table size");
+
+    uint64_t toc_size = (uint64_t)m_header.slot_count * sizeof(ArchiveFormat::TocEntry);
+    if (m_header.toc_offset % ArchiveFormat::TOC_ALIGNMENT != 0 || m_header.toc_offset > m_file.size() || toc_size > m_file.size() - m_header.toc_offset) fail("table of contents out of range");
+
+    const auto* toc = reinterpret_cast<const ArchiveFormat::TocEntry*>(m_file.data().data() + m_header.toc_offset);
+
+    uint32_t occupied = 0;
+    for (uint32_t slot = 0; slot < m_header.slot_count; ++slot)
+    {
+        const ArchiveFormat::TocEntry& entry = toc[slot];
+        if (entry.offset == 0) continue;
+
+        if (entry.offset % ArchiveFormat::ENTRY_ALIGNMENT != 0 || entry.offset > m_header.toc_offset || entry.size > m_header.toc_offset - entry.offset) fail("entry out of range");
+
+        switch (entry.compression)
+        {
+            case ArchiveFormat::Compression::None:
+                if (entry.uncompressed_size != entry.size) fail("uncompressed entry has a different uncompressed size");
+                break;
+            case ArchiveFormat::Compression::LZ4:
+                if (entry.block_size == 0) fail("compressed entry has no block size");
+                break;
+            default:
+                fail("unknown compression");
+        }
+        ++occupied;
+    }
+
+    if (occupied != m_header.entry_count) fail("entry count does not match the table of contents");
+}
+
+/**
+ * Find the entry for a key.
+ *
+ * @return the entry, or nullptr if the key is not in the archive
+ */
+const ArchiveFormat::TocEntry* AssetArchive::find(uint64_t key) const
+{
+    size_t mask = m_toc.size() - 1;
+
+    // the table always has an empty slot, but the probe is bounded anyway so a damaged file can not hang it
+    size_t slot = Util::mix(key) & mask;
+    for (size_t probe = 0; probe < m_toc.size(); ++probe, slot = (slot + 1) & mask)
+    {
+        const ArchiveFormat::TocEntry& entry = m_toc[slot];
+        if (entry.offset == 0) return nullptr;
+        if (entry.key == key) return &entry;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Read an entry's asset data, decompressing it if needed.
+ *
+ * Compressed blocks are decoded straight into dst, in parallel if a job system is given, so dst
+ * can be mapped staging memory.
+ *
+ * @param entry the entry to read
+ * @param dst where to write the data, exactly get_uncompressed_size(entry) bytes
+ * @param jobs the job system to decode blocks on, or nullptr to decode on this thread
+ *
+ * @throws Parable::FileFormatException if the compressed data is corrupt
+ */
+void AssetArchive::read(const ArchiveFormat::TocEntry& entry, std::span<std::byte> dst, JobSystem* jobs) const
+{
+    decode(entry, get_data(entry), dst, jobs);
+}
+
+/**
+ * Decode an entry's data as stored, read by the caller rather than from the mapping, decompressing it if needed.
+ *
+ * @param entry the entry the data is of
+ * @param data the entry's data as stored, exactly entry.size bytes read from entry.offset, and 8 byte aligned
+ * @param dst where to write the data, exactly get_uncompressed_size(entry) bytes
+ * @param jobs the job system to decode blocks on, or nullptr to decode on this thread
+ *
+ * @throws Parable::FileFormatException if the compressed data is corrupt
+ */
+void AssetArchive::decode(const ArchiveFormat::TocEntry& entry, std::span<const std::byte> data, std::span<std::byte> dst, JobSystem* jobs) const
+{
+    PBL_CORE_ASSERT_MSG(data.size() == entry.size, "Decoding archive entry {} from data of the wrong size!", entry.key)
+    PBL_CORE_ASSERT_MSG(dst.size() == entry.uncompressed_size, "Reading archive entry {} into a buffer of the wrong size!", entry.key)
+
+    if (!is_compressed(entry))
+    {
+        if (!data.empty()) std::memcpy(dst.data(), data.data(), data.size());
+        return;
+    }
+
+    auto fail = [this, &entry](const char* reason)
+    {
+        PBL_CORE_ERROR("Entry {} of asset archive {} is invalid: {}", entry.key, m_file.get_path(), reason);
+        throw FileFormatException("Invalid compressed asset archive entry.");
+    };
+
+    uint64_t block_count = (entry.uncompressed_size + entry.block_size - 1) / entry.block_size;
+    uint64_t table_size = (block_count + 1) * sizeof(uint64_t);
+    if (table_size > data.size()) fail("block table out of range");
+
+    // entries are page aligned, and other data must be 8 byte aligned, so the table is viewed in place
+    std::span<const uint64_t> block_offsets(reinterpret_cast<const uint64_t*>(data.data()), block_count + 1);
+    if (block_offsets.front() != table_size || block_offsets.back() != data.size()) fail("block table does not span the entry");
+    for (uint64_t block = 0; block < block_count; ++block)
+    {
+        if (block_offsets[block] > block_offsets[block + 1]) fail("block table out of order");
+    }
+
+    std::atomic<bool> corrupt = false;
+    auto decode_block = [&](size_t block)
+    {
+        std::span<const std::byte> src = data.subspan(block_offsets[block], block_offsets[block + 1] - block_offsets[block]);
+
+        uint64_t start = (uint64_t)block * entry.block_size;
+        std::span<std::byte> out = dst.subspan(start, std::min<uint64_t>(entry.block_size, dst.size() - start));
+
+        if (!Util::LZ4::decompress(src, out)) corrupt.store(true, std::memory_order_relaxed);
+    };
+
+    if (jobs)
+    {
+        jobs->parallel_for(block_count, decode_block);
+    }
+    else
+    {
+        for (size_t block = 0; block < block_count; ++block) decode_block(block);
+    }
+
+    if (corrupt) fail("corrupt compressed block");
+}
+
+/**
+ * Check an entry's data against its checksum, which reads all of it.
+ */
+bool AssetArchive::verify(const ArchiveFormat::TocEntry& entry) const
+{
+    std::span<const std::byte> data = get_data(entry);
+    return Util::hash_bytes(data.data(), data.size()) == entry.checksum;
+}
+
+/**
+ * Add a file to pack. The file is read when the archive is written.
+ *
+ * A compressed entry is stored uncompressed anyway if compressing does not make it smaller.
+ */
+void AssetArchiveWriter::add(uint64_t key, const std::string& path, ArchiveFormat::Compression compression)
+{
+    m_sources.push_back({ key, path, {}, compression });
+}
+
+void AssetArchiveWriter::add(uint64_t key, std::vector<std::byte> data, ArchiveFormat::Compression compression)
+{
+    m_sources.push_back({ key, "", std::move(data), compression });
+}
+
+/**
+ * Compress an entry into independent blocks behind a table of their offsets.
+ *
+ * @return the entry as stored, or empty if compressing it does not save space
+ */
+static std::vector<std::byte> compress_blocks(std::span<const std::byte> data)
+{
+    size_t block_count = (data.size() + ArchiveFormat::BLOCK_SIZE - 1) / ArchiveFormat::BLOCK_SIZE;
+    size_t table_size = (block_count + 1) * sizeof(uint64_t);
+
+    std::vector<uint64_t> block_offsets(block_count + 1);
+    std::vector<std::byte> out(table_size + Util::LZ4::compress_bound(data.size()) + block_count * Util::LZ4::compress_bound(0));
+
+    size_t end = table_size;
+    for (size_t block = 0; block < block_count; ++block)
+    {
+        block_offsets[block] = end;
+
+        std::span<const std::byte> src = data.subspan(block * ArchiveFormat::BLOCK_SIZE, std::min<size_t>(ArchiveFormat::BLOCK_SIZE, data.size() - block * ArchiveFormat::BLOCK_SIZE));
+        end += Util::LZ4::compress(src, std::span(out).subspan(end));
+    }
+    block_offsets[block_count] = end;
+
+    if (end >= data.size()) return {};
+
+    std::memcpy(out.data(), block_offsets.data(), table_size);
+    out.resize(end);
+    return out;
+}
+
+/**
+ * Write the archive, streaming each entry to the file in turn.
+ *
+ * @param path the file to write, replaced if it exists
+ *
+ * @throws Parable::FileOpenException if the archive or a packed file cannot be opened
+ */
+void AssetArchiveWriter::write(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        PBL_CORE_ERROR("Failed to open {} to write an asset archive.", path);
+        throw FileOpenException("Failed to open asset archive for writing.");
+    }
+
+    auto pad_to = [&file](uint64_t alignment)
+    {
+        static constexpr char zeros[ArchiveFormat::ENTRY_ALIGNMENT] = {};
+        uint64_t position = (uint64_t)file.tellp();
+        uint64_t padding = (alignment - position % alignment) % alignment;
+        file.write(zeros, (std::streamsize)padding);
+    };
+
+    // the header is written last, once the table offset is known
+    ArchiveFormat::Header header {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // at most half full, so probe sequences stay short
+    uint32_t slot_count = std::bit_ceil((uint32_t)std::max<size_t>(m_sources.size() * 2, 1));
+    std::vector<ArchiveFormat::TocEntry> toc(slot_count);
+
+    for (const Source& source : m_sources)
+    {
+        Util::MappedFile mapped;
+        std::span<const std::byte> data = source.data;
+        if (!source.path.empty())
+        {
+            mapped = Util::MappedFile(source.path, Util::AccessHint::Sequential);
+            data = mapped.data();
+        }
+
+        ArchiveFormat::TocEntry entry {
+            .key = source.key,
+            .uncompressed_size = data.size(),
+            .compression = ArchiveFormat::Compression::None
+        };
+
+        std::vector<std::byte> compressed;
+        if (source.compression == ArchiveFormat::Compression::LZ4) compressed = compress_blocks(data);
+        if (!compressed.empty())
+        {
+            entry.compression = ArchiveFormat::Compression::LZ4;
+            entry.block_size = ArchiveFormat::BLOCK_SIZE;
+            data = compressed;
+        }
+
+        pad_to(ArchiveFormat::ENTRY_ALIGNMENT);
+
+        entry.offset = (uint64_t)file.tellp();
+        entry.size = data.size();
+        entry.checksum = Util::hash_bytes(data.data(), data.size());
+        file.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+
+        size_t slot = Util::mix(source.key) & (slot_count - 1);
+        while (toc[slot].offset != 0)
+        {
+            PBL_CORE_ASSERT_MSG(toc[slot].key != source.key, "Key {} added to an asset archive twice!", source.key)
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        toc[slot] = entry;
+    }
+
+    pad_to(ArchiveFormat::TOC_ALIGNMENT);
+
+    std::memcpy(header.magic, ArchiveFormat::MAGIC, sizeof(ArchiveFormat::MAGIC));
+    header.version = ArchiveFormat::VERSION;
+    header.entry_count = (uint32_t)m_sources.size();
+    header.slot_count = slot_count;
+    header.toc_offset = (uint64_t)file.tellp();
+
+    file.write(reinterpret_cast<const char*>(toc.data()), (std::streamsize)(toc.size() * sizeof(ArchiveFormat::TocEntry)));
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+
+}
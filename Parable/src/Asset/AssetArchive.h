@@ -0,0 +1,180 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <span>
+
+#include "Core/Base.h"
+
+#include "Util/MappedFile.h"
+
+#include "IO/File.h"
+
+namespace Parable
+{
+
+
+class JobSystem;
+
+/**
+ * The .pblpak packed asset archive format.
+ *
+ * A header page, then the data of each entry starting on its own ENTRY_ALIGNMENT boundary, then
+ * the table of contents. The table is an open addressed hash table of TocEntry slots keyed by
+ * asset, so a lookup probes a few slots in place rather than the table being parsed into a map.
+ *
+ * An entry may be compressed, in which case its data is split into blocks of block_size bytes
+ * (the last may be shorter) which are each compressed on their own, so they decode in parallel.
+ * The data starts with a table of block_count + 1 uint64_t offsets from the start of the entry,
+ * block i spanning [offsets[i], offsets[i + 1]), followed by the blocks.
+ *
+ * Values are written in host byte order.
+ */
+namespace ArchiveFormat
+{
+    constexpr char MAGIC[4] = { 'P', 'P', 'A', 'K' };
+    constexpr uint32_t VERSION = 2;
+    /**
+     * Entries are page aligned, so the formats packed inside keep their own alignment guarantees
+     * and each entry is paged in without touching its neighbours.
+     */
+    constexpr size_t ENTRY_ALIGNMENT = 4096;
+    constexpr size_t TOC_ALIGNMENT = 16;
+    /**
+     * Uncompressed bytes per compressed block. Large enough to keep the ratio close to
+     * compressing whole, small enough that a texture splits across every worker.
+     */
+    constexpr uint32_t BLOCK_SIZE = 256 * 1024;
+
+    enum class Compression : uint32_t
+    {
+        None = 0,
+        LZ4 = 1
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+
+        uint32_t entry_count;
+        /**
+         * Number of slots in the table of contents, a power of two.
+         */
+        uint32_t slot_count;
+        uint64_t toc_offset;
+    };
+
+    /**
+     * A slot in the table of contents.
+     *
+     * An offset of 0 marks an empty slot, as the header occupies the first page.
+     */
+    struct TocEntry
+    {
+        uint64_t key;
+        uint64_t offset;
+        /**
+         * Size of the entry as stored, after any compression.
+         */
+        uint64_t size;
+        /**
+         * Util::hash_bytes of the entry data as stored.
+         */
+        uint64_t checksum;
+
+        uint64_t uncompressed_size;
+        Compression compression;
+        /**
+         * Uncompressed bytes per block, if compressed.
+         */
+        uint32_t block_size;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+    static_assert(std::is_trivially_copyable_v<TocEntry>);
+}
+
+/**
+ * A read-only view of a .pblpak archive.
+ *
+ * The whole archive is memory mapped once, so reading an asset is a page fault rather than a
+ * file open, and entry data can be handed to the cooked format readers in place. Views are valid
+ * while the AssetArchive lives.
+ */
+class AssetArchive
+{
+public:
+    AssetArchive(const std::string& path);
+
+    const ArchiveFormat::TocEntry* find(uint64_t key) const;
+
+    /**
+     * The entry's data as stored, which is only the asset itself if the entry is not compressed.
+     */
+    std::span<const std::byte> get_data(const ArchiveFormat::TocEntry& entry) const { return m_file.data().subspan(entry.offset, entry.size); }
+
+    bool is_compressed(const ArchiveFormat::TocEntry& entry) const { return entry.compression != ArchiveFormat::Compression::None; }
+    uint64_t get_uncompressed_size(const ArchiveFormat::TocEntry& entry) const { return entry.uncompressed_size; }
+
+    void read(const ArchiveFormat::TocEntry& entry, std::span<std::byte> dst, JobSystem* jobs = nullptr) const;
+    void decode(const ArchiveFormat::TocEntry& entry, std::span<const std::byte> data, std::span<std::byte> dst, JobSystem* jobs = nullptr) const;
+
+    /**
+     * The archive opened for reads through the IO service, which fetch an entry's data without faulting in the mapping.
+     */
+    const IO::File& get_file() const { return m_io_file; }
+
+    bool verify(const ArchiveFormat::TocEntry& entry) const;
+
+    uint32_t get_entry_count() const { return m_header.entry_count; }
+    const std::string& get_path() const { return m_file.get_path(); }
+
+private:
+    void validate() const;
+
+    Util::MappedFile m_file;
+    IO::File m_io_file;
+    ArchiveFormat::Header m_header;
+    std::span<const ArchiveFormat::TocEntry> m_toc;
+};
+
+/**
+ * An entry of an archive, as found by AssetRegistry::resolve_packed.
+ */
+struct PackedAsset
+{
+    const AssetArchive* archive = nullptr;
+    const ArchiveFormat::TocEntry* entry = nullptr;
+
+    explicit operator bool() const { return entry != nullptr; }
+};
+
+/**
+ * Builds a .pblpak archive from files or in memory data.
+ */
+class AssetArchiveWriter
+{
+public:
+    void add(uint64_t key, const std::string& path, ArchiveFormat::Compression compression = ArchiveFormat::Compression::None);
+    void add(uint64_t key, std::vector<std::byte> data, ArchiveFormat::Compression compression = ArchiveFormat::Compression::None);
+
+    void write(const std::string& path) const;
+
+private:
+    /**
+     * An entry to pack, from a file if path is set and otherwise from data.
+     */
+    struct Source
+    {
+        uint64_t key;
+        std::string path;
+        std::vector<std::byte> data;
+        ArchiveFormat::Compression compression;
+    };
+
+    std::vector<Source> m_sources;
+};
+
+
+}
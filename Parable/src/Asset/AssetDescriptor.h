@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <string_view>
+
+#include "Util/Hash.h"
 
 namespace Parable
 {
@@ -8,5 +11,26 @@ namespace Parable
 
 using AssetDescriptor = uint64_t;
 
+/**
+ * The descriptor of a named asset, the FNV-1a hash of its name.
+ * 
+ * Stable across builds and runs, so it can be baked into cooked data or computed at compile time.
+ */
+constexpr AssetDescriptor descriptor_from_name(std::string_view name)
+{
+    return Util::fnv1a(name);
+}
+
+namespace AssetLiterals
+{
+    /**
+     * The descriptor of a named asset at compile time, e.g. "meshes/cube"_asset.
+     */
+    consteval AssetDescriptor operator""_asset(const char* name, size_t size)
+    {
+        return descriptor_from_name(std::string_view(name, size));
+    }
+}
+
 
 }
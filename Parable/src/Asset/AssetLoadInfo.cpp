@@ -6,6 +6,7 @@
 
 #include <exception>
 
+#include "CookedRegistry.h"
 #include "EffectLoadInfo.h"
 #include "MaterialLoadInfo.h"
 
@@ -13,28 +14,47 @@ namespace Parable
 {
 
 
+AssetType asset_type_from_string(std::string_view name)
+{
+    if (name == "mesh") return AssetType::Mesh;
+    if (name == "texture") return AssetType::Texture;
+    if (name == "shader") return AssetType::Shader;
+    if (name == "effect") return AssetType::Effect;
+    if (name == "material") return AssetType::Material;
+
+    return AssetType::None;
+}
+
 MeshLoadInfo::MeshLoadInfo(const rapidjson::Value& source)
 {
     auto object = source.GetObject();
 
-    if (!object.HasMember("obj_path") || !object["obj_path"].IsString())
+    bool has_obj = object.HasMember("obj_path") && object["obj_path"].IsString();
+    bool has_pblmesh = object.HasMember("pblmesh_path") && object["pblmesh_path"].IsString();
+
+    if (!has_obj && !has_pblmesh)
     {
-        throw std::exception("MeshLoadInfo does not contain an obj_path string.");
+        throw std::exception("MeshLoadInfo does not contain an obj_path or pblmesh_path string.");
     }
 
-    m_obj_path = object["obj_path"].GetString();
+    if (has_obj) m_obj_path = object["obj_path"].GetString();
+    if (has_pblmesh) m_pblmesh_path = object["pblmesh_path"].GetString();
 }
 
 TextureLoadInfo::TextureLoadInfo(const rapidjson::Value& source)
 {
     auto object = source.GetObject();
 
-    if (!object.HasMember("png_path") || !object["png_path"].IsString())
+    bool has_png = object.HasMember("png_path") && object["png_path"].IsString();
+    bool has_pbltex = object.HasMember("pbltex_path") && object["pbltex_path"].IsString();
+
+    if (!has_png && !has_pbltex)
     {
-        throw std::exception("TextureLoadInfo does not contain a png_path string.");
+        throw std::exception("TextureLoadInfo does not contain a png_path or pbltex_path string.");
     }
 
-    m_png_path = object["png_path"].GetString();
+    if (has_png) m_png_path = object["png_path"].GetString();
+    if (has_pbltex) m_pbltex_path = object["pbltex_path"].GetString();
 }
 
 ShaderLoadInfo::ShaderLoadInfo(const rapidjson::Value& source)
@@ -60,15 +80,74 @@ std::unique_ptr<AssetLoadInfo> AssetLoadInfoFactory::create(const rapidjson::Val
         throw std::exception("AssetLoadInfo does not contain a type string.");
     }
 
-    std::string_view type(source["type"].GetString());
-    if (type == "mesh") return std::make_unique<MeshLoadInfo>(source);
-    if (type == "texture") return std::make_unique<TextureLoadInfo>(source);
-    if (type == "shader") return std::make_unique<ShaderLoadInfo>(source);
-    if (type == "effect") return std::make_unique<EffectLoadInfo>(source);
-    if (type == "material") return std::make_unique<MaterialLoadInfo>(source);
+    switch (asset_type_from_string(source["type"].GetString()))
+    {
+        case AssetType::Mesh: return std::make_unique<MeshLoadInfo>(source);
+        case AssetType::Texture: return std::make_unique<TextureLoadInfo>(source);
+        case AssetType::Shader: return std::make_unique<ShaderLoadInfo>(source);
+        case AssetType::Effect: return std::make_unique<EffectLoadInfo>(source);
+        case AssetType::Material: return std::make_unique<MaterialLoadInfo>(source);
+        default: break;
+    }
 
     throw std::exception("Unrecognised AssetLoadInfo type.");
 }
 
+std::unique_ptr<AssetLoadInfo> AssetLoadInfoFactory::create(const CookedRegistry& registry, const RegistryFormat::Record& record)
+{
+    std::string source_path(registry.get_string(record.source_path));
+    std::string cooked_path(registry.get_string(record.cooked_path));
+
+    switch (record.type)
+    {
+        case AssetType::Mesh: return std::make_unique<MeshLoadInfo>(std::move(source_path), std::move(cooked_path));
+        case AssetType::Texture: return std::make_unique<TextureLoadInfo>(std::move(source_path), std::move(cooked_path));
+        case AssetType::Shader: return std::make_unique<ShaderLoadInfo>(cooked_path.empty() ? std::move(source_path) : std::move(cooked_path));
+        default: break;
+    }
+
+    // the rest are defined by their registry entry, which is only parsed once the asset is used
+    std::string_view definition = registry.get_string(record.definition);
+
+    rapidjson::Document document;
+    document.Parse(definition.data(), definition.size());
+    if (document.HasParseError())
+    {
+        throw std::exception("Cooked registry definition is not valid json.");
+    }
+
+    return create(document);
+}
+
+AssetDescriptor AssetLoadInfoFactory::get_descriptor(const rapidjson::Value& source, size_t index)
+{
+    if (source.IsObject() && source.HasMember("name") && source["name"].IsString())
+    {
+        const rapidjson::Value& name = source["name"];
+        return descriptor_from_name(std::string_view(name.GetString(), name.GetStringLength()));
+    }
+
+    return (AssetDescriptor)index;
+}
+
+bool AssetLoadInfoFactory::is_reference(const rapidjson::Value& source)
+{
+    return source.IsUint64() || source.IsString();
+}
+
+AssetDescriptor AssetLoadInfoFactory::parse_reference(const rapidjson::Value& source)
+{
+    if (source.IsString())
+    {
+        return descriptor_from_name(std::string_view(source.GetString(), source.GetStringLength()));
+    }
+    if (source.IsUint64())
+    {
+        return source.GetUint64();
+    }
+
+    throw std::exception("Asset reference is not a descriptor or a name.");
+}
+
 
 }
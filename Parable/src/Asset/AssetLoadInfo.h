@@ -30,36 +30,58 @@ public:
     virtual AssetType get_asset_type() const = 0;
 };
 
+AssetType asset_type_from_string(std::string_view name);
+
 template<class T>
 concept IsAssetLoadInfo = std::derived_from<T, AssetLoadInfo>;
 
 #define LOAD_INFO_ASSET_TYPE(type) const static AssetType asset_type = AssetType::type;\
                                     AssetType get_asset_type() const override { return AssetType::type; }
 
+/**
+ * Load info for a mesh, from either a cooked .pblmesh (preferred) or a source .obj.
+ */
 class MeshLoadInfo : public AssetLoadInfo
 {
 private:
     std::string m_obj_path;
+    std::string m_pblmesh_path;
 
 public:
     LOAD_INFO_ASSET_TYPE(Mesh)
 
     MeshLoadInfo(const rapidjson::Value& source);
+    MeshLoadInfo(std::string obj_path, std::string pblmesh_path)
+        : m_obj_path(std::move(obj_path)), m_pblmesh_path(std::move(pblmesh_path))
+    {}
+
+    bool is_cooked() const { return !m_pblmesh_path.empty(); }
 
     const std::string& get_obj_path() const { return m_obj_path; }
+    const std::string& get_pblmesh_path() const { return m_pblmesh_path; }
 };
 
+/**
+ * Load info for a texture, from either a cooked .pbltex (preferred) or a source .png.
+ */
 class TextureLoadInfo : public AssetLoadInfo
 {
 private:
     std::string m_png_path;
+    std::string m_pbltex_path;
 
 public:
     LOAD_INFO_ASSET_TYPE(Texture)
 
     TextureLoadInfo(const rapidjson::Value& source);
+    TextureLoadInfo(std::string png_path, std::string pbltex_path)
+        : m_png_path(std::move(png_path)), m_pbltex_path(std::move(pbltex_path))
+    {}
+
+    bool is_cooked() const { return !m_pbltex_path.empty(); }
 
     const std::string& get_png_path() const { return m_png_path; }
+    const std::string& get_pbltex_path() const { return m_pbltex_path; }
 };
 
 class ShaderLoadInfo : public AssetLoadInfo
@@ -71,10 +93,17 @@ public:
     LOAD_INFO_ASSET_TYPE(Shader)
 
     ShaderLoadInfo(const rapidjson::Value& source);
+    ShaderLoadInfo(std::string spv_path) : m_spv_path(std::move(spv_path)) {}
 
     const std::string& get_spv_path() const { return m_spv_path; }
 };
 
+class CookedRegistry;
+namespace RegistryFormat
+{
+    struct Record;
+}
+
 class AssetLoadInfoFactory
 {
 public:
@@ -87,6 +116,33 @@ public:
      * @return std::unique_ptr<AssetLoadInfo> 
      */
     static std::unique_ptr<AssetLoadInfo> create(const rapidjson::Value& source);
+
+    /**
+     * Create a new AssetLoadInfo object from a record of a cooked registry.
+     * 
+     * @param registry The registry holding the record's strings.
+     * @param record The record to create load info from.
+     * @return std::unique_ptr<AssetLoadInfo> 
+     */
+    static std::unique_ptr<AssetLoadInfo> create(const CookedRegistry& registry, const RegistryFormat::Record& record);
+
+    /**
+     * Get the descriptor of an entry in a json registry, the hash of its name if it has one and otherwise its position.
+     * 
+     * @param source The registry entry.
+     * @param index The position of the entry in the registry.
+     * @return AssetDescriptor 
+     */
+    static AssetDescriptor get_descriptor(const rapidjson::Value& source, size_t index);
+
+    /**
+     * Parse a reference to another asset, given either as its descriptor or as its name.
+     * 
+     * @param source The json value of the reference.
+     * @return AssetDescriptor 
+     */
+    static AssetDescriptor parse_reference(const rapidjson::Value& source);
+    static bool is_reference(const rapidjson::Value& source);
 };
 
 
@@ -4,36 +4,40 @@
 
 #include "Core/Base.h"
 
-#include <fstream>
 #include <exception>
 
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
-#include <rapidjson/istreamwrapper.h>
+
+#include "Util/MappedFile.h"
 
 #include "AssetLoadInfo.h"
+#include "AssetArchive.h"
+#include "CookedRegistry.h"
 
 namespace Parable
 {
 
 
-std::map<AssetDescriptor, std::unique_ptr<AssetLoadInfo>> AssetRegistry::descriptor_to_load_info;
+Util::FlatHashMap<AssetDescriptor, AssetRegistry::Entry> AssetRegistry::descriptor_to_load_info;
+std::unique_ptr<AssetArchive> AssetRegistry::mounted_archive;
+std::atomic<bool> AssetRegistry::packed_resolved = false;
+std::unique_ptr<CookedRegistry> AssetRegistry::mounted_registry;
+AssetRegistry::CookedLoadInfos AssetRegistry::cooked_load_infos;
 
 void AssetRegistry::init()
 {
+    // a cooked registry already has everything the json one would be parsed into
+    if (mounted_registry) return;
+
     int num_load_infos = 0;
 
     // loading from a test registry file
-    std::ifstream registry_file("D:\\parable-engine\\test_asset_registry.json");
-    if (!registry_file.is_open())
-    {
-        throw std::exception("Failed to open registry file.");
-    }
-
-    rapidjson::IStreamWrapper registry_file_wrapped{registry_file};
+    Util::MappedFile registry_file("D:\\parable-engine\\test_asset_registry.json", Util::AccessHint::WillNeed);
+    std::string_view registry_json = registry_file.chars();
 
     rapidjson::Document registry_document{};
-    registry_document.ParseStream(registry_file_wrapped);
+    registry_document.Parse(registry_json.data(), registry_json.size());
 
     if (registry_document.HasParseError())
     {
@@ -46,10 +50,17 @@ void AssetRegistry::init()
     }
 
     const auto& registry_array = registry_document.GetArray();
+    descriptor_to_load_info.reserve(registry_array.Size());
 
     for (rapidjson::SizeType i = 0; i < registry_array.Size(); ++i)
     {
-        descriptor_to_load_info.emplace(i, AssetLoadInfoFactory::create(registry_array[i]));
+        std::unique_ptr<AssetLoadInfo> load_info = AssetLoadInfoFactory::create(registry_array[i]);
+        AssetType type = load_info->get_asset_type();
+        AssetDescriptor descriptor = AssetLoadInfoFactory::get_descriptor(registry_array[i], i);
+        if (!descriptor_to_load_info.try_emplace(descriptor, Entry{ type, std::move(load_info) }).second)
+        {
+            PBL_CORE_ERROR("Registry entry {} has the same descriptor as an earlier entry, {}.", i, descriptor);
+        }
 
         ++num_load_infos;
     }
@@ -57,5 +68,120 @@ void AssetRegistry::init()
     PBL_CORE_TRACE("Parsed {} load info objects.", num_load_infos);
 }
 
+/**
+ * Mount a cooked .pblreg registry to resolve load info from, in place of the json registry.
+ * 
+ * Must be called before init, so the json registry is never parsed.
+ * 
+ * @param path the registry written by the cooker
+ * 
+ * @throws Parable::FileOpenException if the registry cannot be opened
+ * @throws Parable::FileFormatException if the file is not a cooked registry
+ */
+void AssetRegistry::mount_registry(const std::string& path)
+{
+    cooked_load_infos.clear();
+
+    mounted_registry = std::make_unique<CookedRegistry>(path);
+
+    cooked_load_infos.slot_count = mounted_registry->get_slot_count();
+    cooked_load_infos.slots = std::make_unique<std::atomic<const AssetLoadInfo*>[]>(cooked_load_infos.slot_count);
 
+    PBL_CORE_TRACE("Mounted asset registry {} with {} entries.", path, mounted_registry->get_entry_count());
 }
+
+/**
+ * Find the load info of an asset.
+ * 
+ * Safe to call from any thread once the registry is initialised.
+ * 
+ * @throws std::runtime_error if the asset is not in the registry, or is not of the expected type
+ */
+const AssetLoadInfo& AssetRegistry::resolve(AssetDescriptor descriptor, AssetType type)
+{
+    if (mounted_registry)
+    {
+        const RegistryFormat::Record* record = mounted_registry->find(descriptor);
+        if (!record) throw std::runtime_error("Asset for descriptor not found!");
+        if (record->type != type) throw std::runtime_error("Asset resolved from descriptor is of unexpected type!");
+
+        std::atomic<const AssetLoadInfo*>& slot = cooked_load_infos.slots[mounted_registry->get_slot(*record)];
+        const AssetLoadInfo* load_info = slot.load(std::memory_order_acquire);
+        if (load_info) return *load_info;
+
+        // threads resolving the same record at once both build it, and the loser's copy is dropped
+        std::unique_ptr<AssetLoadInfo> created = AssetLoadInfoFactory::create(*mounted_registry, *record);
+        if (slot.compare_exchange_strong(load_info, created.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            load_info = created.release();
+        }
+        return *load_info;
+    }
+
+    if (auto it = descriptor_to_load_info.find(descriptor); it != descriptor_to_load_info.end())
+    {
+        const Entry& entry = it->second;
+        if (entry.type == type) {
+            return *entry.load_info;
+        }
+
+        throw std::runtime_error("Asset resolved from descriptor is of unexpected type!");
+    }
+
+    throw std::runtime_error("Asset for descriptor not found!");
+}
+
+void AssetRegistry::CookedLoadInfos::clear()
+{
+    for (size_t i = 0; i < slot_count; ++i)
+    {
+        delete slots[i].load(std::memory_order_relaxed);
+    }
+    slots.reset();
+    slot_count = 0;
+}
+
+/**
+ * Mount a packed asset archive, so assets in it are loaded from the archive rather than their own files.
+ * 
+ * Must be called before any asset is resolved, or those already loaded will have come from their own files.
+ * 
+ * @param path the .pblpak archive, keyed by asset descriptor
+ * 
+ * @throws Parable::FileOpenException if the archive cannot be opened
+ * @throws Parable::FileFormatException if the file is not an asset archive
+ */
+void AssetRegistry::mount_archive(const std::string& path)
+{
+    PBL_CORE_ASSERT_MSG(!packed_resolved.load(std::memory_order_relaxed), "Asset archive {} mounted after assets were already resolved!", path)
+
+    mounted_archive = std::make_unique<AssetArchive>(path);
+
+    PBL_CORE_TRACE("Mounted asset archive {} with {} entries.", path, mounted_archive->get_entry_count());
+}
+
+/**
+ * Find the entry of an asset in the mounted archive.
+ * 
+ * The entry stays valid while the archive is mounted.
+ * 
+ * @param descriptor the asset to find
+ * @return the entry, empty if no archive is mounted or the asset is not in it
+ */
+PackedAsset AssetRegistry::resolve_packed(AssetDescriptor descriptor)
+{
+    packed_resolved.store(true, std::memory_order_relaxed);
+
+    if (!mounted_archive) return {};
+
+    const ArchiveFormat::TocEntry* entry = mounted_archive->find(descriptor);
+    if (!entry) return {};
+
+    // reads the whole entry, so only checked in debug builds
+    PBL_CORE_ASSERT_MSG(mounted_archive->verify(*entry), "Asset {} in archive {} fails its checksum!", descriptor, mounted_archive->get_path())
+
+    return { mounted_archive.get(), entry };
+}
+
+
+}
\ No newline at end of file
@@ -2,8 +2,15 @@
 
 #include "pblpch.h"
 
+#include <atomic>
+#include <span>
+
+#include "AssetArchive.h"
 #include "AssetDescriptor.h"
 #include "AssetLoadInfo.h"
+#include "CookedRegistry.h"
+
+#include "Util/FlatHashMap.h"
 
 namespace Parable
 {
@@ -11,29 +18,66 @@ namespace Parable
 
 /**
  * Provides static access to AssetLoadInfo objects, mapped to by AssetDescriptors.
+ * 
+ * Load info comes either from a json registry, parsed whole at startup, or from a mounted cooked
+ * registry, which is used in place from its mapping. Load info for a cooked record is only built
+ * the first time it is resolved.
  */
 class AssetRegistry
 {
 private:
-    static std::map<AssetDescriptor, std::unique_ptr<AssetLoadInfo>> descriptor_to_load_info;
+    /**
+     * A load info with its asset type cached, so resolving does not need a virtual call.
+     */
+    struct Entry
+    {
+        AssetType type;
+        std::unique_ptr<AssetLoadInfo> load_info;
+    };
+
+    static Util::FlatHashMap<AssetDescriptor, Entry> descriptor_to_load_info;
+
+    /**
+     * Cooked asset data packed by descriptor, if an archive is mounted.
+     */
+    static std::unique_ptr<AssetArchive> mounted_archive;
+    /**
+     * Set once any asset has been resolved against the archive, after which one can no longer be mounted.
+     */
+    static std::atomic<bool> packed_resolved;
+
+    /**
+     * Load info built from the records of the mounted registry, by slot, null until first resolved.
+     */
+    struct CookedLoadInfos
+    {
+        std::unique_ptr<std::atomic<const AssetLoadInfo*>[]> slots;
+        size_t slot_count = 0;
+
+        ~CookedLoadInfos() { clear(); }
+        void clear();
+    };
+
+    /**
+     * The cooked registry, if one is mounted, which replaces the json registry.
+     */
+    static std::unique_ptr<CookedRegistry> mounted_registry;
+    static CookedLoadInfos cooked_load_infos;
+
+    static const AssetLoadInfo& resolve(AssetDescriptor descriptor, AssetType type);
 
 public:
     static void init();
 
+    static void mount_registry(const std::string& path);
+
+    static void mount_archive(const std::string& path);
+    static PackedAsset resolve_packed(AssetDescriptor descriptor);
+
     template<IsAssetLoadInfo ConcreteLoadInfoType>
     static const ConcreteLoadInfoType& resolve(AssetDescriptor descriptor)
     {
-        if (auto it = descriptor_to_load_info.find(descriptor); it != descriptor_to_load_info.end())
-        {
-            const AssetLoadInfo& info = *(it->second);
-            if (info.get_asset_type() == ConcreteLoadInfoType::asset_type) {
-                return static_cast<const ConcreteLoadInfoType&>(info);
-            }
-
-            throw std::runtime_error("Asset resolved from descriptor is of unexpected type!");
-        }
-
-        throw std::runtime_error("Asset for descriptor not found!");
+        return static_cast<const ConcreteLoadInfoType&>(resolve(descriptor, ConcreteLoadInfoType::asset_type));
     }
 };
 
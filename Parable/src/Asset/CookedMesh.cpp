@@ -0,0 +1,163 @@
+#include "CookedMesh.h"
+
+#include "pblpch.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "Exception/IOExceptions.h"
+
+namespace Parable
+{
+
+
+/**
+ * Map a .pblmesh file and validate its header.
+ *
+ * @param path the file to read
+ *
+ * @throws Parable::FileOpenException if the file cannot be opened
+ * @throws Parable::FileFormatException if the file is not a valid .pblmesh
+ */
+CookedMesh::CookedMesh(const std::string& path) : m_file(path, Util::AccessHint::Sequential), m_data(m_file.data()), m_name(path)
+{
+    read_header();
+}
+
+/**
+ * View .pblmesh data held in memory, which must outlive the CookedMesh.
+ *
+ * @param data the data, aligned to at least MeshFormat::BLOB_ALIGNMENT
+ * @param name a name for the data in error messages
+ *
+ * @throws Parable::FileFormatException if the data is not a valid .pblmesh
+ */
+CookedMesh::CookedMesh(std::span<const std::byte> data, const std::string& name) : m_data(data), m_name(name)
+{
+    read_header();
+}
+
+void CookedMesh::read_header()
+{
+    if (m_data.size() < sizeof(MeshFormat::Header))
+    {
+        PBL_CORE_ERROR("{} is too small to be a cooked mesh.", m_name);
+        throw FileFormatException("File is too small to be a cooked mesh.");
+    }
+
+    std::memcpy(&m_header, m_data.data(), sizeof(m_header));
+
+    validate();
+}
+
+/**
+ * Check the header describes blobs which lie within the file.
+ *
+ * @throws Parable::FileFormatException if it does not
+ */
+void CookedMesh::validate() const
+{
+    auto fail = [this](const char* reason)
+    {
+        PBL_CORE_ERROR("Cooked mesh {} is invalid: {}", m_name, reason);
+        throw FileFormatException("Invalid cooked mesh.");
+    };
+
+    if (std::memcmp(m_header.magic, MeshFormat::MAGIC, sizeof(MeshFormat::MAGIC)) != 0) fail("bad magic");
+    if (m_header.version != MeshFormat::VERSION) fail("unsupported version");
+    if (m_header.attribute_count > MeshFormat::MAX_ATTRIBUTES) fail("too many attributes");
+    if (m_header.index_size != 2 && m_header.index_size != 4) fail("index size must be 2 or 4");
+
+    auto in_file = [this](uint64_t offset, uint64_t size)
+    {
+        return offset % MeshFormat::BLOB_ALIGNMENT == 0 && offset <= m_data.size() && size <= m_data.size() - offset;
+    };
+
+    if (!in_file(m_header.vertex_offset, (uint64_t)m_header.vertex_count * m_header.vertex_stride)) fail("vertex blob out of range");
+    if (!in_file(m_header.index_offset, (uint64_t)m_header.index_count * m_header.index_size)) fail("index blob out of range");
+    if (!in_file(m_header.lod_offset, (uint64_t)m_header.lod_count * sizeof(MeshFormat::Lod))) fail("LOD table out of range");
+
+    for (const MeshFormat::VertexAttribute& attribute : get_attributes())
+    {
+        if (attribute.offset >= m_header.vertex_stride) fail("attribute outside the vertex");
+    }
+
+    for (const MeshFormat::Lod& lod : get_lods())
+    {
+        if ((uint64_t)lod.first_index + lod.index_count > m_header.index_count) fail("LOD index range out of range");
+    }
+}
+
+/**
+ * Check the vertices are laid out exactly as a renderer expects, so can be copied without conversion.
+ *
+ * @param stride the expected vertex size
+ * @param attributes the expected attributes, in order
+ */
+bool CookedMesh::has_layout(uint32_t stride, std::span<const MeshFormat::VertexAttribute> attributes) const
+{
+    return stride == m_header.vertex_stride && std::ranges::equal(attributes, get_attributes());
+}
+
+/**
+ * The mesh LODs, finest first.
+ *
+ * The mapping is page aligned and the table is BLOB_ALIGNMENT aligned, so it is viewed in place.
+ */
+std::span<const MeshFormat::Lod> CookedMesh::get_lods() const
+{
+    const auto* lods = reinterpret_cast<const MeshFormat::Lod*>(m_data.data() + m_header.lod_offset);
+    return { lods, m_header.lod_count };
+}
+
+/**
+ * Write a .pblmesh file.
+ *
+ * @param path the file to write, replaced if it exists
+ * @param data the mesh to write
+ *
+ * @throws Parable::FileOpenException if the file cannot be written
+ */
+void CookedMesh::write(const std::string& path, const CookedMeshData& data)
+{
+    PBL_CORE_ASSERT_MSG(data.attributes.size() <= MeshFormat::MAX_ATTRIBUTES, "Too many vertex attributes for a cooked mesh!")
+    PBL_CORE_ASSERT_MSG(data.vertex_stride > 0 && data.vertices.size() % data.vertex_stride == 0, "Vertex data is not a whole number of vertices!")
+
+    auto align = [](uint64_t offset) { return (offset + MeshFormat::BLOB_ALIGNMENT - 1) & ~(uint64_t)(MeshFormat::BLOB_ALIGNMENT - 1); };
+
+    MeshFormat::Header header {};
+    std::memcpy(header.magic, MeshFormat::MAGIC, sizeof(MeshFormat::MAGIC));
+    header.version = MeshFormat::VERSION;
+    header.vertex_stride = data.vertex_stride;
+    header.vertex_count = (uint32_t)(data.vertices.size() / data.vertex_stride);
+    header.index_count = (uint32_t)data.indices.size();
+    header.index_size = sizeof(uint32_t);
+    header.attribute_count = (uint32_t)data.attributes.size();
+    header.lod_count = (uint32_t)data.lods.size();
+    std::ranges::copy(data.attributes, header.attributes);
+    std::ranges::copy(data.bounds_min, header.bounds_min);
+    std::ranges::copy(data.bounds_max, header.bounds_max);
+
+    header.vertex_offset = align(sizeof(header));
+    header.index_offset = align(header.vertex_offset + data.vertices.size_bytes());
+    header.lod_offset = align(header.index_offset + data.indices.size_bytes());
+    uint64_t total_size = header.lod_offset + data.lods.size() * sizeof(MeshFormat::Lod);
+
+    // assemble the file in memory and write it in one call
+    std::vector<std::byte> bytes(total_size);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + header.vertex_offset, data.vertices.data(), data.vertices.size_bytes());
+    std::memcpy(bytes.data() + header.index_offset, data.indices.data(), data.indices.size_bytes());
+    std::memcpy(bytes.data() + header.lod_offset, data.lods.data(), data.lods.size() * sizeof(MeshFormat::Lod));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        PBL_CORE_ERROR("Failed to open {} to write a cooked mesh.", path);
+        throw FileOpenException("Failed to open cooked mesh for writing.");
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+}
+
+
+}
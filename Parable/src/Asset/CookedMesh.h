@@ -0,0 +1,170 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <span>
+
+#include "Core/Base.h"
+
+#include "Util/MappedFile.h"
+
+namespace Parable
+{
+
+
+/**
+ * The .pblmesh cooked mesh format.
+ *
+ * A fixed size header, then the vertex blob, index blob and LOD table, each aligned to
+ * BLOB_ALIGNMENT from the start of the file. The vertex blob is laid out exactly as the
+ * header's attributes describe, so it can be copied straight into a GPU buffer.
+ *
+ * Values are written in host byte order.
+ */
+namespace MeshFormat
+{
+    constexpr char MAGIC[4] = { 'P', 'M', 'S', 'H' };
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t BLOB_ALIGNMENT = 16;
+    constexpr size_t MAX_ATTRIBUTES = 8;
+
+    enum class VertexSemantic : uint8_t
+    {
+        Position = 0,
+        Color,
+        TexCoord,
+        Normal,
+        Tangent
+    };
+
+    enum class AttributeFormat : uint8_t
+    {
+        Float2 = 0,
+        Float3,
+        Float4
+    };
+
+    /**
+     * Describes one attribute within a vertex.
+     */
+    struct VertexAttribute
+    {
+        VertexSemantic semantic;
+        AttributeFormat format;
+        /**
+         * Byte offset of the attribute from the start of the vertex.
+         */
+        uint16_t offset;
+
+        bool operator==(const VertexAttribute& other) const = default;
+    };
+
+    /**
+     * A level of detail, as a range of the index blob.
+     *
+     * LODs share the vertex blob, LOD 0 is the full detail mesh.
+     */
+    struct Lod
+    {
+        uint32_t first_index;
+        uint32_t index_count;
+        /**
+         * The view distance beyond which a coarser LOD should be used.
+         */
+        float max_distance;
+        uint32_t reserved = 0;
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+
+        uint32_t vertex_stride;
+        uint32_t vertex_count;
+        uint32_t index_count;
+        /**
+         * Bytes per index, 2 or 4.
+         */
+        uint32_t index_size;
+        uint32_t attribute_count;
+        uint32_t lod_count;
+
+        VertexAttribute attributes[MAX_ATTRIBUTES];
+
+        float bounds_min[3];
+        float bounds_max[3];
+
+        uint64_t vertex_offset;
+        uint64_t index_offset;
+        uint64_t lod_offset;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+}
+
+/**
+ * Source data to write a cooked mesh from.
+ */
+struct CookedMeshData
+{
+    uint32_t vertex_stride = 0;
+    std::vector<MeshFormat::VertexAttribute> attributes;
+
+    std::span<const std::byte> vertices;
+    std::span<const uint32_t> indices;
+
+    std::array<float, 3> bounds_min {};
+    std::array<float, 3> bounds_max {};
+
+    std::vector<MeshFormat::Lod> lods;
+};
+
+/**
+ * A read-only view of a .pblmesh file.
+ *
+ * The file is memory mapped, or viewed in place in an archive, so the vertex and index blobs can
+ * be copied straight to staging memory without parsing or an intermediate copy. The views are
+ * valid while the CookedMesh lives.
+ */
+class CookedMesh
+{
+public:
+    CookedMesh(const std::string& path);
+    CookedMesh(std::span<const std::byte> data, const std::string& name);
+
+    uint32_t get_vertex_stride() const { return m_header.vertex_stride; }
+    uint32_t get_vertex_count() const { return m_header.vertex_count; }
+    uint32_t get_index_count() const { return m_header.index_count; }
+    uint32_t get_index_size() const { return m_header.index_size; }
+
+    std::span<const MeshFormat::VertexAttribute> get_attributes() const { return { m_header.attributes, m_header.attribute_count }; }
+
+    bool has_layout(uint32_t stride, std::span<const MeshFormat::VertexAttribute> attributes) const;
+
+    std::span<const std::byte> get_vertex_data() const { return m_data.subspan(m_header.vertex_offset, (size_t)m_header.vertex_count * m_header.vertex_stride); }
+    std::span<const std::byte> get_index_data() const { return m_data.subspan(m_header.index_offset, (size_t)m_header.index_count * m_header.index_size); }
+
+    std::span<const MeshFormat::Lod> get_lods() const;
+
+    std::array<float, 3> get_bounds_min() const { return { m_header.bounds_min[0], m_header.bounds_min[1], m_header.bounds_min[2] }; }
+    std::array<float, 3> get_bounds_max() const { return { m_header.bounds_max[0], m_header.bounds_max[1], m_header.bounds_max[2] }; }
+
+    static void write(const std::string& path, const CookedMeshData& data);
+
+private:
+    void read_header();
+    void validate() const;
+
+    /**
+     * The mapped file, unless viewing data owned elsewhere (e.g. an AssetArchive).
+     */
+    Util::MappedFile m_file;
+    std::span<const std::byte> m_data;
+    std::string m_name;
+
+    MeshFormat::Header m_header;
+};
+
+
+}
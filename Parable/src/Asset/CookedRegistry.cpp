@@ -0,0 +1,180 @@
+#include "CookedRegistry.h"
+
+#include "pblpch.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+#include "Exception/IOExceptions.h"
+
+#include "Util/Hash.h"
+
+namespace Parable
+{
+
+
+/**
+ * Map a .pblreg registry and validate its header.
+ *
+ * @param path the registry to read
+ *
+ * @throws Parable::FileOpenException if the file cannot be opened
+ * @throws Parable::FileFormatException if the file is not a valid .pblreg
+ */
+CookedRegistry::CookedRegistry(const std::string& path) : m_file(path, Util::AccessHint::Random)
+{
+    if (m_file.size() < sizeof(RegistryFormat::Header))
+    {
+        PBL_CORE_ERROR("{} is too small to be an asset registry.", path);
+        throw FileFormatException("File is too small to be an asset registry.");
+    }
+
+    std::memcpy(&m_header, m_file.data().data(), sizeof(m_header));
+
+    validate();
+
+    // the mapping is page aligned and the table TABLE_ALIGNMENT aligned, so it is viewed in place
+    m_table = { reinterpret_cast<const RegistryFormat::Record*>(m_file.data().data() + m_header.table_offset), m_header.slot_count };
+    m_strings = m_file.chars().substr(m_header.strings_offset, m_header.strings_size);
+}
+
+/**
+ * @throws Parable::FileFormatException if the header is invalid
+ */
+void CookedRegistry::validate() const
+{
+    auto fail = [this](const char* reason)
+    {
+        PBL_CORE_ERROR("Asset registry {} is invalid: {}", m_file.get_path(), reason);
+        throw FileFormatException("Invalid asset registry.");
+    };
+
+    if (std::memcmp(m_header.magic, RegistryFormat::MAGIC, sizeof(RegistryFormat::MAGIC)) != 0) fail("bad magic");
+    if (m_header.version != RegistryFormat::VERSION) fail("unsupported version");
+    if (!std::has_single_bit(m_header.slot_count) || m_header.entry_count >= m_header.slot_count) fail("bad table size");
+
+    uint64_t table_size = (uint64_t)m_header.slot_count * sizeof(RegistryFormat::Record);
+    if (m_header.table_offset % RegistryFormat::TABLE_ALIGNMENT != 0 || m_header.table_offset > m_file.size() || table_size > m_file.size() - m_header.table_offset) fail("table out of range");
+    if (m_header.strings_offset > m_file.size() || m_header.strings_size > m_file.size() - m_header.strings_offset) fail("string table out of range");
+}
+
+/**
+ * Find the record of an asset.
+ *
+ * @return the record, or nullptr if the asset is not in the registry
+ */
+const RegistryFormat::Record* CookedRegistry::find(AssetDescriptor descriptor) const
+{
+    size_t mask = m_table.size() - 1;
+
+    // the table always has an empty slot, but the probe is bounded anyway so a damaged file can not hang it
+    size_t slot = Util::mix(descriptor) & mask;
+    for (size_t probe = 0; probe < m_table.size(); ++probe, slot = (slot + 1) & mask)
+    {
+        const RegistryFormat::Record& record = m_table[slot];
+        if (record.type == AssetType::None) return nullptr;
+        if (record.descriptor == descriptor) return &record;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @throws Parable::FileFormatException if the string is outside the string table
+ */
+std::string_view CookedRegistry::get_string(RegistryFormat::StringRef string) const
+{
+    if (string.offset > m_strings.size() || string.size > m_strings.size() - string.offset)
+    {
+        PBL_CORE_ERROR("Asset registry {} has a string out of range.", m_file.get_path());
+        throw FileFormatException("Invalid asset registry.");
+    }
+
+    return m_strings.substr(string.offset, string.size);
+}
+
+RegistryFormat::StringRef CookedRegistryWriter::add_string(std::string_view string)
+{
+    PBL_CORE_ASSERT_MSG(m_strings.size() + string.size() <= UINT32_MAX, "Asset registry string table is over 4GB!")
+
+    RegistryFormat::StringRef ref { (uint32_t)m_strings.size(), (uint32_t)string.size() };
+    m_strings.append(string);
+    return ref;
+}
+
+/**
+ * Add the record of an asset. Descriptors must be unique.
+ */
+void CookedRegistryWriter::add(AssetDescriptor descriptor, AssetType type, std::string_view name, std::string_view source_path, std::string_view cooked_path, std::string_view definition)
+{
+    PBL_CORE_ASSERT_MSG(type != AssetType::None, "Asset {} added to a registry without a type!", descriptor)
+
+    m_records.push_back({
+        .descriptor = descriptor,
+        .type = type,
+        .name = add_string(name),
+        .source_path = add_string(source_path),
+        .cooked_path = add_string(cooked_path),
+        .definition = add_string(definition)
+    });
+}
+
+/**
+ * Write the registry.
+ *
+ * @param path the file to write, replaced if it exists
+ *
+ * @throws Parable::FileOpenException if the file cannot be opened
+ */
+void CookedRegistryWriter::write(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        PBL_CORE_ERROR("Failed to open {} to write an asset registry.", path);
+        throw FileOpenException("Failed to open asset registry for writing.");
+    }
+
+    // at most half full, so probe sequences stay short, and never full, so every probe ends
+    uint32_t slot_count = std::bit_ceil((uint32_t)std::max<size_t>(m_records.size() * 2, 2));
+    std::vector<RegistryFormat::Record> table(slot_count);
+
+    for (const RegistryFormat::Record& record : m_records)
+    {
+        size_t slot = Util::mix(record.descriptor) & (slot_count - 1);
+        while (table[slot].type != AssetType::None)
+        {
+            PBL_CORE_ASSERT_MSG(table[slot].descriptor != record.descriptor, "Asset {} added to a registry twice!", record.descriptor)
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        table[slot] = record;
+    }
+
+    constexpr size_t table_offset = (sizeof(RegistryFormat::Header) + RegistryFormat::TABLE_ALIGNMENT - 1) / RegistryFormat::TABLE_ALIGNMENT * RegistryFormat::TABLE_ALIGNMENT;
+
+    RegistryFormat::Header header {
+        .version = RegistryFormat::VERSION,
+        .entry_count = (uint32_t)m_records.size(),
+        .slot_count = slot_count,
+        .table_offset = table_offset,
+        .strings_offset = table_offset + (uint64_t)slot_count * sizeof(RegistryFormat::Record),
+        .strings_size = m_strings.size()
+    };
+    std::memcpy(header.magic, RegistryFormat::MAGIC, sizeof(header.magic));
+
+    static constexpr char zeros[RegistryFormat::TABLE_ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(zeros, (std::streamsize)(table_offset - sizeof(header)));
+    file.write(reinterpret_cast<const char*>(table.data()), (std::streamsize)(table.size() * sizeof(RegistryFormat::Record)));
+    file.write(m_strings.data(), (std::streamsize)m_strings.size());
+
+    if (!file)
+    {
+        PBL_CORE_ERROR("Failed to write asset registry {}.", path);
+        throw FileOpenException("Failed to write asset registry.");
+    }
+}
+
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include "Core/Base.h"
+
+#include "Util/MappedFile.h"
+
+#include "AssetDescriptor.h"
+#include "AssetLoadInfo.h"
+
+namespace Parable
+{
+
+
+/**
+ * The .pblreg cooked asset registry format.
+ *
+ * A header, then a table of fixed size Record slots, then a string table. The table is an open
+ * addressed hash table keyed by descriptor, so a registry is used straight from its mapping: opening
+ * one reads only the header, and a lookup probes a few slots rather than the file being parsed
+ * into a map. Records refer to their strings by offset into the string table.
+ *
+ * Values are written in host byte order.
+ */
+namespace RegistryFormat
+{
+    constexpr char MAGIC[4] = { 'P', 'R', 'E', 'G' };
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t TABLE_ALIGNMENT = 16;
+
+    /**
+     * A string in the string table, which is not null terminated.
+     */
+    struct StringRef
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+
+        uint32_t entry_count;
+        /**
+         * Number of slots in the table, a power of two.
+         */
+        uint32_t slot_count;
+        uint64_t table_offset;
+
+        uint64_t strings_offset;
+        uint64_t strings_size;
+    };
+
+    /**
+     * A slot in the table, the load info of one asset.
+     *
+     * A type of AssetType::None marks an empty slot.
+     */
+    struct Record
+    {
+        AssetDescriptor descriptor;
+        AssetType type;
+        uint32_t reserved = 0;
+
+        /**
+         * The name the descriptor was hashed from, empty if the asset is unnamed.
+         */
+        StringRef name;
+        /**
+         * The source file, and the file it was cooked to, either of which may be empty.
+         */
+        StringRef source_path;
+        StringRef cooked_path;
+        /**
+         * The json registry entry of assets defined entirely by it, e.g. effects and materials.
+         */
+        StringRef definition;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+    static_assert(std::is_trivially_copyable_v<Record>);
+    static_assert(sizeof(Record) == 48);
+}
+
+/**
+ * A read-only view of a .pblreg registry.
+ *
+ * Only the header is validated when opened, so opening is constant time whatever the size of the
+ * registry. Strings are bounds checked as they are read instead. Views are valid while the
+ * CookedRegistry lives.
+ */
+class CookedRegistry
+{
+public:
+    CookedRegistry(const std::string& path);
+
+    const RegistryFormat::Record* find(AssetDescriptor descriptor) const;
+
+    std::string_view get_string(RegistryFormat::StringRef string) const;
+
+    /**
+     * The slot of a record found in this registry, for side tables indexed by slot.
+     */
+    size_t get_slot(const RegistryFormat::Record& record) const { return &record - m_table.data(); }
+    uint32_t get_slot_count() const { return m_header.slot_count; }
+
+    uint32_t get_entry_count() const { return m_header.entry_count; }
+    const std::string& get_path() const { return m_file.get_path(); }
+
+private:
+    void validate() const;
+
+    Util::MappedFile m_file;
+    RegistryFormat::Header m_header;
+    std::span<const RegistryFormat::Record> m_table;
+    std::string_view m_strings;
+};
+
+/**
+ * Builds a .pblreg registry.
+ */
+class CookedRegistryWriter
+{
+public:
+    void add(AssetDescriptor descriptor, AssetType type, std::string_view name, std::string_view source_path, std::string_view cooked_path, std::string_view definition = {});
+
+    void write(const std::string& path) const;
+
+private:
+    RegistryFormat::StringRef add_string(std::string_view string);
+
+    std::vector<RegistryFormat::Record> m_records;
+    std::string m_strings;
+};
+
+
+}
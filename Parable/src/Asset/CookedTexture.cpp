@@ -0,0 +1,177 @@
+#include "CookedTexture.h"
+
+#include "pblpch.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+#include "Exception/IOExceptions.h"
+
+namespace Parable
+{
+
+
+/**
+ * The size in bytes of one mip level of a texture, 0 for an unknown format.
+ *
+ * Block compressed levels are padded up to whole blocks.
+ */
+size_t TextureFormat::get_level_size(PixelFormat format, uint32_t width, uint32_t height)
+{
+    size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+
+    switch (format)
+    {
+        case PixelFormat::RGBA8Srgb: return (size_t)width * height * 4;
+        case PixelFormat::BC1RgbSrgb: return blocks * 8;
+        case PixelFormat::BC3Srgb:
+        case PixelFormat::BC5Unorm:
+        case PixelFormat::BC7Srgb: return blocks * 16;
+    }
+    return 0;
+}
+
+bool TextureFormat::is_block_compressed(PixelFormat format)
+{
+    return format != PixelFormat::RGBA8Srgb;
+}
+
+/**
+ * Whether a format holds sRGB encoded colour, which must be filtered in linear space.
+ */
+bool TextureFormat::is_srgb(PixelFormat format)
+{
+    return format != PixelFormat::BC5Unorm;
+}
+
+/**
+ * The number of levels in a full mip chain down to 1x1, capped at MAX_MIPS.
+ */
+uint32_t TextureFormat::get_full_mip_count(uint32_t width, uint32_t height)
+{
+    return std::min<uint32_t>(std::bit_width(std::max({ width, height, 1u })), MAX_MIPS);
+}
+
+/**
+ * Map a .pbltex file and validate its header.
+ *
+ * @param path the file to read
+ *
+ * @throws Parable::FileOpenException if the file cannot be opened
+ * @throws Parable::FileFormatException if the file is not a valid .pbltex
+ */
+CookedTexture::CookedTexture(const std::string& path) : m_file(path, Util::AccessHint::Sequential), m_data(m_file.data()), m_name(path)
+{
+    read_header();
+}
+
+/**
+ * View .pbltex data held in memory, which must outlive the CookedTexture.
+ *
+ * @param data the data, aligned to at least TextureFormat::BLOB_ALIGNMENT
+ * @param name a name for the data in error messages
+ *
+ * @throws Parable::FileFormatException if the data is not a valid .pbltex
+ */
+CookedTexture::CookedTexture(std::span<const std::byte> data, const std::string& name) : m_data(data), m_name(name)
+{
+    read_header();
+}
+
+void CookedTexture::read_header()
+{
+    if (m_data.size() < sizeof(TextureFormat::Header))
+    {
+        PBL_CORE_ERROR("{} is too small to be a cooked texture.", m_name);
+        throw FileFormatException("File is too small to be a cooked texture.");
+    }
+
+    std::memcpy(&m_header, m_data.data(), sizeof(m_header));
+
+    validate();
+}
+
+/**
+ * Check the header describes mip levels which lie within the file.
+ *
+ * @throws Parable::FileFormatException if it does not
+ */
+void CookedTexture::validate() const
+{
+    auto fail = [this](const char* reason)
+    {
+        PBL_CORE_ERROR("Cooked texture {} is invalid: {}", m_name, reason);
+        throw FileFormatException("Invalid cooked texture.");
+    };
+
+    if (std::memcmp(m_header.magic, TextureFormat::MAGIC, sizeof(TextureFormat::MAGIC)) != 0) fail("bad magic");
+    if (m_header.version != TextureFormat::VERSION) fail("unsupported version");
+    if (TextureFormat::get_level_size(m_header.format, 1, 1) == 0) fail("unknown pixel format");
+    if (m_header.mip_count == 0 || m_header.mip_count > TextureFormat::MAX_MIPS) fail("bad mip count");
+
+    for (uint32_t mip = 0; mip < m_header.mip_count; ++mip)
+    {
+        const TextureFormat::MipLevel& level = m_header.mips[mip];
+
+        if (level.width != std::max(m_header.width >> mip, 1u) || level.height != std::max(m_header.height >> mip, 1u)) fail("mip level has the wrong dimensions");
+        if (level.size != TextureFormat::get_level_size(m_header.format, level.width, level.height)) fail("mip level has the wrong size");
+        if (level.offset % TextureFormat::BLOB_ALIGNMENT != 0 || level.offset > m_data.size() || level.size > m_data.size() - level.offset) fail("mip level out of range");
+    }
+}
+
+/**
+ * Write a .pbltex file.
+ *
+ * @param path the file to write, replaced if it exists
+ * @param data the texture to write
+ *
+ * @throws Parable::FileOpenException if the file cannot be written
+ */
+void CookedTexture::write(const std::string& path, const CookedTextureData& data)
+{
+    PBL_CORE_ASSERT_MSG(!data.mips.empty() && data.mips.size() <= TextureFormat::MAX_MIPS, "Bad number of mip levels for a cooked texture!")
+
+    auto align = [](uint64_t offset) { return (offset + TextureFormat::BLOB_ALIGNMENT - 1) & ~(uint64_t)(TextureFormat::BLOB_ALIGNMENT - 1); };
+
+    TextureFormat::Header header {};
+    std::memcpy(header.magic, TextureFormat::MAGIC, sizeof(TextureFormat::MAGIC));
+    header.version = TextureFormat::VERSION;
+    header.width = data.width;
+    header.height = data.height;
+    header.format = data.format;
+    header.mip_count = (uint32_t)data.mips.size();
+
+    uint64_t offset = align(sizeof(header));
+    for (uint32_t mip = 0; mip < header.mip_count; ++mip)
+    {
+        TextureFormat::MipLevel& level = header.mips[mip];
+        level.width = std::max(data.width >> mip, 1u);
+        level.height = std::max(data.height >> mip, 1u);
+        level.offset = offset;
+        level.size = data.mips[mip].size();
+
+        PBL_CORE_ASSERT_MSG(level.size == TextureFormat::get_level_size(data.format, level.width, level.height), "Mip level {} is the wrong size!", mip)
+
+        offset = align(offset + level.size);
+    }
+
+    // assemble the file in memory and write it in one call
+    std::vector<std::byte> bytes(header.mips[header.mip_count - 1].offset + header.mips[header.mip_count - 1].size);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (uint32_t mip = 0; mip < header.mip_count; ++mip)
+    {
+        std::memcpy(bytes.data() + header.mips[mip].offset, data.mips[mip].data(), header.mips[mip].size);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        PBL_CORE_ERROR("Failed to open {} to write a cooked texture.", path);
+        throw FileOpenException("Failed to open cooked texture for writing.");
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+}
+
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <span>
+
+#include "Core/Base.h"
+
+#include "Util/MappedFile.h"
+
+namespace Parable
+{
+
+
+/**
+ * The .pbltex cooked texture format.
+ *
+ * A fixed size header holding a table of mip levels, then the pixel data of each level, finest
+ * first and each aligned to BLOB_ALIGNMENT from the start of the file. Levels are stored in the
+ * layout the GPU samples them in, either plain texels or BCn blocks of 4x4 texels in row major
+ * order, so the whole chain can be copied straight into a staging buffer.
+ *
+ * Values are written in host byte order.
+ */
+namespace TextureFormat
+{
+    constexpr char MAGIC[4] = { 'P', 'T', 'E', 'X' };
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t BLOB_ALIGNMENT = 16;
+    constexpr size_t MAX_MIPS = 16;
+
+    enum class PixelFormat : uint32_t
+    {
+        RGBA8Srgb = 0,
+        /**
+         * Opaque colour, 8 bytes per block.
+         */
+        BC1RgbSrgb = 1,
+        /**
+         * Colour with smooth alpha, 16 bytes per block.
+         */
+        BC3Srgb = 2,
+        /**
+         * Two linear channels, for tangent space normal maps, 16 bytes per block.
+         */
+        BC5Unorm = 3,
+        /**
+         * High quality colour and alpha, 16 bytes per block.
+         */
+        BC7Srgb = 4
+    };
+
+    size_t get_level_size(PixelFormat format, uint32_t width, uint32_t height);
+    bool is_block_compressed(PixelFormat format);
+    bool is_srgb(PixelFormat format);
+    uint32_t get_full_mip_count(uint32_t width, uint32_t height);
+
+    struct MipLevel
+    {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+
+        uint32_t width;
+        uint32_t height;
+        PixelFormat format;
+        uint32_t mip_count;
+
+        MipLevel mips[MAX_MIPS];
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header>);
+}
+
+/**
+ * Source data to write a cooked texture from.
+ */
+struct CookedTextureData
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    TextureFormat::PixelFormat format = TextureFormat::PixelFormat::RGBA8Srgb;
+
+    /**
+     * The data of each mip level in format, finest first. Each level halves the size of the last.
+     */
+    std::vector<std::span<const std::byte>> mips;
+};
+
+/**
+ * A read-only view of a .pbltex file.
+ *
+ * The file is memory mapped, or viewed in place in an archive, so mip levels can be copied
+ * straight to staging memory without decoding. The views are valid while the CookedTexture lives.
+ */
+class CookedTexture
+{
+public:
+    CookedTexture(const std::string& path);
+    CookedTexture(std::span<const std::byte> data, const std::string& name);
+
+    uint32_t get_width() const { return m_header.width; }
+    uint32_t get_height() const { return m_header.height; }
+    TextureFormat::PixelFormat get_format() const { return m_header.format; }
+    uint32_t get_mip_count() const { return m_header.mip_count; }
+
+    const TextureFormat::MipLevel& get_mip_level(uint32_t mip) const { return m_header.mips[mip]; }
+    std::span<const std::byte> get_mip_data(uint32_t mip) const { return m_data.subspan(m_header.mips[mip].offset, m_header.mips[mip].size); }
+
+    static void write(const std::string& path, const CookedTextureData& data);
+
+private:
+    void read_header();
+    void validate() const;
+
+    /**
+     * The mapped file, unless viewing data owned elsewhere (e.g. an AssetArchive).
+     */
+    Util::MappedFile m_file;
+    std::span<const std::byte> m_data;
+    std::string m_name;
+
+    TextureFormat::Header m_header;
+};
+
+
+}
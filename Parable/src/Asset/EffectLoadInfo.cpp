@@ -53,19 +53,19 @@ EffectLoadInfo::EffectPassInfo::EffectPassInfo(const rapidjson::Value& source)
 
             // ShaderStageInfo.shader - descriptor 
             auto shader = json_shader_stage.FindMember("shader");
-            if (shader == json_shader_stage.MemberEnd() || !shader->value.IsUint64())
+            if (shader == json_shader_stage.MemberEnd() || !AssetLoadInfoFactory::is_reference(shader->value))
             {
-                throw std::exception("ShaderStageInfo missing uint64 shader member.");
+                throw std::exception("ShaderStageInfo missing shader reference member.");
             }
 
             // ShaderStageInfo.stage - ShaderStage enum
             auto stage = json_shader_stage.FindMember("stage");
-            if (shader == json_shader_stage.MemberEnd() || !shader->value.IsString())
+            if (stage == json_shader_stage.MemberEnd() || !stage->value.IsString())
             {
                 throw std::exception("ShaderStageInfo missing string stage member.");
             }
 
-            m_shader_stages.emplace_back(shader->value.GetUint64(),shader_stage_from_string(shader->value.GetString()));
+            m_shader_stages.emplace_back(AssetLoadInfoFactory::parse_reference(shader->value),shader_stage_from_string(stage->value.GetString()));
         }
     }
 }
@@ -129,7 +129,7 @@ std::vector<EffectLoadInfo::ParameterBufferObjectBinding> extract_parameter_bind
 
         // ParameterBufferObjectBinding.type - str (EffectParameterType enum)
         auto type = json_binding.FindMember("type");
-        if (type == json_binding.MemberEnd() || !type->value.IsUint())
+        if (type == json_binding.MemberEnd() || !type->value.IsString())
         {
             throw std::exception("ParameterBufferObjectBinding missing string member type.");
         }
@@ -15,45 +15,49 @@ StateHandle::StateHandle(ResourceState& state_block) : m_state_block(&state_bloc
 
 StateHandle::~StateHandle()
 {
-    PBL_CORE_ASSERT(m_state_block->get_ref_count() > 0)
     if (m_state_block)
     {
         m_state_block->decrement_ref_count();
     }
 }
 
-StateHandle::StateHandle(const StateHandle& other)
+StateHandle::StateHandle(const StateHandle& other) : m_state_block(other.m_state_block)
 {
-    if (other.m_state_block)
+    if (m_state_block)
     {
-        m_state_block = other.m_state_block;
         m_state_block->increment_ref_count();
     }
 }
 
 StateHandle& StateHandle::operator=(const StateHandle& other)
 {
+    // take the new reference first, so assigning a handle to itself never drops the count to 0
     if (other.m_state_block)
     {
-        m_state_block = other.m_state_block;
-        m_state_block->increment_ref_count();
+        other.m_state_block->increment_ref_count();
     }
+    if (m_state_block)
+    {
+        m_state_block->decrement_ref_count();
+    }
+    m_state_block = other.m_state_block;
     return *this;
 }
 
-StateHandle::StateHandle(StateHandle&& other)
+StateHandle::StateHandle(StateHandle&& other) : m_state_block(other.m_state_block)
 {
-    if (other.m_state_block)
-    {
-        m_state_block = other.m_state_block;
-        other.m_state_block = nullptr;
-    }
+    other.m_state_block = nullptr;
 }
 
 StateHandle& StateHandle::operator=(StateHandle&& other)
 {
-    if (other.m_state_block)
+    if (this != &other)
     {
+        // ref counts drive eviction, so the reference held before must be released
+        if (m_state_block)
+        {
+            m_state_block->decrement_ref_count();
+        }
         m_state_block = other.m_state_block;
         other.m_state_block = nullptr;
     }
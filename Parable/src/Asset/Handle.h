@@ -76,7 +76,7 @@ public:
     Handle(ResourceStorageBlock<ResourceType>& resource_block) 
         : StateHandle(static_cast<ResourceState&>(resource_block))
     {}
-    ~Handle() = default;
+    // no destructor is declared, which would leave moves falling back to copying the reference
 
     /**
      * Dereferences the handle to use the resource.
@@ -29,12 +29,12 @@ MaterialLoadInfo::MaterialParametersInfo::MaterialParametersInfo(const rapidjson
 
     for (rapidjson::SizeType i = 0; i < texture_descriptors.Size(); ++i)
     {
-        if (!texture_descriptors[i].IsUint64())
+        if (!AssetLoadInfoFactory::is_reference(texture_descriptors[i]))
         {
-            throw std::exception("MaterialParametersLoadInfo texture_descriptors contains a non-uint64 entry.");
+            throw std::exception("MaterialParametersLoadInfo texture_descriptors contains an entry which is not an asset reference.");
         }
 
-        m_texture_descriptors.push_back(texture_descriptors[i].GetUint64());
+        m_texture_descriptors.push_back(AssetLoadInfoFactory::parse_reference(texture_descriptors[i]));
     }
 
     if (!json_info.HasMember("float_values") || !json_info["float_values"].IsArray())
@@ -65,12 +65,12 @@ MaterialLoadInfo::MaterialLoadInfo(const rapidjson::Value& source)
 
     auto json_info = source.GetObject();
 
-    if (!json_info.HasMember("effect") || !source["effect"].IsUint64())
+    if (!json_info.HasMember("effect") || !AssetLoadInfoFactory::is_reference(source["effect"]))
     {
-        throw std::exception("MaterialLoadInfo does not contain an effect uint descriptor.");
+        throw std::exception("MaterialLoadInfo does not contain an effect reference.");
     }
 
-    AssetDescriptor effect = json_info["effect"].GetUint64();
+    m_effect_descriptor = AssetLoadInfoFactory::parse_reference(json_info["effect"]);
 
     if (!json_info.HasMember("parameters") || !json_info["parameters"].IsObject())
     {
@@ -0,0 +1,98 @@
+#include "ResourceState.h"
+
+#include "Core/Base.h"
+
+namespace Parable
+{
+
+
+void ResourceState::increment_ref_count()
+{
+    if (m_reference_count++ == 0 && m_in_lru)
+    {
+        m_residency->unlink(*this);
+    }
+}
+
+void ResourceState::decrement_ref_count()
+{
+    PBL_CORE_ASSERT(m_reference_count > 0);
+    if (--m_reference_count == 0 && m_residency && m_load_state == ResourceLoadState::Loaded)
+    {
+        m_residency->link(*this);
+    }
+}
+
+void ResourceState::set_load_state(ResourceLoadState state)
+{
+    if (m_residency && state != m_load_state)
+    {
+        if (state == ResourceLoadState::Loaded) m_residency->on_loaded(*this);
+        else if (m_load_state == ResourceLoadState::Loaded) m_residency->on_unloaded(*this);
+    }
+
+    m_load_state = state;
+}
+
+
+void ResidencyList::on_loaded(ResourceState& state)
+{
+    m_resident_size += state.m_resident_size;
+    if (state.m_reference_count == 0) link(state);
+}
+
+void ResidencyList::on_unloaded(ResourceState& state)
+{
+    PBL_CORE_ASSERT(m_resident_size >= state.m_resident_size);
+    m_resident_size -= state.m_resident_size;
+    if (state.m_in_lru) unlink(state);
+}
+
+/**
+ * Add a resource to the back of the eviction order, as the most recently released.
+ */
+void ResidencyList::link(ResourceState& state)
+{
+    PBL_CORE_ASSERT(!state.m_in_lru);
+
+    state.m_lru_prev = m_lru_tail;
+    state.m_lru_next = nullptr;
+    if (m_lru_tail) m_lru_tail->m_lru_next = &state;
+    else m_lru_head = &state;
+    m_lru_tail = &state;
+
+    state.m_in_lru = true;
+}
+
+void ResidencyList::unlink(ResourceState& state)
+{
+    PBL_CORE_ASSERT(state.m_in_lru);
+
+    if (state.m_lru_prev) state.m_lru_prev->m_lru_next = state.m_lru_next;
+    else m_lru_head = state.m_lru_next;
+    if (state.m_lru_next) state.m_lru_next->m_lru_prev = state.m_lru_prev;
+    else m_lru_tail = state.m_lru_prev;
+
+    state.m_lru_prev = nullptr;
+    state.m_lru_next = nullptr;
+    state.m_in_lru = false;
+}
+
+ResourceState* ResidencyList::pop_eviction_candidate()
+{
+    if (m_resident_size <= m_budget) return nullptr;
+
+    return pop_least_recent();
+}
+
+ResourceState* ResidencyList::pop_least_recent()
+{
+    if (!m_lru_head) return nullptr;
+
+    ResourceState* state = m_lru_head;
+    unlink(*state);
+    return state;
+}
+
+
+}
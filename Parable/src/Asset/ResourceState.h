@@ -13,6 +13,8 @@ enum class ResourceLoadState
     Loaded
 };
 
+class ResidencyList;
+
 /**
  * Represents the state of a single Resource.
  */
@@ -26,6 +28,21 @@ private:
 
     ResourceLoadState m_load_state = ResourceLoadState::Unloaded;
 
+    /**
+     * The list tracking this resource's memory, if it can be evicted.
+     */
+    ResidencyList* m_residency = nullptr;
+    /**
+     * The memory held by the resource while loaded.
+     */
+    size_t m_resident_size = 0;
+
+    friend class ResidencyList;
+    // links in the residency list's eviction order, while loaded and unreferenced
+    ResourceState* m_lru_prev = nullptr;
+    ResourceState* m_lru_next = nullptr;
+    bool m_in_lru = false;
+
 public:
     ~ResourceState()
     {
@@ -33,19 +50,69 @@ public:
         PBL_CORE_ASSERT(m_reference_count == 0);
     }
 
-    void increment_ref_count()
-    {
-        m_reference_count++;
-    }
-    void decrement_ref_count()
-    {
-        PBL_CORE_ASSERT(m_reference_count > 0);
-        m_reference_count--;
-    }
+    void increment_ref_count();
+    void decrement_ref_count();
     int get_ref_count() const { return m_reference_count; }
 
     ResourceLoadState get_load_state() const { return m_load_state; }
-    void set_load_state(ResourceLoadState state) { m_load_state = state; }
+    void set_load_state(ResourceLoadState state);
+
+    /**
+     * Make the resource evictable, with its memory tracked by a residency list.
+     */
+    void set_residency(ResidencyList* residency) { m_residency = residency; }
+    /**
+     * Set the memory the resource holds, before it is set Loaded.
+     */
+    void set_resident_size(size_t size) { m_resident_size = size; }
+    size_t get_resident_size() const { return m_resident_size; }
+};
+
+/**
+ * Tracks the memory held by a set of loaded resources, and orders those with no handles for eviction.
+ * 
+ * A resource joins the eviction order when its last handle is released while loaded, or when it
+ * finishes loading with no handles, and leaves it when a handle is taken again. The least recently
+ * released resource is evicted first, whenever the total is over budget.
+ */
+class ResidencyList
+{
+private:
+    size_t m_budget;
+    size_t m_resident_size = 0;
+
+    ResourceState* m_lru_head = nullptr;
+    ResourceState* m_lru_tail = nullptr;
+
+    friend class ResourceState;
+    void on_loaded(ResourceState& state);
+    void on_unloaded(ResourceState& state);
+    void link(ResourceState& state);
+    void unlink(ResourceState& state);
+
+public:
+    ResidencyList(size_t budget) : m_budget(budget) {}
+
+    /**
+     * Take the least recently released resource out of the eviction order, if over budget.
+     * 
+     * The caller evicts it by setting it Unloaded, which releases its memory from the total.
+     * 
+     * @return The resource to evict, or nullptr if within budget or nothing can be evicted.
+     */
+    ResourceState* pop_eviction_candidate();
+    /**
+     * Take the least recently released resource out of the eviction order, whatever the total.
+     * 
+     * For when memory runs out before the budget does, e.g. a fragmented buffer.
+     * 
+     * @return The resource to evict, or nullptr if nothing can be evicted.
+     */
+    ResourceState* pop_least_recent();
+
+    size_t get_budget() const { return m_budget; }
+    void set_budget(size_t budget) { m_budget = budget; }
+    size_t get_resident_size() const { return m_resident_size; }
 };
 
 /**
@@ -65,6 +132,7 @@ public:
 
     ResourceType& get_resource() { PBL_CORE_ASSERT(m_resource); return *m_resource; }
     void set_resource(std::unique_ptr<ResourceType> resource) { m_resource = std::move(resource); }
+    std::unique_ptr<ResourceType> take_resource() { return std::move(m_resource); }
 };
 
 
@@ -0,0 +1,697 @@
+#include "TextureEncoder.h"
+
+#include "pblpch.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "Core/Base.h"
+
+namespace Parable
+{
+
+
+/**
+ * The 16 texels of a 4x4 block as RGBA in [0, 255], as floats for fitting endpoints.
+ */
+using Texels = std::array<std::array<float, 4>, 16>;
+using Colour = std::array<float, 4>;
+
+/**
+ * BC7 interpolation weights out of 64 for 4 bit indices.
+ */
+constexpr int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static const std::array<float, 256>& get_srgb_to_linear_table()
+{
+    static const std::array<float, 256> table = []()
+    {
+        std::array<float, 256> values;
+        for (int i = 0; i < 256; ++i)
+        {
+            float c = i / 255.0f;
+            values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+static uint8_t linear_to_srgb(float c)
+{
+    c = std::clamp(c, 0.0f, 1.0f);
+    float encoded = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    return (uint8_t)std::lround(encoded * 255.0f);
+}
+
+/**
+ * Halve an image with a box filter, for the next level of a mip chain.
+ *
+ * sRGB colour is averaged in linear space, so the chain does not darken as it shrinks; alpha is
+ * always linear. A dimension of 1 stays 1, and the last row or column of an odd dimension is
+ * folded into its neighbour.
+ *
+ * @param rgba tightly packed RGBA8 texels
+ * @param srgb whether the colour channels are sRGB encoded
+ * @return the texels of the level, max(width / 2, 1) by max(height / 2, 1)
+ */
+std::vector<std::byte> TextureEncoder::downsample(std::span<const std::byte> rgba, uint32_t width, uint32_t height, bool srgb)
+{
+    PBL_CORE_ASSERT_MSG(rgba.size() == (size_t)width * height * 4, "Texture data is the wrong size for its dimensions!")
+
+    const std::array<float, 256>& to_linear = get_srgb_to_linear_table();
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(rgba.data());
+
+    uint32_t out_width = std::max(width >> 1, 1u);
+    uint32_t out_height = std::max(height >> 1, 1u);
+    std::vector<std::byte> out((size_t)out_width * out_height * 4);
+
+    for (uint32_t y = 0; y < out_height; ++y)
+    {
+        uint32_t y0 = std::min(y * 2, height - 1);
+        uint32_t y1 = std::min(y * 2 + 1, height - 1);
+
+        for (uint32_t x = 0; x < out_width; ++x)
+        {
+            uint32_t x0 = std::min(x * 2, width - 1);
+            uint32_t x1 = std::min(x * 2 + 1, width - 1);
+
+            const uint8_t* texels[4] = {
+                src + ((size_t)y0 * width + x0) * 4,
+                src + ((size_t)y0 * width + x1) * 4,
+                src + ((size_t)y1 * width + x0) * 4,
+                src + ((size_t)y1 * width + x1) * 4
+            };
+
+            std::byte* dst = out.data() + ((size_t)y * out_width + x) * 4;
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                bool linearise = srgb && channel < 3;
+
+                float sum = 0.0f;
+                for (const uint8_t* texel : texels) sum += linearise ? to_linear[texel[channel]] : texel[channel] / 255.0f;
+
+                dst[channel] = (std::byte)(linearise ? linear_to_srgb(sum * 0.25f) : (uint8_t)std::lround(sum * 0.25f * 255.0f));
+            }
+        }
+    }
+
+    return out;
+}
+
+/**
+ * Read a 4x4 block, repeating the last row and column where it hangs off the image.
+ */
+static Texels load_block(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t block_x, uint32_t block_y)
+{
+    Texels texels;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        uint32_t x = std::min(block_x * 4 + i % 4, width - 1);
+        uint32_t y = std::min(block_y * 4 + i / 4, height - 1);
+
+        const uint8_t* texel = rgba + ((size_t)y * width + x) * 4;
+        for (int channel = 0; channel < 4; ++channel) texels[i][channel] = texel[channel];
+    }
+    return texels;
+}
+
+static Colour clamp_colour(const Colour& c)
+{
+    return { std::clamp(c[0], 0.0f, 255.0f), std::clamp(c[1], 0.0f, 255.0f), std::clamp(c[2], 0.0f, 255.0f), std::clamp(c[3], 0.0f, 255.0f) };
+}
+
+/**
+ * Fit endpoints to the first N channels of a block, at the extremes of the texels along the
+ * principal axis of their distribution.
+ */
+template<int N>
+static void fit_principal_axis(const Texels& texels, Colour& e0, Colour& e1)
+{
+    Colour mean {};
+    for (const Colour& texel : texels)
+    {
+        for (int i = 0; i < N; ++i) mean[i] += texel[i] / 16.0f;
+    }
+
+    float covariance[N][N] = {};
+    Colour lo { 255, 255, 255, 255 };
+    Colour hi {};
+    for (const Colour& texel : texels)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            for (int j = 0; j < N; ++j) covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+            lo[i] = std::min(lo[i], texel[i]);
+            hi[i] = std::max(hi[i], texel[i]);
+        }
+    }
+
+    // power iteration, starting from the extent of the block which is usually close already
+    Colour axis {};
+    for (int i = 0; i < N; ++i) axis[i] = hi[i] - lo[i];
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        Colour next {};
+        float length = 0.0f;
+        for (int i = 0; i < N; ++i)
+        {
+            for (int j = 0; j < N; ++j) next[i] += covariance[i][j] * axis[j];
+            length += next[i] * next[i];
+        }
+
+        if (length < 1e-8f) break;
+
+        length = std::sqrt(length);
+        for (int i = 0; i < N; ++i) axis[i] = next[i] / length;
+    }
+
+    float length = 0.0f;
+    for (int i = 0; i < N; ++i) length += axis[i] * axis[i];
+    if (length < 1e-8f)
+    {
+        // a flat block
+        e0 = e1 = mean;
+        return;
+    }
+    length = std::sqrt(length);
+    for (int i = 0; i < N; ++i) axis[i] /= length;
+
+    float min_t = 0.0f;
+    float max_t = 0.0f;
+    for (const Colour& texel : texels)
+    {
+        float t = 0.0f;
+        for (int i = 0; i < N; ++i) t += (texel[i] - mean[i]) * axis[i];
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+
+    e0 = mean;
+    e1 = mean;
+    for (int i = 0; i < N; ++i)
+    {
+        e0[i] += axis[i] * max_t;
+        e1[i] += axis[i] * min_t;
+    }
+    e0 = clamp_colour(e0);
+    e1 = clamp_colour(e1);
+}
+
+/**
+ * Solve for the endpoints which best reproduce a block given each texel's interpolation weight.
+ *
+ * @param weights the weight of e1 for each texel, with e0 weighted by the rest
+ * @return false if every texel has the same weight, so the endpoints are not determined
+ */
+template<int N>
+static bool fit_least_squares(const Texels& texels, const float (&weights)[16], Colour& e0, Colour& e1)
+{
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    Colour ax {}, bx {};
+    for (int t = 0; t < 16; ++t)
+    {
+        float b = weights[t];
+        float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int i = 0; i < N; ++i)
+        {
+            ax[i] += a * texels[t][i];
+            bx[i] += b * texels[t][i];
+        }
+    }
+
+    float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f) return false;
+
+    for (int i = 0; i < N; ++i)
+    {
+        e0[i] = (bb * ax[i] - ab * bx[i]) / determinant;
+        e1[i] = (aa * bx[i] - ab * ax[i]) / determinant;
+    }
+    e0 = clamp_colour(e0);
+    e1 = clamp_colour(e1);
+    return true;
+}
+
+/**
+ * Pick the nearest palette entry to each texel over the first N channels.
+ *
+ * @return the total squared error
+ */
+template<int N, size_t P>
+static float assign_indices(const Texels& texels, const std::array<Colour, P>& palette, std::array<uint8_t, 16>& indices)
+{
+    float total = 0.0f;
+    for (int t = 0; t < 16; ++t)
+    {
+        float best = std::numeric_limits<float>::max();
+        for (size_t p = 0; p < P; ++p)
+        {
+            float error = 0.0f;
+            for (int i = 0; i < N; ++i) error += (texels[t][i] - palette[p][i]) * (texels[t][i] - palette[p][i]);
+
+            if (error < best)
+            {
+                best = error;
+                indices[t] = (uint8_t)p;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+static uint16_t to_565(const Colour& c)
+{
+    uint16_t r = (uint16_t)std::lround(c[0] * 31.0f / 255.0f);
+    uint16_t g = (uint16_t)std::lround(c[1] * 63.0f / 255.0f);
+    uint16_t b = (uint16_t)std::lround(c[2] * 31.0f / 255.0f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static Colour from_565(uint16_t c)
+{
+    int r = (c >> 11) & 31;
+    int g = (c >> 5) & 63;
+    int b = c & 31;
+    return { (float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2)), 255.0f };
+}
+
+/**
+ * Quantise BC1 endpoints and choose indices, always in the 4 colour mode.
+ *
+ * @return the total squared error
+ */
+static float try_bc1(const Texels& texels, const Colour& e0, const Colour& e1, uint16_t& c0, uint16_t& c1, std::array<uint8_t, 16>& indices)
+{
+    c0 = to_565(e0);
+    c1 = to_565(e1);
+    // the 4 colour mode needs c0 > c1
+    if (c0 < c1) std::swap(c0, c1);
+
+    Colour p0 = from_565(c0);
+    Colour p1 = from_565(c1);
+    std::array<Colour, 4> palette { p0, p1, p0, p1 };
+    for (int i = 0; i < 3; ++i)
+    {
+        palette[2][i] = (2.0f * p0[i] + p1[i]) / 3.0f;
+        palette[3][i] = (p0[i] + 2.0f * p1[i]) / 3.0f;
+    }
+
+    // equal endpoints select the 3 colour mode, where only index 0 is the same colour
+    if (c0 == c1) return assign_indices<3>(texels, std::array<Colour, 1> { p0 }, indices);
+
+    return assign_indices<3>(texels, palette, indices);
+}
+
+static void write_u16(uint8_t* out, uint16_t value)
+{
+    out[0] = (uint8_t)(value & 0xff);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void encode_bc1_block(const Texels& texels, uint8_t* out)
+{
+    Colour e0, e1;
+    fit_principal_axis<3>(texels, e0, e1);
+
+    uint16_t c0, c1;
+    std::array<uint8_t, 16> indices;
+    float error = try_bc1(texels, e0, e1, c0, c1, indices);
+
+    // refit the endpoints to the chosen indices, keeping them if they do better
+    static constexpr float BC1_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    float weights[16];
+    for (int t = 0; t < 16; ++t) weights[t] = BC1_WEIGHTS[indices[t]];
+
+    e0 = from_565(c0);
+    e1 = from_565(c1);
+    if (fit_least_squares<3>(texels, weights, e0, e1))
+    {
+        uint16_t refit_c0, refit_c1;
+        std::array<uint8_t, 16> refit_indices;
+        if (try_bc1(texels, e0, e1, refit_c0, refit_c1, refit_indices) < error)
+        {
+            c0 = refit_c0;
+            c1 = refit_c1;
+            indices = refit_indices;
+        }
+    }
+
+    uint32_t bits = 0;
+    for (int t = 0; t < 16; ++t) bits |= (uint32_t)indices[t] << (2 * t);
+
+    write_u16(out, c0);
+    write_u16(out + 2, c1);
+    write_u16(out + 4, (uint16_t)(bits & 0xffff));
+    write_u16(out + 6, (uint16_t)(bits >> 16));
+}
+
+/**
+ * Encode one channel in the 8 value mode, with the endpoints at the channel's extremes.
+ */
+static void encode_bc4_block(const Texels& texels, int channel, uint8_t* out)
+{
+    float lo = 255.0f;
+    float hi = 0.0f;
+    for (const Colour& texel : texels)
+    {
+        lo = std::min(lo, texel[channel]);
+        hi = std::max(hi, texel[channel]);
+    }
+
+    uint8_t a0 = (uint8_t)std::lround(hi);
+    uint8_t a1 = (uint8_t)std::lround(lo);
+    out[0] = a0;
+    out[1] = a1;
+
+    uint64_t bits = 0;
+    if (a0 != a1)
+    {
+        float palette[8] = { (float)a0, (float)a1 };
+        for (int i = 2; i < 8; ++i) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7.0f;
+
+        for (int t = 0; t < 16; ++t)
+        {
+            int best_index = 0;
+            for (int i = 1; i < 8; ++i)
+            {
+                if (std::abs(texels[t][channel] - palette[i]) < std::abs(texels[t][channel] - palette[best_index])) best_index = i;
+            }
+            bits |= (uint64_t)best_index << (3 * t);
+        }
+    }
+
+    for (int i = 0; i < 6; ++i) out[2 + i] = (uint8_t)(bits >> (8 * i));
+}
+
+/**
+ * Writes fields of a 128 bit BC7 block, least significant bit first.
+ */
+class BitWriter
+{
+public:
+    BitWriter(uint8_t* out) : m_out(out) { std::memset(out, 0, 16); }
+
+    void put(uint32_t value, int bits)
+    {
+        for (int bit = 0; bit < bits; ++bit, ++m_position)
+        {
+            if ((value >> bit) & 1) m_out[m_position / 8] |= (uint8_t)(1 << (m_position % 8));
+        }
+    }
+
+private:
+    uint8_t* m_out;
+    size_t m_position = 0;
+};
+
+/**
+ * A BC7 mode 6 endpoint, 7 bits per channel plus a shared low bit.
+ */
+struct Bc7Endpoint
+{
+    uint8_t channels[4];
+    uint8_t p;
+};
+
+static Bc7Endpoint quantise_bc7(const Colour& c)
+{
+    Bc7Endpoint best {};
+    float best_error = std::numeric_limits<float>::max();
+
+    for (uint8_t p = 0; p < 2; ++p)
+    {
+        Bc7Endpoint endpoint { {}, p };
+        float error = 0.0f;
+        for (int i = 0; i < 4; ++i)
+        {
+            endpoint.channels[i] = (uint8_t)std::clamp<long>(std::lround((c[i] - p) / 2.0f), 0, 127);
+            float value = (float)((endpoint.channels[i] << 1) | p);
+            error += (value - c[i]) * (value - c[i]);
+        }
+
+        if (error < best_error)
+        {
+            best_error = error;
+            best = endpoint;
+        }
+    }
+
+    return best;
+}
+
+static float try_bc7(const Texels& texels, const Colour& e0, const Colour& e1, Bc7Endpoint& q0, Bc7Endpoint& q1, std::array<uint8_t, 16>& indices)
+{
+    q0 = quantise_bc7(e0);
+    q1 = quantise_bc7(e1);
+
+    std::array<Colour, 16> palette;
+    for (int p = 0; p < 16; ++p)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            int v0 = (q0.channels[i] << 1) | q0.p;
+            int v1 = (q1.channels[i] << 1) | q1.p;
+            palette[p][i] = (float)(((64 - BC7_WEIGHTS[p]) * v0 + BC7_WEIGHTS[p] * v1 + 32) >> 6);
+        }
+    }
+
+    return assign_indices<4>(texels, palette, indices);
+}
+
+/**
+ * Encode a block in BC7 mode 6: one subset, RGBA endpoints and 4 bit indices.
+ *
+ * @return the total squared error
+ */
+static float encode_bc7_mode6(const Texels& texels, uint8_t* out)
+{
+    Colour e0, e1;
+    fit_principal_axis<4>(texels, e0, e1);
+
+    Bc7Endpoint q0, q1;
+    std::array<uint8_t, 16> indices;
+    float error = try_bc7(texels, e0, e1, q0, q1, indices);
+
+    float weights[16];
+    for (int t = 0; t < 16; ++t) weights[t] = BC7_WEIGHTS[indices[t]] / 64.0f;
+
+    if (fit_least_squares<4>(texels, weights, e0, e1))
+    {
+        Bc7Endpoint refit_q0, refit_q1;
+        std::array<uint8_t, 16> refit_indices;
+        float refit_error = try_bc7(texels, e0, e1, refit_q0, refit_q1, refit_indices);
+        if (refit_error < error)
+        {
+            error = refit_error;
+            q0 = refit_q0;
+            q1 = refit_q1;
+            indices = refit_indices;
+        }
+    }
+
+    // the first index is stored without its top bit, so must be below 8; the weights are
+    // symmetric, so swapping the endpoints and mirroring every index decodes the same
+    if (indices[0] >= 8)
+    {
+        std::swap(q0, q1);
+        for (uint8_t& index : indices) index = 15 - index;
+    }
+
+    BitWriter writer(out);
+    // the mode is the position of the first set bit
+    writer.put(1 << 6, 7);
+    for (int i = 0; i < 4; ++i)
+    {
+        writer.put(q0.channels[i], 7);
+        writer.put(q1.channels[i], 7);
+    }
+    writer.put(q0.p, 1);
+    writer.put(q1.p, 1);
+    writer.put(indices[0], 3);
+    for (int t = 1; t < 16; ++t) writer.put(indices[t], 4);
+
+    return error;
+}
+
+/**
+ * Encode a block in BC7 mode 5: one subset, with separate RGB and alpha endpoints and 2 bit
+ * indices for each. Better than mode 6 where alpha does not follow the colour.
+ *
+ * @return the total squared error
+ */
+static float encode_bc7_mode5(const Texels& texels, uint8_t* out)
+{
+    constexpr int WEIGHTS[4] = { 0, 21, 43, 64 };
+
+    auto quantise = [](const Colour& c, uint8_t (&q)[3])
+    {
+        for (int i = 0; i < 3; ++i) q[i] = (uint8_t)std::lround(c[i] * 127.0f / 255.0f);
+    };
+    auto expand = [](uint8_t q) { return (q << 1) | (q >> 6); };
+
+    auto try_colour = [&](const Colour& e0, const Colour& e1, uint8_t (&q0)[3], uint8_t (&q1)[3], std::array<uint8_t, 16>& indices)
+    {
+        quantise(e0, q0);
+        quantise(e1, q1);
+
+        std::array<Colour, 4> palette;
+        for (int p = 0; p < 4; ++p)
+        {
+            for (int i = 0; i < 3; ++i) palette[p][i] = (float)(((64 - WEIGHTS[p]) * expand(q0[i]) + WEIGHTS[p] * expand(q1[i]) + 32) >> 6);
+        }
+        return assign_indices<3>(texels, palette, indices);
+    };
+
+    Colour e0, e1;
+    fit_principal_axis<3>(texels, e0, e1);
+
+    uint8_t q0[3], q1[3];
+    std::array<uint8_t, 16> colour_indices;
+    float colour_error = try_colour(e0, e1, q0, q1, colour_indices);
+
+    float weights[16];
+    for (int t = 0; t < 16; ++t) weights[t] = WEIGHTS[colour_indices[t]] / 64.0f;
+
+    if (fit_least_squares<3>(texels, weights, e0, e1))
+    {
+        uint8_t refit_q0[3], refit_q1[3];
+        std::array<uint8_t, 16> refit_indices;
+        float refit_error = try_colour(e0, e1, refit_q0, refit_q1, refit_indices);
+        if (refit_error < colour_error)
+        {
+            colour_error = refit_error;
+            std::copy(refit_q0, refit_q0 + 3, q0);
+            std::copy(refit_q1, refit_q1 + 3, q1);
+            colour_indices = refit_indices;
+        }
+    }
+
+    // alpha endpoints at its extremes, which are stored at full precision
+    uint8_t a0 = 0;
+    uint8_t a1 = 255;
+    for (const Colour& texel : texels)
+    {
+        a0 = std::max(a0, (uint8_t)texel[3]);
+        a1 = std::min(a1, (uint8_t)texel[3]);
+    }
+
+    std::array<uint8_t, 16> alpha_indices;
+    float alpha_error = 0.0f;
+    for (int t = 0; t < 16; ++t)
+    {
+        float best = std::numeric_limits<float>::max();
+        for (int p = 0; p < 4; ++p)
+        {
+            float value = (float)(((64 - WEIGHTS[p]) * a0 + WEIGHTS[p] * a1 + 32) >> 6);
+            float error = (texels[t][3] - value) * (texels[t][3] - value);
+            if (error < best)
+            {
+                best = error;
+                alpha_indices[t] = (uint8_t)p;
+            }
+        }
+        alpha_error += best;
+    }
+
+    // as in mode 6, each first index is stored without its top bit
+    if (colour_indices[0] >= 2)
+    {
+        std::swap(q0, q1);
+        for (uint8_t& index : colour_indices) index = 3 - index;
+    }
+    if (alpha_indices[0] >= 2)
+    {
+        std::swap(a0, a1);
+        for (uint8_t& index : alpha_indices) index = 3 - index;
+    }
+
+    BitWriter writer(out);
+    writer.put(1 << 5, 6);
+    // no channel rotation
+    writer.put(0, 2);
+    for (int i = 0; i < 3; ++i)
+    {
+        writer.put(q0[i], 7);
+        writer.put(q1[i], 7);
+    }
+    writer.put(a0, 8);
+    writer.put(a1, 8);
+    writer.put(colour_indices[0], 1);
+    for (int t = 1; t < 16; ++t) writer.put(colour_indices[t], 2);
+    writer.put(alpha_indices[0], 1);
+    for (int t = 1; t < 16; ++t) writer.put(alpha_indices[t], 2);
+
+    return colour_error + alpha_error;
+}
+
+/**
+ * Encode a block in whichever of BC7 modes 5 and 6 reproduces it best.
+ */
+static void encode_bc7_block(const Texels& texels, uint8_t* out)
+{
+    uint8_t mode5[16];
+    float mode5_error = encode_bc7_mode5(texels, mode5);
+    float mode6_error = encode_bc7_mode6(texels, out);
+
+    if (mode5_error < mode6_error) std::memcpy(out, mode5, sizeof(mode5));
+}
+
+/**
+ * Encode an image in a cooked texture pixel format.
+ *
+ * @param rgba tightly packed RGBA8 texels
+ * @return the level's data, TextureFormat::get_level_size(format, width, height) bytes
+ */
+std::vector<std::byte> TextureEncoder::encode(TextureFormat::PixelFormat format, std::span<const std::byte> rgba, uint32_t width, uint32_t height)
+{
+    PBL_CORE_ASSERT_MSG(rgba.size() == (size_t)width * height * 4, "Texture data is the wrong size for its dimensions!")
+
+    if (!TextureFormat::is_block_compressed(format)) return { rgba.begin(), rgba.end() };
+
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(rgba.data());
+
+    std::vector<std::byte> out(TextureFormat::get_level_size(format, width, height));
+    size_t block_size = TextureFormat::get_level_size(format, 4, 4);
+    uint32_t blocks_x = (width + 3) / 4;
+    uint32_t blocks_y = (height + 3) / 4;
+
+    for (uint32_t block_y = 0; block_y < blocks_y; ++block_y)
+    {
+        for (uint32_t block_x = 0; block_x < blocks_x; ++block_x)
+        {
+            Texels texels = load_block(src, width, height, block_x, block_y);
+            uint8_t* block = reinterpret_cast<uint8_t*>(out.data()) + ((size_t)block_y * blocks_x + block_x) * block_size;
+
+            switch (format)
+            {
+                case TextureFormat::PixelFormat::BC1RgbSrgb:
+                    encode_bc1_block(texels, block);
+                    break;
+                case TextureFormat::PixelFormat::BC3Srgb:
+                    encode_bc4_block(texels, 3, block);
+                    encode_bc1_block(texels, block + 8);
+                    break;
+                case TextureFormat::PixelFormat::BC5Unorm:
+                    encode_bc4_block(texels, 0, block);
+                    encode_bc4_block(texels, 1, block + 8);
+                    break;
+                case TextureFormat::PixelFormat::BC7Srgb:
+                    encode_bc7_block(texels, block);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    return out;
+}
+
+
+}
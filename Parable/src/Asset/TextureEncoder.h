@@ -0,0 +1,28 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <span>
+
+#include "CookedTexture.h"
+
+namespace Parable
+{
+
+
+/**
+ * CPU texture processing for cooking: building mip chains and encoding BCn blocks.
+ *
+ * Input is always tightly packed RGBA8. The block encoders aim for good quality at cook time
+ * speed, fitting endpoints to the principal axis of each block and refining them by least
+ * squares, rather than searching exhaustively like an offline reference encoder.
+ */
+namespace TextureEncoder
+{
+    std::vector<std::byte> downsample(std::span<const std::byte> rgba, uint32_t width, uint32_t height, bool srgb);
+
+    std::vector<std::byte> encode(TextureFormat::PixelFormat format, std::span<const std::byte> rgba, uint32_t width, uint32_t height);
+}
+
+
+}
@@ -66,10 +66,15 @@ Application::Application()
     //m_ecs = builder.create();
 
     m_window = std::make_unique<Window>(1600,900,std::string("Parable Engine"), false);
-    m_window->set_app_event_callback(PBL_BIND_MEMBER_EVENT_HANDLER(Application::on_event));
+    m_event_buffer.set_coalescing(true);
+    m_window->set_event_buffer(m_event_buffer);
+
+    // we handle window closing (and thus application quitting) before any layer
+    m_event_router.set_priority(std::numeric_limits<int>::max());
+    m_event_router.subscribe<&Application::on_window_close>(this);
 
     Renderer::Init(m_window->get_glfw_window());
-    m_layer_stack.push(std::make_unique<RenderLayer>());
+    push_layer(std::make_unique<RenderLayer>());
 
     // load test mesh
     cubeMesh = Renderer::get_instance()->load_mesh(4);
@@ -79,9 +84,9 @@ Application::Application()
     matA = Renderer::get_instance()->load_texture(texADescriptor);
     matB = Renderer::get_instance()->load_texture(texBDescriptor);
 
-    m_layer_stack.push(std::make_unique<Input::InputLayer>());
+    push_layer(std::make_unique<Input::InputLayer>());
 
-    m_layer_stack.push(std::make_unique<EventLogLayer>(0));
+    push_layer(std::make_unique<EventLogLayer>(0));
 }
 
 /**
@@ -99,6 +104,9 @@ void Application::run()
     {
         time.start_frame();
 
+        // run the callbacks of reads which have completed, so the work they start is picked up by this frame's update
+        m_io_service.poll();
+
         // TEMP, rotate meshes for test
         auto currentTime = std::chrono::high_resolution_clock::now();
         float elapsedTime = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
@@ -118,12 +126,25 @@ void Application::run()
         // get events from glfw window
         m_window->on_update();
 
+        if (m_event_replayer)
+        {
+            replay_frame_events();
+        }
+        else if (m_event_recorder)
+        {
+            m_event_recorder->record_frame(m_frame, m_event_buffer.get_raw_events());
+        }
+
+        // then events posted by other threads
+        m_event_queue.drain(m_event_buffer);
+
         if (!m_event_buffer.is_empty())
         {
             process_events();
         }
 
         time.end_frame();
+        ++m_frame;
     }
 
 }
@@ -144,43 +165,88 @@ void Application::on_update()
 }
 
 /**
- * Pushes event to event queue
+ * Routes all events in the buffer to the layers subscribed to them, then recycles the buffer for the next frame.
+ * 
+ * Indexes rather than iterates, as layers may push further events while handling one.
  */
-void Application::on_event(Event::EventUPtr e)
+void Application::process_events()
 {
-    m_event_buffer.push(std::move(e));
+    for (size_t i = 0; i < m_event_buffer.size(); ++i)
+    {
+        // events pushed by handlers must not coalesce into ones already dispatched
+        m_event_buffer.freeze();
+        m_event_router.dispatch(*m_event_buffer[i]);
+    }
+
+    m_event_buffer.clear();
 }
 
 /**
- * Dispatches all events in queue to layers
+ * Stops the main loop when the window is closed.
  */
-void Application::process_events()
+bool Application::on_window_close(WindowCloseEvent& e)
 {
-    while(!m_event_buffer.is_empty())
-    {
-        Event::EventUPtr e = m_event_buffer.next();
+    m_running = false;
+    return true;
+}
 
-        // we handle window closing (and thus application quitting) here
-        if (e->get_event_type() == WindowCloseEvent::get_static_type())
-        {
-            e->handled = true;
-            m_running = false;
-        }
+/**
+ * Record the window events of every following frame to a binary event log.
+ * 
+ * @param path the log file to write
+ * 
+ * @throws Parable::FileOpenException if the log cannot be written
+ */
+void Application::record_events(const std::string& path)
+{
+    m_event_recorder = std::make_unique<EventRecorder>(path);
+    PBL_CORE_INFO("Recording events to {}.", path);
+}
 
-        for(auto it = m_layer_stack.crbegin(); it != m_layer_stack.crend(); ++it)
-        {
-            if (e->handled) return;
+/**
+ * Replace the window events of every following frame with those from a binary event log.
+ * 
+ * The log is replayed by frame number from the start of the application, and the application
+ * closes once it has been replayed, so each replay runs an identical session.
+ * 
+ * @param path the log file to replay
+ * 
+ * @throws Parable::FileOpenException if the log cannot be opened
+ * @throws Parable::FileFormatException if the file is not an event log
+ */
+void Application::replay_events(const std::string& path)
+{
+    m_event_replayer = std::make_unique<EventReplayer>(path);
+    PBL_CORE_INFO("Replaying events from {}.", path);
+}
 
-            (*it)->on_event(e.get());
-        }
+/**
+ * Swap this frame's live window events for the recorded ones.
+ */
+void Application::replay_frame_events()
+{
+    // live input is discarded, apart from closing the window so a replay can be cut short
+    bool closed = std::ranges::any_of(m_event_buffer.get_raw_events(), [](Event* e){ return e->get_event_type() == EventType::WindowClosed; });
+    m_event_buffer.clear();
+
+    m_event_replayer->replay_frame(m_frame, m_event_buffer);
+
+    if (closed || m_event_replayer->is_finished())
+    {
+        m_event_buffer.push<WindowCloseEvent>();
     }
 }
 
 /**
  * Add an engine layer.
+ * 
+ * The layer subscribes its event handlers above those of the layers already in the stack.
  */
 void Application::push_layer(UPtr<Layer> layer)
 {
+    m_event_router.set_priority((int)m_layer_stack.size());
+    layer->on_subscribe(m_event_router);
+
     m_layer_stack.push(std::move(layer));
 }
 
@@ -6,6 +6,13 @@
 #include "Core/LayerStack.h"
 
 #include "Events/EventBuffer.h"
+#include "Events/EventRouter.h"
+#include "Events/EventQueue.h"
+#include "Events/EventLog.h"
+
+#include "Jobs/JobSystem.h"
+
+#include "IO/IOService.h"
 
 #include "Window/Window.h"
 
@@ -18,6 +25,8 @@ int main(int argc, char** argv);
 namespace Parable
 {
 
+class WindowCloseEvent;
+
 
 /**
  * Manages the overall state for the application.
@@ -39,6 +48,22 @@ class Application
 
         // called each frame, update each layer
         void on_update();
+
+        /**
+         * The queue other threads post engine events to, which are dispatched on the next frame.
+         */
+        EventQueue& get_event_queue() { return m_event_queue; }
+        /**
+         * The worker pool for CPU work which can be split up, like decoding assets.
+         */
+        JobSystem& get_job_system() { return m_job_system; }
+        /**
+         * Asynchronous file reads, whose callbacks run on the main thread at the start of each frame.
+         */
+        IO::IOService& get_io_service() { return m_io_service; }
+
+        void record_events(const std::string& path);
+        void replay_events(const std::string& path);
     
     protected:
         void push_layer(UPtr<Layer> layer);
@@ -47,6 +72,14 @@ class Application
          * Buffer of events to be processed.
          */
         EventBuffer m_event_buffer;
+        /**
+         * Events posted from other threads, drained into m_event_buffer each frame.
+         */
+        EventQueue m_event_queue;
+        /**
+         * Routes buffered events to the handlers layers subscribed.
+         */
+        EventRouter m_event_router;
         /**
          * Engine layers, which consume events.
          */
@@ -57,11 +90,16 @@ class Application
          */
         UPtr<ECS::ECS> m_ecs;
 
+        JobSystem m_job_system;
+        IO::IOService m_io_service;
+
     private:
         void run();
 
-        void on_event(Event::EventUPtr e);
         void process_events();
+        void replay_frame_events();
+
+        bool on_window_close(WindowCloseEvent& e);
 
         /**
          * The main application window.
@@ -71,6 +109,20 @@ class Application
         // timekeeper (contains delta time)
         Time time;
 
+        /**
+         * The number of frames run so far.
+         */
+        uint64_t m_frame = 0;
+
+        /**
+         * Records window events to a log, if recording.
+         */
+        UPtr<EventRecorder> m_event_recorder;
+        /**
+         * Replaces window events with those from a log, if replaying.
+         */
+        UPtr<EventReplayer> m_event_replayer;
+
         bool m_running = true;
         bool m_minimised = false;
         friend int ::main(int argc, char** argv);
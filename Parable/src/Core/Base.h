@@ -40,9 +40,6 @@
 #define KB(x) 1000 * x
 #define MB(x) 1000000 * x
 
-// might be faster using pure lambdas, is like this as its the first way I could understand to do this
-#define PBL_BIND_MEMBER_EVENT_HANDLER(func) std::bind(std::mem_fn(&func), this, std::placeholders::_1)
-
 // typedefs
 
 template<class T>
@@ -3,6 +3,8 @@
 #include "Core/Base.h"
 #include "Core/Application.h"
 
+#include "Asset/AssetRegistry.h"
+
 extern Parable::Application* Parable::create_application();
 
 /**
@@ -16,9 +18,27 @@ int main(int argc, char** argv){
 
     Parable::Log::init();
 
+    // a cooked registry replaces parsing the json one, and the app loads assets as it is created,
+    // so both are mounted before it is
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg == "--registry") Parable::AssetRegistry::mount_registry(argv[++i]);
+        else if (arg == "--archive") Parable::AssetRegistry::mount_archive(argv[++i]);
+    }
+
     // Create app
     auto app = Parable::create_application();
 
+    // event capture options, for replaying identical sessions
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        if (arg == "--record-events") app->record_events(argv[++i]);
+        else if (arg == "--replay-events") app->replay_events(argv[++i]);
+        else if (arg == "--registry" || arg == "--archive") ++i;
+    }
+
     // Start the app
     app->run();
 
@@ -4,7 +4,7 @@
 
 #include "Core/Base.h"
 
-#include "Events/Event.h"
+#include "Events/EventRouter.h"
 
 namespace Parable
 {
@@ -30,11 +30,13 @@ public:
      */
     virtual void on_update() = 0;
     /**
-     * Processes an event.
+     * Subscribe the layer's event handlers.
      * 
-     * @param e 
+     * Called once when the layer is pushed, with the router priority set from its position in the stack.
+     * 
+     * @param router the application event router
      */
-    virtual void on_event(Event* e) = 0;
+    virtual void on_subscribe(EventRouter& router) {}
 };
 
 
@@ -25,6 +25,8 @@ private:
 public:
     void push(UPtr<Layer> layer) { m_layers.push_back(std::move(layer)); }
 
+    size_t size() const { return m_layers.size(); }
+
     auto cbegin() { return m_layers.cbegin(); }
     auto cend() { return m_layers.cend(); }
     auto crbegin() { return m_layers.crbegin(); }
@@ -6,10 +6,16 @@ namespace Parable
 {
 
 
-void EventLogLayer::on_event(Event* e)
+void EventLogLayer::on_subscribe(EventRouter& router)
 {
-    if(e->get_event_category() & m_event_category_blacklist) return;
-    PBL_CORE_INFO(e->to_string());
+    router.subscribe_category<&EventLogLayer::log_event>(EventRouter::ALL_CATEGORIES, this);
+}
+
+bool EventLogLayer::log_event(Event& e)
+{
+    if(e.get_event_category() & m_event_category_blacklist) return false;
+    PBL_CORE_INFO(e.to_string());
+    return false;
 }
 
 
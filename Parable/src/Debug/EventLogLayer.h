@@ -3,6 +3,7 @@
 #include "Core/Base.h"
 #include "Core/Layer.h"
 #include "Events/Event.h"
+#include "Events/EventRouter.h"
 
 namespace Parable
 {
@@ -26,7 +27,10 @@ public:
     EventLogLayer(int event_category_blacklist = 0) : Layer(std::string("EventLogLayer")), m_event_category_blacklist(event_category_blacklist) {}
 
     void on_update() override {}
-    void on_event(Event* e) override;
+    void on_subscribe(EventRouter& router) override;
+
+private:
+    bool log_event(Event& e);
 };
 
 
@@ -0,0 +1,29 @@
+#include "Debug/MemoryTelemetryLayer.h"
+
+#include "Core/Log.h"
+#include "Memory/MemoryTracker.h"
+
+namespace Parable
+{
+
+
+void MemoryTelemetryLayer::on_update()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - m_last_dump).count() < m_interval) return;
+
+    m_last_dump = now;
+    dump();
+}
+
+/**
+ * Dump a snapshot immediately.
+ * 
+ */
+void MemoryTelemetryLayer::dump()
+{
+    MemoryTracker::dump_json(m_dump_path);
+}
+
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Core/Base.h"
+#include "Core/Layer.h"
+#include "Events/Event.h"
+
+#include <chrono>
+
+namespace Parable
+{
+
+/** A debug layer which periodically dumps memory telemetry.
+ * 
+ * Writes a MemoryTracker snapshot as JSON to a file every interval. Allocators only
+ * report to the tracker when the engine is built with PBL_MEMORY_TRACKING.
+ * 
+ */
+class MemoryTelemetryLayer : public Layer
+{
+private:
+    /**
+     * File the snapshot is written to, overwritten on each dump.
+     */
+    std::string m_dump_path;
+
+    /**
+     * Seconds between dumps.
+     */
+    double m_interval;
+
+    std::chrono::steady_clock::time_point m_last_dump;
+
+public:
+    MemoryTelemetryLayer(const std::string& dump_path, double interval = 5.0) :
+                                                                Layer(std::string("MemoryTelemetryLayer")),
+                                                                m_dump_path(dump_path),
+                                                                m_interval(interval),
+                                                                m_last_dump(std::chrono::steady_clock::now())
+                                                                {}
+
+    void on_update() override;
+
+    void dump();
+};
+
+
+}
@@ -39,7 +39,9 @@ ComponentManager::ComponentManager(ComponentRegistry& registry, size_t total_chu
 																	chunk_size,
 																	0,
 																	total_chunks_allocation_size,
-																	allocator.allocate(total_chunks_allocation_size, 0)
+																	allocator.allocate(total_chunks_allocation_size, alignof(std::max_align_t)),
+																	"ECS/ComponentChunks",
+																	&allocator
 																)
 															),
 															m_component_constructors(std::move(registry.get_ctors())),
@@ -21,6 +21,8 @@ ECS::ECSBuilder::ECSBuilder() : m_component_registry(std::make_unique<ComponentR
  * Creates a new ECS object from the set values.
  * 
  * Constructs the EntityManager, ComponentManager, SystemManager and EntityComponentMap, as well as allocating the specified ammount of memory.
+ * 
+ * The memory is committed from a VirtualArena so large ECS heaps can be backed by huge pages.
  */
 UPtr<ECS> ECS::ECSBuilder::create()
 {
@@ -32,7 +34,9 @@ UPtr<ECS> ECS::ECSBuilder::create()
 
 	size_t total_size = m_entity_component_map_size + m_component_chunks_total_size;
 
-	UPtr<Allocator> allocator = std::make_unique<LinearAllocator>(total_size, malloc(total_size));
+	UPtr<VirtualArena> arena = std::make_unique<VirtualArena>(total_size, m_huge_page_mode);
+
+	UPtr<Allocator> allocator = std::make_unique<LinearAllocator>(total_size, arena->commit_block(total_size), "ECS");
 
 	UPtr<EntityManager> entity_manager = std::make_unique<EntityManager>();
 
@@ -40,7 +44,7 @@ UPtr<ECS> ECS::ECSBuilder::create()
 
 	UPtr<SystemManager> system_manager = std::make_unique<SystemManager>();
 
-	return UPtr<ECS>(new ECS(std::move(entity_manager), std::move(component_manager), std::move(system_manager), std::move(allocator)));
+	return UPtr<ECS>(new ECS(std::move(arena), std::move(entity_manager), std::move(component_manager), std::move(system_manager), std::move(allocator)));
 }
 
 /**
@@ -48,10 +52,12 @@ UPtr<ECS> ECS::ECSBuilder::create()
  * 
  * Takes control of a bunch of ptrs to implementations created by ECSBuilder.
  */
-ECS::ECS(UPtr<EntityManager> entity_manager,
+ECS::ECS(UPtr<VirtualArena> arena,
+			UPtr<EntityManager> entity_manager,
 			UPtr<ComponentManager> component_manager,
 			UPtr<SystemManager> system_manager,
 			UPtr<Allocator> allocator) :
+												m_arena(std::move(arena)),
 												m_entity_manager(std::move(entity_manager)),
 												m_component_manager(std::move(component_manager)),
 												m_system_manager(std::move(system_manager)),
@@ -61,11 +67,11 @@ ECS::ECS(UPtr<EntityManager> entity_manager,
 }
 
 /**
- * Must also free the ECS memory.
+ * The ECS memory is released with m_arena.
  */
 ECS::~ECS()
 {
-	free(m_allocator->get_start());
+
 }
 
 
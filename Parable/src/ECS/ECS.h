@@ -5,6 +5,8 @@
 
 #include "ComponentManager.h"
 
+#include "Memory/VirtualArena.h"
+
 namespace Parable
 {
 class Allocator;
@@ -89,6 +91,7 @@ public:
 		void set_entity_component_map_size(size_t s) { m_entity_component_map_size = s; }
 		void set_component_chunk_size(size_t s) { m_component_chunk_size = s; }
 		void set_component_chunks_total_size(size_t s) { m_component_chunks_total_size = s; }
+		void set_huge_page_mode(HugePageMode m) { m_huge_page_mode = m; }
 
 		ComponentRegistry* get_registry() { return m_component_registry.get(); }
 
@@ -97,6 +100,8 @@ public:
 		size_t m_component_chunk_size = 0;
 		size_t m_component_chunks_total_size = 0;
 
+		HugePageMode m_huge_page_mode = HugePageMode::Transparent;
+
 		UPtr<ComponentRegistry> m_component_registry;
 
 		bool created = false;
@@ -108,7 +113,12 @@ private:
 	 * 
 	 * ECS objects can only be constructed by an ECSBuilder.
 	 */
-	ECS(UPtr<EntityManager>, UPtr<ComponentManager>, UPtr<SystemManager>, UPtr<Allocator>);
+	ECS(UPtr<VirtualArena>, UPtr<EntityManager>, UPtr<ComponentManager>, UPtr<SystemManager>, UPtr<Allocator>);
+
+	/**
+	 * Backing memory for m_allocator, declared first so it is released last.
+	 */
+	UPtr<VirtualArena> m_arena;
 
 	UPtr<EntityManager> m_entity_manager;
 	UPtr<ComponentManager> m_component_manager;
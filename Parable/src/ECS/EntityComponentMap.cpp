@@ -25,7 +25,9 @@ EntityComponentMap::EntityComponentMap(ComponentTypeID num_components, size_t al
 	m_allocator = std::make_unique<PoolAllocator>(sizeof(IComponent*) * num_components,
 													alignof(IComponent*),
 													allocation_size,
-													m_parent_allocator.allocate(allocation_size, alignof(IComponent*))
+													m_parent_allocator.allocate(allocation_size, alignof(IComponent*)),
+													"ECS/EntityComponentMap",
+													&m_parent_allocator
 												);						
 }
 
@@ -4,8 +4,6 @@
 
 #include "Core/Base.h"
 
-#include <functional>
-
 namespace Parable{
 
 
@@ -18,7 +16,10 @@ enum class EventType
     None = 0,
 	WindowClosed,WindowResized,WindowFocused,WindowMinimised,
 	KeyPressed,KeyRepeated,KeyReleased,
-	MouseMoved,MouseEnter,MouseExit,MouseBtnPressed,MouseBtnReleased,MouseScrolled
+	MouseMoved,MouseEnter,MouseExit,MouseBtnPressed,MouseBtnReleased,MouseScrolled,
+	ResourceLoaded,
+	// the number of event types, keep last
+	Count
 };
 
 /**
@@ -33,7 +34,8 @@ enum EventCategory
 	EventCategoryMouse = BIT(3),
 	// used by input system 
 	EventCategoryButton = BIT(4),
-	EventCategoryAxis = BIT(5)
+	EventCategoryAxis = BIT(5),
+	EventCategoryResource = BIT(6)
 };
 
 #define EVENT_CLASS_TYPE(type) static EventType get_static_type() { return EventType::type; }\
@@ -53,8 +55,6 @@ class Event
 {
 
 public:
-	typedef std::unique_ptr<Event> EventUPtr;
-
     virtual ~Event() = default;
 
     bool handled = false;
@@ -72,54 +72,4 @@ public:
 };
 
 
-/**
- * Dispatches events to engine layers.
- */
-class EventDispatcher
-{
-public:
-	EventDispatcher(Event* event) : m_event(event) {} 
-
-	/**
-	 * Dispatches m_event to a handler function.
-	 * 
-	 * Sets m_event.handled if the handler returns true (the event was handled), and returns true if the correct event type was passed (and so the handler was invoked).
-	 * 
-	 * @tparam T the concrete event type the handler accepts
-	 * 
-	 * @param func function pointer to the handler
-	 */
-	template<typename T>
-	inline bool dispatch(const std::function<bool(T&)>& func)
-	{
-		if (m_event->get_event_type() == T::get_static_type())
-		{
-			m_event->handled |= func(static_cast<T&>(*m_event));
-			return true;
-		}
-		return false;
-	}
-
-	/**
-	 * Dispatch a pointer to the event.
-	 * 
-	 * Use carefully, mostly deprecated but used for some debugging for now.
-	 * 
-	 * @param func function pointer to handlers
-	 */
-	inline bool dispatch_raw(const std::function<bool(Event*)>& func)
-	{
-		m_event->handled |= func(m_event);
-		return true;
-	}
-
-private:
-	/**
-	 * The event which we are dispatching.
-	 * 
-	 */
-	Event* m_event;
-};
-
-
 }
\ No newline at end of file
@@ -5,17 +5,62 @@ namespace Parable
 {
 
 
+EventBuffer::~EventBuffer()
+{
+    clear();
+}
+
+/**
+ * Destroy all stored events and rewind to the start of the first block.
+ *
+ * The blocks are kept for reuse.
+ */
+void EventBuffer::clear()
+{
+    for (Event* e : m_constructed) e->~Event();
+    m_constructed.clear();
+    m_events.clear();
+    m_raw_events.clear();
+    m_frozen = 0;
+
+    m_block = 0;
+    m_offset = 0;
+}
+
 /**
- * Pop the next queued event
+ * Bump allocate space for an event, moving to the next block (or adding one) if the current is full.
  *
- * @return the unique ptr to the next event
+ * @param size the size of the event
+ * @param alignment the alignment of the event
  */
-Event::EventUPtr EventBuffer::next()
+void* EventBuffer::allocate(size_t size, size_t alignment)
 {
-    Event::EventUPtr e = std::move(m_event_queue.front());
-    m_event_queue.pop();
-    return e;
+    size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+
+    if (m_block >= m_blocks.size() || offset + size > BLOCK_SIZE)
+    {
+        if (m_block < m_blocks.size()) ++m_block;
+        if (m_block == m_blocks.size()) m_blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(BLOCK_SIZE));
+        offset = 0;
+    }
+
+    m_offset = offset + size;
+    return m_blocks[m_block].get() + offset;
+}
+
+/**
+ * Remove the latest event of a type from the events to dispatch, if there is one after the frozen events.
+ *
+ * The event stays in the raw stream and is destroyed on clear() as usual.
+ *
+ * @param type the type of event to drop
+ */
+void EventBuffer::drop_last_of_type(EventType type)
+{
+    auto first = m_events.begin() + (ptrdiff_t)m_frozen;
+    auto it = std::find_if(m_events.rbegin(), std::make_reverse_iterator(first), [type](Event* e){ return e->get_event_type() == type; });
+    if (it.base() != first) m_events.erase(std::next(it).base());
 }
 
 
-}
\ No newline at end of file
+}
@@ -9,21 +9,172 @@
 namespace Parable{
 
 
+/**
+ * An event type which can merge a following event of the same type into itself.
+ *
+ * coalesce() returns false if the two events cannot be merged (e.g. repeats of different keys).
+ */
+template<class T>
+concept CoalescableEvent = requires(T& event, const T& next) { { event.coalesce(next) } -> std::same_as<bool>; };
+
+/**
+ * An event type where only the latest event of a frame matters.
+ */
+template<class T>
+concept SupersedingEvent = T::SUPERSEDES_PREVIOUS;
+
 /**
  * A buffer to store incoming engine events to process at a later time.
- * 
+ *
+ * Events are constructed in place in blocks of raw storage owned by the buffer, rather than
+ * each being heap allocated. The blocks are kept when the buffer is cleared, so after the
+ * first few frames pushing an event does not allocate.
+ *
+ * Pointers to events stay valid until the next clear(), so layers receive views into the
+ * buffer and must not keep them beyond the frame.
+ *
+ * With coalescing enabled, consecutive events of a CoalescableEvent type are merged into one
+ * (e.g. mouse moves accumulate their delta) and a SupersedingEvent replaces any earlier event of
+ * its type, so high rate input is dispatched once per frame. Every pushed event is still kept in
+ * order in the raw stream, for code which needs each sample.
+ *
  */
 class EventBuffer
 {
+public:
+    static constexpr size_t BLOCK_SIZE = 16 * 1024;
+
+    EventBuffer() = default;
+    ~EventBuffer();
+
+    EventBuffer(const EventBuffer&) = delete;
+    EventBuffer& operator=(const EventBuffer&) = delete;
+
+    /**
+     * Construct an event of type T at the back of the buffer.
+     *
+     * @tparam T the concrete event type
+     *
+     * @param args arguments forwarded to the constructor of T
+     *
+     * @return reference to the stored event
+     */
+    template<class T, class... Args>
+    T& push(Args&&... args)
+    {
+        static_assert(std::is_base_of_v<Event, T>, "EventBuffer can only store Events.");
+        static_assert(sizeof(T) <= BLOCK_SIZE, "Event type too large for an EventBuffer block.");
+
+        T* e = construct<T>(std::forward<Args>(args)...);
+
+        if (m_coalescing)
+        {
+            m_raw_events.push_back(e);
+
+            if constexpr (CoalescableEvent<T>)
+            {
+                if (m_events.size() > m_frozen && m_events.back()->get_event_type() == T::get_static_type())
+                {
+                    // the merge target is always a copy owned by the coalesced stream, so the raw event is unchanged
+                    T* last = static_cast<T*>(m_events.back());
+                    if (last->coalesce(*e)) return *last;
+                }
+
+                T* merged = construct<T>(*e);
+                m_events.push_back(merged);
+                return *merged;
+            }
+            else if constexpr (SupersedingEvent<T>)
+            {
+                drop_last_of_type(T::get_static_type());
+            }
+        }
+
+        m_events.push_back(e);
+        return *e;
+    }
+
+    bool is_empty() const { return m_events.empty(); }
+    size_t size() const { return m_events.size(); }
+
+    Event* operator[](size_t i) const { return m_events[i]; }
+
+    auto begin() const { return m_events.cbegin(); }
+    auto end() const { return m_events.cend(); }
+
+    /**
+     * Every event pushed this frame, in order and before coalescing.
+     *
+     * The same as the events themselves if coalescing is disabled.
+     */
+    const std::vector<Event*>& get_raw_events() const { return m_coalescing ? m_raw_events : m_events; }
+
+    void clear();
+
+    /**
+     * Stop later pushes coalescing into the events already in the buffer.
+     *
+     * Call before dispatching, so events pushed by handlers never merge into or drop an event
+     * which has already been dispatched.
+     */
+    void freeze() { m_frozen = m_events.size(); }
+
+    /**
+     * Enable or disable coalescing of pushed events, which can only change while the buffer is empty.
+     */
+    void set_coalescing(bool coalescing)
+    {
+        PBL_CORE_ASSERT_MSG(is_empty(), "Cannot change EventBuffer coalescing with events in the buffer!")
+        m_coalescing = coalescing;
+    }
+    bool get_coalescing() const { return m_coalescing; }
+
+    size_t get_num_blocks() const { return m_blocks.size(); }
+
 private:
-    std::queue<Event::EventUPtr> m_event_queue;
-    bool front_in_use = false;
+    template<class T, class... Args>
+    T* construct(Args&&... args)
+    {
+        T* e = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        m_constructed.push_back(e);
+        return e;
+    }
 
-public:
-    bool is_empty() { return m_event_queue.size() == 0; }
-    void push(Event::EventUPtr e) { m_event_queue.push(std::move(e)); }
-    Event::EventUPtr next();
+    void* allocate(size_t size, size_t alignment);
+    void drop_last_of_type(EventType type);
+
+    /**
+     * Raw storage the events are constructed in.
+     */
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    /**
+     * Index of the block currently being filled.
+     */
+    size_t m_block = 0;
+    /**
+     * Offset of the first free byte in the current block.
+     */
+    size_t m_offset = 0;
+
+    /**
+     * The events to dispatch, in the order they were pushed.
+     */
+    std::vector<Event*> m_events;
+    /**
+     * Every pushed event when coalescing, which m_events may have merged or dropped.
+     */
+    std::vector<Event*> m_raw_events;
+    /**
+     * Every event constructed in the blocks, to destroy on clear().
+     */
+    std::vector<Event*> m_constructed;
+
+    bool m_coalescing = false;
+    /**
+     * The number of events at the front of m_events which coalescing must not touch.
+     */
+    size_t m_frozen = 0;
 };
 
 
-}
\ No newline at end of file
+}
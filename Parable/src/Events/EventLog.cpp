@@ -0,0 +1,239 @@
+#include "Events/EventLog.h"
+
+#include "Events/WindowEvent.h"
+#include "Events/InputEvent.h"
+
+
+namespace Parable
+{
+
+
+// RECORDER
+
+/**
+ * Create a recorder writing to a new log file.
+ * 
+ * @param path the file to write, replaced if it exists
+ * 
+ * @throws Parable::FileOpenException if the file cannot be opened for writing
+ */
+EventRecorder::EventRecorder(const std::string& path) :
+                                            m_file(path, std::ios::binary | std::ios::trunc),
+                                            m_start(std::chrono::steady_clock::now())
+{
+    if (!m_file)
+    {
+        PBL_CORE_ERROR("Failed to open event log {} for writing.", path);
+        throw FileOpenException("Failed to open event log for writing.");
+    }
+
+    m_file.write(EventLog::MAGIC, sizeof(EventLog::MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&EventLog::VERSION), sizeof(EventLog::VERSION));
+}
+
+EventRecorder::~EventRecorder()
+{
+    m_file.flush();
+}
+
+/**
+ * Append a frame's events to the log.
+ * 
+ * Frames without any recordable events are not written.
+ * 
+ * @param frame the frame number
+ * @param events the events in the order they were pushed
+ */
+void EventRecorder::record_frame(uint64_t frame, std::span<Event* const> events)
+{
+    if (events.empty()) return;
+
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+
+    m_frame_bytes.clear();
+    write(frame);
+    write(time);
+    size_t count_offset = m_frame_bytes.size();
+    write((uint32_t)0);
+
+    uint32_t count = 0;
+    for (Event* e : events)
+    {
+        if (write_event(*e)) ++count;
+    }
+
+    if (count == 0) return;
+
+    std::memcpy(m_frame_bytes.data() + count_offset, &count, sizeof(count));
+    m_file.write(reinterpret_cast<const char*>(m_frame_bytes.data()), (std::streamsize)m_frame_bytes.size());
+    m_num_recorded += count;
+}
+
+/**
+ * Encode one event into the frame block.
+ * 
+ * @return false if the event type is not recorded (engine internal events, which a replay regenerates)
+ */
+bool EventRecorder::write_event(Event& e)
+{
+    EventType type = e.get_event_type();
+
+    switch (type)
+    {
+        case EventType::WindowClosed:
+        case EventType::MouseEnter:
+        case EventType::MouseExit:
+            write((uint8_t)type);
+            return true;
+        case EventType::WindowResized:
+        {
+            auto& resize = static_cast<WindowResizeEvent&>(e);
+            write((uint8_t)type);
+            write((int32_t)resize.get_width());
+            write((int32_t)resize.get_height());
+            return true;
+        }
+        case EventType::WindowFocused:
+            write((uint8_t)type);
+            write((uint8_t)static_cast<WindowFocusEvent&>(e).focused);
+            return true;
+        case EventType::WindowMinimised:
+            write((uint8_t)type);
+            write((uint8_t)static_cast<WindowMinimiseEvent&>(e).minimised);
+            return true;
+        case EventType::KeyPressed:
+        case EventType::KeyRepeated:
+        case EventType::KeyReleased:
+            write((uint8_t)type);
+            write((int32_t)static_cast<KeyEvent&>(e).get_key_code());
+            return true;
+        case EventType::MouseMoved:
+        {
+            auto& moved = static_cast<MouseMovedEvent&>(e);
+            write((uint8_t)type);
+            write(moved.get_x());
+            write(moved.get_y());
+            write(moved.get_delta_x());
+            write(moved.get_delta_y());
+            return true;
+        }
+        case EventType::MouseBtnPressed:
+        case EventType::MouseBtnReleased:
+            write((uint8_t)type);
+            write((int32_t)static_cast<MouseBtnEvent&>(e).get_button());
+            return true;
+        case EventType::MouseScrolled:
+            write((uint8_t)type);
+            write(static_cast<MouseScrolledEvent&>(e).get_scroll_amt());
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+// REPLAYER
+
+/**
+ * Open a log for replay.
+ * 
+ * @param path the log file to read
+ * 
+ * @throws Parable::FileOpenException if the file cannot be opened
+ * @throws Parable::FileFormatException if the file is not an event log of this version
+ */
+EventReplayer::EventReplayer(const std::string& path) : m_file(path, Util::AccessHint::Sequential)
+{
+    char magic[sizeof(EventLog::MAGIC)];
+    for (char& c : magic) c = read<char>();
+
+    if (std::memcmp(magic, EventLog::MAGIC, sizeof(magic)) != 0)
+    {
+        PBL_CORE_ERROR("{} is not an event log.", path);
+        throw FileFormatException("File is not an event log.");
+    }
+
+    uint32_t version = read<uint32_t>();
+    if (version != EventLog::VERSION)
+    {
+        PBL_CORE_ERROR("Event log {} has version {}, expected {}.", path, version, EventLog::VERSION);
+        throw FileFormatException("Unsupported event log version.");
+    }
+
+    if (!is_finished()) read_frame_header();
+}
+
+/**
+ * Push the events recorded for a frame into a buffer.
+ * 
+ * Any earlier frames which have not been replayed are replayed first, so events are never lost
+ * if the replay starts late.
+ * 
+ * @param frame the frame number to replay
+ * @param buffer the buffer to push the events into
+ * 
+ * @return the number of events pushed
+ * 
+ * @throws Parable::FileFormatException if the log is corrupt
+ */
+size_t EventReplayer::replay_frame(uint64_t frame, EventBuffer& buffer)
+{
+    size_t count = 0;
+    while (!is_finished() && m_next_frame <= frame)
+    {
+        for (uint32_t i = 0; i < m_frame_events; ++i) read_event(buffer);
+        count += m_frame_events;
+
+        if (!is_finished()) read_frame_header();
+    }
+    return count;
+}
+
+void EventReplayer::read_frame_header()
+{
+    m_next_frame = read<uint64_t>();
+    m_frame_time = read<double>();
+    m_frame_events = read<uint32_t>();
+}
+
+void EventReplayer::read_event(EventBuffer& buffer)
+{
+    EventType type = (EventType)read<uint8_t>();
+
+    switch (type)
+    {
+        case EventType::WindowClosed:       buffer.push<WindowCloseEvent>(); break;
+        case EventType::MouseEnter:         buffer.push<MouseEnterEvent>(); break;
+        case EventType::MouseExit:          buffer.push<MouseExitEvent>(); break;
+        case EventType::WindowResized:
+        {
+            int32_t width = read<int32_t>();
+            int32_t height = read<int32_t>();
+            buffer.push<WindowResizeEvent>(width, height);
+            break;
+        }
+        case EventType::WindowFocused:      buffer.push<WindowFocusEvent>(read<uint8_t>() != 0); break;
+        case EventType::WindowMinimised:    buffer.push<WindowMinimiseEvent>(read<uint8_t>() != 0); break;
+        case EventType::KeyPressed:         buffer.push<KeyPressedEvent>(read<int32_t>()); break;
+        case EventType::KeyRepeated:        buffer.push<KeyRepeatedEvent>(read<int32_t>()); break;
+        case EventType::KeyReleased:        buffer.push<KeyReleasedEvent>(read<int32_t>()); break;
+        case EventType::MouseMoved:
+        {
+            double x = read<double>();
+            double y = read<double>();
+            double delta_x = read<double>();
+            double delta_y = read<double>();
+            buffer.push<MouseMovedEvent>(x, y, delta_x, delta_y);
+            break;
+        }
+        case EventType::MouseBtnPressed:    buffer.push<MouseBtnPressedEvent>(read<int32_t>()); break;
+        case EventType::MouseBtnReleased:   buffer.push<MouseBtnReleasedEvent>(read<int32_t>()); break;
+        case EventType::MouseScrolled:      buffer.push<MouseScrolledEvent>(read<double>()); break;
+        default:
+            PBL_CORE_ERROR("Event log {} has an unknown event type {} at byte {}.", m_file.get_path(), (int)type, m_cursor - 1);
+            throw FileFormatException("Event log contains an unknown event type.");
+    }
+}
+
+
+}
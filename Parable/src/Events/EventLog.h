@@ -0,0 +1,127 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <fstream>
+#include <chrono>
+#include <cstring>
+
+#include "Core/Base.h"
+
+#include "Events/Event.h"
+#include "Events/EventBuffer.h"
+
+#include "Util/MappedFile.h"
+
+#include "Exception/IOExceptions.h"
+
+namespace Parable
+{
+
+
+/**
+ * Binary event logs, for replaying identical input through the engine.
+ * 
+ * A log is a header then one block per frame which had input:
+ * 
+ *      frame block:    u64 frame, f64 seconds since recording started, u32 event count, events
+ *      event:          u8 EventType, then a payload specific to the type
+ * 
+ * Values are written in host byte order, so logs are only portable between machines of the
+ * same endianness.
+ */
+namespace EventLog
+{
+    constexpr char MAGIC[8] = { 'P', 'B', 'L', 'E', 'V', 'L', 'O', 'G' };
+    constexpr uint32_t VERSION = 1;
+}
+
+/**
+ * Writes the events leaving the Window each frame to a binary event log.
+ * 
+ * Events are recorded before coalescing, so a replay is coalesced exactly as the live session was.
+ */
+class EventRecorder
+{
+public:
+    EventRecorder(const std::string& path);
+    ~EventRecorder();
+
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    void record_frame(uint64_t frame, std::span<Event* const> events);
+
+    size_t get_num_recorded() const { return m_num_recorded; }
+
+private:
+    template<class T>
+    void write(const T& value)
+    {
+        const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
+        m_frame_bytes.insert(m_frame_bytes.end(), bytes, bytes + sizeof(T));
+    }
+
+    bool write_event(Event& e);
+
+    std::ofstream m_file;
+
+    std::chrono::steady_clock::time_point m_start;
+
+    /**
+     * The encoded frame block, written to the file in one call.
+     */
+    std::vector<std::byte> m_frame_bytes;
+
+    size_t m_num_recorded = 0;
+};
+
+/**
+ * Reads a binary event log back into EventBuffers, in place of the Window's live input.
+ */
+class EventReplayer
+{
+public:
+    EventReplayer(const std::string& path);
+
+    size_t replay_frame(uint64_t frame, EventBuffer& buffer);
+
+    /**
+     * Whether every frame in the log has been replayed.
+     */
+    bool is_finished() const { return m_cursor >= m_file.size(); }
+
+    /**
+     * The recording time of the next frame block, or of the last if finished.
+     */
+    double get_frame_time() const { return m_frame_time; }
+
+private:
+    template<class T>
+    T read()
+    {
+        if (m_cursor + sizeof(T) > m_file.size())
+        {
+            PBL_CORE_ERROR("Event log {} is truncated at byte {}.", m_file.get_path(), m_cursor);
+            throw FileFormatException("Event log is truncated.");
+        }
+
+        T value;
+        std::memcpy(&value, m_file.data().data() + m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return value;
+    }
+
+    void read_frame_header();
+    void read_event(EventBuffer& buffer);
+
+    Util::MappedFile m_file;
+    size_t m_cursor = 0;
+
+    uint64_t m_next_frame = 0;
+    double m_frame_time = 0.0;
+    uint32_t m_frame_events = 0;
+};
+
+
+}
@@ -0,0 +1,35 @@
+#include "Events/EventQueue.h"
+
+
+namespace Parable
+{
+
+
+/**
+ * Construct every posted event into a buffer, main thread only.
+ *
+ * Events posted while draining may be left for the next drain.
+ *
+ * @param buffer the buffer to push the events into
+ *
+ * @return the number of events drained
+ */
+size_t EventQueue::drain(EventBuffer& buffer)
+{
+    static constexpr size_t BATCH_SIZE = 32;
+    std::array<Record, BATCH_SIZE> batch;
+
+    size_t total = 0;
+    size_t count;
+    do
+    {
+        count = m_queue.pop_batch(batch);
+        for (size_t i = 0; i < count; ++i) batch[i].emit(buffer, batch[i].payload);
+        total += count;
+    } while (count == BATCH_SIZE);
+
+    return total;
+}
+
+
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <cstring>
+
+#include "Core/Base.h"
+
+#include "Events/Event.h"
+#include "Events/EventBuffer.h"
+
+#include "Util/MPSCQueue.h"
+#include "Util/CacheLine.h"
+
+namespace Parable
+{
+
+
+namespace EventQueueDetail
+{
+
+/**
+ * Trivially copyable storage for the constructor arguments of a posted event.
+ *
+ * A recursive aggregate rather than std::tuple, which is not trivially copyable.
+ */
+template<class... Ts>
+struct PackedArgs
+{
+    template<class F, class... Prev>
+    void apply(F&& f, const Prev&... prev) const { f(prev...); }
+};
+
+template<class T, class... Ts>
+struct PackedArgs<T, Ts...>
+{
+    T head;
+    PackedArgs<Ts...> tail;
+
+    template<class F, class... Prev>
+    void apply(F&& f, const Prev&... prev) const { tail.apply(f, prev..., head); }
+};
+
+inline PackedArgs<> pack()
+{
+    return {};
+}
+
+template<class T, class... Ts>
+PackedArgs<T, Ts...> pack(const T& head, const Ts&... tail)
+{
+    return { head, pack(tail...) };
+}
+
+}
+
+
+/**
+ * A thread safe queue for engine events posted from outside the main thread.
+ *
+ * Worker threads (asset loading, jobs, file watching) post events without locking, and the
+ * main thread drains them into the frame's EventBuffer, where they are dispatched with window
+ * events. This lets other systems react to completions rather than polling shared state.
+ *
+ * Events are posted as a type and its constructor arguments, which must be trivially copyable
+ * and fit in PAYLOAD_SIZE bytes. The event itself is only constructed when drained.
+ *
+ */
+class EventQueue
+{
+public:
+    static constexpr size_t CAPACITY = 1024;
+    static constexpr size_t PAYLOAD_SIZE = Util::CACHE_LINE_SIZE - sizeof(void*);
+
+    EventQueue() = default;
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    /**
+     * Post an event of type T, from any thread.
+     *
+     * @tparam T the concrete event type
+     *
+     * @param args arguments for the constructor of T
+     *
+     * @return false if the queue is full and the event was dropped
+     */
+    template<class T, class... Args>
+    bool post(const Args&... args)
+    {
+        using Packed = EventQueueDetail::PackedArgs<Args...>;
+
+        static_assert(std::is_base_of_v<Event, T>, "EventQueue can only post Events.");
+        static_assert(std::is_trivially_copyable_v<Packed>, "Posted event arguments must be trivially copyable.");
+        static_assert(sizeof(Packed) <= PAYLOAD_SIZE, "Posted event arguments are too large.");
+
+        Record record;
+        record.emit = &emit<T, Packed>;
+        Packed packed = EventQueueDetail::pack(args...);
+        std::memcpy(record.payload, &packed, sizeof(Packed));
+
+        return m_queue.push(record);
+    }
+
+    size_t drain(EventBuffer& buffer);
+
+private:
+    using EmitFn = void(*)(EventBuffer& buffer, const std::byte* payload);
+
+    /**
+     * A posted event, one cache line.
+     *
+     * The payload is only ever memcpy'd to and from, so needs no alignment.
+     */
+    struct Record
+    {
+        EmitFn emit;
+        std::byte payload[PAYLOAD_SIZE];
+    };
+
+    template<class T, class Packed>
+    static void emit(EventBuffer& buffer, const std::byte* payload)
+    {
+        // the arguments need not be default constructible, so copy into raw storage, implicitly creating them
+        alignas(Packed) std::byte storage[sizeof(Packed)];
+        std::memcpy(storage, payload, sizeof(Packed));
+        const Packed& packed = *std::launder(reinterpret_cast<const Packed*>(storage));
+        packed.apply([&buffer](const auto&... args){ buffer.push<T>(args...); });
+    }
+
+    Util::MPSCQueue<Record, CAPACITY> m_queue;
+};
+
+
+}
@@ -0,0 +1,76 @@
+#include "Events/EventRouter.h"
+
+
+namespace Parable
+{
+
+
+/**
+ * Remove every subscription made with a context object.
+ *
+ * @param context the object whose handlers to remove
+ */
+void EventRouter::unsubscribe(void* context)
+{
+    std::erase_if(m_subscriptions, [context](const Subscription& s){ return s.context == context; });
+
+    for (Route& route : m_routes) route.resolved = false;
+}
+
+/**
+ * Offer an event to its subscribed handlers, stopping at the first which handles it.
+ *
+ * @param e the event to dispatch
+ */
+void EventRouter::dispatch(Event& e)
+{
+    EventType type = e.get_event_type();
+    Route& route = m_routes[(size_t)type];
+
+    // every event of a type has the same category, so it only needs reading on resolution
+    if (!route.resolved) resolve(route, type, e.get_event_category());
+
+    for (const Handler& handler : route.handlers)
+    {
+        if (handler.fn(handler.context, e))
+        {
+            e.handled = true;
+            return;
+        }
+    }
+}
+
+void EventRouter::add(const Subscription& subscription)
+{
+    // keep subscriptions ordered by priority, after any of equal priority
+    auto it = std::upper_bound(m_subscriptions.begin(), m_subscriptions.end(), subscription.priority,
+                                [](int priority, const Subscription& s){ return priority > s.priority; });
+    m_subscriptions.insert(it, subscription);
+
+    for (Route& route : m_routes) route.resolved = false;
+}
+
+/**
+ * Collect the handlers for an event type from the type and category subscriptions.
+ *
+ * @param route the route to fill
+ * @param type the event type of the route
+ * @param category the category mask of events of this type
+ */
+void EventRouter::resolve(Route& route, EventType type, int category)
+{
+    route.handlers.clear();
+
+    for (const Subscription& s : m_subscriptions)
+    {
+        if (s.type == type || (s.category_mask & category))
+        {
+            route.handlers.push_back({ s.fn, s.context });
+        }
+    }
+
+    route.resolved = true;
+}
+
+
+}
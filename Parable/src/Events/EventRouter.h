@@ -0,0 +1,151 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include "Core/Base.h"
+
+#include "Events/Event.h"
+
+namespace Parable{
+
+
+/**
+ * Routes engine events to the handlers subscribed to them.
+ *
+ * Handlers are registered once, either for a single concrete event type or for a mask of
+ * event categories, and stored as plain function pointers with a context object. Each event
+ * is then offered only to the handlers subscribed to it, in descending priority.
+ *
+ * Handlers are member functions returning true if they handled the event, which stops it
+ * propagating to lower priority handlers:
+ *
+ *      router.subscribe<&RenderLayer::on_window_resize>(this);
+ *      router.subscribe_category<&EventLogLayer::log_event>(EventCategoryInput, this);
+ *
+ * The handlers for each event type are resolved (merging type and category subscriptions)
+ * the first time an event of that type is dispatched after a subscription changes.
+ *
+ */
+class EventRouter
+{
+private:
+    /**
+     * Deduces the class and event type of a handler member function.
+     */
+    template<class M> struct HandlerTraits;
+
+    template<class C, class T>
+    struct HandlerTraits<bool (C::*)(T&)>
+    {
+        using Class = C;
+        using EventT = T;
+    };
+
+public:
+    /**
+     * A mask matching every event category.
+     */
+    static constexpr int ALL_CATEGORIES = ~0;
+
+    using HandlerFn = bool(*)(void* context, Event& e);
+
+    EventRouter() = default;
+
+    /**
+     * Set the priority of subsequent subscriptions.
+     *
+     * Higher priority handlers see events first, handlers of equal priority are invoked in
+     * subscription order.
+     *
+     * @param priority the priority to subscribe with
+     */
+    void set_priority(int priority) { m_priority = priority; }
+
+    /**
+     * Subscribe a member function to a concrete event type.
+     *
+     * The event type is deduced from the handler, which must have the signature bool(T&).
+     *
+     * @tparam Method pointer to the handler member function
+     *
+     * @param context the object to invoke the handler on
+     */
+    template<auto Method>
+    void subscribe(typename HandlerTraits<decltype(Method)>::Class* context)
+    {
+        using T = typename HandlerTraits<decltype(Method)>::EventT;
+        static_assert(!std::is_same_v<T, Event>, "Handlers for all events should use subscribe_category.");
+
+        add(Subscription{ &invoke<Method>, context, m_priority, T::get_static_type(), 0 });
+    }
+
+    /**
+     * Subscribe a member function to every event in any of the given categories.
+     *
+     * The handler must have the signature bool(Event&).
+     *
+     * @tparam Method pointer to the handler member function
+     *
+     * @param category_mask the EventCategory bits to subscribe to
+     * @param context the object to invoke the handler on
+     */
+    template<auto Method>
+    void subscribe_category(int category_mask, typename HandlerTraits<decltype(Method)>::Class* context)
+    {
+        static_assert(std::is_same_v<typename HandlerTraits<decltype(Method)>::EventT, Event>, "Category handlers must accept any Event.");
+
+        add(Subscription{ &invoke<Method>, context, m_priority, EventType::None, category_mask });
+    }
+
+    void unsubscribe(void* context);
+
+    void dispatch(Event& e);
+
+private:
+    template<auto Method>
+    static bool invoke(void* context, Event& e)
+    {
+        using Traits = HandlerTraits<decltype(Method)>;
+        return (static_cast<typename Traits::Class*>(context)->*Method)(static_cast<typename Traits::EventT&>(e));
+    }
+
+    struct Handler
+    {
+        HandlerFn fn;
+        void* context;
+    };
+
+    struct Subscription
+    {
+        HandlerFn fn;
+        void* context;
+        int priority;
+
+        /**
+         * The event type subscribed to, or None for a category subscription.
+         */
+        EventType type;
+        int category_mask;
+    };
+
+    /**
+     * The resolved handlers for one event type.
+     */
+    struct Route
+    {
+        std::vector<Handler> handlers;
+        bool resolved = false;
+    };
+
+    void add(const Subscription& subscription);
+    void resolve(Route& route, EventType type, int category);
+
+    std::vector<Subscription> m_subscriptions;
+
+    std::array<Route, (size_t)EventType::Count> m_routes;
+
+    int m_priority = 0;
+};
+
+
+}
@@ -54,7 +54,25 @@ public:
     EVENT_CLASS_CATEGORY(EventCategoryInput | EventCategoryKeyboard)
     EVENT_CLASS_TYPE(KeyRepeated)
     using KeyEvent::KeyEvent;
-    std::string to_string() const override { std::stringstream out_stream; out_stream << get_name() << ": KeyCode=" << (Input::InputCode)m_keycode; return out_stream.str();}
+    std::string to_string() const override { std::stringstream out_stream; out_stream << get_name() << ": KeyCode=" << (Input::InputCode)m_keycode << ", Count=" << m_repeat_count; return out_stream.str();}
+
+    /**
+     * The number of repeats this event stands for, more than one if repeats were coalesced.
+     */
+    int get_repeat_count() { return m_repeat_count; }
+
+    /**
+     * Merge a following repeat of the same key into this one.
+     */
+    bool coalesce(const KeyRepeatedEvent& next)
+    {
+        if (next.m_keycode != m_keycode) return false;
+        m_repeat_count += next.m_repeat_count;
+        return true;
+    }
+
+private:
+    int m_repeat_count = 1;
 };
 
 class KeyReleasedEvent : public KeyEvent
@@ -76,16 +94,36 @@ public:
     EVENT_CLASS_CATEGORY(EventCategoryInput | EventCategoryMouse | EventCategoryAxis)
     EVENT_CLASS_TYPE(MouseMoved)
 
-    MouseMovedEvent(double x, double y) : m_x(x), m_y(y) {}
+    MouseMovedEvent(double x, double y, double delta_x = 0.0, double delta_y = 0.0) : m_x(x), m_y(y), m_delta_x(delta_x), m_delta_y(delta_y) {}
 
-    std::string to_string() const override { std::stringstream out_stream; out_stream << get_name() << ": X=" << m_x << ", Y=" << m_y; return out_stream.str();}
+    std::string to_string() const override { std::stringstream out_stream; out_stream << get_name() << ": X=" << m_x << ", Y=" << m_y << ", DX=" << m_delta_x << ", DY=" << m_delta_y; return out_stream.str();}
 
     double get_x() { return m_x; }
     double get_y() { return m_y; }
 
+    /**
+     * Movement since the previous cursor sample, accumulated over all samples if moves were coalesced.
+     */
+    double get_delta_x() { return m_delta_x; }
+    double get_delta_y() { return m_delta_y; }
+
+    /**
+     * Merge a following move into this one, taking its position and accumulating its delta.
+     */
+    bool coalesce(const MouseMovedEvent& next)
+    {
+        m_x = next.m_x;
+        m_y = next.m_y;
+        m_delta_x += next.m_delta_x;
+        m_delta_y += next.m_delta_y;
+        return true;
+    }
+
 private:
     double m_x;
     double m_y;
+    double m_delta_x;
+    double m_delta_y;
 };
 
 class MouseEnterEvent : public Event
@@ -149,6 +187,15 @@ public:
 
     double get_scroll_amt() { return m_scroll_amt; }
 
+    /**
+     * Merge a following scroll into this one, summing the ammounts.
+     */
+    bool coalesce(const MouseScrolledEvent& next)
+    {
+        m_scroll_amt += next.m_scroll_amt;
+        return true;
+    }
+
     std::string to_string() const override { std::stringstream out_stream; out_stream << get_name() << ": Ammount=" << m_scroll_amt; return out_stream.str();}
 
 private:
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Core/Base.h"
+#include "Events/Event.h"
+
+#include "Asset/AssetDescriptor.h"
+
+#include <sstream>
+
+namespace Parable
+{
+
+
+/**
+ * Posted when a resource finishes loading and its handles become usable.
+ */
+class ResourceLoadedEvent : public Event
+{
+public:
+    EVENT_CLASS_CATEGORY(EventCategoryResource)
+    EVENT_CLASS_TYPE(ResourceLoaded)
+
+    ResourceLoadedEvent(AssetDescriptor descriptor) : m_descriptor(descriptor) {}
+
+    AssetDescriptor get_descriptor() { return m_descriptor; }
+
+    std::string to_string() const override { std::stringstream out_stream; out_stream << get_name() << ": Descriptor=" << m_descriptor; return out_stream.str();}
+
+private:
+    AssetDescriptor m_descriptor;
+};
+
+
+}
@@ -49,6 +49,11 @@ public:
     EVENT_CLASS_CATEGORY(EventCategoryWindow)
     EVENT_CLASS_TYPE(WindowResized) 
 
+    /**
+     * Only the last resize in a frame matters, so earlier ones are dropped when coalescing.
+     */
+    static constexpr bool SUPERSEDES_PREVIOUS = true;
+
     WindowResizeEvent(int width, int height) : m_width(width), m_height(height) {}
 
     std::string to_string() const override { std::stringstream out_stream; out_stream << get_name() << ": Width=" << m_width << ", Height=" << m_height; return out_stream.str();}
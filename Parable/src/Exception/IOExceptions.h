@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Exception.h"
+
+namespace Parable
+{
+
+
+/**
+ * Thrown when a file cannot be opened or mapped.
+ */
+class FileOpenException : public Exception
+{
+public:
+    using Exception::Exception;
+};
+
+/**
+ * Thrown when a file's contents are not in the expected format.
+ */
+class FileFormatException : public Exception
+{
+public:
+    using Exception::Exception;
+};
+
+
+}
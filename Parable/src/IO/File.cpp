@@ -0,0 +1,169 @@
+#include "File.h"
+
+#include "Core/Base.h"
+
+#include "Exception/IOExceptions.h"
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+namespace Parable::IO
+{
+
+
+/**
+ * Open a file for reading.
+ * 
+ * @param path the file to open
+ * 
+ * @throws Parable::FileOpenException if the file cannot be opened
+ */
+File::File(const std::string& path) : m_path(path)
+{
+#if defined(PBL_PLATFORM_WINDOWS)
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        PBL_CORE_ERROR("Failed to open {}.", path);
+        throw FileOpenException("Failed to open file.");
+    }
+    m_handle = handle;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size))
+    {
+        close();
+        PBL_CORE_ERROR("Failed to get the size of {}.", path);
+        throw FileOpenException("Failed to get the size of a file.");
+    }
+    m_size = (uint64_t)size.QuadPart;
+#else
+    m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0)
+    {
+        PBL_CORE_ERROR("Failed to open {}.", path);
+        throw FileOpenException("Failed to open file.");
+    }
+
+    struct stat st;
+    if (fstat(m_fd, &st) != 0)
+    {
+        close();
+        PBL_CORE_ERROR("Failed to get the size of {}.", path);
+        throw FileOpenException("Failed to get the size of a file.");
+    }
+    m_size = (uint64_t)st.st_size;
+#endif
+}
+
+File::File(File&& other) :
+                    m_path(std::move(other.m_path)),
+                    m_size(std::exchange(other.m_size, 0)),
+#if defined(PBL_PLATFORM_WINDOWS)
+                    m_handle(std::exchange(other.m_handle, nullptr))
+#else
+                    m_fd(std::exchange(other.m_fd, -1))
+#endif
+{
+}
+
+File& File::operator=(File&& other)
+{
+    if (this == &other) return *this;
+
+    close();
+
+    m_path = std::move(other.m_path);
+    m_size = std::exchange(other.m_size, 0);
+#if defined(PBL_PLATFORM_WINDOWS)
+    m_handle = std::exchange(other.m_handle, nullptr);
+#else
+    m_fd = std::exchange(other.m_fd, -1);
+#endif
+
+    return *this;
+}
+
+File::~File()
+{
+    close();
+}
+
+bool File::is_open() const
+{
+#if defined(PBL_PLATFORM_WINDOWS)
+    return m_handle != nullptr;
+#else
+    return m_fd >= 0;
+#endif
+}
+
+void File::close()
+{
+#if defined(PBL_PLATFORM_WINDOWS)
+    if (m_handle != nullptr) CloseHandle(m_handle);
+    m_handle = nullptr;
+#else
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+}
+
+/**
+ * Read into a buffer from an offset, blocking until done.
+ * 
+ * Fills the whole buffer unless the end of the file is reached first.
+ * 
+ * @param buffer where to read to, its size is the number of bytes requested
+ * @param offset the position in the file to read from
+ */
+ReadResult File::read_at(std::span<std::byte> buffer, uint64_t offset) const
+{
+    ReadResult result;
+
+    while (result.bytes < buffer.size())
+    {
+        size_t remaining = buffer.size() - result.bytes;
+        uint64_t position = offset + result.bytes;
+
+#if defined(PBL_PLATFORM_WINDOWS)
+        OVERLAPPED overlapped {};
+        overlapped.Offset = (DWORD)position;
+        overlapped.OffsetHigh = (DWORD)(position >> 32);
+
+        DWORD read = 0;
+        DWORD to_read = (DWORD)std::min<size_t>(remaining, std::numeric_limits<DWORD>::max());
+        if (!ReadFile(m_handle, buffer.data() + result.bytes, to_read, &read, &overlapped))
+        {
+            DWORD error = GetLastError();
+            if (error == ERROR_HANDLE_EOF) break;
+            result.error = (int)error;
+            break;
+        }
+#else
+        ssize_t read = pread(m_fd, buffer.data() + result.bytes, remaining, (off_t)position);
+        if (read < 0)
+        {
+            if (errno == EINTR) continue;
+            result.error = errno;
+            break;
+        }
+#endif
+        // end of file
+        if (read == 0) break;
+
+        result.bytes += (size_t)read;
+    }
+
+    return result;
+}
+
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <span>
+
+namespace Parable::IO
+{
+
+
+/**
+ * The outcome of a single read.
+ */
+struct ReadResult
+{
+    /**
+     * Bytes read into the buffer, less than requested only at the end of the file.
+     */
+    size_t bytes = 0;
+    /**
+     * 0 on success, otherwise an errno value.
+     */
+    int error = 0;
+
+    bool ok() const { return error == 0; }
+};
+
+/**
+ * A file opened for reading at arbitrary offsets.
+ * 
+ * Holds only the OS handle; reads go through IOService for async access, or read_at to block.
+ */
+class File
+{
+public:
+    File() = default;
+    File(const std::string& path);
+    File(const File&) = delete;
+    File(File&& other);
+    ~File();
+
+    File& operator=(const File&) = delete;
+    File& operator=(File&& other);
+
+    ReadResult read_at(std::span<std::byte> buffer, uint64_t offset) const;
+
+    uint64_t size() const { return m_size; }
+    bool is_open() const;
+
+    const std::string& get_path() const { return m_path; }
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    void* get_handle() const { return m_handle; }
+#else
+    int get_fd() const { return m_fd; }
+#endif
+
+private:
+    void close();
+
+    std::string m_path;
+    uint64_t m_size = 0;
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    void* m_handle = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+
+}
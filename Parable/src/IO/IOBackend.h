@@ -0,0 +1,64 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <span>
+
+#include "File.h"
+
+namespace Parable::IO
+{
+
+
+using ReadCallback = std::function<void(const ReadResult&)>;
+
+/**
+ * A read queued with an IOBackend.
+ */
+struct ReadRequest
+{
+    const File* file = nullptr;
+    std::span<std::byte> buffer;
+    uint64_t offset = 0;
+    ReadCallback callback;
+};
+
+/**
+ * Interface for the OS mechanism which services an IOService's reads.
+ * 
+ * Only the thread owning the IOService calls into a backend.
+ */
+class IOBackend
+{
+public:
+    virtual ~IOBackend() = default;
+
+    /**
+     * Queue a read. It is not started until the next flush().
+     */
+    virtual void enqueue(ReadRequest&& request) = 0;
+    /**
+     * Start all the queued reads.
+     */
+    virtual void flush() = 0;
+    /**
+     * Run the callbacks of completed reads on the calling thread.
+     * 
+     * @param wait block until at least one read completes, the caller must ensure one is in flight
+     * 
+     * @return the number of reads completed
+     */
+    virtual size_t poll(bool wait) = 0;
+
+    /**
+     * Pin buffers which will be read into repeatedly, so the OS can skip mapping them per read.
+     * 
+     * Optional, backends which cannot use it ignore it.
+     */
+    virtual void register_buffers(std::span<const std::span<std::byte>> buffers) {}
+
+    virtual const char* get_name() const = 0;
+};
+
+
+}
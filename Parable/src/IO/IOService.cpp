@@ -0,0 +1,117 @@
+#include "IOService.h"
+
+#include "ThreadPoolBackend.h"
+#include "UringBackend.h"
+
+
+namespace Parable::IO
+{
+
+
+IOService::IOService(const IOServiceConfig& config)
+{
+    if (config.backend != IOBackendType::ThreadPool)
+    {
+        m_backend = UringBackend::create(config.queue_depth);
+        m_backend_type = IOBackendType::IoUring;
+
+        if (!m_backend && config.backend == IOBackendType::IoUring)
+        {
+            PBL_CORE_WARN("io_uring is not available, IOService falling back to a thread pool.");
+        }
+    }
+
+    if (!m_backend)
+    {
+        m_backend = std::make_unique<ThreadPoolBackend>(config.worker_threads);
+        m_backend_type = IOBackendType::ThreadPool;
+    }
+
+    PBL_CORE_TRACE("IOService using the {} backend.", m_backend->get_name());
+}
+
+IOService::~IOService()
+{
+    // in flight reads still write to their buffers and reference the backend
+    wait_all();
+}
+
+/**
+ * Queue a read, calling back when it completes.
+ * 
+ * @param file the file to read from, must stay open until the read completes
+ * @param buffer where to read to, its size is the number of bytes requested
+ * @param offset the position in the file to read from
+ * @param callback called from poll() or wait_all() with the result
+ */
+void IOService::read(const File& file, std::span<std::byte> buffer, uint64_t offset, ReadCallback callback)
+{
+    PBL_CORE_ASSERT_MSG(file.is_open(), "Reading from a file which is not open!")
+
+    ++m_in_flight;
+    m_backend->enqueue(ReadRequest{ &file, buffer, offset, std::move(callback) });
+}
+
+/**
+ * Queue a read, returning a future for its result.
+ * 
+ * The future is only made ready from poll() or wait_all(), so it must not be waited on
+ * by the thread which owns the service.
+ */
+std::future<ReadResult> IOService::read(const File& file, std::span<std::byte> buffer, uint64_t offset)
+{
+    auto promise = std::make_shared<std::promise<ReadResult>>();
+    std::future<ReadResult> future = promise->get_future();
+
+    read(file, buffer, offset, [promise](const ReadResult& result) { promise->set_value(result); });
+
+    return future;
+}
+
+/**
+ * Hand all queued reads to the OS.
+ */
+void IOService::submit()
+{
+    m_backend->flush();
+}
+
+/**
+ * Submit queued reads and run the callbacks of any which have completed, without blocking.
+ * 
+ * @return the number of reads completed
+ */
+size_t IOService::poll()
+{
+    size_t completed = m_backend->poll(false);
+    m_in_flight -= completed;
+    return completed;
+}
+
+/**
+ * Submit queued reads and block until every read has completed and called back.
+ * 
+ * Callbacks may queue more reads, which are also waited for.
+ */
+void IOService::wait_all()
+{
+    while (m_in_flight > 0)
+    {
+        m_in_flight -= m_backend->poll(true);
+    }
+}
+
+/**
+ * Register buffers which reads will land in repeatedly (e.g. staging memory).
+ * 
+ * Must be called with no reads in flight.
+ */
+void IOService::register_buffers(std::span<const std::span<std::byte>> buffers)
+{
+    PBL_CORE_ASSERT_MSG(m_in_flight == 0, "Registering IO buffers with reads in flight!")
+
+    m_backend->register_buffers(buffers);
+}
+
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <future>
+#include <span>
+
+#include "Core/Base.h"
+
+#include "File.h"
+#include "IOBackend.h"
+
+namespace Parable::IO
+{
+
+
+enum class IOBackendType
+{
+    /**
+     * io_uring where the kernel supports it, otherwise ThreadPool.
+     */
+    Auto,
+    /**
+     * Linux io_uring, falls back to ThreadPool if it cannot be set up.
+     */
+    IoUring,
+    /**
+     * Blocking reads on a pool of worker threads.
+     */
+    ThreadPool
+};
+
+struct IOServiceConfig
+{
+    IOBackendType backend = IOBackendType::Auto;
+    /**
+     * Reads in flight at once with io_uring; more are queued until completions free space.
+     */
+    uint32_t queue_depth = 256;
+    /**
+     * Worker threads for the ThreadPool backend.
+     */
+    uint32_t worker_threads = 2;
+};
+
+/**
+ * Asynchronous file reads into caller owned buffers.
+ * 
+ * Reads are batched: read() only queues, and the batch is handed to the OS in one go by
+ * submit() (or poll()/wait_all()). Completion callbacks and futures are only ever run from
+ * poll() and wait_all(), on the thread which owns the service, so callers need no locking.
+ * 
+ * Buffers must stay alive and untouched until their read completes.
+ */
+class IOService
+{
+public:
+    IOService(const IOServiceConfig& config = {});
+    IOService(const IOService&) = delete;
+    ~IOService();
+
+    IOService& operator=(const IOService&) = delete;
+
+    void read(const File& file, std::span<std::byte> buffer, uint64_t offset, ReadCallback callback);
+    std::future<ReadResult> read(const File& file, std::span<std::byte> buffer, uint64_t offset);
+
+    void submit();
+    size_t poll();
+    void wait_all();
+
+    void register_buffers(std::span<const std::span<std::byte>> buffers);
+
+    /**
+     * Number of reads which have been queued but whose callbacks have not run yet.
+     */
+    size_t get_in_flight() const { return m_in_flight; }
+    IOBackendType get_backend_type() const { return m_backend_type; }
+
+private:
+    UPtr<IOBackend> m_backend;
+    IOBackendType m_backend_type;
+
+    size_t m_in_flight = 0;
+};
+
+
+}
@@ -0,0 +1,96 @@
+#include "ThreadPoolBackend.h"
+
+#include "Core/Base.h"
+
+
+namespace Parable::IO
+{
+
+
+ThreadPoolBackend::ThreadPoolBackend(uint32_t num_threads)
+{
+    PBL_CORE_ASSERT_MSG(num_threads > 0, "ThreadPoolBackend needs at least one thread!")
+
+    m_threads.reserve(num_threads);
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        m_threads.emplace_back(&ThreadPoolBackend::worker, this);
+    }
+}
+
+ThreadPoolBackend::~ThreadPoolBackend()
+{
+    {
+        std::lock_guard lock(m_queue_mutex);
+        m_stopping = true;
+    }
+    m_queue_cv.notify_all();
+
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+void ThreadPoolBackend::enqueue(ReadRequest&& request)
+{
+    m_batch.push_back(std::move(request));
+}
+
+void ThreadPoolBackend::flush()
+{
+    if (m_batch.empty()) return;
+
+    {
+        std::lock_guard lock(m_queue_mutex);
+        for (ReadRequest& request : m_batch) m_queue.push_back(std::move(request));
+    }
+    m_batch.clear();
+
+    m_queue_cv.notify_all();
+}
+
+size_t ThreadPoolBackend::poll(bool wait)
+{
+    flush();
+
+    {
+        std::unique_lock lock(m_done_mutex);
+        if (wait) m_done_cv.wait(lock, [this] { return !m_done.empty(); });
+        std::swap(m_done, m_done_swap);
+    }
+
+    size_t completed = m_done_swap.size();
+    for (auto& [request, result] : m_done_swap)
+    {
+        if (request.callback) request.callback(result);
+    }
+    m_done_swap.clear();
+
+    return completed;
+}
+
+void ThreadPoolBackend::worker()
+{
+    while (true)
+    {
+        ReadRequest request;
+        {
+            std::unique_lock lock(m_queue_mutex);
+            m_queue_cv.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+
+            if (m_queue.empty()) return;
+
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        ReadResult result = request.file->read_at(request.buffer, request.offset);
+
+        {
+            std::lock_guard lock(m_done_mutex);
+            m_done.emplace_back(std::move(request), result);
+        }
+        m_done_cv.notify_one();
+    }
+}
+
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "IOBackend.h"
+
+namespace Parable::IO
+{
+
+
+/**
+ * IOBackend which runs blocking reads on worker threads.
+ * 
+ * Used where io_uring is unavailable (older kernels, sandboxes, other platforms).
+ */
+class ThreadPoolBackend : public IOBackend
+{
+public:
+    ThreadPoolBackend(uint32_t num_threads);
+    ~ThreadPoolBackend();
+
+    void enqueue(ReadRequest&& request) override;
+    void flush() override;
+    size_t poll(bool wait) override;
+
+    const char* get_name() const override { return "thread pool"; }
+
+private:
+    void worker();
+
+    std::vector<std::thread> m_threads;
+    bool m_stopping = false;
+
+    /**
+     * Reads queued since the last flush, only touched by the owning thread.
+     */
+    std::vector<ReadRequest> m_batch;
+
+    std::mutex m_queue_mutex;
+    std::condition_variable m_queue_cv;
+    std::deque<ReadRequest> m_queue;
+
+    std::mutex m_done_mutex;
+    std::condition_variable m_done_cv;
+    std::vector<std::pair<ReadRequest, ReadResult>> m_done;
+    /**
+     * Swapped with m_done on poll, so callbacks run without holding the lock.
+     */
+    std::vector<std::pair<ReadRequest, ReadResult>> m_done_swap;
+};
+
+
+}
@@ -0,0 +1,350 @@
+#include "UringBackend.h"
+
+#if defined(PBL_PLATFORM_LINUX)
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+namespace Parable::IO
+{
+
+
+static int io_uring_setup(uint32_t entries, io_uring_params* params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+static int io_uring_register(int fd, uint32_t opcode, const void* arg, uint32_t nr_args)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static uint32_t load_acquire(const uint32_t* p)
+{
+    return std::atomic_ref<const uint32_t>(*p).load(std::memory_order_acquire);
+}
+
+static void store_release(uint32_t* p, uint32_t value)
+{
+    std::atomic_ref<uint32_t>(*p).store(value, std::memory_order_release);
+}
+
+UPtr<IOBackend> UringBackend::create(uint32_t queue_depth)
+{
+    UPtr<UringBackend> backend(new UringBackend());
+    if (!backend->init(queue_depth)) return nullptr;
+    return backend;
+}
+
+/**
+ * Create the ring and map its queues.
+ * 
+ * @return false if io_uring is unavailable or lacks IORING_OP_READ (kernels before 5.6)
+ */
+bool UringBackend::init(uint32_t queue_depth)
+{
+    io_uring_params params {};
+    m_ring_fd = io_uring_setup(queue_depth, &params);
+    if (m_ring_fd < 0)
+    {
+        PBL_CORE_TRACE("io_uring_setup failed: {}", std::strerror(errno));
+        return false;
+    }
+
+    // check the read ops exist before committing to the ring
+    size_t probe_size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    std::vector<std::byte> probe_storage(probe_size);
+    io_uring_probe* probe = (io_uring_probe*)probe_storage.data();
+    if (io_uring_register(m_ring_fd, IORING_REGISTER_PROBE, probe, 256) < 0
+        || probe->last_op < IORING_OP_READ
+        || !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED))
+    {
+        PBL_CORE_TRACE("io_uring does not support IORING_OP_READ.");
+        return false;
+    }
+
+    m_sq_mapping_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    m_cq_mapping_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    bool single_mapping = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mapping) m_sq_mapping_size = m_cq_mapping_size = std::max(m_sq_mapping_size, m_cq_mapping_size);
+
+    m_sq_mapping = mmap(nullptr, m_sq_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING);
+    if (m_sq_mapping == MAP_FAILED)
+    {
+        m_sq_mapping = nullptr;
+        return false;
+    }
+
+    if (single_mapping)
+    {
+        m_cq_mapping = m_sq_mapping;
+    }
+    else
+    {
+        m_cq_mapping = mmap(nullptr, m_cq_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_CQ_RING);
+        if (m_cq_mapping == MAP_FAILED)
+        {
+            m_cq_mapping = nullptr;
+            return false;
+        }
+    }
+
+    m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    m_sqes = (io_uring_sqe*)sqes;
+
+    char* sq = (char*)m_sq_mapping;
+    m_sq_head = (uint32_t*)(sq + params.sq_off.head);
+    m_sq_tail = (uint32_t*)(sq + params.sq_off.tail);
+    m_sq_mask = *(uint32_t*)(sq + params.sq_off.ring_mask);
+    m_sq_entries = params.sq_entries;
+    m_sq_array = (uint32_t*)(sq + params.sq_off.array);
+
+    char* cq = (char*)m_cq_mapping;
+    m_cq_head = (uint32_t*)(cq + params.cq_off.head);
+    m_cq_tail = (uint32_t*)(cq + params.cq_off.tail);
+    m_cq_mask = *(uint32_t*)(cq + params.cq_off.ring_mask);
+    m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    // never have more in flight than the completion queue holds, so it cannot overflow
+    m_slots.resize(params.cq_entries);
+    m_free_slots.reserve(params.cq_entries);
+    for (uint32_t i = params.cq_entries; i > 0; --i) m_free_slots.push_back(i - 1);
+
+    return true;
+}
+
+UringBackend::~UringBackend()
+{
+    if (m_sqes != nullptr) munmap(m_sqes, m_sqes_size);
+    if (m_cq_mapping != nullptr && m_cq_mapping != m_sq_mapping) munmap(m_cq_mapping, m_cq_mapping_size);
+    if (m_sq_mapping != nullptr) munmap(m_sq_mapping, m_sq_mapping_size);
+    if (m_ring_fd >= 0) close(m_ring_fd);
+}
+
+void UringBackend::enqueue(ReadRequest&& request)
+{
+    PBL_CORE_ASSERT_MSG(request.buffer.size() <= std::numeric_limits<uint32_t>::max(), "io_uring reads are limited to 4GB!")
+
+    m_queued.push_back(std::move(request));
+}
+
+/**
+ * Write the submission entry for the remainder of a slot's read.
+ * 
+ * @return false if the submission queue is full
+ */
+bool UringBackend::push_submission(uint32_t slot)
+{
+    uint32_t tail = *m_sq_tail;
+    if (tail - load_acquire(m_sq_head) >= m_sq_entries) return false;
+
+    Slot& s = m_slots[slot];
+    std::byte* dst = s.request.buffer.data() + s.done;
+    size_t remaining = s.request.buffer.size() - s.done;
+
+    uint32_t index = tail & m_sq_mask;
+    io_uring_sqe& sqe = m_sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = s.request.file->get_fd();
+    sqe.addr = (uint64_t)(uintptr_t)dst;
+    sqe.len = (uint32_t)remaining;
+    sqe.off = s.request.offset + s.done;
+    sqe.user_data = slot;
+
+    for (size_t i = 0; i < m_registered.size(); ++i)
+    {
+        const std::span<std::byte>& r = m_registered[i];
+        if (dst >= r.data() && dst + remaining <= r.data() + r.size())
+        {
+            sqe.opcode = IORING_OP_READ_FIXED;
+            sqe.buf_index = (uint16_t)i;
+            break;
+        }
+    }
+
+    m_sq_array[index] = index;
+    store_release(m_sq_tail, tail + 1);
+    ++m_unsubmitted;
+
+    return true;
+}
+
+/**
+ * Pass the written submission entries to the kernel.
+ * 
+ * @param min_complete block until this many completions are available
+ */
+void UringBackend::submit_pending(uint32_t min_complete)
+{
+    uint32_t flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    while (true)
+    {
+        int ret = io_uring_enter(m_ring_fd, m_unsubmitted, min_complete, flags);
+        if (ret >= 0)
+        {
+            m_unsubmitted -= (uint32_t)ret;
+            return;
+        }
+        if (errno == EINTR) continue;
+        // the kernel is short of resources, completions will free some
+        if (errno == EAGAIN || errno == EBUSY) return;
+
+        PBL_CORE_ERROR("io_uring_enter failed: {}", std::strerror(errno));
+        return;
+    }
+}
+
+void UringBackend::flush()
+{
+    while (!m_resubmit.empty())
+    {
+        if (!push_submission(m_resubmit.back()))
+        {
+            // make room by handing the full queue to the kernel
+            submit_pending(0);
+            if (!push_submission(m_resubmit.back())) break;
+        }
+        m_resubmit.pop_back();
+    }
+
+    while (!m_queued.empty() && !m_free_slots.empty())
+    {
+        uint32_t slot = m_free_slots.back();
+        m_slots[slot] = Slot{ std::move(m_queued.front()), 0 };
+        m_queued.pop_front();
+
+        if (!push_submission(slot))
+        {
+            submit_pending(0);
+            if (!push_submission(slot))
+            {
+                m_queued.push_front(std::move(m_slots[slot].request));
+                break;
+            }
+        }
+
+        m_free_slots.pop_back();
+    }
+
+    if (m_unsubmitted > 0) submit_pending(0);
+}
+
+/**
+ * Consume the completion queue, continuing short reads and calling back finished ones.
+ * 
+ * @return the number of reads finished
+ */
+size_t UringBackend::reap()
+{
+    uint32_t head = *m_cq_head;
+    uint32_t tail = load_acquire(m_cq_tail);
+
+    std::vector<std::pair<ReadRequest, ReadResult>> finished;
+
+    for (; head != tail; ++head)
+    {
+        const io_uring_cqe& cqe = m_cqes[head & m_cq_mask];
+        uint32_t slot = (uint32_t)cqe.user_data;
+        Slot& s = m_slots[slot];
+
+        ReadResult result { s.done, 0 };
+        if (cqe.res < 0)
+        {
+            result.error = -cqe.res;
+        }
+        else
+        {
+            s.done += (size_t)cqe.res;
+            result.bytes = s.done;
+
+            // short read which did not hit the end of the file
+            if (cqe.res > 0 && s.done < s.request.buffer.size())
+            {
+                m_resubmit.push_back(slot);
+                continue;
+            }
+        }
+
+        finished.emplace_back(std::move(s.request), result);
+        m_free_slots.push_back(slot);
+    }
+
+    store_release(m_cq_head, head);
+
+    // callbacks may queue more reads, so run them once the queue state is consistent
+    for (auto& [request, result] : finished)
+    {
+        if (request.callback) request.callback(result);
+    }
+
+    return finished.size();
+}
+
+size_t UringBackend::poll(bool wait)
+{
+    flush();
+
+    size_t completed = reap();
+    while (wait && completed == 0)
+    {
+        // reaping may have queued the rest of a short read
+        flush();
+
+        // with no reads in slots nothing can complete, so waiting would never return
+        if (m_free_slots.size() == m_slots.size()) return 0;
+
+        // hand over anything still in the submission queue before waiting on it
+        if (m_unsubmitted > 0) submit_pending(0);
+        submit_pending(1);
+        completed = reap();
+    }
+
+    return completed;
+}
+
+void UringBackend::register_buffers(std::span<const std::span<std::byte>> buffers)
+{
+    if (!m_registered.empty())
+    {
+        io_uring_register(m_ring_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        m_registered.clear();
+    }
+
+    if (buffers.empty()) return;
+
+    std::vector<iovec> iovecs;
+    iovecs.reserve(buffers.size());
+    for (const std::span<std::byte>& buffer : buffers) iovecs.push_back(iovec{ buffer.data(), buffer.size() });
+
+    if (io_uring_register(m_ring_fd, IORING_REGISTER_BUFFERS, iovecs.data(), (uint32_t)iovecs.size()) < 0)
+    {
+        // usually RLIMIT_MEMLOCK, reads still work without registration
+        PBL_CORE_WARN("Failed to register io_uring buffers: {}", std::strerror(errno));
+        return;
+    }
+
+    m_registered.assign(buffers.begin(), buffers.end());
+}
+
+
+}
+
+#endif
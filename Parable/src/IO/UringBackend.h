@@ -0,0 +1,123 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <deque>
+
+#include "Core/Base.h"
+
+#include "IOBackend.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace Parable::IO
+{
+
+
+#if defined(PBL_PLATFORM_LINUX)
+
+/**
+ * IOBackend on Linux io_uring, driven through the raw syscalls.
+ * 
+ * A flush fills one submission queue entry per read and submits the whole batch with a
+ * single io_uring_enter. At most one completion queue's worth of reads are in flight;
+ * the rest wait in a queue until completions free a slot.
+ * 
+ * Reads into registered buffers use IORING_OP_READ_FIXED, which skips pinning the
+ * destination pages for each read.
+ */
+class UringBackend : public IOBackend
+{
+public:
+    /**
+     * Set up a ring, or return nullptr if the kernel does not support io_uring (or it is disabled).
+     */
+    static UPtr<IOBackend> create(uint32_t queue_depth);
+
+    UringBackend(const UringBackend&) = delete;
+    ~UringBackend();
+
+    UringBackend& operator=(const UringBackend&) = delete;
+
+    void enqueue(ReadRequest&& request) override;
+    void flush() override;
+    size_t poll(bool wait) override;
+
+    void register_buffers(std::span<const std::span<std::byte>> buffers) override;
+
+    const char* get_name() const override { return "io_uring"; }
+
+private:
+    /**
+     * A read occupying a submission, indexed by the user_data of its entries.
+     */
+    struct Slot
+    {
+        ReadRequest request;
+        /**
+         * Bytes read so far, short reads are resubmitted for the remainder.
+         */
+        size_t done = 0;
+    };
+
+    UringBackend() = default;
+
+    bool init(uint32_t queue_depth);
+
+    bool push_submission(uint32_t slot);
+    void submit_pending(uint32_t min_complete);
+    size_t reap();
+
+    int m_ring_fd = -1;
+
+    void* m_sq_mapping = nullptr;
+    size_t m_sq_mapping_size = 0;
+    void* m_cq_mapping = nullptr;
+    size_t m_cq_mapping_size = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    size_t m_sqes_size = 0;
+
+    uint32_t* m_sq_head = nullptr;
+    uint32_t* m_sq_tail = nullptr;
+    uint32_t m_sq_mask = 0;
+    uint32_t m_sq_entries = 0;
+    uint32_t* m_sq_array = nullptr;
+
+    uint32_t* m_cq_head = nullptr;
+    uint32_t* m_cq_tail = nullptr;
+    uint32_t m_cq_mask = 0;
+    io_uring_cqe* m_cqes = nullptr;
+
+    /**
+     * Entries written to the submission queue but not yet passed to io_uring_enter.
+     */
+    uint32_t m_unsubmitted = 0;
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_free_slots;
+    /**
+     * Slots with a short read to continue, submitted ahead of new reads.
+     */
+    std::vector<uint32_t> m_resubmit;
+
+    std::deque<ReadRequest> m_queued;
+
+    std::vector<std::span<std::byte>> m_registered;
+};
+
+#else
+
+/**
+ * io_uring is Linux only, so elsewhere IOService always uses the thread pool.
+ */
+class UringBackend
+{
+public:
+    static UPtr<IOBackend> create(uint32_t queue_depth) { return nullptr; }
+};
+
+#endif
+
+
+}
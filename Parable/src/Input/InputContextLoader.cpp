@@ -1,13 +1,12 @@
 
-// TEMP : remove when implementing new filesystem stuff
-#include <fstream>
-
 #include "Input/InputContextLoader.h"
 
 #include "Input/ButtonMap.h"
 
 #include "Input/InputContext.h"
 
+#include "Util/MappedFile.h"
+
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
 
@@ -21,14 +20,12 @@ namespace Parable::Input
  */
 InputContext InputContextLoader::load_context()
 {
-    std::ifstream t(m_file);
-    std::stringstream ss;
-    ss << t.rdbuf();
-    std::string json_string (std::move(ss.str()));
-    char* json_chars = const_cast<char*>(json_string.c_str());
+    Util::MappedFile file(m_file, Util::AccessHint::WillNeed);
+    std::string_view json = file.chars();
 
+    // parse straight from the mapping, strings are copied into the document
     rapidjson::Document document;
-    document.ParseInsitu(json_chars);
+    document.Parse(json.data(), json.size());
     PBL_ASSERT_MSG(!document.HasParseError(), "Error '{}' parsing {}!", GetParseError_En(document.GetParseError()), m_file)
 
     PBL_ASSERT_MSG(document.IsObject(), "JSON root is not an object while parsing {} for input context.", m_file)
@@ -10,9 +10,9 @@ void InputLayer::on_update()
     m_input_manager.on_update();
 }
 
-void InputLayer::on_event(Event* e)
+void InputLayer::on_subscribe(EventRouter& router)
 {
-    m_input_manager.on_event(e);
+    m_input_manager.subscribe(router);
 }
 
 
@@ -19,7 +19,7 @@ public:
     InputLayer() : Layer("InputLayer"), m_input_manager() {}
 
     void on_update() override;
-    void on_event(Event* e) override;
+    void on_subscribe(EventRouter& router) override;
 
 private:
     InputManager m_input_manager;
@@ -31,19 +31,18 @@ void InputManager::on_update()
     m_input_state.mouse_position_delta.x = 0; m_input_state.mouse_position_delta.y = 0;
 }
 
-void InputManager::on_event(Event* e)
+void InputManager::subscribe(EventRouter& router)
 {
-    EventDispatcher dispatcher (e);
-    dispatcher.dispatch<KeyPressedEvent>(PBL_BIND_MEMBER_EVENT_HANDLER(InputManager::key_pressed));
-    dispatcher.dispatch<KeyReleasedEvent>(PBL_BIND_MEMBER_EVENT_HANDLER(InputManager::key_released));
-    dispatcher.dispatch<MouseBtnPressedEvent>(PBL_BIND_MEMBER_EVENT_HANDLER(InputManager::mouse_btn_pressed));
-    dispatcher.dispatch<MouseBtnReleasedEvent>(PBL_BIND_MEMBER_EVENT_HANDLER(InputManager::mouse_btn_released));
+    router.subscribe<&InputManager::key_pressed>(this);
+    router.subscribe<&InputManager::key_released>(this);
+    router.subscribe<&InputManager::mouse_btn_pressed>(this);
+    router.subscribe<&InputManager::mouse_btn_released>(this);
 }
 
 /**
  * Passes key pressed event to contexts and modifies polling state.
  *
- * Binds to event dispatcher.
+ * Subscribed to the event router.
  */
 bool InputManager::key_pressed(KeyPressedEvent& e)
 {
@@ -57,7 +56,7 @@ bool InputManager::key_pressed(KeyPressedEvent& e)
 /**
  * Passes key released event to contexts and modifies polling state.
  *
- * Binds to event dispatcher.
+ * Subscribed to the event router.
  */
 bool InputManager::key_released(KeyReleasedEvent& e)
 {
@@ -70,7 +69,7 @@ bool InputManager::key_released(KeyReleasedEvent& e)
 /**
  * Passes mouse button pressed event to contexts and modifies polling state.
  *
- * Binds to event dispatcher.
+ * Subscribed to the event router.
  */
 bool InputManager::mouse_btn_pressed(MouseBtnPressedEvent& e)
 {
@@ -84,7 +83,7 @@ bool InputManager::mouse_btn_pressed(MouseBtnPressedEvent& e)
 /**
  * Passes mouse button released event to contexts and modifies polling state.
  *
- * Binds to event dispatcher.
+ * Subscribed to the event router.
  */
 bool InputManager::mouse_btn_released(MouseBtnReleasedEvent& e)
 {
@@ -97,7 +96,7 @@ bool InputManager::mouse_btn_released(MouseBtnReleasedEvent& e)
 /**
  * Passes scroll event to contexts and modifies polling state.
  *
- * Binds to event dispatcher.
+ * Subscribed to the event router.
  */
 bool InputManager::mouse_scrolled(MouseScrolledEvent& e)
 {
@@ -123,7 +122,7 @@ bool InputManager::mouse_scrolled(MouseScrolledEvent& e)
 /**
  * Passes mouse moved event to contexts and modifies polling state.
  *
- * Binds to event dispatcher.
+ * Subscribed to the event router.
  */
 bool InputManager::mouse_moved(MouseMovedEvent& e)
 {
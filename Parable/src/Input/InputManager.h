@@ -4,6 +4,7 @@
 
 #include "Core/Base.h"
 #include "Events/InputEvent.h"
+#include "Events/EventRouter.h"
 #include "Input/InputCodes.h"
 #include "Input/InputContext.h"
 
@@ -48,7 +49,7 @@ public:
     ~InputManager() { s_instance = nullptr; }
 
     void on_update();
-    void on_event(Event* e);
+    void subscribe(EventRouter& router);
 
     bool is_key_down(KeyCode key) { return m_input_state.key_down[(int)key]; }
     bool is_key_pressed(KeyCode key) { return m_input_state.key_pressed[(int)key]; }
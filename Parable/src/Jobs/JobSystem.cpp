@@ -0,0 +1,116 @@
+#include "JobSystem.h"
+
+#include "Core/Base.h"
+
+
+namespace Parable
+{
+
+
+/**
+ * @param num_threads worker threads to start, 0 for one per hardware thread besides the caller's
+ */
+JobSystem::JobSystem(uint32_t num_threads)
+{
+    if (num_threads == 0) num_threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    m_threads.reserve(num_threads);
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        m_threads.emplace_back(&JobSystem::worker, this);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard lock(m_queue_mutex);
+        m_stopping = true;
+    }
+    m_queue_cv.notify_all();
+
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+/**
+ * Queue a job, counted by a counter which must outlive it.
+ */
+void JobSystem::run(Job job, JobCounter& counter)
+{
+    counter.m_remaining.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard lock(m_queue_mutex);
+        m_queue.push_back({ std::move(job), &counter });
+    }
+    m_queue_cv.notify_one();
+}
+
+/**
+ * Block until every job counted by a counter has finished, running queued jobs meanwhile.
+ */
+void JobSystem::wait(JobCounter& counter)
+{
+    while (!counter.is_done())
+    {
+        if (try_run_one()) continue;
+
+        // nothing left to help with, so the rest are running on workers
+        std::unique_lock lock(m_done_mutex);
+        m_done_cv.wait(lock, [&counter] { return counter.is_done(); });
+    }
+}
+
+bool JobSystem::try_run_one()
+{
+    QueuedJob queued;
+    {
+        std::lock_guard lock(m_queue_mutex);
+        if (m_queue.empty()) return false;
+
+        queued = std::move(m_queue.front());
+        m_queue.pop_front();
+    }
+
+    queued.job();
+    finish(*queued.counter);
+
+    return true;
+}
+
+void JobSystem::worker()
+{
+    while (true)
+    {
+        QueuedJob queued;
+        {
+            std::unique_lock lock(m_queue_mutex);
+            m_queue_cv.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+
+            if (m_queue.empty()) return;
+
+            queued = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        queued.job();
+        finish(*queued.counter);
+    }
+}
+
+/**
+ * Count a job as finished, waking waiters if it was the last of its batch.
+ *
+ * The counter is not touched after the decrement, as a waiter may return and destroy it.
+ */
+void JobSystem::finish(JobCounter& counter)
+{
+    if (counter.m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    // taking the lock orders this with a waiter checking the counter, so the wake is not lost
+    std::lock_guard lock(m_done_mutex);
+    m_done_cv.notify_all();
+}
+
+
+}
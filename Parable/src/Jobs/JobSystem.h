@@ -0,0 +1,119 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Parable
+{
+
+
+/**
+ * Counts the jobs of a batch which have not finished, so the batch can be waited on.
+ */
+class JobCounter
+{
+public:
+    bool is_done() const { return m_remaining.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_remaining = 0;
+};
+
+/**
+ * A pool of worker threads running short CPU jobs, like decompressing or decoding asset data.
+ *
+ * A thread waiting on a counter runs queued jobs itself until its batch finishes, so waiting
+ * from inside a job does not starve the pool.
+ *
+ * Jobs must not throw; catch inside the job and report through captured state.
+ */
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+
+    JobSystem(uint32_t num_threads = 0);
+    JobSystem(const JobSystem&) = delete;
+    ~JobSystem();
+
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void run(Job job, JobCounter& counter);
+    void wait(JobCounter& counter);
+
+    /**
+     * Call fn(i) for each i in [0, count) across the pool, returning once all calls finish.
+     *
+     * The calling thread runs the first index, so a count of 1 never touches the queue.
+     *
+     * Unlike plain jobs fn may throw: every call still runs to completion before the first
+     * exception is rethrown on the calling thread, as the jobs reference this stack frame.
+     */
+    template<class Fn>
+    void parallel_for(size_t count, Fn&& fn)
+    {
+        if (count == 0) return;
+
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        auto call = [&fn, &error_mutex, &error](size_t i)
+        {
+            try
+            {
+                fn(i);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+        };
+
+        JobCounter counter;
+        for (size_t i = 1; i < count; ++i)
+        {
+            run([&call, i]() { call(i); }, counter);
+        }
+
+        call((size_t)0);
+        wait(counter);
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    uint32_t get_thread_count() const { return (uint32_t)m_threads.size(); }
+
+private:
+    struct QueuedJob
+    {
+        Job job;
+        JobCounter* counter;
+    };
+
+    bool try_run_one();
+    void worker();
+
+    void finish(JobCounter& counter);
+
+    std::vector<std::thread> m_threads;
+    bool m_stopping = false;
+
+    std::mutex m_queue_mutex;
+    std::condition_variable m_queue_cv;
+    std::deque<QueuedJob> m_queue;
+
+    std::mutex m_done_mutex;
+    std::condition_variable m_done_cv;
+};
+
+
+}
@@ -3,6 +3,8 @@
 #include "pblpch.h"
 #include "Core/Base.h"
 
+#include "MemoryTracker.h"
+
 namespace Parable
 {
 
@@ -10,13 +12,27 @@ namespace Parable
 /**
  * Base interface for custom engine allocators.
  * 
+ * Each allocator has a name and optionally a parent allocator it takes its memory from.
+ * The name is used as the MemoryTracker tag when PBL_MEMORY_TRACKING is defined;
+ * unnamed allocators report into their parents tag. A child tag's bytes are a breakdown
+ * of the block already counted against its parent, not additional memory.
+ * 
  */
 class Allocator
 {
 public:
-    Allocator(size_t size, void* start) : m_size(size), m_start(start)
+    Allocator(size_t size, void* start, const std::string& name = "", Allocator* parent = nullptr) :
+                                                                                m_size(size),
+                                                                                m_start(start),
+                                                                                m_name(name),
+                                                                                m_parent(parent)
     {
         PBL_CORE_ASSERT_MSG(start != nullptr, "Cannot have an allocator start at null!");
+
+#ifdef PBL_MEMORY_TRACKING
+        MemoryTag parent_tag = parent ? parent->get_tag() : MemoryTracker::ROOT_TAG;
+        m_tag = name.empty() ? parent_tag : MemoryTracker::register_tag(name, parent_tag);
+#endif
     }
     virtual ~Allocator() {}
 
@@ -34,7 +50,44 @@ public:
     size_t get_used() { return m_used; }
     size_t get_allocations() { return m_allocations; }
 
+    const std::string& get_name() const { return m_name; }
+    Allocator* get_parent() const { return m_parent; }
+    MemoryTag get_tag() const { return m_tag; }
+
 protected:
+    /**
+     * Report bytes taken from this allocator to the MemoryTracker.
+     * 
+     * No-op unless PBL_MEMORY_TRACKING is defined.
+     */
+    void track_allocation(size_t size)
+    {
+#ifdef PBL_MEMORY_TRACKING
+        MemoryTracker::record_allocation(m_tag, size);
+#endif
+    }
+
+    /**
+     * Report bytes returned to this allocator to the MemoryTracker.
+     */
+    void track_deallocation(size_t size)
+    {
+#ifdef PBL_MEMORY_TRACKING
+        MemoryTracker::record_deallocation(m_tag, size);
+#endif
+    }
+
+    /**
+     * Report an allocation this allocator could not satisfy.
+     */
+    void track_failed_allocation(size_t size)
+    {
+#ifdef PBL_MEMORY_TRACKING
+        MemoryTracker::record_failed_allocation(m_tag, size);
+#endif
+    }
+
+
     /**
      * The size in bytes of the allocation.
      */
@@ -51,6 +104,18 @@ protected:
      * The number of allocations made.
      */
     size_t m_allocations = 0;
+    /**
+     * Name of the allocator, used as its memory tag.
+     */
+    std::string m_name;
+    /**
+     * The allocator this one takes its memory from, if any.
+     */
+    Allocator* m_parent;
+    /**
+     * Tag this allocator reports to the MemoryTracker under.
+     */
+    MemoryTag m_tag = MemoryTracker::ROOT_TAG;
 };
 
 
@@ -5,8 +5,8 @@ namespace Parable
 {
 
 
-LinearAllocator::LinearAllocator(size_t size, void* start) :
-                                                    Allocator(size, start),
+LinearAllocator::LinearAllocator(size_t size, void* start, const std::string& name, Allocator* parent) :
+                                                    Allocator(size, start, name, parent),
                                                     m_free_start(start)
                                                     { PBL_CORE_ASSERT_MSG(size > 0, "LinearAllocator given size of 0!") }
 
@@ -34,9 +34,17 @@ void* LinearAllocator::allocate(size_t size, size_t alignment)
     if (std::align(alignment, size, aligned_free, free_size_after_alignment))
     {
         // add the alignment padding + alloc size to used, move the free ptr to the aligned addr + alloc size
-        m_used += (free_size - free_size_after_alignment) + size;
+        size_t used = (free_size - free_size_after_alignment) + size;
+        m_used += used;
         m_free_start = (void*)((uintptr_t)aligned_free + size);
         ++m_allocations;
+
+        track_allocation(used);
+    }
+    else
+    {
+        aligned_free = nullptr;
+        track_failed_allocation(size);
     }
 
     return aligned_free;
@@ -56,6 +64,8 @@ void LinearAllocator::deallocate(void* p)
  */
 void LinearAllocator::clear()
 {
+    if (m_used > 0) track_deallocation(m_used);
+
     m_used = 0;
     m_allocations = 0;
     m_free_start = m_start;
@@ -14,7 +14,7 @@ namespace Parable
 class LinearAllocator : public Allocator
 {
 public:
-    LinearAllocator(size_t size, void* start);
+    LinearAllocator(size_t size, void* start, const std::string& name = "", Allocator* parent = nullptr);
     ~LinearAllocator();
 
     void* allocate(size_t size, size_t alignment) override; 
@@ -0,0 +1,369 @@
+#include "MemoryTracker.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <fstream>
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+
+namespace Parable
+{
+
+
+/**
+ * Counters for one tag on one thread.
+ *
+ * Only the owning thread writes, so relaxed load/store is enough; the atomics
+ * exist so snapshot() can read them from another thread.
+ *
+ */
+struct TagCounters
+{
+    std::atomic<int64_t> current_bytes{0};
+    std::atomic<int64_t> peak_bytes{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> failed_allocations{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::array<std::atomic<uint64_t>, MemoryTagStats::NUM_SIZE_BUCKETS> size_histogram = {};
+};
+
+/**
+ * Increment a counter owned by the calling thread.
+ */
+template<class T>
+static inline void bump(std::atomic<T>& counter, T amount)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * A threads counters for every tag.
+ *
+ */
+struct ThreadCounters
+{
+    ThreadCounters();
+    ~ThreadCounters();
+
+    std::array<TagCounters, MemoryTracker::MAX_TAGS> tags;
+};
+
+namespace
+{
+    struct TagInfo
+    {
+        std::string name;
+        MemoryTag parent;
+    };
+
+    struct RateSample
+    {
+        uint64_t allocations = 0;
+        uint64_t bytes_allocated = 0;
+    };
+
+    /**
+     * Shared tracker state, guarded by mutex.
+     *
+     */
+    struct TrackerState
+    {
+        std::mutex mutex;
+
+        std::vector<TagInfo> tags = { { "root", MemoryTracker::ROOT_TAG } };
+
+        /**
+         * Counter blocks of live threads.
+         */
+        std::vector<ThreadCounters*> threads;
+
+        /**
+         * Totals folded in from threads which have exited.
+         */
+        std::array<MemoryTagStats, MemoryTracker::MAX_TAGS> retired = {};
+
+        /**
+         * Peaks observed by previous snapshots.
+         */
+        std::array<int64_t, MemoryTracker::MAX_TAGS> peaks = {};
+
+        std::array<RateSample, MemoryTracker::MAX_TAGS> last_sample = {};
+        double last_sample_time = 0.0;
+
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    };
+
+    TrackerState& get_state()
+    {
+        static TrackerState state;
+        return state;
+    }
+}
+
+ThreadCounters::ThreadCounters()
+{
+    TrackerState& state = get_state();
+    std::lock_guard lock(state.mutex);
+    state.threads.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters()
+{
+    TrackerState& state = get_state();
+    std::lock_guard lock(state.mutex);
+
+    // fold this threads totals into the retired block so they survive the thread
+    for (size_t i = 0; i < MemoryTracker::MAX_TAGS; ++i)
+    {
+        TagCounters& counters = tags[i];
+        MemoryTagStats& retired = state.retired[i];
+
+        retired.current_bytes += counters.current_bytes.load(std::memory_order_relaxed);
+        retired.peak_bytes = std::max(retired.peak_bytes, counters.peak_bytes.load(std::memory_order_relaxed));
+        retired.allocations += counters.allocations.load(std::memory_order_relaxed);
+        retired.deallocations += counters.deallocations.load(std::memory_order_relaxed);
+        retired.failed_allocations += counters.failed_allocations.load(std::memory_order_relaxed);
+        retired.bytes_allocated += counters.bytes_allocated.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < MemoryTagStats::NUM_SIZE_BUCKETS; ++b)
+        {
+            retired.size_histogram[b] += counters.size_histogram[b].load(std::memory_order_relaxed);
+        }
+    }
+
+    state.threads.erase(std::find(state.threads.begin(), state.threads.end(), this));
+}
+
+static ThreadCounters& get_thread_counters()
+{
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+/**
+ * Register a named tag.
+ *
+ * Registering a name which already exists returns the existing tag, so allocators
+ * of the same subsystem accumulate into one tag.
+ *
+ * @param name the name of the tag
+ * @param parent the parent tag, for grouping subsystems
+ * @return MemoryTag the tag id
+ */
+MemoryTag MemoryTracker::register_tag(const std::string& name, MemoryTag parent)
+{
+    TrackerState& state = get_state();
+    std::lock_guard lock(state.mutex);
+
+    for (size_t i = 0; i < state.tags.size(); ++i)
+    {
+        if (state.tags[i].name == name) return (MemoryTag)i;
+    }
+
+    PBL_CORE_ASSERT_MSG(parent < state.tags.size(), "Memory tag parent {} is not registered.", parent)
+
+    if (state.tags.size() >= MAX_TAGS)
+    {
+        PBL_CORE_WARN("Out of memory tags, '{}' will be tracked under root.", name);
+        return ROOT_TAG;
+    }
+
+    state.tags.push_back({ name, parent });
+    return (MemoryTag)(state.tags.size() - 1);
+}
+
+std::string MemoryTracker::get_tag_name(MemoryTag tag)
+{
+    TrackerState& state = get_state();
+    std::lock_guard lock(state.mutex);
+    return state.tags.at(tag).name;
+}
+
+MemoryTag MemoryTracker::get_tag_parent(MemoryTag tag)
+{
+    TrackerState& state = get_state();
+    std::lock_guard lock(state.mutex);
+    return state.tags.at(tag).parent;
+}
+
+void MemoryTracker::record_allocation(MemoryTag tag, size_t size)
+{
+    TagCounters& counters = get_thread_counters().tags[tag];
+
+    bump(counters.allocations, (uint64_t)1);
+    bump(counters.bytes_allocated, (uint64_t)size);
+    bump(counters.size_histogram[size_bucket(size)], (uint64_t)1);
+
+    int64_t current = counters.current_bytes.load(std::memory_order_relaxed) + (int64_t)size;
+    counters.current_bytes.store(current, std::memory_order_relaxed);
+    if (current > counters.peak_bytes.load(std::memory_order_relaxed))
+    {
+        counters.peak_bytes.store(current, std::memory_order_relaxed);
+    }
+}
+
+void MemoryTracker::record_deallocation(MemoryTag tag, size_t size)
+{
+    TagCounters& counters = get_thread_counters().tags[tag];
+
+    bump(counters.deallocations, (uint64_t)1);
+    bump(counters.current_bytes, -(int64_t)size);
+}
+
+/**
+ * Record an allocation that could not be satisfied.
+ *
+ * Logs the tag so an OOM can be attributed to the subsystem which caused it.
+ *
+ * @param tag the tag of the failing allocator
+ * @param size the requested size
+ */
+void MemoryTracker::record_failed_allocation(MemoryTag tag, size_t size)
+{
+    bump(get_thread_counters().tags[tag].failed_allocations, (uint64_t)1);
+
+    PBL_CORE_ERROR("Allocation of {} bytes failed in memory tag '{}'.", size, get_tag_name(tag));
+}
+
+/**
+ * Merge the counters of every thread into a snapshot.
+ *
+ * Rates are computed against the previous call to snapshot().
+ *
+ * @return MemorySnapshot the merged statistics of all registered tags
+ */
+MemorySnapshot MemoryTracker::snapshot()
+{
+    TrackerState& state = get_state();
+    std::lock_guard lock(state.mutex);
+
+    MemorySnapshot snapshot;
+    snapshot.timestamp = std::chrono::duration<double>(std::chrono::steady_clock::now() - state.start_time).count();
+
+    double elapsed = snapshot.timestamp - state.last_sample_time;
+    state.last_sample_time = snapshot.timestamp;
+
+    snapshot.tags.reserve(state.tags.size());
+    for (size_t i = 0; i < state.tags.size(); ++i)
+    {
+        MemoryTagStats stats = state.retired[i];
+        stats.name = state.tags[i].name;
+        stats.tag = (MemoryTag)i;
+        stats.parent = state.tags[i].parent;
+
+        for (ThreadCounters* thread : state.threads)
+        {
+            TagCounters& counters = thread->tags[i];
+
+            stats.current_bytes += counters.current_bytes.load(std::memory_order_relaxed);
+            stats.peak_bytes = std::max(stats.peak_bytes, counters.peak_bytes.load(std::memory_order_relaxed));
+            stats.allocations += counters.allocations.load(std::memory_order_relaxed);
+            stats.deallocations += counters.deallocations.load(std::memory_order_relaxed);
+            stats.failed_allocations += counters.failed_allocations.load(std::memory_order_relaxed);
+            stats.bytes_allocated += counters.bytes_allocated.load(std::memory_order_relaxed);
+            for (size_t b = 0; b < MemoryTagStats::NUM_SIZE_BUCKETS; ++b)
+            {
+                stats.size_histogram[b] += counters.size_histogram[b].load(std::memory_order_relaxed);
+            }
+        }
+
+        // a tag used by several threads can have a merged current above any single thread peak
+        state.peaks[i] = std::max({ state.peaks[i], stats.peak_bytes, stats.current_bytes });
+        stats.peak_bytes = state.peaks[i];
+
+        RateSample& last = state.last_sample[i];
+        if (elapsed > 0.0)
+        {
+            stats.allocation_rate = (double)(stats.allocations - last.allocations) / elapsed;
+            stats.byte_rate = (double)(stats.bytes_allocated - last.bytes_allocated) / elapsed;
+        }
+        last.allocations = stats.allocations;
+        last.bytes_allocated = stats.bytes_allocated;
+
+        snapshot.tags.push_back(std::move(stats));
+    }
+
+    return snapshot;
+}
+
+/**
+ * Serialise the snapshot as JSON.
+ *
+ * @return std::string the JSON document
+ */
+std::string MemorySnapshot::to_json() const
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    writer.StartObject();
+
+    writer.Key("timestamp");
+    writer.Double(timestamp);
+
+    writer.Key("tags");
+    writer.StartArray();
+    for (const MemoryTagStats& stats : tags)
+    {
+        writer.StartObject();
+
+        writer.Key("name");
+        writer.String(stats.name.c_str(), (rapidjson::SizeType)stats.name.size());
+        writer.Key("parent");
+        writer.Uint(stats.parent);
+        writer.Key("current_bytes");
+        writer.Int64(stats.current_bytes);
+        writer.Key("peak_bytes");
+        writer.Int64(stats.peak_bytes);
+        writer.Key("allocations");
+        writer.Uint64(stats.allocations);
+        writer.Key("deallocations");
+        writer.Uint64(stats.deallocations);
+        writer.Key("failed_allocations");
+        writer.Uint64(stats.failed_allocations);
+        writer.Key("bytes_allocated");
+        writer.Uint64(stats.bytes_allocated);
+        writer.Key("allocation_rate");
+        writer.Double(stats.allocation_rate);
+        writer.Key("byte_rate");
+        writer.Double(stats.byte_rate);
+
+        writer.Key("size_histogram");
+        writer.StartArray();
+        for (uint64_t count : stats.size_histogram)
+        {
+            writer.Uint64(count);
+        }
+        writer.EndArray();
+
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+/**
+ * Take a snapshot and write it to a file as JSON.
+ *
+ * @param path the file to write
+ */
+void MemoryTracker::dump_json(const std::string& path)
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+    {
+        PBL_CORE_ERROR("Could not open '{}' to dump memory snapshot.", path);
+        return;
+    }
+
+    file << snapshot().to_json();
+}
+
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "pblpch.h"
+#include "Core/Base.h"
+
+#include <array>
+#include <vector>
+
+namespace Parable
+{
+
+
+/**
+ * Id of a memory tag, as returned by MemoryTracker::register_tag.
+ *
+ */
+using MemoryTag = uint16_t;
+
+/**
+ * Per-tag statistics merged from every thread at the time of a MemoryTracker::snapshot.
+ *
+ */
+struct MemoryTagStats
+{
+    /**
+     * Number of size histogram buckets.
+     *
+     * Bucket i counts allocations of size <= 16 << i, the last bucket counts everything larger.
+     */
+    static constexpr size_t NUM_SIZE_BUCKETS = 16;
+
+    std::string name;
+    MemoryTag tag;
+    MemoryTag parent;
+
+    int64_t current_bytes = 0;
+    int64_t peak_bytes = 0;
+
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t failed_allocations = 0;
+    uint64_t bytes_allocated = 0;
+
+    /**
+     * Allocations per second since the previous snapshot.
+     */
+    double allocation_rate = 0.0;
+    /**
+     * Bytes allocated per second since the previous snapshot.
+     */
+    double byte_rate = 0.0;
+
+    std::array<uint64_t, NUM_SIZE_BUCKETS> size_histogram = {};
+};
+
+/**
+ * A point-in-time view of all memory tags.
+ *
+ */
+struct MemorySnapshot
+{
+    /**
+     * Seconds since the tracker was first used.
+     */
+    double timestamp = 0.0;
+
+    std::vector<MemoryTagStats> tags;
+
+    std::string to_json() const;
+};
+
+/**
+ * Collects per-tag allocation statistics from allocators.
+ *
+ * Each thread records into its own counter block without locking or atomic RMW,
+ * blocks are only merged when a snapshot is taken. Allocators register a tag on
+ * construction (see Allocator) and record through it when PBL_MEMORY_TRACKING is defined.
+ *
+ * Peak bytes are exact for tags only touched by a single thread, otherwise they are
+ * the largest of the per-thread peaks and the merged current value at snapshot time.
+ *
+ */
+class MemoryTracker
+{
+public:
+    /**
+     * Maximum number of distinct tags.
+     */
+    static constexpr size_t MAX_TAGS = 128;
+    /**
+     * The root tag which all other tags descend from.
+     */
+    static constexpr MemoryTag ROOT_TAG = 0;
+
+    static MemoryTag register_tag(const std::string& name, MemoryTag parent = ROOT_TAG);
+    static std::string get_tag_name(MemoryTag tag);
+    static MemoryTag get_tag_parent(MemoryTag tag);
+
+    static void record_allocation(MemoryTag tag, size_t size);
+    static void record_deallocation(MemoryTag tag, size_t size);
+    static void record_failed_allocation(MemoryTag tag, size_t size);
+
+    static MemorySnapshot snapshot();
+
+    static void dump_json(const std::string& path);
+
+    /**
+     * Get the histogram bucket for an allocation size.
+     *
+     * @param size the allocation size in bytes
+     * @return size_t the bucket index
+     */
+    static constexpr size_t size_bucket(size_t size)
+    {
+        size_t bucket = 0;
+        size_t bound = 16;
+        while (bucket < MemoryTagStats::NUM_SIZE_BUCKETS - 1 && size > bound)
+        {
+            bound <<= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+};
+
+
+}
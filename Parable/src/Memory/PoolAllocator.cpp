@@ -16,9 +16,11 @@ namespace Parable
  * @param object_alignment alignment of the chunks
  * @param alloc_size size of the allocated memory
  * @param alloc_start address of start of the allocated memory
+ * @param name name of the allocator, used as its memory tag
+ * @param parent the allocator the memory was taken from, if any
  */
-PoolAllocator::PoolAllocator(size_t object_size, size_t object_alignment, size_t alloc_size, void* alloc_start) :
-                                Allocator(alloc_size, alloc_start), 
+PoolAllocator::PoolAllocator(size_t object_size, size_t object_alignment, size_t alloc_size, void* alloc_start, const std::string& name, Allocator* parent) :
+                                Allocator(alloc_size, alloc_start, name, parent), 
                                 m_object_size(object_size),
                                 m_object_alignment(object_alignment)
 {
@@ -48,6 +50,10 @@ PoolAllocator::PoolAllocator(size_t object_size, size_t object_alignment, size_t
 
 PoolAllocator::PoolAllocator(PoolAllocator&& other) : Allocator(other.get_size(), other.get_start())
 {
+    m_name = std::move(other.m_name);
+    m_parent = other.m_parent;
+    m_tag = other.m_tag;
+
     m_object_size = other.m_object_size;
     m_object_alignment = other.m_object_alignment;
     m_free_list = other.m_free_list;
@@ -61,6 +67,10 @@ PoolAllocator::PoolAllocator(PoolAllocator&& other) : Allocator(other.get_size()
 
 PoolAllocator& PoolAllocator::operator=(PoolAllocator&& other)
 {
+    m_name = std::move(other.m_name);
+    m_parent = other.m_parent;
+    m_tag = other.m_tag;
+
     m_object_size = other.m_object_size;
     m_object_alignment = other.m_object_alignment;
     m_free_list = other.m_free_list;
@@ -91,7 +101,11 @@ void* PoolAllocator::allocate(size_t size, size_t alignment)
     PBL_CORE_ASSERT_MSG(size == m_object_size, "PoolAllocator::allocate incorrect size {}, must be equal to the pool object size {}.", size, m_object_size)
     PBL_CORE_ASSERT_MSG(alignment == m_object_alignment, "PoolAllocator::allocate incorrect alignment {}, should be {}.", alignment, m_object_alignment)
 
-    if (m_free_list == nullptr) return nullptr;
+    if (m_free_list == nullptr)
+    {
+        track_failed_allocation(size);
+        return nullptr;
+    }
 
     void* return_ptr = m_free_list;
 
@@ -101,6 +115,8 @@ void* PoolAllocator::allocate(size_t size, size_t alignment)
     m_used += m_object_size;
     ++m_allocations;
 
+    track_allocation(m_object_size);
+
     return return_ptr;
 }
 
@@ -121,6 +137,8 @@ void PoolAllocator::deallocate(void* p)
 
     m_used -= m_object_size; 
     m_allocations--;
+
+    track_deallocation(m_object_size);
 } 
 
 
@@ -15,7 +15,7 @@ namespace Parable
 class PoolAllocator : public Allocator
 {
 public:
-    PoolAllocator(size_t object_size, size_t object_alignment, size_t alloc_size, void* alloc_start);
+    PoolAllocator(size_t object_size, size_t object_alignment, size_t alloc_size, void* alloc_start, const std::string& name = "", Allocator* parent = nullptr);
     PoolAllocator(PoolAllocator&& other);
     ~PoolAllocator();
 
@@ -27,11 +27,13 @@ public:
      * @tparam T type of object which this pool will store
      * @param alloc_size size of the allocated memory
      * @param alloc_start address of the start of the allocation
+     * @param name name of the allocator, used as its memory tag
+     * @param parent the allocator the memory was taken from, if any
      */
     template<class T>
-    static PoolAllocator create(size_t alloc_size, void* alloc_start)
+    static PoolAllocator create(size_t alloc_size, void* alloc_start, const std::string& name = "", Allocator* parent = nullptr)
     {
-        return PoolAllocator(sizeof(T), alignof(T), alloc_size, alloc_start);
+        return PoolAllocator(sizeof(T), alignof(T), alloc_size, alloc_start, name, parent);
     }
 
     void* allocate(size_t size, size_t alignment) override;
@@ -0,0 +1,94 @@
+#include "RingAllocator.h"
+
+
+namespace Parable
+{
+
+
+RingAllocator::RingAllocator(size_t size, void* start, const std::string& name, Allocator* parent) :
+                                                    Allocator(size, start, name, parent)
+                                                    { PBL_CORE_ASSERT_MSG(size > 0, "RingAllocator given size of 0!") }
+
+RingAllocator::~RingAllocator()
+{
+    PBL_CORE_ASSERT_MSG(m_used == 0 && m_allocations == 0, "RingAllocator memory leak!")
+}
+
+/**
+ * Allocate memory after the newest allocation, wrapping to the start of the ring if it does not fit before the end.
+ * 
+ * @param size the number of bytes to allocate
+ * @param alignment the alignment required
+ * @return void* address of allocated memory, or nullptr if there is no space
+ */
+void* RingAllocator::allocate(size_t size, size_t alignment)
+{
+    PBL_CORE_ASSERT_MSG(size != 0, "Trying to allocate with size 0!")
+
+    uintptr_t start = (uintptr_t)m_start;
+
+    // place a block starting at begin if it fits before limit
+    auto try_place = [&](size_t begin, size_t limit) -> bool
+    {
+        size_t offset = ((start + begin + alignment - 1) & ~(uintptr_t)(alignment - 1)) - start;
+        if (offset + size > limit) return false;
+
+        m_blocks.push_back({ begin, offset, offset + size, false });
+        return true;
+    };
+
+    bool placed;
+    if (m_blocks.empty())
+    {
+        placed = try_place(0, m_size);
+    }
+    else if (m_blocks.back().begin >= m_blocks.front().begin)
+    {
+        // live blocks are one run, so there is space after the newest and before the oldest
+        placed = try_place(m_blocks.back().end, m_size) || try_place(0, m_blocks.front().begin);
+    }
+    else
+    {
+        // live blocks have wrapped, so the only space is between the newest and the oldest
+        placed = try_place(m_blocks.back().end, m_blocks.front().begin);
+    }
+
+    if (!placed)
+    {
+        track_failed_allocation(size);
+        return nullptr;
+    }
+
+    const Block& block = m_blocks.back();
+    m_used += block.end - block.begin;
+    ++m_allocations;
+    track_allocation(block.end - block.begin);
+
+    return (void*)(start + block.offset);
+}
+
+/**
+ * Free an allocation, reclaiming its space once every allocation made before it is also freed.
+ * 
+ * @param p address of the allocation
+ */
+void RingAllocator::deallocate(void* p)
+{
+    size_t offset = (uintptr_t)p - (uintptr_t)m_start;
+
+    auto it = std::find_if(m_blocks.begin(), m_blocks.end(), [offset](const Block& block) { return block.offset == offset && !block.freed; });
+    PBL_CORE_ASSERT_MSG(it != m_blocks.end(), "Deallocating memory not allocated from this RingAllocator!")
+
+    it->freed = true;
+    m_used -= it->end - it->begin;
+    --m_allocations;
+    track_deallocation(it->end - it->begin);
+
+    while (!m_blocks.empty() && m_blocks.front().freed)
+    {
+        m_blocks.pop_front();
+    }
+}
+
+
+}
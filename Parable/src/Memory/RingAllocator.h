@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Allocator.h"
+
+#include <deque>
+
+namespace Parable
+{
+
+
+/**
+ * Allocates like a ring buffer, for short lived allocations which are mostly freed in the order they were made.
+ * 
+ * Allocations may be freed in any order, but space is only reclaimed from the oldest live allocation
+ * onward, so one long lived allocation holds back reuse of everything made after it.
+ * 
+ */
+class RingAllocator : public Allocator
+{
+public:
+    RingAllocator(size_t size, void* start, const std::string& name = "", Allocator* parent = nullptr);
+    ~RingAllocator();
+
+    void* allocate(size_t size, size_t alignment) override;
+    void deallocate(void* p) override;
+
+private:
+    /**
+     * A live allocation, or a freed one waiting for those before it to be freed.
+     */
+    struct Block
+    {
+        /**
+         * Offset of the block start, including any alignment padding.
+         */
+        size_t begin;
+        /**
+         * Offset of the address given out.
+         */
+        size_t offset;
+        size_t end;
+        bool freed;
+    };
+
+    /**
+     * Blocks in allocation order, the oldest first.
+     */
+    std::deque<Block> m_blocks;
+};
+
+
+}
@@ -0,0 +1,276 @@
+#include "SlabAllocator.h"
+
+
+namespace Parable
+{
+
+
+/**
+ * Slot size of each size class.
+ */
+static constexpr std::array<uint32_t, SlabAllocator::NUM_SIZE_CLASSES> CLASS_SIZES = {
+    8, 16, 24, 32,
+    40, 48, 56, 64,
+    80, 96, 112, 128,
+    160, 192, 224, 256
+};
+
+/**
+ * Size class of each size in steps of 8, indexed by (size + 7) / 8.
+ */
+static constexpr std::array<uint8_t, SlabAllocator::MAX_SIZE / 8 + 1> CLASS_LOOKUP = []()
+{
+    std::array<uint8_t, SlabAllocator::MAX_SIZE / 8 + 1> lookup = {};
+    uint8_t c = 0;
+    for (size_t i = 0; i < lookup.size(); ++i)
+    {
+        while (CLASS_SIZES[c] < i * 8) ++c;
+        lookup[i] = c;
+    }
+    return lookup;
+}();
+
+/**
+ * Construct a new Slab Allocator.
+ *
+ * Slabs are carved lazily from the SLAB_SIZE aligned part of the memory.
+ *
+ * @param size size of the allocated memory
+ * @param start address of start of the allocated memory
+ * @param name name of the allocator, used as its memory tag
+ * @param parent the allocator the memory was taken from, if any
+ */
+SlabAllocator::SlabAllocator(size_t size, void* start, const std::string& name, Allocator* parent) :
+                                                        Allocator(size, start, name, parent)
+{
+    m_next_slab = ((uintptr_t)start + SLAB_SIZE - 1) & ~(uintptr_t)(SLAB_SIZE - 1);
+    m_slabs_end = ((uintptr_t)start + size) & ~(uintptr_t)(SLAB_SIZE - 1);
+
+    PBL_CORE_ASSERT_MSG(m_next_slab < m_slabs_end, "SlabAllocator given too little memory for a single slab ({} bytes).", size)
+}
+
+SlabAllocator::~SlabAllocator()
+{
+    PBL_CORE_ASSERT_MSG(m_used == 0 && m_allocations == 0, "SlabAllocator memory leak! Used = {}, Allocs = {}", m_used, m_allocations);
+}
+
+/**
+ * Get the size class which serves an allocation.
+ *
+ * @param size the allocation size, at most MAX_SIZE
+ * @param alignment the alignment required, at most MAX_ALIGNMENT
+ * @return size_t index of the size class
+ */
+size_t SlabAllocator::size_class(size_t size, size_t alignment)
+{
+    size_t c = CLASS_LOOKUP[(size + 7) / 8];
+
+    // slots are only aligned to their size, so move up to a class whose size is a multiple of alignment
+    while (CLASS_SIZES[c] % alignment != 0) ++c;
+
+    return c;
+}
+
+/**
+ * Get the slot size of a size class.
+ */
+size_t SlabAllocator::class_size(size_t size_class)
+{
+    return CLASS_SIZES[size_class];
+}
+
+/**
+ * Allocate from the size class matching size.
+ *
+ * @param size the number of bytes to allocate
+ * @param alignment the alignment required
+ * @return void* address of allocated memory, or nullptr if no slab is available
+ */
+void* SlabAllocator::allocate(size_t size, size_t alignment)
+{
+    PBL_CORE_ASSERT_MSG(size != 0, "Trying to allocate with size 0!")
+    PBL_CORE_ASSERT_MSG(size <= MAX_SIZE, "SlabAllocator::allocate size {} is larger than the maximum {}.", size, MAX_SIZE)
+    PBL_CORE_ASSERT_MSG(alignment <= MAX_ALIGNMENT, "SlabAllocator::allocate alignment {} is larger than the maximum {}.", alignment, MAX_ALIGNMENT)
+
+    size_t c = size_class(size, alignment == 0 ? 1 : alignment);
+
+    SlabHeader* slab = m_partial_slabs[c];
+    if (slab == nullptr)
+    {
+        slab = acquire_slab(c);
+        if (slab == nullptr)
+        {
+            track_failed_allocation(size);
+            return nullptr;
+        }
+    }
+
+    void* p;
+    if (slab->free_list != nullptr)
+    {
+        p = slab->free_list;
+        slab->free_list = *(void**)p;
+    }
+    else
+    {
+        p = (void*)((uintptr_t)slab + slab->bump);
+        slab->bump += slab->slot_size;
+    }
+
+    if (++slab->used == slab->capacity) unlink(m_partial_slabs[c], slab);
+
+    m_used += slab->slot_size;
+    ++m_allocations;
+
+    track_allocation(slab->slot_size);
+
+    return p;
+}
+
+/**
+ * Deallocate memory allocated by this allocator.
+ *
+ * @param p the memory to deallocate
+ */
+void SlabAllocator::deallocate(void* p)
+{
+    free_slot(get_slab(p), p);
+}
+
+/**
+ * Deallocate many allocations at once.
+ *
+ * Cheaper than repeated deallocate() when runs of pointers come from the same slab,
+ * as the slabs list membership is only updated once per run.
+ *
+ * @param ptrs the allocations to free
+ * @param count the number of allocations
+ */
+void SlabAllocator::deallocate_batch(void* const* ptrs, size_t count)
+{
+    size_t i = 0;
+    while (i < count)
+    {
+        SlabHeader* slab = get_slab(ptrs[i]);
+        PBL_CORE_ASSERT_MSG(contains_slab(slab), "SlabAllocator::deallocate_batch pointer is not from this allocator.")
+
+        bool was_full = slab->used == slab->capacity;
+
+        // push the run of pointers which share this slab straight onto its free list
+        uint32_t freed = 0;
+        for (; i < count && get_slab(ptrs[i]) == slab; ++i, ++freed)
+        {
+            *(void**)ptrs[i] = slab->free_list;
+            slab->free_list = ptrs[i];
+        }
+
+        slab->used -= freed;
+        m_used -= (size_t)freed * slab->slot_size;
+        m_allocations -= freed;
+
+        track_deallocation((size_t)freed * slab->slot_size);
+
+        if (slab->used == 0)
+        {
+            if (!was_full) unlink(m_partial_slabs[slab->size_class], slab);
+            release_slab(slab);
+        }
+        else if (was_full)
+        {
+            link(m_partial_slabs[slab->size_class], slab);
+        }
+    }
+}
+
+void SlabAllocator::free_slot(SlabHeader* slab, void* p)
+{
+    PBL_CORE_ASSERT_MSG(contains_slab(slab), "SlabAllocator::deallocate pointer is not from this allocator.")
+
+    bool was_full = slab->used == slab->capacity;
+
+    *(void**)p = slab->free_list;
+    slab->free_list = p;
+    --slab->used;
+
+    m_used -= slab->slot_size;
+    --m_allocations;
+
+    track_deallocation(slab->slot_size);
+
+    if (slab->used == 0)
+    {
+        if (!was_full) unlink(m_partial_slabs[slab->size_class], slab);
+        release_slab(slab);
+    }
+    else if (was_full)
+    {
+        link(m_partial_slabs[slab->size_class], slab);
+    }
+}
+
+/**
+ * Get an unused slab and set it up for a size class.
+ *
+ * @param size_class the class the slab will serve
+ * @return SlabHeader* the slab, linked into the partial list of the class; or nullptr if out of memory
+ */
+SlabAllocator::SlabHeader* SlabAllocator::acquire_slab(size_t size_class)
+{
+    SlabHeader* slab = m_empty_slabs;
+    if (slab != nullptr)
+    {
+        unlink(m_empty_slabs, slab);
+    }
+    else
+    {
+        if (m_next_slab >= m_slabs_end) return nullptr;
+
+        slab = (SlabHeader*)m_next_slab;
+        m_next_slab += SLAB_SIZE;
+    }
+
+    uint32_t slot_size = CLASS_SIZES[size_class];
+
+    slab->free_list = nullptr;
+    slab->next = nullptr;
+    slab->prev = nullptr;
+    slab->bump = SLAB_HEADER_SIZE;
+    slab->used = 0;
+    slab->capacity = (uint32_t)((SLAB_SIZE - SLAB_HEADER_SIZE) / slot_size);
+    slab->slot_size = slot_size;
+    slab->size_class = (uint8_t)size_class;
+
+    link(m_partial_slabs[size_class], slab);
+
+    return slab;
+}
+
+/**
+ * Return an empty slab to the shared list.
+ */
+void SlabAllocator::release_slab(SlabHeader* slab)
+{
+    link(m_empty_slabs, slab);
+}
+
+void SlabAllocator::link(SlabHeader*& list, SlabHeader* slab)
+{
+    slab->prev = nullptr;
+    slab->next = list;
+    if (list != nullptr) list->prev = slab;
+    list = slab;
+}
+
+void SlabAllocator::unlink(SlabHeader*& list, SlabHeader* slab)
+{
+    if (slab->prev != nullptr) slab->prev->next = slab->next;
+    else list = slab->next;
+
+    if (slab->next != nullptr) slab->next->prev = slab->prev;
+
+    slab->next = nullptr;
+    slab->prev = nullptr;
+}
+
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Allocator.h"
+
+#include <array>
+
+namespace Parable
+{
+
+
+/**
+ * Allocates small objects of any size up to MAX_SIZE from per-size-class slabs.
+ *
+ * Sizes are rounded up to one of NUM_SIZE_CLASSES classes: steps of 8 up to 32, then
+ * four steps per power of two (40, 48, 56, 64, 80, ... 256). The memory is split into
+ * SLAB_SIZE aligned slabs which each serve one class, so the slab of any allocation
+ * can be found by masking its address and allocate/deallocate are O(1).
+ *
+ * Slabs which become empty are returned to a shared list and can be reused by any class.
+ *
+ */
+class SlabAllocator : public Allocator
+{
+public:
+    /**
+     * Size and alignment of a slab.
+     */
+    static constexpr size_t SLAB_SIZE = 16 * 1024;
+    /**
+     * Largest allocation size served.
+     */
+    static constexpr size_t MAX_SIZE = 256;
+    /**
+     * Largest alignment served.
+     */
+    static constexpr size_t MAX_ALIGNMENT = 64;
+    static constexpr size_t NUM_SIZE_CLASSES = 16;
+
+    SlabAllocator(size_t size, void* start, const std::string& name = "", Allocator* parent = nullptr);
+    SlabAllocator(const SlabAllocator&) = delete;
+    ~SlabAllocator();
+
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    void* allocate(size_t size, size_t alignment) override;
+    void  deallocate(void* p) override;
+
+    void deallocate_batch(void* const* ptrs, size_t count);
+
+    static size_t size_class(size_t size, size_t alignment = 1);
+    static size_t class_size(size_t size_class);
+
+private:
+    /**
+     * Header at the start of each slab.
+     *
+     * Slots are handed out from the bump offset until the slab has been fully carved,
+     * after which they only come from the free list. This avoids touching a whole slab
+     * when it is first used.
+     */
+    struct SlabHeader
+    {
+        void* free_list;
+        SlabHeader* next;
+        SlabHeader* prev;
+        uint32_t bump;
+        uint32_t used;
+        uint32_t capacity;
+        uint32_t slot_size;
+        uint8_t size_class;
+    };
+
+    /**
+     * Offset of the first slot in a slab.
+     */
+    static constexpr size_t SLAB_HEADER_SIZE = MAX_ALIGNMENT;
+    static_assert(sizeof(SlabHeader) <= SLAB_HEADER_SIZE, "SlabHeader does not fit in the reserved header space.");
+
+    SlabHeader* get_slab(void* p) const { return (SlabHeader*)((uintptr_t)p & ~(uintptr_t)(SLAB_SIZE - 1)); }
+    bool contains_slab(SlabHeader* slab) const { return (uintptr_t)slab >= (uintptr_t)m_start && (uintptr_t)slab < m_next_slab; }
+
+    SlabHeader* acquire_slab(size_t size_class);
+    void release_slab(SlabHeader* slab);
+
+    void link(SlabHeader*& list, SlabHeader* slab);
+    void unlink(SlabHeader*& list, SlabHeader* slab);
+
+    void free_slot(SlabHeader* slab, void* p);
+
+    /**
+     * Slabs with at least one free slot, per size class.
+     */
+    std::array<SlabHeader*, NUM_SIZE_CLASSES> m_partial_slabs = {};
+    /**
+     * Slabs with no allocations, available to any class.
+     */
+    SlabHeader* m_empty_slabs = nullptr;
+    /**
+     * Start of the slabs which have never been used.
+     */
+    uintptr_t m_next_slab;
+    /**
+     * End of the slab aligned part of the memory.
+     */
+    uintptr_t m_slabs_end;
+};
+
+
+}
@@ -0,0 +1,229 @@
+#include "VirtualArena.h"
+
+#include "Exception/MemoryExceptions.h"
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+
+namespace Parable
+{
+
+
+static constexpr size_t round_up(size_t value, size_t multiple)
+{
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
+/**
+ * Reserve address space for a new arena.
+ *
+ * Nothing is committed until commit() or commit_block() is called.
+ *
+ * @param reserve_size bytes of address space to reserve, rounded up to COMMIT_STEP
+ * @param huge_pages how committed memory should be backed by huge pages
+ */
+VirtualArena::VirtualArena(size_t reserve_size, HugePageMode huge_pages) :
+                                                m_reserved(round_up(reserve_size, COMMIT_STEP)),
+                                                m_huge_pages(huge_pages)
+{
+    PBL_CORE_ASSERT_MSG(reserve_size > 0, "VirtualArena given reserve size of 0!")
+
+    // over-reserve by one step so the usable range can be aligned to a huge page boundary
+    m_mapping_size = m_reserved + COMMIT_STEP;
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    m_mapping = VirtualAlloc(nullptr, m_mapping_size, MEM_RESERVE, PAGE_NOACCESS);
+    if (m_mapping == nullptr) throw AllocationFailedException("VirtualArena failed to reserve address space.");
+
+    if (m_huge_pages != HugePageMode::None)
+    {
+        // large pages on windows need SeLockMemoryPrivilege and cannot be committed incrementally
+        PBL_CORE_WARN("VirtualArena huge pages are not supported on Windows, using regular pages.");
+        m_huge_pages = HugePageMode::None;
+    }
+#else
+    m_mapping = mmap(nullptr, m_mapping_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (m_mapping == MAP_FAILED)
+    {
+        m_mapping = nullptr;
+        throw AllocationFailedException("VirtualArena failed to reserve address space.");
+    }
+#endif
+
+    m_start = (void*)round_up((uintptr_t)m_mapping, COMMIT_STEP);
+}
+
+VirtualArena::VirtualArena(VirtualArena&& other) :
+                                m_start(other.m_start),
+                                m_reserved(other.m_reserved),
+                                m_committed(other.m_committed),
+                                m_used(other.m_used),
+                                m_huge_pages(other.m_huge_pages),
+                                m_mapping(other.m_mapping),
+                                m_mapping_size(other.m_mapping_size)
+{
+    other.m_start = nullptr;
+    other.m_mapping = nullptr;
+    other.m_reserved = other.m_committed = other.m_used = other.m_mapping_size = 0;
+}
+
+VirtualArena& VirtualArena::operator=(VirtualArena&& other)
+{
+    if (this == &other) return *this;
+
+    release();
+
+    m_start = other.m_start;
+    m_reserved = other.m_reserved;
+    m_committed = other.m_committed;
+    m_used = other.m_used;
+    m_huge_pages = other.m_huge_pages;
+    m_mapping = other.m_mapping;
+    m_mapping_size = other.m_mapping_size;
+
+    other.m_start = nullptr;
+    other.m_mapping = nullptr;
+    other.m_reserved = other.m_committed = other.m_used = other.m_mapping_size = 0;
+
+    return *this;
+}
+
+VirtualArena::~VirtualArena()
+{
+    release();
+}
+
+/**
+ * Return the whole mapping to the OS.
+ *
+ */
+void VirtualArena::release()
+{
+    if (m_mapping == nullptr) return;
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    VirtualFree(m_mapping, 0, MEM_RELEASE);
+#else
+    munmap(m_mapping, m_mapping_size);
+#endif
+
+    m_mapping = nullptr;
+    m_start = nullptr;
+}
+
+/**
+ * Make sure at least size bytes from the start of the arena are committed.
+ *
+ * Commits in whole COMMIT_STEPs.
+ *
+ * @param size the number of bytes from the start which must be usable
+ */
+void VirtualArena::commit(size_t size)
+{
+    if (size <= m_committed) return;
+    if (size > m_reserved) throw OutOfMemoryException("VirtualArena commit exceeds its reserved size.");
+
+    size_t new_committed = round_up(size, COMMIT_STEP);
+    void* commit_start = (void*)((uintptr_t)m_start + m_committed);
+    size_t commit_size = new_committed - m_committed;
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    if (VirtualAlloc(commit_start, commit_size, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+    {
+        throw OutOfMemoryException("VirtualArena failed to commit memory.");
+    }
+#else
+    bool committed = false;
+
+#ifdef MAP_HUGETLB
+    if (m_huge_pages == HugePageMode::Explicit)
+    {
+        // replace the reserved range with pages from the hugetlbfs pool
+        void* p = mmap(commit_start, commit_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            committed = true;
+        }
+        else
+        {
+            PBL_CORE_WARN("VirtualArena could not get explicit huge pages, falling back to transparent huge pages.");
+            m_huge_pages = HugePageMode::Transparent;
+        }
+    }
+#endif
+
+    if (!committed)
+    {
+        if (mprotect(commit_start, commit_size, PROT_READ | PROT_WRITE) != 0)
+        {
+            throw OutOfMemoryException("VirtualArena failed to commit memory.");
+        }
+
+#ifdef MADV_HUGEPAGE
+        // advisory only, the kernel may still use regular pages
+        if (m_huge_pages != HugePageMode::None) madvise(commit_start, commit_size, MADV_HUGEPAGE);
+#endif
+    }
+#endif
+
+    m_committed = new_committed;
+}
+
+/**
+ * Take a block of committed memory from the arena.
+ *
+ * Blocks are taken linearly and can only be returned all at once with reset().
+ *
+ * @param size the number of bytes required
+ * @param alignment the alignment of the block
+ * @return void* the start of the block
+ */
+void* VirtualArena::commit_block(size_t size, size_t alignment)
+{
+    PBL_CORE_ASSERT_MSG(size != 0, "Trying to commit a block of size 0!")
+
+    size_t offset = round_up(m_used, alignment);
+    commit(offset + size);
+
+    m_used = offset + size;
+
+    return (void*)((uintptr_t)m_start + offset);
+}
+
+/**
+ * Decommit all memory, keeping the address space reserved.
+ *
+ * Invalidates all blocks.
+ *
+ */
+void VirtualArena::reset()
+{
+    m_used = 0;
+
+    if (m_committed > 0)
+    {
+#if defined(PBL_PLATFORM_WINDOWS)
+        bool decommitted = VirtualFree(m_start, m_committed, MEM_DECOMMIT) != 0;
+#else
+        // remap as inaccessible, which also drops any explicit huge page mappings
+        bool decommitted = mmap(m_start, m_committed, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) != MAP_FAILED;
+#endif
+
+        // the pages are still committed, so keep counting them and reuse them from the start
+        if (!decommitted)
+        {
+            PBL_CORE_ERROR("VirtualArena failed to decommit {} bytes of memory.", m_committed);
+            return;
+        }
+    }
+
+    m_committed = 0;
+}
+
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "pblpch.h"
+#include "Core/Base.h"
+
+namespace Parable
+{
+
+
+/**
+ * How a VirtualArena should back its memory with huge pages.
+ *
+ */
+enum class HugePageMode
+{
+    /**
+     * Regular pages only.
+     */
+    None,
+    /**
+     * Ask the OS to back committed memory with transparent huge pages (madvise MADV_HUGEPAGE).
+     */
+    Transparent,
+    /**
+     * Map committed memory from the explicit huge page pool (hugetlbfs/MAP_HUGETLB).
+     *
+     * Falls back to regular pages if the pool cannot satisfy a commit.
+     */
+    Explicit
+};
+
+/**
+ * A contiguous range of reserved address space which is committed on demand.
+ *
+ * Reserving does not use any physical memory, so an arena can reserve enough for the
+ * worst case up front and keep pointers stable as it grows. Memory is committed in
+ * steps of COMMIT_STEP (one 2MB huge page) so huge pages can back every step.
+ *
+ * Blocks handed out by commit_block() are intended as the backing store of
+ * LinearAllocator/PoolAllocator, which take a (size, start) pair.
+ *
+ */
+class VirtualArena
+{
+public:
+    /**
+     * Size of a committed step, also the size of a huge page on x86-64.
+     */
+    static constexpr size_t COMMIT_STEP = (size_t)2 << 20;
+
+    VirtualArena(size_t reserve_size, HugePageMode huge_pages = HugePageMode::Transparent);
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena(VirtualArena&& other);
+    ~VirtualArena();
+
+    VirtualArena& operator=(const VirtualArena&) = delete;
+    VirtualArena& operator=(VirtualArena&& other);
+
+    void* commit_block(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    void commit(size_t size);
+    void reset();
+
+    void* get_start() const { return m_start; }
+    size_t get_reserved() const { return m_reserved; }
+    size_t get_committed() const { return m_committed; }
+    size_t get_used() const { return m_used; }
+    HugePageMode get_huge_page_mode() const { return m_huge_pages; }
+
+    /**
+     * Whether the address is inside the reserved range.
+     */
+    bool contains(const void* p) const
+    {
+        return (uintptr_t)p >= (uintptr_t)m_start && (uintptr_t)p < (uintptr_t)m_start + m_reserved;
+    }
+
+private:
+    void release();
+
+    /**
+     * Start of the reserved range, aligned to COMMIT_STEP.
+     */
+    void* m_start = nullptr;
+    /**
+     * Bytes of address space reserved.
+     */
+    size_t m_reserved = 0;
+    /**
+     * Bytes committed from the start of the range, a multiple of COMMIT_STEP.
+     */
+    size_t m_committed = 0;
+    /**
+     * Bytes handed out by commit_block().
+     */
+    size_t m_used = 0;
+
+    HugePageMode m_huge_pages;
+
+    /**
+     * Base and size of the OS mapping, which can be larger than the reserved range due to alignment.
+     */
+    void* m_mapping = nullptr;
+    size_t m_mapping_size = 0;
+};
+
+
+}
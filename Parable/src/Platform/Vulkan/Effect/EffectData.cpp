@@ -5,7 +5,7 @@
 #include "Asset/EffectLoadInfo.h"
 #include "Asset/AssetRegistry.h"
 
-#include "Util/ReadFile.h"
+#include "Util/MappedFile.h"
 
 namespace Parable::Vulkan
 {
@@ -39,11 +39,11 @@ EffectData::EffectData(const EffectLoadInfo& load_info)
         {
             const ShaderLoadInfo& shader_info = AssetRegistry::resolve(shader.shader);
 
-            std::vector<char> code = Util::read_file(shader_info.get_spv_path());
+            Util::MappedFile code(shader_info.get_spv_path());
             vk::ShaderModuleCreateInfo shader_create_info(
                 {},
                 code.size(),
-                reinterpret_cast<uint32_t*>(code.data())
+                reinterpret_cast<const uint32_t*>(code.data().data())
             );
 
             shaders.emplace_back(shader_stage_to_vk(shader_pass),device.createShaderModule(shader_create_info)));
@@ -29,5 +29,10 @@ void EffectLoadTask::create_device_resources(Device& device)
     m_effect_storage.set_load_state(Parable::ResourceLoadState::Loaded);
 }
 
+void EffectLoadTask::on_load_failed()
+{
+    m_effect_storage.set_load_state(Parable::ResourceLoadState::Unloaded);
+}
+
 
 }
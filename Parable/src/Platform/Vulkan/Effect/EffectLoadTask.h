@@ -37,9 +37,16 @@ public:
      * Create pipelines and other state objects.
     */
     void create_device_resources(Device& device) override;
+    /**
+     * Leave the effect unloaded.
+     */
+    void on_load_failed() override;
 
     // unused
-    void record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer) override {}
+    void get_reads(std::vector<FileRead>& reads) override {}
+    void prepare() override {}
+    std::span<const UploadPart> get_upload_parts() const override { return {}; }
+    void record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer, const UploadChunk& chunk) override {}
     void on_load_complete() override {}
 };
 
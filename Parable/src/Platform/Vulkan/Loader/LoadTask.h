@@ -1,9 +1,12 @@
 #pragma once
 
-namespace vk
-{
-    class CommandBuffer;
-}
+#include "pblpch.h"
+
+#include <span>
+
+#include <vulkan/vulkan.hpp>
+
+#include "IO/File.h"
 
 namespace Parable::Vulkan
 {
@@ -11,6 +14,69 @@ namespace Parable::Vulkan
 
 class Device;
 class PhysicalDevice;
+class Buffer;
+
+/**
+ * A read of a task's source data, issued through the application's IO service before the task is prepared.
+ */
+struct FileRead
+{
+    const IO::File* file;
+    uint64_t offset;
+    /**
+     * Owned by the task, and filled completely; a read which comes up short fails the task.
+     */
+    std::span<std::byte> buffer;
+};
+
+/**
+ * A contiguous range of a task's prepared data, which the loader stages and the task copies to its destination.
+ */
+struct UploadPart
+{
+    std::span<const std::byte> data;
+    /**
+     * Whether the part may be split between chunks, as buffer data can. An image level is always staged whole.
+     */
+    bool splittable = false;
+};
+
+/**
+ * Where a range of one upload part lies in staging.
+ */
+struct StagedRange
+{
+    /**
+     * The index of the part in the task's upload parts.
+     */
+    size_t part;
+    /**
+     * The offset of the range from the start of its part.
+     */
+    vk::DeviceSize part_offset;
+    vk::DeviceSize size;
+    /**
+     * The offset of the range in the staging buffer.
+     */
+    vk::DeviceSize staging_offset;
+};
+
+/**
+ * The ranges of a task's upload staged for one submission.
+ *
+ * An upload larger than the loader's staging ring is split into several chunks, each staged and
+ * recorded once the one before it has finished on the GPU.
+ */
+struct UploadChunk
+{
+    Buffer* staging_buffer = nullptr;
+    std::vector<StagedRange> ranges;
+    /**
+     * Whether this is the first or last chunk of the upload, both for an upload which fits in one.
+     */
+    bool first = true;
+    bool last = true;
+};
 
 /**
  * Interface for a single vulkan resource loading job.
@@ -23,20 +89,54 @@ public:
     // All the interface methods are pure virtual to force implementations
     // to explicitly acknowledge they do not use a specific function by defining it empty.
 
+    // A load runs in stages: get_reads on the thread which owns the loader, whose reads run on the IO
+    // service, then prepare on a worker thread once they have all finished, then the loader stages the
+    // task's upload parts and record_commands copies them chunk by chunk on the owning thread, then
+    // create_device_resources, then on_load_complete once the GPU is done.
+    // Tasks are prepared in parallel with each other, so prepare must only touch the task's own state.
+
     /**
-     * Record the necessary vulkan commands to do this load.
-     * 
-     * This is used by all resource loading tasks which must execute some GPU commands to load.
-     * 
+     * Open the task's source files and size buffers for them, adding a read for each.
+     *
+     * Runs on the owning thread, and should only do what is needed to know the reads, as the
+     * reads of every task submitted in an update are issued together.
+     *
+     * @param reads The reads to issue, which may be left empty.
+     */
+    virtual void get_reads(std::vector<FileRead>& reads) = 0;
+
+    /**
+     * Do the CPU side of the load, decoding the data read into the parts to upload.
+     *
+     * Runs on a worker thread once every read has finished, and must not use the vulkan device or do
+     * blocking file IO.
+     */
+    virtual void prepare() = 0;
+
+    /**
+     * The prepared data to upload, in the order it is staged.
+     *
+     * Called after prepare, and must stay valid until the load completes or fails.
+     */
+    virtual std::span<const UploadPart> get_upload_parts() const = 0;
+
+    /**
+     * Record the necessary vulkan commands to copy one chunk of staged data to its destination.
+     *
+     * Called once per chunk, in order, on the owning thread. The first chunk should create the
+     * destination, and the last leave the resource ready to use. A task with no upload parts is
+     * recorded once with an empty chunk.
+     *
      * Note that currently, the command buffer queue is only guaranteed to have transfer capabilities
      * (e.g. implementations should not record any graphics, compute or non-transfer queue commands).
-     * 
+     *
      * @param command_buffer The command buffer to record into.
+     * @param chunk The staged ranges to copy.
      */
-    virtual void record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer) = 0;
+    virtual void record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer, const UploadChunk& chunk) = 0;
 
     /**
-     * Create resources synchronously using the vulkan device.
+     * Create resources synchronously using the vulkan device, once the last chunk is submitted.
      */
     virtual void create_device_resources(Device& device) = 0;
 
@@ -44,6 +144,15 @@ public:
      * Called when all async loading task is complete, signalling that any needed cleanup can occur.
      */
     virtual void on_load_complete() = 0;
+
+    /**
+     * Called instead of on_load_complete when a stage of the task throws, on the owning thread.
+     *
+     * The loader frees the task's staging itself. The task should release what else it holds, e.g.
+     * a destination created by an earlier chunk, and set its resource Unloaded so a later load can
+     * retry it. Any commands it recorded have finished by then.
+     */
+    virtual void on_load_failed() = 0;
 };
 
 
@@ -1,83 +1,510 @@
 #include "Loader.h"
 
+#include <cstring>
+
 #include <vulkan/vulkan.hpp>
 
 #include "LoadTask.h"
 
+#include "Core/Application.h"
+#include "Events/ResourceEvent.h"
+#include "Exception/IOExceptions.h"
+#include "IO/IOService.h"
+
 namespace Parable::Vulkan
 {
 
 
-Loader::Loader(Device device, PhysicalDevice physical_device, uint32_t transfer_family)
+Loader::Loader(Device device, PhysicalDevice physical_device, uint32_t transfer_family, vk::DeviceSize staging_ring_size)
     : m_device(device),
     m_physical_device(physical_device),
-    m_transfer_queue(device->getQueue(transfer_family, 0))
+    m_transfer_queue(device->getQueue(transfer_family, 0)),
+    m_staging_ring(m_device, m_physical_device, staging_ring_size)
 {
-    vk::CommandPoolCreateInfo cmd_pool_info(   
-        vk::CommandPoolCreateFlagBits::eTransient,
+    PBL_CORE_ASSERT_MSG(staging_ring_size >= 4 * StagingRing::COPY_ALIGNMENT, "Staging ring is too small to split uploads into!")
+
+    // command buffers are reset one at a time as their submissions finish
+    vk::CommandPoolCreateInfo cmd_pool_info(
+        vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
         transfer_family
     );
     m_command_pool = CommandPool(m_device, cmd_pool_info);
 
-    m_command_buffer = m_command_pool.create_command_buffers(vk::CommandBufferLevel::ePrimary, 1)[0];
-
-    vk::FenceCreateInfo fenceInfo {};
-    m_transfer_finished_fence = m_device->createFence(fenceInfo);
+    vk::SemaphoreTypeCreateInfo timeline_info(vk::SemaphoreType::eTimeline, m_last_timeline_value);
+    vk::SemaphoreCreateInfo semaphore_info({}, &timeline_info);
+    m_timeline_semaphore = m_device->createSemaphore(semaphore_info);
 }
 
 Loader::~Loader()
 {
-    m_device->destroyFence(m_transfer_finished_fence);
+    // staging memory is only released as submissions finish
+    flush();
 
-    std::vector<vk::CommandBuffer> buffs{m_command_buffer};
-    m_command_pool.free_command_buffers(buffs);
+    m_staging_ring.destroy();
+    m_device->destroySemaphore(m_timeline_semaphore);
+
+    if (!m_free_command_buffers.empty()) m_command_pool.free_command_buffers(m_free_command_buffers);
     m_command_pool.destroy();
 }
 
-void Loader::submit_task(std::unique_ptr<LoadTask> task)
+void Loader::submit_task(AssetDescriptor descriptor, std::unique_ptr<LoadTask> task)
+{
+    m_tasks.push_back({ descriptor, std::move(task) });
+}
+
+void Loader::update()
 {
-    m_tasks.push_back(std::move(task));
+    complete_finished(false);
+    submit_staged(false);
+    collect_prepared(false);
+    stage_waiting();
+    start_reading();
+    start_preparing();
 }
 
-void Loader::run_tasks()
+void Loader::flush()
 {
-    m_command_buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    IO::IOService& io_service = Application::get_instance().get_io_service();
 
-    for (auto& task : m_tasks)
+    // a task's chunks are staged one after another, so run every stage until nothing is left,
+    // each pass waiting for all submissions so the next starts with the whole ring free
+    while (is_busy())
     {
-        task->record_commands(m_device, m_physical_device, m_command_buffer);
+        start_reading();
+        if (!m_reading_tasks.empty()) io_service.wait_all();
+        start_preparing();
+        collect_prepared(true);
+        stage_waiting();
+        submit_staged(true);
+        complete_finished(true);
     }
+}
 
-    m_command_buffer.end();
+/**
+ * Issue the source reads of the submitted tasks to the IO service, as one batch.
+ *
+ * A task with nothing to read is ready to prepare straight away.
+ */
+void Loader::start_reading()
+{
+    if (m_tasks.empty()) return;
 
-    m_transfer_queue.submit({vk::SubmitInfo(0, nullptr, nullptr, 1, &m_command_buffer)}, m_transfer_finished_fence);
+    IO::IOService& io_service = Application::get_instance().get_io_service();
 
-    // call all the host/driver side creation funcs while the GPU works
-    for (auto& task : m_tasks)
+    std::vector<FileRead> reads;
+    for (auto& pending : m_tasks)
+    {
+        reads.clear();
+        try
+        {
+            pending.task->get_reads(reads);
+        }
+        catch (...)
+        {
+            pending.error = std::current_exception();
+            fail_task(pending);
+            continue;
+        }
+
+        if (reads.empty())
+        {
+            m_read_tasks.push_back(std::move(pending));
+            continue;
+        }
+
+        auto it = m_reading_tasks.insert(m_reading_tasks.end(), std::move(pending));
+        it->reads_in_flight = reads.size();
+        for (const FileRead& read : reads)
+        {
+            io_service.read(*read.file, read.buffer, read.offset, [this, it, size = read.buffer.size()](const IO::ReadResult& result) {
+                finish_read(it, result, size);
+            });
+        }
+    }
+    m_tasks.clear();
+
+    io_service.submit();
+}
+
+/**
+ * Note the result of one of a task's reads, run by the IO service on the owning thread.
+ *
+ * Once the last of its reads finishes, the task is queued to prepare, or failed if any of them did.
+ */
+void Loader::finish_read(std::list<PendingTask>::iterator it, const IO::ReadResult& result, size_t size)
+{
+    PendingTask& pending = *it;
+
+    if (!pending.error && !result.ok())
+    {
+        PBL_CORE_ERROR("Reading the source of asset {} failed: {}", pending.descriptor, std::strerror(result.error));
+        pending.error = std::make_exception_ptr(FileOpenException("Failed to read asset source."));
+    }
+    else if (!pending.error && result.bytes < size)
+    {
+        pending.error = std::make_exception_ptr(FileFormatException("Asset source ended before the data expected."));
+    }
+
+    // the task's buffers are only released once none of its reads are writing to them
+    if (--pending.reads_in_flight > 0) return;
+
+    if (pending.error) fail_task(pending);
+    else m_read_tasks.push_back(std::move(pending));
+    m_reading_tasks.erase(it);
+}
+
+/**
+ * Start preparing the tasks whose reads have finished on the job system, as one batch.
+ */
+void Loader::start_preparing()
+{
+    if (m_read_tasks.empty()) return;
+
+    std::unique_ptr<JobBatch> batch = std::make_unique<JobBatch>();
+    batch->tasks = std::move(m_read_tasks);
+    m_read_tasks.clear();
+
+    JobSystem& job_system = Application::get_instance().get_job_system();
+    for (auto& pending : batch->tasks)
     {
-        task->create_device_resources();
+        job_system.run([&pending]() {
+            try
+            {
+                pending.task->prepare();
+            }
+            catch (...)
+            {
+                pending.error = std::current_exception();
+            }
+        }, batch->counter);
     }
 
-    // now wait until the GPU is actually done
-    vk::Result res = m_device->waitForFences(1, &m_transfer_finished_fence, VK_TRUE, UINT64_MAX);
-    if (res != vk::Result::eSuccess) {
-        throw std::runtime_error("Failed to wait for transfer fence.");
+    m_preparing_batches.push_back(std::move(batch));
+}
+
+/**
+ * Queue the tasks of every batch which has finished preparing to be staged, in the order they were submitted.
+ *
+ * @param wait Whether to wait for batches to finish preparing, rather than leave them for a later update.
+ */
+void Loader::collect_prepared(bool wait)
+{
+    JobSystem& job_system = Application::get_instance().get_job_system();
+
+    while (!m_preparing_batches.empty())
+    {
+        JobBatch& batch = *m_preparing_batches.front();
+        if (wait) job_system.wait(batch.counter);
+        else if (!batch.counter.is_done()) break;
+
+        // a task which failed is dropped on its own, so the rest of its batch still loads
+        for (auto& pending : batch.tasks)
+        {
+            if (pending.error) fail_task(pending);
+            else m_waiting_tasks.push_back(std::move(pending));
+        }
+        m_preparing_batches.pop_front();
     }
+}
+
+/**
+ * Lay out the next chunk of a task's upload from where its last chunk ended.
+ *
+ * Parts are packed whole while they fit in half the ring, so one chunk can be staged while the one
+ * before it is copied. A splittable part which does not fit is split at the end of the chunk, and
+ * an image level which does not fit goes in a chunk of its own, however large.
+ */
+Loader::ChunkLayout Loader::layout_chunk(PendingTask& pending) const
+{
+    constexpr vk::DeviceSize alignment = StagingRing::COPY_ALIGNMENT;
 
-    // cleanup
-    for (auto& task : m_tasks)
+    std::span<const UploadPart> parts = pending.task->get_upload_parts();
+    vk::DeviceSize max_size = m_staging_ring.get_size() / 2;
+
+    UploadChunk& chunk = pending.chunk;
+    chunk.ranges.clear();
+    chunk.first = pending.next_part == 0 && pending.next_part_offset == 0;
+
+    ChunkLayout layout;
+    size_t part = pending.next_part;
+    vk::DeviceSize part_offset = pending.next_part_offset;
+    while (part < parts.size())
     {
-        task->on_load_complete();
+        vk::DeviceSize remaining = parts[part].data.size() - part_offset;
+        vk::DeviceSize staging_offset = (layout.size + alignment - 1) / alignment * alignment;
+
+        if (remaining == 0)
+        {
+            ++part;
+            part_offset = 0;
+            continue;
+        }
+
+        if (staging_offset + remaining <= max_size)
+        {
+            chunk.ranges.push_back({ part, part_offset, remaining, staging_offset });
+            layout.size = staging_offset + remaining;
+            ++part;
+            part_offset = 0;
+            continue;
+        }
+
+        // the rest of the part does not fit in this chunk
+        if (parts[part].splittable)
+        {
+            vk::DeviceSize size = staging_offset < max_size ? (max_size - staging_offset) / alignment * alignment : 0;
+            if (size > 0)
+            {
+                chunk.ranges.push_back({ part, part_offset, size, staging_offset });
+                layout.size = staging_offset + size;
+                part_offset += size;
+            }
+        }
+        else if (chunk.ranges.empty())
+        {
+            chunk.ranges.push_back({ part, 0, remaining, 0 });
+            layout.size = remaining;
+            ++part;
+        }
+        break;
     }
 
-    res = m_device->resetFences(1, &m_transfer_finished_fence);
-    if (res != vk::Result::eSuccess) {
-        throw std::runtime_error("Failed to reset transfer fence.");
+    // trailing empty parts have nothing to stage, so do not hold the last chunk back
+    while (part < parts.size() && parts[part].data.size() == part_offset)
+    {
+        ++part;
+        part_offset = 0;
     }
 
-    m_device->resetCommandPool(m_command_pool);
+    chunk.last = part == parts.size();
+    layout.end_part = part;
+    layout.end_part_offset = part_offset;
+    return layout;
+}
 
-    m_tasks.clear();
+/**
+ * Stage the next chunk of each waiting task, in order, while the staging ring has space.
+ *
+ * A task whose chunk does not fit holds back those after it, so a large upload is not starved by
+ * smaller ones, and is retried on a later update once finished submissions have freed their staging.
+ * Only a chunk larger than the whole ring is given a buffer of its own.
+ */
+void Loader::stage_waiting()
+{
+    if (m_waiting_tasks.empty()) return;
+
+    std::unique_ptr<JobBatch> batch = std::make_unique<JobBatch>();
+
+    while (!m_waiting_tasks.empty())
+    {
+        PendingTask& pending = m_waiting_tasks.front();
+        ChunkLayout layout = layout_chunk(pending);
+
+        if (layout.size > m_staging_ring.get_size())
+        {
+            PBL_CORE_WARN("Asset {} has {} bytes to upload which can not be split to fit the staging ring, staging them in a buffer of their own.", pending.descriptor, layout.size);
+            pending.staging.allocate_dedicated(m_device, m_physical_device, layout.size);
+        }
+        else if (layout.size > 0 && !pending.staging.allocate(m_staging_ring, layout.size))
+        {
+            break;
+        }
+
+        for (StagedRange& range : pending.chunk.ranges)
+        {
+            range.staging_offset += pending.staging.get_offset();
+        }
+        pending.next_part = layout.end_part;
+        pending.next_part_offset = layout.end_part_offset;
+
+        batch->tasks.push_back(std::move(pending));
+        m_waiting_tasks.pop_front();
+    }
+
+    if (batch->tasks.empty()) return;
+
+    // the jobs are only started once the batch is complete, as they refer to its tasks in place
+    JobSystem& job_system = Application::get_instance().get_job_system();
+    for (auto& pending : batch->tasks)
+    {
+        if (pending.chunk.ranges.empty()) continue;
+
+        job_system.run([&pending]() {
+            std::span<const UploadPart> parts = pending.task->get_upload_parts();
+            for (const StagedRange& range : pending.chunk.ranges)
+            {
+                std::byte* staged = pending.staging.get_data() + (range.staging_offset - pending.staging.get_offset());
+                std::memcpy(staged, parts[range.part].data.data() + range.part_offset, range.size);
+            }
+        }, batch->counter);
+    }
+
+    m_staging_batches.push_back(std::move(batch));
+}
+
+/**
+ * Record every batch which has finished staging into one submission to the transfer queue.
+ *
+ * Batches are submitted in order, so one still staging holds back those after it.
+ *
+ * @param wait Whether to wait for batches to finish staging, rather than leave them for a later update.
+ */
+void Loader::submit_staged(bool wait)
+{
+    if (m_staging_batches.empty()) return;
+
+    JobSystem& job_system = Application::get_instance().get_job_system();
+
+    std::vector<PendingTask> tasks;
+    while (!m_staging_batches.empty())
+    {
+        JobBatch& batch = *m_staging_batches.front();
+        if (wait) job_system.wait(batch.counter);
+        else if (!batch.counter.is_done()) break;
+
+        for (auto& pending : batch.tasks)
+        {
+            tasks.push_back(std::move(pending));
+        }
+        m_staging_batches.pop_front();
+    }
+
+    if (tasks.empty()) return;
+
+    vk::CommandBuffer command_buffer;
+    if (m_free_command_buffers.empty())
+    {
+        command_buffer = m_command_pool.create_command_buffers(vk::CommandBufferLevel::ePrimary, 1)[0];
+    }
+    else
+    {
+        command_buffer = m_free_command_buffers.back();
+        m_free_command_buffers.pop_back();
+    }
+
+    command_buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+    // a task which throws part way through recording may have recorded copies from its staging,
+    // so it is only failed once the submission has finished
+    for (auto& pending : tasks)
+    {
+        // the staging buffer is only known here, as a dedicated one moves with its task
+        pending.chunk.staging_buffer = &pending.staging.get_buffer();
+
+        try
+        {
+            pending.task->record_commands(m_device, m_physical_device, command_buffer, pending.chunk);
+        }
+        catch (...)
+        {
+            pending.error = std::current_exception();
+        }
+    }
+
+    command_buffer.end();
+
+    uint64_t timeline_value = ++m_last_timeline_value;
+    vk::TimelineSemaphoreSubmitInfo timeline_info(0, nullptr, 1, &timeline_value);
+    vk::SubmitInfo submit_info(0, nullptr, nullptr, 1, &command_buffer, 1, &m_timeline_semaphore, &timeline_info);
+    m_transfer_queue.submit({submit_info});
+
+    // call all the host/driver side creation funcs while the GPU works
+    for (auto& pending : tasks)
+    {
+        if (pending.error || !pending.chunk.last) continue;
+
+        try
+        {
+            pending.task->create_device_resources(m_device);
+        }
+        catch (...)
+        {
+            pending.error = std::current_exception();
+        }
+    }
+
+    m_submissions.push_back({ std::move(tasks), command_buffer, timeline_value });
+}
+
+/**
+ * Free the staging of every submission the GPU has finished, completing its tasks or queueing their next chunk.
+ *
+ * @param wait Whether to wait for every submission to finish, rather than leave them for a later update.
+ */
+void Loader::complete_finished(bool wait)
+{
+    if (m_submissions.empty()) return;
+
+    if (wait)
+    {
+        vk::SemaphoreWaitInfo wait_info({}, 1, &m_timeline_semaphore, &m_last_timeline_value);
+        vk::Result res = m_device->waitSemaphores(wait_info, UINT64_MAX);
+        if (res != vk::Result::eSuccess) {
+            throw std::runtime_error("Failed to wait for transfer timeline semaphore.");
+        }
+    }
+
+    uint64_t finished_value = m_device->getSemaphoreCounterValue(m_timeline_semaphore);
+
+    // tasks part way through their upload, which stage their next chunk before any task waiting now
+    std::vector<PendingTask> unfinished;
+
+    // cleanup, and tell the rest of the engine the resources are ready
+    EventQueue& event_queue = Application::get_instance().get_event_queue();
+    while (!m_submissions.empty() && m_submissions.front().timeline_value <= finished_value)
+    {
+        Submission& submission = m_submissions.front();
+        for (auto& pending : submission.tasks)
+        {
+            pending.staging.free();
+
+            if (pending.error)
+            {
+                fail_task(pending);
+                continue;
+            }
+
+            if (!pending.chunk.last)
+            {
+                unfinished.push_back(std::move(pending));
+                continue;
+            }
+
+            pending.task->on_load_complete();
+            if (!event_queue.post<ResourceLoadedEvent>(pending.descriptor))
+            {
+                PBL_CORE_WARN("Event queue full, dropped ResourceLoadedEvent for asset {}.", pending.descriptor);
+            }
+        }
+
+        submission.command_buffer.reset();
+        m_free_command_buffers.push_back(submission.command_buffer);
+        m_submissions.pop_front();
+    }
+
+    m_waiting_tasks.insert(m_waiting_tasks.begin(), std::make_move_iterator(unfinished.begin()), std::make_move_iterator(unfinished.end()));
+}
+
+/**
+ * Log why a task failed, free its staging, and let it release what else it holds before it is dropped.
+ */
+void Loader::fail_task(PendingTask& pending)
+{
+    try
+    {
+        std::rethrow_exception(pending.error);
+    }
+    catch (const std::exception& e)
+    {
+        PBL_CORE_ERROR("Failed to load asset {}: {}", pending.descriptor, e.what());
+    }
+    catch (...)
+    {
+        PBL_CORE_ERROR("Failed to load asset {}.", pending.descriptor);
+    }
+
+    pending.staging.free();
+    pending.task->on_load_failed();
 }
 
 
@@ -2,49 +2,191 @@
 
 #include "pblpch.h"
 
+#include <list>
+
 #include <vulkan/vulkan.hpp>
 
 #include "../Wrapper/PhysicalDevice.h"
 #include "../Wrapper/Device.h"
 #include "../Wrapper/CommandPool.h"
-#include "../Wrapper/CommandPool.h"
 
 #include "LoadTask.h"
+#include "StagingRing.h"
+
+#include "Asset/AssetDescriptor.h"
+#include "IO/File.h"
+#include "Jobs/JobSystem.h"
 
 namespace Parable::Vulkan
 {
 
 
 /**
- * Queues loading tasks for vulkan resources and dispatches tasks in bulk.
+ * Queues loading tasks for vulkan resources and streams them in without blocking the caller.
+ *
+ * Each update, the source reads of the submitted tasks are issued to the application's IO service,
+ * and the tasks whose reads have all finished are prepared on the application's job system,
+ * decoding what was read. Prepared tasks then wait, in
+ * order, for space in the staging ring for the next chunk of their upload, and each chunk is
+ * written to staging by a job. Each update, every batch whose staging has finished is recorded
+ * into one submission on the transfer queue, which signals the next value of a timeline semaphore.
+ * Later updates poll the semaphore, free the staging of every submission it has passed, and
+ * complete those tasks, or queue the next chunk of those with more to upload.
  */
 class Loader
 {
 private:
-    std::vector<std::unique_ptr<LoadTask>> m_tasks;
+    /**
+     * A submitted task and the asset it loads.
+     */
+    struct PendingTask
+    {
+        AssetDescriptor descriptor;
+        std::unique_ptr<LoadTask> task;
+        /**
+         * An exception thrown by one of the task's stages, which fails the task without stopping the others.
+         */
+        std::exception_ptr error;
+
+        /**
+         * The task's reads which the IO service has not finished yet.
+         */
+        size_t reads_in_flight = 0;
+
+        /**
+         * Where in the task's upload parts the next chunk starts.
+         */
+        size_t next_part = 0;
+        vk::DeviceSize next_part_offset = 0;
+
+        /**
+         * The chunk being staged or copied, and the memory it is staged in.
+         */
+        UploadChunk chunk;
+        StagingAllocation staging;
+    };
+
+    /**
+     * Tasks with a stage running on the job system, either being prepared or having a chunk written to staging.
+     */
+    struct JobBatch
+    {
+        std::vector<PendingTask> tasks;
+        JobCounter counter;
+    };
+
+    /**
+     * Tasks whose commands are executing on the GPU.
+     */
+    struct Submission
+    {
+        std::vector<PendingTask> tasks;
+        vk::CommandBuffer command_buffer;
+        /**
+         * The timeline semaphore value signalled when the commands finish.
+         */
+        uint64_t timeline_value;
+    };
+
+    /**
+     * The extent of a task's next chunk, laid out but not yet staged.
+     */
+    struct ChunkLayout
+    {
+        vk::DeviceSize size = 0;
+        /**
+         * Where in the task's upload parts the chunk ends.
+         */
+        size_t end_part = 0;
+        vk::DeviceSize end_part_offset = 0;
+    };
+
+    std::vector<PendingTask> m_tasks;
+    /**
+     * Tasks with reads in flight, listed so the read callbacks can refer to them as others come and go.
+     */
+    std::list<PendingTask> m_reading_tasks;
+    /**
+     * Tasks whose reads have all finished, to be prepared.
+     */
+    std::vector<PendingTask> m_read_tasks;
+    // batches are kept in submission order, and boxed as the job counter can not move
+    std::deque<std::unique_ptr<JobBatch>> m_preparing_batches;
+    /**
+     * Prepared tasks waiting for staging space for their next chunk, in the order they are staged.
+     */
+    std::deque<PendingTask> m_waiting_tasks;
+    std::deque<std::unique_ptr<JobBatch>> m_staging_batches;
+    std::deque<Submission> m_submissions;
 
     PhysicalDevice m_physical_device;
     Device m_device;
     
     vk::Queue m_transfer_queue;
 
+    /**
+     * Staging memory shared by every task.
+     */
+    StagingRing m_staging_ring;
+
     CommandPool m_command_pool;
-    vk::CommandBuffer m_command_buffer;
+    /**
+     * Command buffers from finished submissions, to reuse.
+     */
+    std::vector<vk::CommandBuffer> m_free_command_buffers;
+
+    vk::Semaphore m_timeline_semaphore;
+    uint64_t m_last_timeline_value = 0;
 
-    vk::Fence m_transfer_finished_fence;
+    void start_reading();
+    void finish_read(std::list<PendingTask>::iterator it, const IO::ReadResult& result, size_t size);
+    void start_preparing();
+    void collect_prepared(bool wait);
+    void stage_waiting();
+    void submit_staged(bool wait);
+    void complete_finished(bool wait);
+    void fail_task(PendingTask& pending);
+
+    ChunkLayout layout_chunk(PendingTask& pending) const;
 
 public:
-    Loader(Device device, PhysicalDevice physical_device, uint32_t transfer_family);
+    /**
+     * @param staging_ring_size The size of the staging memory shared by all tasks; larger uploads are split into chunks to fit it.
+     */
+    Loader(Device device, PhysicalDevice physical_device, uint32_t transfer_family, vk::DeviceSize staging_ring_size);
     ~Loader();
 
     /**
      * Submit a load task to be dispatched at some point in the future.
      * 
+     * A ResourceLoadedEvent for the descriptor is posted to the application once the task completes.
+     * 
+     * @param descriptor The asset the task loads.
      * @param task A unique pointer to the task object.
      */
-    void submit_task(std::unique_ptr<LoadTask> task);
+    void submit_task(AssetDescriptor descriptor, std::unique_ptr<LoadTask> task);
+
+    /**
+     * Advance loading without blocking, called once per frame.
+     *
+     * Completes the tasks whose GPU work has finished, submits those which have finished staging,
+     * stages the next chunk of waiting tasks while the staging ring has space, issues the reads of
+     * those submitted since the last update, and starts preparing those whose reads have finished.
+     */
+    void update();
 
-    void run_tasks();
+    /**
+     * Block until every submitted task has completed.
+     */
+    void flush();
+
+    /**
+     * Whether any task is still loading.
+     */
+    bool is_busy() const
+    {
+        return !m_tasks.empty() || !m_reading_tasks.empty() || !m_read_tasks.empty() || !m_preparing_batches.empty() || !m_waiting_tasks.empty() || !m_staging_batches.empty() || !m_submissions.empty();
+    }
 };
 
 
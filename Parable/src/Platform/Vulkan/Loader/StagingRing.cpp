@@ -0,0 +1,106 @@
+#include "StagingRing.h"
+
+#include "Core/Base.h"
+
+#include "../Wrapper/Device.h"
+#include "../Wrapper/PhysicalDevice.h"
+
+namespace Parable::Vulkan
+{
+
+
+/**
+ * Create a host visible buffer to stage from.
+ */
+static Buffer create_staging_buffer(Device& device, PhysicalDevice& physical_device, vk::DeviceSize size)
+{
+    BufferBuilder staging_buffer_builder;
+    staging_buffer_builder.buffer_info.size = size;
+    staging_buffer_builder.buffer_info.usage  = vk::BufferUsageFlagBits::eTransferSrc;
+    staging_buffer_builder.buffer_info.sharingMode = vk::SharingMode::eExclusive;
+    staging_buffer_builder.required_memory_properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+    return staging_buffer_builder.create(device, physical_device);
+}
+
+StagingRing::StagingRing(Device& device, PhysicalDevice& physical_device, vk::DeviceSize size)
+    : m_buffer(create_staging_buffer(device, physical_device, size))
+{
+    m_buffer.map(0, size);
+    m_map = static_cast<std::byte*>(m_buffer.get_map());
+
+    m_allocator.emplace(size, m_map, "Staging Ring");
+}
+
+void StagingRing::destroy()
+{
+    m_allocator.reset();
+
+    m_buffer.unmap();
+    m_buffer.destroy();
+}
+
+std::byte* StagingRing::allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+{
+    return static_cast<std::byte*>(m_allocator->allocate(size, alignment));
+}
+
+void StagingRing::free(std::byte* data)
+{
+    m_allocator->deallocate(data);
+}
+
+/**
+ * Allocate staging memory from the ring.
+ * 
+ * @return Whether the ring had space. If not nothing is allocated, and the caller should retry once earlier allocations are freed.
+ */
+bool StagingAllocation::allocate(StagingRing& ring, vk::DeviceSize size, vk::DeviceSize alignment)
+{
+    PBL_CORE_ASSERT_MSG(!m_data, "Staging memory is already allocated!")
+
+    m_data = ring.allocate(size, alignment);
+    if (!m_data) return false;
+
+    m_ring = &ring;
+    m_size = size;
+    return true;
+}
+
+/**
+ * Allocate staging memory in a buffer of its own, for data which can not fit in the ring however much of it is free.
+ */
+void StagingAllocation::allocate_dedicated(Device& device, PhysicalDevice& physical_device, vk::DeviceSize size)
+{
+    PBL_CORE_ASSERT_MSG(!m_data, "Staging memory is already allocated!")
+
+    m_own_buffer = create_staging_buffer(device, physical_device, size);
+    m_own_buffer.map(0, size);
+    m_data = static_cast<std::byte*>(m_own_buffer.get_map());
+    m_size = size;
+}
+
+/**
+ * Free the staging memory, once the copies from it have completed.
+ */
+void StagingAllocation::free()
+{
+    if (!m_data) return;
+
+    if (m_ring)
+    {
+        m_ring->free(m_data);
+        m_ring = nullptr;
+    }
+    else
+    {
+        m_own_buffer.unmap();
+        m_own_buffer.destroy();
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+
+}
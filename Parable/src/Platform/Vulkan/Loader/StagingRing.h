@@ -0,0 +1,95 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include "../Wrapper/Buffer.h"
+
+#include "Memory/RingAllocator.h"
+
+namespace Parable::Vulkan
+{
+
+
+class Device;
+class PhysicalDevice;
+
+/**
+ * A persistently mapped, host visible buffer which load tasks are staged in.
+ * 
+ * The loader allocates each task's staging in submission order, and frees it once the copies
+ * complete, which is close to the order it allocated in, so the buffer is managed as a ring.
+ * It is only used from the thread which owns the loader.
+ */
+class StagingRing
+{
+public:
+    /**
+     * The default alignment of allocations, enough for the texel blocks of every texture format.
+     */
+    static constexpr vk::DeviceSize COPY_ALIGNMENT = 16;
+
+    StagingRing(Device& device, PhysicalDevice& physical_device, vk::DeviceSize size);
+
+    /**
+     * Destroy the buffer, once every allocation is freed.
+     */
+    void destroy();
+
+    /**
+     * Allocate from the ring.
+     * 
+     * @return The mapped memory allocated, or nullptr if the ring has no space.
+     */
+    std::byte* allocate(vk::DeviceSize size, vk::DeviceSize alignment = COPY_ALIGNMENT);
+    void free(std::byte* data);
+
+    Buffer& get_buffer() { return m_buffer; }
+    vk::DeviceSize get_size() const { return m_buffer.get_size(); }
+    /**
+     * The offset into the buffer of allocated memory.
+     */
+    vk::DeviceSize get_offset(const std::byte* data) const { return data - m_map; }
+
+private:
+    Buffer m_buffer;
+    std::byte* m_map;
+
+    std::optional<RingAllocator> m_allocator;
+};
+
+/**
+ * Staging memory for one chunk of an upload, taken from the ring, or from a buffer of its own as a last resort.
+ * 
+ * The memory is mapped for as long as it is allocated.
+ */
+class StagingAllocation
+{
+public:
+    bool allocate(StagingRing& ring, vk::DeviceSize size, vk::DeviceSize alignment = StagingRing::COPY_ALIGNMENT);
+    void allocate_dedicated(Device& device, PhysicalDevice& physical_device, vk::DeviceSize size);
+    void free();
+
+    /**
+     * The buffer to copy from, at get_offset.
+     */
+    Buffer& get_buffer() { return m_ring ? m_ring->get_buffer() : m_own_buffer; }
+    vk::DeviceSize get_offset() const { return m_ring ? m_ring->get_offset(m_data) : 0; }
+
+    std::byte* get_data() const { return m_data; }
+    vk::DeviceSize get_size() const { return m_size; }
+
+private:
+    /**
+     * The ring allocated from, or null if the memory is in m_own_buffer.
+     */
+    StagingRing* m_ring = nullptr;
+    Buffer m_own_buffer;
+
+    std::byte* m_data = nullptr;
+    vk::DeviceSize m_size = 0;
+};
+
+
+}
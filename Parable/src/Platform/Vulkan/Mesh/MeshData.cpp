@@ -1,5 +1,7 @@
 #include "MeshData.h"
 
+#include <spanstream>
+
 #include "Core/Base.h"
 
 #define TINYOBJLOADER_IMPLEMENTATION
@@ -7,6 +9,12 @@
 
 #include "../Wrapper/Vertex.h"
 
+#include "Util/FlatHashMap.h"
+
+#include "Asset/CookedMesh.h"
+
+#include "Exception/IOExceptions.h"
+
 namespace Parable::Vulkan
 {
 
@@ -21,22 +29,46 @@ size_t MeshData::get_indices_size() const
     return sizeof(m_indices[0]) * m_indices.size();
 }
 
-MeshData MeshData::from_obj(const std::string& obj_path)
+/**
+ * Write the mesh as a .pblmesh, with a single LOD covering every index.
+ *
+ * @param path the file to write
+ */
+void MeshData::write_cooked(const std::string& path) const
 {
-    // load an obj model
-    // will throw a runtime error if file badly formatted
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-    bool success = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, obj_path.c_str());
+    CookedMeshData cooked;
+    cooked.vertex_stride = sizeof(Vertex);
+    std::ranges::copy(Vertex::get_mesh_attributes(), std::back_inserter(cooked.attributes));
+    cooked.vertices = std::as_bytes(std::span(m_vertices));
+    cooked.indices = m_indices;
 
-    PBL_CORE_ASSERT_MSG(success, "tinyobj failed: {} : {}", warn, err);
+    if (!m_vertices.empty())
+    {
+        glm::vec3 min = m_vertices[0].pos;
+        glm::vec3 max = m_vertices[0].pos;
+        for (const Vertex& vertex : m_vertices)
+        {
+            min = glm::min(min, vertex.pos);
+            max = glm::max(max, vertex.pos);
+        }
+        cooked.bounds_min = { min.x, min.y, min.z };
+        cooked.bounds_max = { max.x, max.y, max.z };
+    }
+
+    cooked.lods.push_back({ .first_index = 0, .index_count = (uint32_t)m_indices.size(), .max_distance = std::numeric_limits<float>::infinity() });
+
+    CookedMesh::write(path, cooked);
+}
 
+/**
+ * Collect the shapes of a loaded obj into one mesh, deduplicating vertices.
+ */
+static MeshData build_mesh(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::shape_t>& shapes)
+{
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
 
-    std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+    Util::FlatHashMap<Vertex, uint32_t, VertexHash> uniqueVertices{};
     // collect all the shapes to one vertices array
     // dedupe vertices
     for (const auto& shape : shapes) {
@@ -60,12 +92,12 @@ MeshData MeshData::from_obj(const std::string& obj_path)
                 }
             };
             
-            if (uniqueVertices.find(vertex) == uniqueVertices.end()) {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+            auto [it, inserted] = uniqueVertices.try_emplace(vertex, static_cast<uint32_t>(vertices.size()));
+            if (inserted) {
                 vertices.push_back(vertex);
             }
 
-            indices.push_back(uniqueVertices[vertex]);
+            indices.push_back(it->second);
         }
     }
 
@@ -73,4 +105,48 @@ MeshData MeshData::from_obj(const std::string& obj_path)
 }
 
 
+MeshData MeshData::from_obj(const std::string& obj_path)
+{
+    // load an obj model
+    // will throw a runtime error if file badly formatted
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+    bool success = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, obj_path.c_str());
+
+    PBL_CORE_ASSERT_MSG(success, "tinyobj failed: {} : {}", warn, err);
+
+    return build_mesh(attrib, shapes);
+}
+
+/**
+ * Parse an obj file already read into memory.
+ *
+ * @param obj the contents of the file
+ * @param obj_path the file it was read from, for error messages
+ *
+ * @throws Parable::FileFormatException if the obj can not be parsed
+ */
+MeshData MeshData::from_obj(std::span<const std::byte> obj, const std::string& obj_path)
+{
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+
+    // materials are looked up relative to the working directory, as when loading from the path
+    std::ispanstream stream(std::span<const char>(reinterpret_cast<const char*>(obj.data()), obj.size()));
+    tinyobj::MaterialFileReader material_reader("");
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &stream, &material_reader))
+    {
+        PBL_CORE_ERROR("Failed to parse obj {}: {} : {}", obj_path, warn, err);
+        throw FileFormatException("Failed to parse obj file.");
+    }
+
+    return build_mesh(attrib, shapes);
+}
+
+
+
 }
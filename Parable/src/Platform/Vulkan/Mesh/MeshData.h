@@ -1,6 +1,9 @@
 #pragma once
 
 #include "pblpch.h"
+
+#include <span>
+
 #include "../Wrapper/Vertex.h"
 
 namespace Parable::Vulkan
@@ -22,6 +25,7 @@ public:
     {
         m_vertices = std::move(other.m_vertices);
         m_indices = std::move(other.m_indices);
+        return *this;
     }
 
     const std::vector<Vertex>& get_vertices() const { return m_vertices; };
@@ -30,7 +34,10 @@ public:
     size_t get_vertices_size() const;
     size_t get_indices_size() const;
 
+    void write_cooked(const std::string& path) const;
+
     static MeshData from_obj(const std::string& obj_path);
+    static MeshData from_obj(std::span<const std::byte> obj, const std::string& obj_path);
 };
 
 
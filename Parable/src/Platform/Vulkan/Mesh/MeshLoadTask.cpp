@@ -6,9 +6,10 @@
 #include "../Wrapper/Buffer.h"
 #include "../Wrapper/BufferSuballocator.h"
 
-#include "MeshData.h"
 #include "Mesh.h"
 
+#include "Core/Application.h"
+
 #include "Asset/ResourceState.h"
 #include "Asset/AssetLoadInfo.h"
 
@@ -18,71 +19,146 @@ namespace Parable::Vulkan
 
 MeshLoadTask::MeshLoadTask(
     const MeshLoadInfo& load_info,
+    PackedAsset packed,
     Parable::ResourceStorageBlock<Parable::Mesh>& mesh_storage,
     BufferSuballocator& vertex_target_suballocator,
-    BufferSuballocator& index_target_suballocator
+    BufferSuballocator& index_target_suballocator,
+    std::function<void(size_t)> on_out_of_space
 )
     : m_load_info(load_info),
+    m_packed(packed),
     m_mesh_storage(mesh_storage),
     m_vertex_target_suballocator(vertex_target_suballocator),
-    m_index_target_suballocator(index_target_suballocator)
+    m_index_target_suballocator(index_target_suballocator),
+    m_on_out_of_space(std::move(on_out_of_space))
 {}
 
-void MeshLoadTask::record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer)
+/**
+ * Check a cooked mesh was cooked with the renderer's vertex layout.
+ */
+static void check_layout(const CookedMesh& cooked_mesh)
+{
+    if (!cooked_mesh.has_layout(sizeof(Vertex), Vertex::get_mesh_attributes()) || cooked_mesh.get_index_size() != sizeof(uint32_t))
+    {
+        PBL_CORE_ERROR("A cooked mesh does not match the renderer vertex layout, it must be recooked.");
+        throw std::runtime_error("Cooked mesh has the wrong vertex layout!");
+    }
+}
+
+void MeshLoadTask::get_reads(std::vector<FileRead>& reads)
+{
+    if (m_packed)
+    {
+        m_source.resize(m_packed.entry->size);
+        reads.push_back({ &m_packed.archive->get_file(), m_packed.entry->offset, m_source });
+        return;
+    }
+
+    m_source_file = IO::File(m_load_info.is_cooked() ? m_load_info.get_pblmesh_path() : m_load_info.get_obj_path());
+    m_source.resize(m_source_file.size());
+    reads.push_back({ &m_source_file, 0, m_source });
+}
+
+void MeshLoadTask::prepare()
 {
-    MeshData mesh_data = MeshData::from_obj(m_load_info.get_obj_path());
+    // a cooked mesh is decompressed if need be and copied to staging as is, otherwise parse the source obj
+    if (m_packed && m_packed.archive->is_compressed(*m_packed.entry))
+    {
+        m_decompressed.resize(m_packed.archive->get_uncompressed_size(*m_packed.entry));
+        m_packed.archive->decode(*m_packed.entry, m_source, m_decompressed, &Application::get_instance().get_job_system());
+        m_source = {};
+        m_cooked_mesh.emplace(m_decompressed, "packed mesh");
+    }
+    else if (m_packed)
+    {
+        m_cooked_mesh.emplace(m_source, "packed mesh");
+    }
+    else if (m_load_info.is_cooked())
+    {
+        m_cooked_mesh.emplace(m_source, m_load_info.get_pblmesh_path());
+    }
 
-    // allocate ranges in the GPU buffers for the data
-    // as we now know how big it is
-    BufferSlice vertex_slice = m_vertex_target_suballocator.allocate(mesh_data.get_vertices_size());
-    if (vertex_slice.size == 0) 
+    if (m_cooked_mesh)
     {
-        throw std::runtime_error("Out of vertex buffer space!");
+        check_layout(*m_cooked_mesh);
+
+        m_parts[0] = { m_cooked_mesh->get_vertex_data(), true };
+        m_parts[1] = { m_cooked_mesh->get_index_data(), true };
+    }
+    else
+    {
+        m_mesh_data = MeshData::from_obj(m_source, m_load_info.get_obj_path());
+        m_source = {};
+
+        m_parts[0] = { std::as_bytes(std::span(m_mesh_data.get_vertices())), true };
+        m_parts[1] = { std::as_bytes(std::span(m_mesh_data.get_indices())), true };
+    }
+}
+
+void MeshLoadTask::record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer, const UploadChunk& chunk)
+{
+    if (chunk.first)
+    {
+        // allocate ranges in the GPU buffers for the data
+        // as we now know how big it is
+        m_vertex_slice = m_vertex_target_suballocator.allocate(m_parts[0].data.size());
+        if (m_vertex_slice.size == 0) 
+        {
+            m_out_of_space_size = m_parts[0].data.size() + m_parts[1].data.size();
+            throw std::runtime_error("Out of vertex buffer space!");
+        }
+        m_index_slice = m_index_target_suballocator.allocate(m_parts[1].data.size());
+        if (m_index_slice.size == 0) 
+        {
+            m_vertex_target_suballocator.free(m_vertex_slice);
+            m_vertex_slice = BufferSlice();
+            m_out_of_space_size = m_parts[0].data.size() + m_parts[1].data.size();
+            throw std::runtime_error("Out of index buffer space!");
+        }
+
+        // we are now able to set the Mesh information correctly
+        m_mesh_storage.set_resource(std::make_unique<Mesh>(m_vertex_slice, m_index_slice));
+        m_mesh_storage.set_resident_size(m_vertex_slice.size + m_index_slice.size);
     }
-    BufferSlice index_slice = m_index_target_suballocator.allocate(mesh_data.get_indices_size());
-    if (index_slice.size == 0) 
+
+    // record copy commands, part 0 holding vertices and part 1 indices
+    for (const StagedRange& range : chunk.ranges)
     {
-        throw std::runtime_error("Out of index buffer space!");
+        BufferSuballocator& target = range.part == 0 ? m_vertex_target_suballocator : m_index_target_suballocator;
+        const BufferSlice& slice = range.part == 0 ? m_vertex_slice : m_index_slice;
+
+        target.get_buffer().copy_from(*chunk.staging_buffer, range.staging_offset, slice.start + range.part_offset, range.size, command_buffer);
     }
-    
-    // we are now able to set the Mesh information correctly
-    m_mesh_storage.set_resource(std::make_unique<Mesh>(vertex_slice, index_slice));
-
-    // copy data to staging buffers
-    // TODO: in future can pre-allocate staging buffers and keep around
-    //      prealloc some sensible size, and grow if need to load larger model
-    //          (or could use multiple transfer commands for larger meshes??)
-    BufferBuilder vertex_staging_buffer_builder;
-    vertex_staging_buffer_builder.buffer_info.size = mesh_data.get_vertices_size();
-    vertex_staging_buffer_builder.buffer_info.usage  = vk::BufferUsageFlagBits::eTransferSrc;
-    vertex_staging_buffer_builder.buffer_info.sharingMode = vk::SharingMode::eExclusive;
-    vertex_staging_buffer_builder.required_memory_properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
-
-    m_vertex_staging_buffer = vertex_staging_buffer_builder.create(device, physical_device);
-    m_vertex_staging_buffer.write((void*)mesh_data.get_vertices().data(), 0, mesh_data.get_vertices_size());
-
-    BufferBuilder index_staging_buffer_builder;
-    index_staging_buffer_builder.buffer_info.size = mesh_data.get_indices_size();
-    index_staging_buffer_builder.buffer_info.usage  = vk::BufferUsageFlagBits::eTransferSrc;
-    index_staging_buffer_builder.buffer_info.sharingMode = vk::SharingMode::eExclusive;
-    index_staging_buffer_builder.required_memory_properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
-
-    m_index_staging_buffer = index_staging_buffer_builder.create(device, physical_device);
-    m_index_staging_buffer.write((void*)mesh_data.get_indices().data(), 0, mesh_data.get_indices_size());
-
-    // record copy commands
-    m_vertex_target_suballocator.get_buffer().copy_from(m_vertex_staging_buffer, 0, vertex_slice.start, vertex_slice.size, command_buffer);
-    m_index_target_suballocator.get_buffer().copy_from(m_index_staging_buffer, 0, index_slice.start, index_slice.size, command_buffer);
 }
 
 void MeshLoadTask::on_load_complete()
 {
-    m_vertex_staging_buffer.destroy();
-    m_index_staging_buffer.destroy();
+    // the source is no longer needed once copied
+    m_cooked_mesh.reset();
+    m_mesh_data = MeshData();
+    m_decompressed = {};
+    m_source = {};
+    m_source_file = IO::File();
 
     // update the state block to show the mesh is now loaded
     m_mesh_storage.set_load_state(Parable::ResourceLoadState::Loaded);
 }
 
+void MeshLoadTask::on_load_failed()
+{
+    // an earlier chunk may have allocated the mesh's buffer ranges, which nothing else refers to yet
+    if (m_vertex_slice.size > 0)
+    {
+        m_mesh_storage.take_resource();
+        m_vertex_target_suballocator.free(m_vertex_slice);
+        m_index_target_suballocator.free(m_index_slice);
+    }
+
+    m_mesh_storage.set_load_state(Parable::ResourceLoadState::Unloaded);
+
+    // the buffers may be full or fragmented within budget, so the store evicts to make room
+    if (m_out_of_space_size > 0) m_on_out_of_space(m_out_of_space_size);
+}
+
 
 }
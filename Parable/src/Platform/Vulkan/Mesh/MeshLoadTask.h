@@ -2,8 +2,16 @@
 
 #include "pblpch.h"
 
+#include <span>
+
 #include "../Loader/LoadTask.h"
-#include "../Wrapper/Buffer.h"
+#include "../Wrapper/BufferSlice.h"
+
+#include "Asset/AssetArchive.h"
+#include "Asset/CookedMesh.h"
+#include "IO/File.h"
+
+#include "MeshData.h"
 
 namespace Parable
 {
@@ -34,31 +42,75 @@ class MeshLoadTask : public LoadTask
 {
 private:
     const MeshLoadInfo& m_load_info;
+    /**
+     * The cooked mesh in a mounted archive, empty to load from the load info's files.
+     */
+    PackedAsset m_packed;
 
     Parable::ResourceStorageBlock<Parable::Mesh>& m_mesh_storage;
 
     BufferSuballocator& m_vertex_target_suballocator;
     BufferSuballocator& m_index_target_suballocator;
 
-    Buffer m_vertex_staging_buffer;
-    Buffer m_index_staging_buffer;
+    /**
+     * The file the source is read from, when it is not in an archive, and the data read.
+     */
+    IO::File m_source_file;
+    std::vector<std::byte> m_source;
+
+    // the prepared source, from prepare until the load completes
+    std::vector<std::byte> m_decompressed;
+    std::optional<CookedMesh> m_cooked_mesh;
+    MeshData m_mesh_data;
+
+    /**
+     * The vertex data then the index data, either of which may be split between chunks.
+     */
+    UploadPart m_parts[2];
+
+    /**
+     * The ranges of the GPU buffers the mesh is copied to, allocated by the first chunk.
+     */
+    BufferSlice m_vertex_slice = {};
+    BufferSlice m_index_slice = {};
+
+    /**
+     * Called with the bytes needed if the mesh does not fit in the buffers, so the store can make room and retry.
+     */
+    std::function<void(size_t)> m_on_out_of_space;
+    size_t m_out_of_space_size = 0;
 
 public:
     MeshLoadTask(
         const MeshLoadInfo& load_info,
+        PackedAsset packed,
         Parable::ResourceStorageBlock<Parable::Mesh>& mesh_storage,
         BufferSuballocator& vertex_target_suballocator,
-        BufferSuballocator& index_target_suballocator
+        BufferSuballocator& index_target_suballocator,
+        std::function<void(size_t)> on_out_of_space
     );
 
     /**
-     * Record buffer copy commands.
+     * Read the cooked mesh from its archive or file, or the source obj.
      */
-    void record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer) override;
+    void get_reads(std::vector<FileRead>& reads) override;
     /**
-     * Release staging buffer resources.
+     * Decompress the cooked mesh, or parse the source obj.
+     */
+    void prepare() override;
+    std::span<const UploadPart> get_upload_parts() const override { return m_parts; }
+    /**
+     * Allocate the mesh's buffer ranges with the first chunk, and record buffer copy commands.
+     */
+    void record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer, const UploadChunk& chunk) override;
+    /**
+     * Release the prepared source.
      */
     void on_load_complete() override;
+    /**
+     * Release any buffer ranges allocated, leaving the mesh unloaded, and report if it did not fit.
+     */
+    void on_load_failed() override;
 
     // unused
     void create_device_resources(Device& device) {}
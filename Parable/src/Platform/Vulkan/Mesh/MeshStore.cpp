@@ -2,6 +2,7 @@
 
 #include "pblpch.h"
 
+#include "Mesh.h"
 #include "MeshData.h"
 #include "MeshLoadTask.h"
 
@@ -18,7 +19,17 @@ std::unique_ptr<LoadTask> MeshStore::create_load_task(AssetDescriptor descriptor
 {
     const Parable::MeshLoadInfo& load_info = AssetRegistry::resolve<Parable::MeshLoadInfo>(descriptor);
 
-    return std::make_unique<MeshLoadTask>(load_info, storage_block, m_vertex_buffer_suballocator, m_index_buffer_suballocator);
+    auto on_out_of_space = [this, descriptor, &storage_block](size_t size) { defer_load(descriptor, storage_block, size); };
+
+    return std::make_unique<MeshLoadTask>(load_info, AssetRegistry::resolve_packed(descriptor), storage_block, m_vertex_buffer_suballocator, m_index_buffer_suballocator, std::move(on_out_of_space));
+}
+
+void MeshStore::destroy_resource(Parable::Mesh& resource)
+{
+    Mesh& mesh = static_cast<Mesh&>(resource);
+
+    m_vertex_buffer_suballocator.free(mesh.get_vertex_slice());
+    m_index_buffer_suballocator.free(mesh.get_index_slice());
 }
 
 
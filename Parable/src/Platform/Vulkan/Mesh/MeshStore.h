@@ -30,8 +30,8 @@ private:
     BufferSuballocator m_index_buffer_suballocator;
 
 public:
-    MeshStore(Buffer vertex_buffer, Buffer index_buffer, Loader& loader)
-        : ResourceStore<Parable::Mesh>(loader),
+    MeshStore(Buffer vertex_buffer, Buffer index_buffer, Loader& loader, size_t memory_budget)
+        : ResourceStore<Parable::Mesh>(loader, memory_budget),
         m_vertex_buffer_suballocator(vertex_buffer),
         m_index_buffer_suballocator(index_buffer)
     {}
@@ -40,6 +40,7 @@ public:
     Buffer& get_index_buffer() { return m_index_buffer_suballocator.get_buffer(); }
 
     std::unique_ptr<LoadTask> create_load_task(AssetDescriptor descriptor, ResourceStorageBlock<Parable::Mesh>& storage_block) override;
+    void destroy_resource(Parable::Mesh& resource) override;
 };
 
 
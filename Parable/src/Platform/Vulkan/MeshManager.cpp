@@ -7,6 +7,8 @@
 
 #include "Wrapper/Vertex.h"
 
+#include "Util/FlatHashMap.h"
+
 #include "UniformBufferObjects.h"
 
 namespace Parable::Vulkan
@@ -27,7 +29,7 @@ MeshHandle MeshManager::load_mesh(std::string path)
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
 
-    std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+    Util::FlatHashMap<Vertex, uint32_t, VertexHash> uniqueVertices{};
     // collect all the shapes to one vertices array
     // dedupe vertices
     for (const auto& shape : shapes) {
@@ -51,12 +53,12 @@ MeshHandle MeshManager::load_mesh(std::string path)
                 }
             };
             
-            if (uniqueVertices.find(vertex) == uniqueVertices.end()) {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+            auto [it, inserted] = uniqueVertices.try_emplace(vertex, static_cast<uint32_t>(vertices.size()));
+            if (inserted) {
                 vertices.push_back(vertex);
             }
 
-            indices.push_back(uniqueVertices[vertex]);
+            indices.push_back(it->second);
         }
     }
 
@@ -193,6 +193,12 @@ Renderer::Renderer(GLFWwindow* window) : m_window(window)
     // specify the device features we need
     vk::PhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = true;
+    // block compressed textures are used where available
+    deviceFeatures.textureCompressionBC = m_physical_device->getFeatures().textureCompressionBC;
+
+    // the resource loader tracks its transfers with a timeline semaphore, core and required since 1.2
+    vk::PhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.timelineSemaphore = true;
 
     // creating the actual logical device
     vk::DeviceCreateInfo deviceCreateInfo(
@@ -200,7 +206,8 @@ Renderer::Renderer(GLFWwindow* window) : m_window(window)
         queueCreateInfos,
         validationLayers,
         requiredDeviceExtensions,
-        &deviceFeatures
+        &deviceFeatures,
+        &vulkan12Features
     );
     
     m_device = Device(m_physical_device, deviceCreateInfo);
@@ -588,7 +595,7 @@ Renderer::Renderer(GLFWwindow* window) : m_window(window)
 
     // CREATE resource loader
 
-    m_resource_loader = std::make_unique<Loader>(m_device, m_physical_device, queueFamilyIndices.transfer_family);
+    m_resource_loader = std::make_unique<Loader>(m_device, m_physical_device, queueFamilyIndices.transfer_family, STAGING_RING_SIZE);
 
     // CREATE mesh store
 
@@ -609,10 +616,10 @@ Renderer::Renderer(GLFWwindow* window) : m_window(window)
 
     Buffer index_buffer = index_buffer_builder.create(m_device, m_physical_device);
 
-    m_mesh_store = std::make_unique<MeshStore>(vertex_buffer, index_buffer, *m_resource_loader);
+    m_mesh_store = std::make_unique<MeshStore>(vertex_buffer, index_buffer, *m_resource_loader, MESH_MEMORY_BUDGET);
 
     // CREATE tex store
-    m_texture_store = std::make_unique<TextureStore>(m_device, m_material_descriptor_set_layout, *m_resource_loader);
+    m_texture_store = std::make_unique<TextureStore>(m_device, m_material_descriptor_set_layout, *m_resource_loader, TEXTURE_MEMORY_BUDGET);
 }
 
 Renderer::~Renderer()
@@ -623,6 +630,9 @@ Renderer::~Renderer()
     // wait until the device has finished working
     (*m_device).waitIdle();
 
+    // completes any loads still in flight, so needs the device
+    m_resource_loader.reset();
+
     m_framebuffers.destroy();
     m_swapchain.destroy();
 
@@ -799,7 +809,8 @@ void Renderer::on_update()
         return;
     }    
 
-    m_resource_loader->run_tasks();
+    // streams in loads without waiting on them, so a load never stalls the frame
+    m_resource_loader->update();
 
     const FramebufferData& framebufferData = m_framebuffers[m_current_frame];
 
@@ -809,6 +820,10 @@ void Renderer::on_update()
         throw std::runtime_error("failed to wait for inflight fence");
     }
 
+    // the frames which could use resources evicted now have finished by the time they are destroyed
+    m_mesh_store->update_residency(m_frame_count, MAX_FRAMES_IN_FLIGHT);
+    m_texture_store->update_residency(m_frame_count, MAX_FRAMES_IN_FLIGHT);
+
     // aquire image from the swapchain
     vk::ResultValue<uint32_t> imageResult = (*m_device).acquireNextImageKHR(m_swapchain, UINT64_MAX, framebufferData.image_available_sem, VK_NULL_HANDLE);
     
@@ -866,10 +881,8 @@ void Renderer::on_update()
         throw std::runtime_error("failed to present");
     }
 
-    // run loading stuff here to simulate async loading
-    // m_resource_loader->run_tasks();
-
     m_current_frame = (m_current_frame + 1) % MAX_FRAMES_IN_FLIGHT; // go to the next frame origin
+    ++m_frame_count;
 }
 
 
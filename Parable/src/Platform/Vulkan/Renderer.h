@@ -131,7 +131,20 @@ private:
     std::vector<DrawCall> m_draw_calls;
 
     const size_t MAX_FRAMES_IN_FLIGHT = 2;
+    /**
+     * Size of the staging memory the resource loader keeps mapped for uploads.
+     */
+    const vk::DeviceSize STAGING_RING_SIZE = MB(32);
+    /**
+     * GPU memory loaded meshes and textures may hold before unreferenced ones are evicted.
+     */
+    const size_t MESH_MEMORY_BUDGET = MB(3);
+    const size_t TEXTURE_MEMORY_BUDGET = MB(256);
     int m_current_frame = 0;
+    /**
+     * Count of frames recorded, which orders the destruction of evicted resources after the frames using them.
+     */
+    uint64_t m_frame_count = 0;
 
     bool m_resized = false;
 
@@ -9,9 +9,9 @@ namespace Parable::Vulkan
 {
 
 
-void ResourceLoader::submit_load_task(std::unique_ptr<LoadTask> task)
+void ResourceLoader::submit_load_task(AssetDescriptor descriptor, std::unique_ptr<LoadTask> task)
 {
-    m_loader.submit_task(std::move(task));
+    m_loader.submit_task(descriptor, std::move(task));
 }
 
 
@@ -2,8 +2,12 @@
 
 #include "pblpch.h"
 
+#include <deque>
+
 #include "Core/Base.h"
 
+#include "Util/FlatHashMap.h"
+
 #include "Asset/AssetDescriptor.h"
 #include "Asset/Handle.h"
 #include "Asset/ResourceState.h"
@@ -25,21 +29,79 @@ private:
     Loader& m_loader;
 
 protected:
-    void submit_load_task(std::unique_ptr<LoadTask> task);
+    void submit_load_task(AssetDescriptor descriptor, std::unique_ptr<LoadTask> task);
     ResourceLoader(Loader& loader) : m_loader(loader) {}
 };
 
 /**
  * Handles the storage and lookup of Vulkan resources.
+ * 
+ * Loaded resources with no handles are evicted, least recently released first, while the store
+ * is over its memory budget, or when a load does not fit in memory the store sub-allocates from.
+ * Their storage blocks are kept, so loading an evicted resource again reloads it into the same block.
  */
 template<class ResourceType>
 class ResourceStore : public ResourceLoader
 {
 private:
+    /**
+     * Storage for the blocks handles point to, a deque so blocks never move as it grows.
+     */
+    std::deque<ResourceStorageBlock<ResourceType>> m_storage_blocks;
     /**
      * Maps previously loaded Resources from their descriptors for lookup.
      */
-    std::map<AssetDescriptor,ResourceStorageBlock<ResourceType>> m_descriptor_resource_map;
+    Util::FlatHashMap<AssetDescriptor, ResourceStorageBlock<ResourceType>*> m_descriptor_resource_map;
+
+    ResidencyList m_residency;
+
+    /**
+     * An evicted resource, which frames still in flight may use.
+     */
+    struct RetiredResource
+    {
+        /**
+         * The frame the resource was evicted before.
+         */
+        uint64_t frame;
+        std::unique_ptr<ResourceType> resource;
+    };
+    std::deque<RetiredResource> m_retired_resources;
+
+    /**
+     * A load which failed for want of space in a fixed buffer, retried once resources are evicted to make room.
+     */
+    struct DeferredLoad
+    {
+        AssetDescriptor descriptor;
+        ResourceStorageBlock<ResourceType>* storage_block;
+        /**
+         * The bytes the load needs.
+         */
+        size_t size;
+        /**
+         * The frame the resources evicted for it are destroyed by, 0 until they are evicted.
+         */
+        uint64_t retry_frame = 0;
+    };
+    std::vector<DeferredLoad> m_deferred_loads;
+
+    void retire(ResourceStorageBlock<ResourceType>& storage_block, uint64_t frame)
+    {
+        m_retired_resources.push_back({ frame, storage_block.take_resource() });
+        storage_block.set_load_state(ResourceLoadState::Unloaded);
+    }
+
+    void start_load(AssetDescriptor descriptor, ResourceStorageBlock<ResourceType>& storage_block)
+    {
+        // if the asset cannot be resolved this throws with the block still Unloaded, so a later load retries it
+        std::unique_ptr<LoadTask> load_task = create_load_task(descriptor, storage_block);
+
+        // its state block goes into the Loading state until the data is uploaded to the GPU
+        storage_block.set_load_state(ResourceLoadState::Loading);
+
+        submit_load_task(descriptor, std::move(load_task));
+    }
 
 protected:
     /**
@@ -51,8 +113,38 @@ protected:
      */
     virtual std::unique_ptr<LoadTask> create_load_task(AssetDescriptor descriptor, ResourceStorageBlock<ResourceType>& storage_block) = 0;
 
+    /**
+     * @brief Release the GPU memory and objects of an evicted resource, once no frame can use it.
+     * 
+     * @param resource The resource to destroy.
+     */
+    virtual void destroy_resource(ResourceType& resource) = 0;
+
+    /**
+     * @brief Retry a load which failed because it did not fit, though the store may be within budget.
+     * 
+     * Unreferenced resources are evicted until as many bytes are freed, and the load restarts once
+     * no frame can use them. It is dropped if nothing can be evicted.
+     * 
+     * @param descriptor The asset which failed to load.
+     * @param storage_block The block it was loading into.
+     * @param size The bytes of space it needs.
+     */
+    void defer_load(AssetDescriptor descriptor, ResourceStorageBlock<ResourceType>& storage_block, size_t size)
+    {
+        for (const DeferredLoad& deferred : m_deferred_loads)
+        {
+            if (deferred.storage_block == &storage_block) return;
+        }
+
+        m_deferred_loads.push_back({ descriptor, &storage_block, size });
+    }
+
 public:
-    ResourceStore(Loader& loader) : ResourceLoader(loader) {}
+    /**
+     * @param memory_budget The bytes of GPU memory loaded resources may hold before unreferenced ones are evicted.
+     */
+    ResourceStore(Loader& loader, size_t memory_budget) : ResourceLoader(loader), m_residency(memory_budget) {}
 
     /**
      * @brief Get a handle to a resource, loading it if it is not already loaded.
@@ -63,23 +155,90 @@ public:
     Handle<ResourceType> load(AssetDescriptor descriptor)
     {
         // first see if we already have this resource
-        // TODO: what if the state is ::Unloaded? Should initiate loading but reuse the storage block
-        auto hint = m_descriptor_resource_map.lower_bound(descriptor);
-        if (hint != m_descriptor_resource_map.end() && hint->first == descriptor)
+        auto [it, inserted] = m_descriptor_resource_map.try_emplace(descriptor, nullptr);
+        if (!inserted)
         {
-            return Handle<ResourceType>(hint->second);
+            // an evicted resource reloads into its old block, so any handles kept to it stay valid
+            if (it->second->get_load_state() == ResourceLoadState::Unloaded)
+            {
+                start_load(descriptor, *it->second);
+            }
+            return Handle<ResourceType>(*it->second);
         }
         
-        // its state block goes into the Loading state until the mesh data is uploaded to GPU buffers
-        auto it = m_descriptor_resource_map.emplace_hint(hint, descriptor, ResourceStorageBlock<ResourceType>());
-        it->second.set_load_state(ResourceLoadState::Loading);
+        ResourceStorageBlock<ResourceType>& storage_block = m_storage_blocks.emplace_back();
+        it->second = &storage_block;
+        storage_block.set_residency(&m_residency);
+
+        start_load(descriptor, storage_block);
+
+        return Handle<ResourceType>(storage_block);
+    }
+
+    /**
+     * @brief Evict unreferenced resources while over budget, and destroy those evicted before any frame still in flight.
+     * 
+     * Also evicts to make room for deferred loads, and restarts them once what they evicted is destroyed.
+     * 
+     * Called once per frame, before recording the frame.
+     * 
+     * @param frame The index of the frame about to be recorded.
+     * @param frames_in_flight How many frames may be executing on the GPU at once.
+     */
+    void update_residency(uint64_t frame, uint64_t frames_in_flight)
+    {
+        while (!m_retired_resources.empty() && m_retired_resources.front().frame + frames_in_flight <= frame)
+        {
+            destroy_resource(*m_retired_resources.front().resource);
+            m_retired_resources.pop_front();
+        }
 
-        // now we must submit a load task to copy the mesh data to gpu buffers
-        std::unique_ptr<LoadTask> load_task = create_load_task(descriptor, it->second);
-        submit_load_task(std::move(load_task));
+        while (ResourceState* state = m_residency.pop_eviction_candidate())
+        {
+            retire(static_cast<ResourceStorageBlock<ResourceType>&>(*state), frame);
+        }
 
-        return Handle<ResourceType>(it->second);
+        // loads which did not fit evict what they need even within budget, then wait for it to be destroyed
+        for (auto it = m_deferred_loads.begin(); it != m_deferred_loads.end();)
+        {
+            if (it->retry_frame == 0)
+            {
+                size_t evicted = 0;
+                while (evicted < it->size)
+                {
+                    ResourceState* state = m_residency.pop_least_recent();
+                    if (!state) break;
+
+                    evicted += state->get_resident_size();
+                    retire(static_cast<ResourceStorageBlock<ResourceType>&>(*state), frame);
+                }
+
+                if (evicted == 0)
+                {
+                    PBL_CORE_ERROR("Asset {} does not fit, and nothing can be evicted to make room.", it->descriptor);
+                    it = m_deferred_loads.erase(it);
+                    continue;
+                }
+
+                it->retry_frame = frame + frames_in_flight;
+            }
+
+            if (it->retry_frame <= frame)
+            {
+                // a load() since may have restarted it already
+                if (it->storage_block->get_load_state() == ResourceLoadState::Unloaded)
+                {
+                    start_load(it->descriptor, *it->storage_block);
+                }
+                it = m_deferred_loads.erase(it);
+                continue;
+            }
+
+            ++it;
+        }
     }
+
+    const ResidencyList& get_residency() const { return m_residency; }
 };
 
 
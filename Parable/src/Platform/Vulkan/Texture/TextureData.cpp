@@ -6,6 +6,11 @@
 
 #include "Core/Base.h"
 
+#include "Asset/CookedTexture.h"
+#include "Asset/TextureEncoder.h"
+
+#include "Exception/IOExceptions.h"
+
 namespace Parable::Vulkan
 {
 
@@ -31,5 +36,54 @@ TextureData TextureData::from_png(const std::string& png_path)
     return TextureData(pixels, image_size, TextureData::TextureDimensions{static_cast<uint32_t>(tex_width),static_cast<uint32_t>(tex_height)});
 }
 
+/**
+ * Decode a png already read into memory.
+ *
+ * @param png the contents of the file
+ * @param png_path the file it was read from, for error messages
+ *
+ * @throws Parable::FileFormatException if the png can not be decoded
+ */
+TextureData TextureData::from_png(std::span<const std::byte> png, const std::string& png_path)
+{
+    int tex_width, tex_height, tex_channels;
+    stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(png.data()), (int)png.size(), &tex_width, &tex_height, &tex_channels, STBI_rgb_alpha);
+
+    if (!pixels)
+    {
+        PBL_CORE_ERROR("Failed to decode png {}: {}", png_path, stbi_failure_reason());
+        throw FileFormatException("Failed to decode png file.");
+    }
+
+    vk::DeviceSize image_size = (vk::DeviceSize)tex_width * tex_height * 4;
+
+    return TextureData(pixels, image_size, TextureData::TextureDimensions{static_cast<uint32_t>(tex_width),static_cast<uint32_t>(tex_height)});
+}
+
+/**
+ * Build the full mip chain down to 1x1, replacing any already built.
+ *
+ * @param srgb whether the pixels are sRGB colour, which is filtered in linear space
+ */
+void TextureData::generate_mips(bool srgb)
+{
+    m_mips.clear();
+
+    uint32_t mip_count = TextureFormat::get_full_mip_count(m_dimensions.width, m_dimensions.height);
+    for (uint32_t level = 1; level < mip_count; ++level)
+    {
+        m_mips.push_back(TextureEncoder::downsample(get_mip(level - 1), std::max(m_dimensions.width >> (level - 1), 1u), std::max(m_dimensions.height >> (level - 1), 1u), srgb));
+    }
+}
+
+/**
+ * The RGBA8 pixels of a mip level, where level 0 is the decoded image.
+ */
+std::span<const std::byte> TextureData::get_mip(uint32_t level) const
+{
+    if (level == 0) return { reinterpret_cast<const std::byte*>(m_pixels), (size_t)m_pixels_size };
+    return m_mips[level - 1];
+}
+
 
 }
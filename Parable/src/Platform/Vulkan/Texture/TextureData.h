@@ -1,5 +1,8 @@
 #pragma once
 
+#include <span>
+#include <utility>
+
 #include <stb_image.h>
 #include <vulkan/vulkan.hpp>
 
@@ -22,6 +25,11 @@ private:
 
     TextureDimensions m_dimensions;
 
+    /**
+     * The levels of the mip chain below the base level, each half the size of the last.
+     */
+    std::vector<std::vector<std::byte>> m_mips;
+
 public:
     TextureData(stbi_uc* pixels, vk::DeviceSize size, TextureDimensions dimensions)
         : m_pixels(pixels),
@@ -29,13 +37,27 @@ public:
         m_dimensions(dimensions)
     {}
 
+    TextureData(const TextureData&) = delete;
+    TextureData(TextureData&& other) noexcept
+        : m_pixels(std::exchange(other.m_pixels, nullptr)),
+        m_pixels_size(other.m_pixels_size),
+        m_dimensions(other.m_dimensions),
+        m_mips(std::move(other.m_mips))
+    {}
+
     ~TextureData();
 
     stbi_uc* get_pixels() { return m_pixels; }
     vk::DeviceSize get_pixels_size() { return m_pixels_size; }
     const TextureDimensions& get_dimensions() { return m_dimensions; }
 
+    void generate_mips(bool srgb);
+
+    uint32_t get_mip_count() const { return 1 + (uint32_t)m_mips.size(); }
+    std::span<const std::byte> get_mip(uint32_t level) const;
+
     static TextureData from_png(const std::string& png_path);
+    static TextureData from_png(std::span<const std::byte> png, const std::string& png_path);
 };
 
 
@@ -3,13 +3,13 @@
 #include "pblpch.h"
 
 #include "Core/Base.h"
+#include "Core/Application.h"
 
 #include <vulkan/vulkan.hpp>
 
 #include "../Wrapper/Buffer.h"
 #include "../Wrapper/Image.h"
 
-#include "TextureData.h"
 #include "Texture.h"
 
 #include "Asset/AssetLoadInfo.h"
@@ -19,29 +19,153 @@ namespace Parable::Vulkan
 {
 
 
-void TextureLoadTask::record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer)
+/**
+ * The image format a cooked pixel format is uploaded as.
+ */
+static vk::Format get_image_format(TextureFormat::PixelFormat format)
 {
-    TextureData data = TextureData::from_png(m_load_info.get_png_path());
+    switch (format)
+    {
+        case TextureFormat::PixelFormat::RGBA8Srgb: return vk::Format::eR8G8B8A8Srgb;
+        case TextureFormat::PixelFormat::BC1RgbSrgb: return vk::Format::eBc1RgbSrgbBlock;
+        case TextureFormat::PixelFormat::BC3Srgb: return vk::Format::eBc3SrgbBlock;
+        case TextureFormat::PixelFormat::BC5Unorm: return vk::Format::eBc5UnormBlock;
+        case TextureFormat::PixelFormat::BC7Srgb: return vk::Format::eBc7SrgbBlock;
+    }
+    return vk::Format::eUndefined;
+}
+
+static vk::BufferImageCopy get_level_copy(vk::DeviceSize staging_offset, uint32_t mip, uint32_t width, uint32_t height)
+{
+    return vk::BufferImageCopy(
+        staging_offset,
+        0, // bufferRowLength
+        0, // bufferImageHeight
+        vk::ImageSubresourceLayers(
+            vk::ImageAspectFlagBits::eColor,
+            mip, // mipLevel
+            0, // baseArrayLayer
+            1  // layerCount
+        ),
+        {0,0,0},            // imageOffset
+        {width,height,1}    // imageExtent
+    );
+}
+
+/**
+ * Take the format and levels of a cooked texture, each level one upload part.
+ */
+void TextureLoadTask::prepare_levels(const CookedTexture& texture)
+{
+    m_prepared_image.format = texture.get_format();
+    m_prepared_image.width = texture.get_width();
+    m_prepared_image.height = texture.get_height();
+
+    for (uint32_t mip = 0; mip < texture.get_mip_count(); ++mip)
+    {
+        const TextureFormat::MipLevel& level = texture.get_mip_level(mip);
+        m_prepared_image.level_extents.push_back(vk::Extent2D(level.width, level.height));
+        m_parts.push_back({ texture.get_mip_data(mip) });
+    }
+}
+
+void TextureLoadTask::get_reads(std::vector<FileRead>& reads)
+{
+    if (m_packed)
+    {
+        m_source.resize(m_packed.entry->size);
+        reads.push_back({ &m_packed.archive->get_file(), m_packed.entry->offset, m_source });
+        return;
+    }
+
+    m_source_file = IO::File(m_load_info.is_cooked() ? m_load_info.get_pbltex_path() : m_load_info.get_png_path());
+    m_source.resize(m_source_file.size());
+    reads.push_back({ &m_source_file, 0, m_source });
+}
+
+void TextureLoadTask::prepare()
+{
+    // a cooked texture is decompressed if need be and its levels copied to staging as they are
+    if (m_packed && m_packed.archive->is_compressed(*m_packed.entry))
+    {
+        m_decompressed.resize(m_packed.archive->get_uncompressed_size(*m_packed.entry));
+        m_packed.archive->decode(*m_packed.entry, m_source, m_decompressed, &Application::get_instance().get_job_system());
+        m_source = {};
+        m_cooked_texture.emplace(m_decompressed, "packed texture");
+    }
+    else if (m_packed)
+    {
+        m_cooked_texture.emplace(m_source, "packed texture");
+    }
+    else if (m_load_info.is_cooked())
+    {
+        m_cooked_texture.emplace(m_source, m_load_info.get_pbltex_path());
+    }
+
+    if (m_cooked_texture)
+    {
+        prepare_levels(*m_cooked_texture);
+        return;
+    }
 
-    // set up staging buf
-    BufferBuilder staging_buffer_builder;
-    staging_buffer_builder.buffer_info.size = data.get_pixels_size();
-    staging_buffer_builder.buffer_info.usage  = vk::BufferUsageFlagBits::eTransferSrc;
-    staging_buffer_builder.buffer_info.sharingMode = vk::SharingMode::eExclusive;
-    staging_buffer_builder.required_memory_properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    // mips are built at load time for uncooked textures, so they sample the same as cooked ones
+    m_texture_data.emplace(TextureData::from_png(m_source, m_load_info.get_png_path()));
+    m_source = {};
+    m_texture_data->generate_mips(true);
 
-    m_staging_buffer = staging_buffer_builder.create(device, physical_device);
+    m_prepared_image.width = m_texture_data->get_dimensions().width;
+    m_prepared_image.height = m_texture_data->get_dimensions().height;
 
-    // write tex to staging
-    m_staging_buffer.write(data.get_pixels(), 0, data.get_pixels_size());
+    for (uint32_t mip = 0; mip < m_texture_data->get_mip_count(); ++mip)
+    {
+        m_prepared_image.level_extents.push_back(vk::Extent2D(std::max(m_prepared_image.width >> mip, 1u), std::max(m_prepared_image.height >> mip, 1u)));
+        m_parts.push_back({ m_texture_data->get_mip(mip) });
+    }
+}
+
+void TextureLoadTask::record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer, const UploadChunk& chunk)
+{
+    if (chunk.first)
+    {
+        if (TextureFormat::is_block_compressed(m_prepared_image.format) && !physical_device->getFeatures().textureCompressionBC)
+        {
+            PBL_CORE_ERROR("Texture {} is block compressed, which the device does not support.", m_load_info.get_pbltex_path());
+            throw std::runtime_error("Block compressed textures are not supported by the device!");
+        }
+
+        create_image(device, physical_device, command_buffer);
+    }
+
+    // levels are never split, so each range is one whole level
+    std::vector<vk::BufferImageCopy> regions;
+    for (const StagedRange& range : chunk.ranges)
+    {
+        PBL_CORE_ASSERT_MSG(range.part_offset == 0 && range.size == m_parts[range.part].data.size(), "A texture level was split between chunks!")
+
+        const vk::Extent2D& extent = m_prepared_image.level_extents[range.part];
+        regions.push_back(get_level_copy(range.staging_offset, (uint32_t)range.part, extent.width, extent.height));
+    }
+
+    if (!regions.empty()) m_image->copy_from_buffer(command_buffer, *chunk.staging_buffer, regions);
+
+    if (chunk.last) finish_image(device, physical_device, command_buffer);
+}
+
+/**
+ * Create the image, and transition every level to be copied into.
+ */
+void TextureLoadTask::create_image(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer)
+{
+    uint32_t mip_count = (uint32_t)m_prepared_image.level_extents.size();
+    vk::Format format = get_image_format(m_prepared_image.format);
 
     // create image
     vk::ImageCreateInfo image_info(
         {},
         vk::ImageType::e2D,
-        vk::Format::eR8G8B8A8Srgb,
-        vk::Extent3D(data.get_dimensions().width, data.get_dimensions().height, 1),
-        1, // mipLevels
+        format,
+        vk::Extent3D(m_prepared_image.width, m_prepared_image.height, 1),
+        mip_count, // mipLevels
         1, // arrayLevels
         vk::SampleCountFlagBits::e1,
         vk::ImageTiling::eOptimal,
@@ -51,7 +175,8 @@ void TextureLoadTask::record_commands(Device& device, PhysicalDevice& physical_d
         vk::ImageLayout::eUndefined
     );
 
-    Image texture_image(device, physical_device, image_info);
+    m_image.emplace(device, physical_device, image_info);
+    m_texture_storage.set_resident_size(device->getImageMemoryRequirements(**m_image).size);
 
     // now record commands
 
@@ -62,11 +187,11 @@ void TextureLoadTask::record_commands(Device& device, PhysicalDevice& physical_d
         vk::ImageLayout::eUndefined,
         vk::ImageLayout::eTransferDstOptimal,
         VK_QUEUE_FAMILY_IGNORED,VK_QUEUE_FAMILY_IGNORED,
-        texture_image,
+        **m_image,
         vk::ImageSubresourceRange(
             vk::ImageAspectFlagBits::eColor,
             0, // baseMipLevel
-            1, // levelCount
+            mip_count, // levelCount
             0, // baseArrayLayer
             1  // layerCount
         )
@@ -80,21 +205,28 @@ void TextureLoadTask::record_commands(Device& device, PhysicalDevice& physical_d
         {},
         barriers
     );
+}
 
-    texture_image.copy_from_buffer(command_buffer, m_staging_buffer, data.get_dimensions().width, data.get_dimensions().height);
+/**
+ * Transition the copied image to be sampled, and write it into the descriptor set.
+ */
+void TextureLoadTask::finish_image(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer)
+{
+    uint32_t mip_count = (uint32_t)m_prepared_image.level_extents.size();
+    vk::Format format = get_image_format(m_prepared_image.format);
 
     // now can transition texture to shader optimal
-    barriers = {vk::ImageMemoryBarrier(
+    vk::ImageMemoryBarrier barriers = {vk::ImageMemoryBarrier(
         vk::AccessFlagBits::eTransferWrite,
         {},
         vk::ImageLayout::eTransferDstOptimal,
         vk::ImageLayout::eShaderReadOnlyOptimal,
         VK_QUEUE_FAMILY_IGNORED,VK_QUEUE_FAMILY_IGNORED,
-        texture_image,
+        **m_image,
         vk::ImageSubresourceRange(
             vk::ImageAspectFlagBits::eColor,
             0, // baseMipLevel
-            1, // levelCount
+            mip_count, // levelCount
             0, // baseArrayLayer
             1  // layerCount
         )
@@ -113,14 +245,14 @@ void TextureLoadTask::record_commands(Device& device, PhysicalDevice& physical_d
     vk::ImageView texture_view = device->createImageView(
         vk::ImageViewCreateInfo(
             {},
-            texture_image,
+            **m_image,
             vk::ImageViewType::e2D,
-            vk::Format::eR8G8B8A8Srgb,
+            format,
             {},
             vk::ImageSubresourceRange(
                 vk::ImageAspectFlagBits::eColor,
                 0, // baseMipLevel
-                1, // levelCount
+                mip_count, // levelCount
                 0, // baseArrayLayer
                 1  // layerCount
             )
@@ -143,7 +275,7 @@ void TextureLoadTask::record_commands(Device& device, PhysicalDevice& physical_d
             false,  // compareEnable
             vk::CompareOp::eAlways,
             0.0f,   // minLod
-            0.0f,   // maxLod
+            (float)mip_count,   // maxLod
             vk::BorderColor::eIntOpaqueBlack,   // borderColor
             false   // unnormalizedCoordinates
         )
@@ -173,16 +305,41 @@ void TextureLoadTask::record_commands(Device& device, PhysicalDevice& physical_d
     device->updateDescriptorSets(descriptor_writes, {});
 
     // now we can construct the Texture object and place it into the state block
-    std::unique_ptr<Parable::Texture> tex = std::make_unique<Texture>(std::move(texture_image), texture_view, texture_sampler, m_descriptor_set);
+    std::unique_ptr<Parable::Texture> tex = std::make_unique<Texture>(std::move(*m_image), texture_view, texture_sampler, m_descriptor_set);
     m_texture_storage.set_resource(std::move(tex));
+    m_image.reset();
 }
 
 void TextureLoadTask::on_load_complete()
 {
-    m_staging_buffer.destroy();
+    // the source is no longer needed once copied
+    m_cooked_texture.reset();
+    m_texture_data.reset();
+    m_decompressed = {};
+    m_source = {};
+    m_source_file = IO::File();
 
     m_texture_storage.set_load_state(ResourceLoadState::Loaded);
 }
 
+void TextureLoadTask::on_load_failed()
+{
+    // an earlier chunk may have created the image, which nothing else refers to yet
+    if (m_image)
+    {
+        m_image->destroy();
+        m_image.reset();
+    }
+
+    // a retry allocates a new set, so this one would otherwise leak from the pool
+    if (m_descriptor_set)
+    {
+        m_release_descriptor_set(m_descriptor_set);
+        m_descriptor_set = nullptr;
+    }
+
+    m_texture_storage.set_load_state(ResourceLoadState::Unloaded);
+}
+
 
 }
\ No newline at end of file
@@ -1,8 +1,18 @@
 #pragma once
 
+#include "pblpch.h"
+
+#include <span>
+
 #include "../Loader/LoadTask.h"
 
-#include "../Wrapper/Buffer.h"
+#include "../Wrapper/Image.h"
+
+#include "Asset/AssetArchive.h"
+#include "Asset/CookedTexture.h"
+#include "IO/File.h"
+
+#include "TextureData.h"
 
 namespace vk
 {
@@ -32,6 +42,10 @@ class TextureLoadTask : public LoadTask
 {
 private:
     const TextureLoadInfo& m_load_info;
+    /**
+     * The cooked texture in a mounted archive, empty to load from the load info's files.
+     */
+    PackedAsset m_packed;
 
     ResourceStorageBlock<Parable::Texture>& m_texture_storage;
 
@@ -39,23 +53,78 @@ private:
      * An allocated descriptor set for the new texture.
      */
     vk::DescriptorSet m_descriptor_set;
+    /**
+     * Returns the descriptor set to its pool if the load fails, as no texture will own it.
+     */
+    std::function<void(vk::DescriptorSet)> m_release_descriptor_set;
+
+    /**
+     * The image to upload, each of whose mip levels is one upload part.
+     */
+    struct PreparedImage
+    {
+        TextureFormat::PixelFormat format = TextureFormat::PixelFormat::RGBA8Srgb;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<vk::Extent2D> level_extents;
+    };
+    PreparedImage m_prepared_image;
+    std::vector<UploadPart> m_parts;
+
+    /**
+     * The file the source is read from, when it is not in an archive, and the data read.
+     */
+    IO::File m_source_file;
+    std::vector<std::byte> m_source;
+
+    // the prepared source, from prepare until the load completes
+    std::vector<std::byte> m_decompressed;
+    std::optional<CookedTexture> m_cooked_texture;
+    std::optional<TextureData> m_texture_data;
 
-    Buffer m_staging_buffer;
+    /**
+     * The image, created by the first chunk and handed to the texture by the last.
+     */
+    std::optional<Image> m_image;
+
+    void prepare_levels(const CookedTexture& texture);
+    void create_image(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer);
+    void finish_image(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer);
 
 public:
     TextureLoadTask(
         const TextureLoadInfo& load_info,
+        PackedAsset packed,
         ResourceStorageBlock<Parable::Texture>& texture_storage,
-        vk::DescriptorSet descriptor_set
+        vk::DescriptorSet descriptor_set,
+        std::function<void(vk::DescriptorSet)> release_descriptor_set
     )
         : m_load_info(load_info),
+        m_packed(packed),
         m_texture_storage(texture_storage),
-        m_descriptor_set(descriptor_set)
+        m_descriptor_set(descriptor_set),
+        m_release_descriptor_set(std::move(release_descriptor_set))
     {}
     
-    void record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer) override;
+    /**
+     * Read the cooked texture from its archive or file, or the source png.
+     */
+    void get_reads(std::vector<FileRead>& reads) override;
+    /**
+     * Decompress or decode the texture, building mips for an uncooked one.
+     */
+    void prepare() override;
+    std::span<const UploadPart> get_upload_parts() const override { return m_parts; }
+    /**
+     * Create the image with the first chunk, record the copy of each level staged, and make it ready to sample with the last.
+     */
+    void record_commands(Device& device, PhysicalDevice& physical_device, vk::CommandBuffer& command_buffer, const UploadChunk& chunk) override;
 
     void on_load_complete() override;
+    /**
+     * Destroy any image created and release the descriptor set, leaving the texture unloaded.
+     */
+    void on_load_failed() override;
 
     // unused
     void create_device_resources(Device& device) {}
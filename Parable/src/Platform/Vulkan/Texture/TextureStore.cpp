@@ -12,8 +12,8 @@ namespace Parable::Vulkan
 {
 
 
-TextureStore::TextureStore(Device device, vk::DescriptorSetLayout& texture_descriptor_set_layout, Loader& loader)
-    : ResourceStore<Parable::Texture>(loader),
+TextureStore::TextureStore(Device device, vk::DescriptorSetLayout& texture_descriptor_set_layout, Loader& loader, size_t memory_budget)
+    : ResourceStore<Parable::Texture>(loader, memory_budget),
     m_device(device),
     m_descriptor_set_layout(texture_descriptor_set_layout)
 {
@@ -26,8 +26,9 @@ TextureStore::TextureStore(Device device, vk::DescriptorSetLayout& texture_descr
         )
     };
 
+    // sets are freed individually as textures are evicted
     m_descriptor_pool = m_device->createDescriptorPool(vk::DescriptorPoolCreateInfo(
-        {},
+        vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
         // 100 descriptor sets containing one sampler each
         static_cast<uint32_t>(100),
         texture_descriptor_pool_sizes
@@ -43,7 +44,19 @@ std::unique_ptr<LoadTask> TextureStore::create_load_task(AssetDescriptor descrip
         m_descriptor_pool, 1, &m_descriptor_set_layout
     ))[0];
 
-    return std::make_unique<TextureLoadTask>(load_info, storage_block, descriptor_set);
+    auto release_descriptor_set = [this](vk::DescriptorSet set) { m_device->freeDescriptorSets(m_descriptor_pool, set); };
+
+    return std::make_unique<TextureLoadTask>(load_info, AssetRegistry::resolve_packed(descriptor), storage_block, descriptor_set, std::move(release_descriptor_set));
+}
+
+void TextureStore::destroy_resource(Parable::Texture& resource)
+{
+    Texture& texture = static_cast<Texture&>(resource);
+
+    m_device->destroySampler(texture.get_sampler());
+    m_device->destroyImageView(texture.get_image_view());
+    texture.get_image().destroy();
+    m_device->freeDescriptorSets(m_descriptor_pool, texture.get_descriptor_set());
 }
 
 
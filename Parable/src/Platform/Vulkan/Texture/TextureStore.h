@@ -35,7 +35,7 @@ private:
     vk::DescriptorPool m_descriptor_pool;
 
 public:
-    TextureStore(Device device, vk::DescriptorSetLayout& texture_descriptor_set_layout, Loader& loader);
+    TextureStore(Device device, vk::DescriptorSetLayout& texture_descriptor_set_layout, Loader& loader, size_t memory_budget);
 
     ~TextureStore()
     {
@@ -43,6 +43,7 @@ public:
     }   
 
     std::unique_ptr<LoadTask> create_load_task(AssetDescriptor descriptor, ResourceStorageBlock<Parable::Texture>& storage_block) override;
+    void destroy_resource(Parable::Texture& resource) override;
 };
 
 
@@ -96,11 +96,11 @@ public:
         );
     }
 
-    void copy_from_buffer(vk::CommandBuffer& cmdBuffer, Buffer& srcBuffer, uint32_t width, uint32_t height)
+    void copy_from_buffer(vk::CommandBuffer& cmdBuffer, Buffer& srcBuffer, uint32_t width, uint32_t height, vk::DeviceSize bufferOffset = 0)
     {
         vk::BufferImageCopy regions[1] = {
             vk::BufferImageCopy(
-                0, // offset
+                bufferOffset, // offset
                 0, // bufferRowLength
                 0, // bufferImageHeight
                 vk::ImageSubresourceLayers(
@@ -118,6 +118,15 @@ public:
         cmdBuffer.copyBufferToImage(srcBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, regions);
     }
 
+    /**
+     * Copy several regions, such as every mip level, in one command.
+     */
+    void copy_from_buffer(vk::CommandBuffer& cmdBuffer, Buffer& srcBuffer, const std::vector<vk::BufferImageCopy>& regions)
+    {
+        // assume the image is in eTransferDstOptimal, if not this will break
+        cmdBuffer.copyBufferToImage(srcBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, regions);
+    }
+
 private:
     Device m_device;
 
@@ -2,7 +2,7 @@
 
 #include "VulkanExceptions.h"
 
-#include "Util/ReadFile.h"
+#include "Util/MappedFile.h"
 
 namespace Parable::Vulkan
 {
@@ -10,12 +10,13 @@ namespace Parable::Vulkan
 
 vk::ShaderModule load_shader(vk::Device& device, const std::string& filename)
 {
-    std::vector<char> code = Util::read_file(filename);
+    // the mapping is page aligned, so it can be read as SPIR-V words in place
+    Util::MappedFile code(filename);
 
     vk::ShaderModuleCreateInfo createInfo(
         {},
         code.size(),
-        reinterpret_cast<uint32_t*>(code.data())
+        reinterpret_cast<const uint32_t*>(code.data().data())
     );
 
     return device.createShaderModule(createInfo);
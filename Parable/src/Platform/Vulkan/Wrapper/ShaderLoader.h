@@ -1,7 +1,6 @@
 #pragma once
 
 #include <vulkan/vulkan.hpp>
-#include "Util/ReadFile.h"
 
 namespace Parable::Vulkan
 {
@@ -10,6 +10,10 @@
 
 #include <array>
 
+#include "Util/Hash.h"
+
+#include "Asset/CookedMesh.h"
+
 namespace Parable::Vulkan
 {
 
@@ -53,6 +57,18 @@ struct Vertex {
         return attributeDescriptions;
     }
 
+    /**
+     * The layout of a Vertex as described in a cooked mesh, which must match for the data to be copied as is.
+     */
+    static std::array<MeshFormat::VertexAttribute, 3> get_mesh_attributes() {
+        using namespace MeshFormat;
+        return {
+            VertexAttribute{ VertexSemantic::Position, AttributeFormat::Float3, offsetof(Vertex, pos) },
+            VertexAttribute{ VertexSemantic::Color, AttributeFormat::Float3, offsetof(Vertex, color) },
+            VertexAttribute{ VertexSemantic::TexCoord, AttributeFormat::Float2, offsetof(Vertex, texCoord) }
+        };
+    }
+
     // required for hashing
     bool operator==(const Vertex& other) const {
         return pos == other.pos && color == other.color && texCoord == other.texCoord;
@@ -60,6 +76,23 @@ struct Vertex {
 
 };
 
+/**
+ * Hashes all the components of a vertex together, for deduplicating vertices while loading meshes.
+ */
+struct VertexHash
+{
+    size_t operator()(const Vertex& vertex) const
+    {
+        // adding 0 turns -0 into 0, which compares equal so must hash equal
+        std::array<float, 8> components {
+            vertex.pos.x + 0.0f, vertex.pos.y + 0.0f, vertex.pos.z + 0.0f,
+            vertex.color.x + 0.0f, vertex.color.y + 0.0f, vertex.color.z + 0.0f,
+            vertex.texCoord.x + 0.0f, vertex.texCoord.y + 0.0f
+        };
+        return (size_t)Util::hash_bytes(components.data(), sizeof(components));
+    }
+};
+
 
 
 } // namespace Parable::Vulkan
@@ -67,9 +100,7 @@ struct Vertex {
 namespace std {
     template<> struct hash<Parable::Vulkan::Vertex> {
         size_t operator()(Parable::Vulkan::Vertex const& vertex) const {
-            return ((hash<glm::vec3>()(vertex.pos) ^
-                   (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
-                   (hash<glm::vec2>()(vertex.texCoord) << 1);
+            return Parable::Vulkan::VertexHash()(vertex);
         }
     };
 }
\ No newline at end of file
@@ -11,10 +11,9 @@ void RenderLayer::on_update()
     m_renderer->on_update();
 }
 
-void RenderLayer::on_event(Event* e)
+void RenderLayer::on_subscribe(EventRouter& router)
 {
-    EventDispatcher dispatcher (e);
-    dispatcher.dispatch<WindowResizeEvent>(PBL_BIND_MEMBER_EVENT_HANDLER(RenderLayer::on_window_resize));
+    router.subscribe<&RenderLayer::on_window_resize>(this);
 }
 
 bool RenderLayer::on_window_resize(WindowResizeEvent& e)
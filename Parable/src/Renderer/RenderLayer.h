@@ -23,7 +23,7 @@ public:
     RenderLayer() : Layer("RenderLayer"), m_renderer(Renderer::get_instance()) {}
 
     void on_update() override;
-    void on_event(Event* e) override;
+    void on_subscribe(EventRouter& router) override;
 
 private:
     bool on_window_resize(WindowResizeEvent& e);
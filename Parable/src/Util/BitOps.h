@@ -0,0 +1,278 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+
+#ifdef __AVX2__
+    #include <immintrin.h>
+#endif
+
+//
+//  Word-level kernels shared by the bitset implementations.
+//
+//  Operate on arrays of 64 bit words. The bulk operations have AVX2 paths, compiled in
+//  when the engine is built with PARABLE_ENABLE_AVX2 (which defines __AVX2__).
+//
+
+namespace Parable::Util::BitOps
+{
+
+
+using Word = uint64_t;
+
+static constexpr size_t WORD_BITS = sizeof(Word) * 8;
+
+/**
+ * Number of words needed to hold a number of bits.
+ */
+constexpr size_t words_for(size_t bits)
+{
+    return (bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+/**
+ * Mask of the bits in use in the last word of a bitset.
+ */
+constexpr Word last_word_mask(size_t bits)
+{
+    size_t used = bits % WORD_BITS;
+    return used == 0 ? ~(Word)0 : (((Word)1 << used) - 1);
+}
+
+constexpr Word bit_mask(size_t bit)
+{
+    return (Word)1 << (bit % WORD_BITS);
+}
+
+inline size_t count(const Word* words, size_t n)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) total += (size_t)std::popcount(words[i]);
+    return total;
+}
+
+inline bool any(const Word* words, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(words + i));
+        if (!_mm256_testz_si256(v, v)) return true;
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (words[i] != 0) return true;
+    }
+    return false;
+}
+
+inline bool equal(const Word* a, const Word* b, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        if (!_mm256_testz_si256(x, x)) return false;
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+inline void and_assign(Word* dst, const Word* src, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(dst + i)), _mm256_loadu_si256((const __m256i*)(src + i)));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+#endif
+    for (; i < n; ++i) dst[i] &= src[i];
+}
+
+inline void or_assign(Word* dst, const Word* src, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(dst + i)), _mm256_loadu_si256((const __m256i*)(src + i)));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+#endif
+    for (; i < n; ++i) dst[i] |= src[i];
+}
+
+inline void xor_assign(Word* dst, const Word* src, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(dst + i)), _mm256_loadu_si256((const __m256i*)(src + i)));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+#endif
+    for (; i < n; ++i) dst[i] ^= src[i];
+}
+
+/**
+ * Whether every bit set in a is also set in b.
+ */
+inline bool is_subset(const Word* a, const Word* b, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+    {
+        // andnot computes ~b & a
+        __m256i x = _mm256_andnot_si256(_mm256_loadu_si256((const __m256i*)(b + i)), _mm256_loadu_si256((const __m256i*)(a + i)));
+        if (!_mm256_testz_si256(x, x)) return false;
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if ((a[i] & ~b[i]) != 0) return false;
+    }
+    return true;
+}
+
+/**
+ * Whether a & b has any bit set, without materialising a & b.
+ */
+inline bool and_any(const Word* a, const Word* b, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+    {
+        if (!_mm256_testz_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)))) return true;
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if ((a[i] & b[i]) != 0) return true;
+    }
+    return false;
+}
+
+/**
+ * The number of bits set in a & b, without materialising a & b.
+ */
+inline size_t and_count(const Word* a, const Word* b, size_t n)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) total += (size_t)std::popcount(a[i] & b[i]);
+    return total;
+}
+
+
+/**
+ * Forward iterator over the positions of the set (or unset) bits of a word array.
+ *
+ * Does not allocate; each step is a tzcnt and a clear of the lowest bit, and
+ * empty words are skipped whole.
+ *
+ * @tparam Set true to visit set bits, false to visit unset bits
+ */
+template<bool Set>
+class BitIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const size_t*;
+    using reference = size_t;
+
+    BitIterator() = default;
+    BitIterator(const Word* words, size_t num_words, Word last_mask, size_t word_index) :
+                                                                    m_words(words),
+                                                                    m_num_words(num_words),
+                                                                    m_last_mask(last_mask),
+                                                                    m_word_index(word_index)
+    {
+        if (m_word_index < m_num_words)
+        {
+            m_current = load(m_word_index);
+            if (m_current == 0) advance_word();
+        }
+    }
+
+    size_t operator*() const { return m_word_index * WORD_BITS + (size_t)std::countr_zero(m_current); }
+
+    BitIterator& operator++()
+    {
+        m_current &= m_current - 1;
+        if (m_current == 0) advance_word();
+        return *this;
+    }
+
+    BitIterator operator++(int)
+    {
+        BitIterator old = *this;
+        ++(*this);
+        return old;
+    }
+
+    bool operator==(const BitIterator& other) const { return m_word_index == other.m_word_index && m_current == other.m_current; }
+    bool operator!=(const BitIterator& other) const { return !(*this == other); }
+
+private:
+    Word load(size_t i) const
+    {
+        Word w = Set ? m_words[i] : ~m_words[i];
+        return i == m_num_words - 1 ? (w & m_last_mask) : w;
+    }
+
+    void advance_word()
+    {
+        while (++m_word_index < m_num_words)
+        {
+            m_current = load(m_word_index);
+            if (m_current != 0) return;
+        }
+        m_current = 0;
+    }
+
+    const Word* m_words = nullptr;
+    size_t m_num_words = 0;
+    Word m_last_mask = 0;
+    size_t m_word_index = 0;
+    /**
+     * Bits of the current word still to visit.
+     */
+    Word m_current = 0;
+};
+
+/**
+ * A range over the set (or unset) bits of a word array, for use in range-for.
+ *
+ */
+template<bool Set>
+class BitRange
+{
+public:
+    BitRange(const Word* words, size_t num_words, Word last_mask) : m_words(words), m_num_words(num_words), m_last_mask(last_mask) {}
+
+    BitIterator<Set> begin() const { return BitIterator<Set>(m_words, m_num_words, m_last_mask, 0); }
+    BitIterator<Set> end() const { return BitIterator<Set>(m_words, m_num_words, m_last_mask, m_num_words); }
+
+private:
+    const Word* m_words;
+    size_t m_num_words;
+    Word m_last_mask;
+};
+
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Parable::Util
+{
+
+
+/**
+ * Assumed cache line size, for padding data written by different threads apart.
+ * 
+ * Fixed rather than std::hardware_destructive_interference_size, which can change between
+ * compiler flags and so is unsafe in a type's layout.
+ */
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+
+}
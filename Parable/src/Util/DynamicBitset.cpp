@@ -25,9 +25,7 @@ DynamicBitset::DynamicBitset(size_t size, Allocator& allocator) :
                                                 m_size(size),
                                                 m_allocator(allocator)
 {
-    m_num_segments = size / segment_bitwidth;
-    m_last_segment_bits = size - (m_num_segments * segment_bitwidth);
-    if (m_last_segment_bits > 0) ++m_num_segments;
+    m_num_segments = BitOps::words_for(size);
 
     m_segments = allocator.allocate_array<Segment>(m_num_segments);
 
@@ -39,12 +37,38 @@ DynamicBitset::DynamicBitset(size_t size, Allocator& allocator) :
     reset_all();
 }
 
-                                        
+
 DynamicBitset::~DynamicBitset()
 {
     m_allocator.deallocate_array<Segment>(m_segments);
 }
 
+/**
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
+void DynamicBitset::check_compatible(const DynamicBitset& other) const
+{
+    if (m_size != other.get_size())
+    {
+        std::ostringstream ss;
+        ss << "Cannot compare a bitset of size " << m_size << " with a bitset of size " << other.get_size();
+        throw IncompatibleObjectException(ss.str().c_str());
+    }
+}
+
+/**
+ * @throws Parable::OutOfRangeException if bit >= size of the bitset
+ */
+void DynamicBitset::check_in_range(size_t bit) const
+{
+    if (bit >= m_size)
+    {
+        std::ostringstream ss;
+        ss << "Cannot get bit " << bit << " from a bitset of size " << m_size;
+        throw OutOfRangeException(ss.str().c_str());
+    }
+}
+
 // element access
 
 /**
@@ -54,10 +78,7 @@ DynamicBitset::~DynamicBitset()
  */
 bool DynamicBitset::operator[](size_t bit) const
 {
-    size_t segment = bit / segment_bitwidth;
-    size_t pos = bit - (segment * segment_bitwidth);
-
-    return m_segments[segment] & BIT(pos);
+    return m_segments[bit / segment_bitwidth] & BitOps::bit_mask(bit);
 }
 
 /**
@@ -69,12 +90,7 @@ bool DynamicBitset::operator[](size_t bit) const
  */
 bool DynamicBitset::at(size_t bit) const
 {
-    if (bit >= m_size)
-    {
-        std::ostringstream ss;
-        ss << "Cannot get bit " << bit << " from a bitset of size " << m_size;
-        throw OutOfRangeException(ss.str().c_str());
-    }
+    check_in_range(bit);
 
     return (*this)[bit];
 }
@@ -84,27 +100,16 @@ bool DynamicBitset::at(size_t bit) const
  */
 bool DynamicBitset::all() const
 {
+    if (m_num_segments == 0) return true;
+
     for(size_t i = 0; i < m_num_segments-1; ++i)
     {
         if (~m_segments[i] != 0) return false;
     }
 
     // for last segment, check only the used bits
-    if (m_last_segment_bits < segment_bitwidth)
-    {
-        size_t mask = 0;
-        for(size_t i = 0; i < m_last_segment_bits; ++i)
-        {
-            mask |= BIT(i);
-        }
-        if ((~m_segments[m_num_segments-1]) & mask != 0) return false;
-    }
-    else
-    {
-        if (~m_segments[m_num_segments-1] != 0) return false;
-    }
-
-    return true;
+    Segment mask = BitOps::last_word_mask(m_size);
+    return (m_segments[m_num_segments-1] & mask) == mask;
 }
 
 /**
@@ -112,12 +117,7 @@ bool DynamicBitset::all() const
  */
 bool DynamicBitset::any() const
 {
-    for(size_t i = 0; i < m_num_segments; ++i)
-    {
-        if (m_segments[i] != 0) return true;
-    }
-
-    return false;
+    return BitOps::any(m_segments, m_num_segments);
 }
 
 /**
@@ -133,18 +133,7 @@ bool DynamicBitset::none() const
  */
 size_t DynamicBitset::count() const
 {
-    size_t count = 0;
-    for(size_t i = 0; i < m_num_segments; ++i)
-    {
-        // brian kernighans algorithm
-        Segment n = m_segments[i];
-        while (n)
-        {
-            n = n & (n - 1);    // clear the least significant bit set
-            ++count;
-        }
-    }
-    return count;
+    return BitOps::count(m_segments, m_num_segments);
 }
 
 // comparison
@@ -156,18 +145,9 @@ size_t DynamicBitset::count() const
  */
 bool DynamicBitset::operator==(const DynamicBitset& rhs) const
 {
-    if (m_size != rhs.get_size())
-    {
-        std::ostringstream ss;
-        ss << "Cannot compare a bitset of size " << m_size << " with a bitset of size "<< m_size;
-        throw IncompatibleObjectException(ss.str().c_str());
-    }
+    check_compatible(rhs);
 
-    for(size_t i = 0; i < m_num_segments; ++i)
-    {
-        if (m_segments[i] != rhs.m_segments[i]) return false;
-    }
-    return true;
+    return BitOps::equal(m_segments, rhs.m_segments, m_num_segments);
 }
 
 /**
@@ -177,39 +157,71 @@ bool DynamicBitset::operator==(const DynamicBitset& rhs) const
  */
 bool DynamicBitset::operator!=(const DynamicBitset& rhs) const
 {
-    if (m_size != rhs.get_size())
-    {
-        std::ostringstream ss;
-        ss << "Cannot compare a bitset of size " << m_size << " with a bitset of size " << m_size;
-        throw IncompatibleObjectException(ss.str().c_str());
-    }
-
     return !((*this) == rhs);
 }
 
-
+/**
+ * Checks if all the set bits in a bitset are also set in another.
+ * 
+ * Equivalent to this & other == this.
+ * 
+ * @param other the other bitset to compare with
+ * 
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
 bool DynamicBitset::is_subset_of(const DynamicBitset& other) const
 {
-    if (m_size != other.get_size())
-    {
-        std::ostringstream ss;
-        ss << "Cannot compare a bitset of size " << m_size << " with a bitset of size "<< m_size;
-        throw IncompatibleObjectException(ss.str().c_str());
-    }
-
-    for(size_t i = 0; i < m_num_segments; ++i)
-    {
-        Segment s = m_segments[i] & other.m_segments[i];
-        if (s != m_segments[i]) return false;
-    }
+    check_compatible(other);
 
-    return true;
+    return BitOps::is_subset(m_segments, other.m_segments, m_num_segments);
 }
+
+/**
+ * Checks if all the set bits in another bitset are also set in this one.
+ * 
+ * Equivalent to this & other == other.
+ * 
+ * @param other the other bitset to compare with
+ * 
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
 bool DynamicBitset::is_superset_of(const DynamicBitset& other) const
 {
     return other.is_subset_of(*this);
 }
 
+/**
+ * Checks if this and another bitset have any set bits in common.
+ * 
+ * Equivalent to (this & other).any(), without modifying either bitset.
+ * 
+ * @param other the other bitset to compare with
+ * 
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
+bool DynamicBitset::and_any(const DynamicBitset& other) const
+{
+    check_compatible(other);
+
+    return BitOps::and_any(m_segments, other.m_segments, m_num_segments);
+}
+
+/**
+ * Counts the set bits this and another bitset have in common.
+ * 
+ * Equivalent to (this & other).count(), without modifying either bitset.
+ * 
+ * @param other the other bitset to compare with
+ * 
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
+size_t DynamicBitset::and_count(const DynamicBitset& other) const
+{
+    check_compatible(other);
+
+    return BitOps::and_count(m_segments, other.m_segments, m_num_segments);
+}
+
 
 // modifiers
 
@@ -222,17 +234,9 @@ bool DynamicBitset::is_superset_of(const DynamicBitset& other) const
  */
 DynamicBitset& DynamicBitset::operator&=(const DynamicBitset& other)
 {
-    if (m_size != other.get_size())
-    {
-        std::ostringstream ss;
-        ss << "Cannot compare a bitset of size " << m_size << " with a bitset of size ";
-        throw IncompatibleObjectException(ss.str().c_str());
-    }
+    check_compatible(other);
 
-    for(size_t i = 0; i < m_num_segments; ++i)
-    {
-        m_segments[i] &= other.m_segments[i];
-    }
+    BitOps::and_assign(m_segments, other.m_segments, m_num_segments);
 
     return (*this);
 }
@@ -246,17 +250,9 @@ DynamicBitset& DynamicBitset::operator&=(const DynamicBitset& other)
  */
 DynamicBitset& DynamicBitset::operator|=(const DynamicBitset& other)
 {
-    if (m_size != other.get_size())
-    {
-        std::ostringstream ss;
-        ss << "Cannot compare a bitset of size " << m_size << " with a bitset of size ";
-        throw IncompatibleObjectException(ss.str().c_str());
-    }
+    check_compatible(other);
 
-    for(size_t i = 0; i < m_num_segments; ++i)
-    {
-        m_segments[i] |= other.m_segments[i];
-    }
+    BitOps::or_assign(m_segments, other.m_segments, m_num_segments);
 
     return (*this);
 }
@@ -270,17 +266,9 @@ DynamicBitset& DynamicBitset::operator|=(const DynamicBitset& other)
  */
 DynamicBitset& DynamicBitset::operator^=(const DynamicBitset& other)
 {
-    if (m_size != other.get_size())
-    {
-        std::ostringstream ss;
-        ss << "Cannot compare a bitset of size " << m_size << " with a bitset of size ";
-        throw IncompatibleObjectException(ss.str().c_str());
-    }
+    check_compatible(other);
 
-    for(size_t i = 0; i < m_num_segments; ++i)
-    {
-        m_segments[i] ^= other.m_segments[i];
-    }
+    BitOps::xor_assign(m_segments, other.m_segments, m_num_segments);
 
     return (*this);
 }
@@ -294,6 +282,9 @@ void DynamicBitset::flip_all()
     {
         m_segments[i] = ~m_segments[i];
     }
+
+    // keep the unused bits clear
+    if (m_num_segments > 0) m_segments[m_num_segments-1] &= BitOps::last_word_mask(m_size);
 }
 
 /**
@@ -305,17 +296,9 @@ void DynamicBitset::flip_all()
  */
 void DynamicBitset::flip(size_t bit)
 {
-    if (bit >= m_size)
-    {
-        std::ostringstream ss;
-        ss << "Cannot get bit " << bit << " from a bitset of size " << m_size;
-        throw OutOfRangeException(ss.str().c_str());
-    }
+    check_in_range(bit);
 
-    size_t segment = bit / segment_bitwidth;
-    size_t pos = bit - (segment * segment_bitwidth);
-
-    m_segments[segment] ^= BIT(pos);
+    m_segments[bit / segment_bitwidth] ^= BitOps::bit_mask(bit);
 }
 
 /**
@@ -327,6 +310,9 @@ void DynamicBitset::set_all()
     {
         m_segments[i] = ~((Segment)0);
     }
+
+    // keep the unused bits clear
+    if (m_num_segments > 0) m_segments[m_num_segments-1] = BitOps::last_word_mask(m_size);
 }
 
 /**
@@ -338,17 +324,9 @@ void DynamicBitset::set_all()
  */
 void DynamicBitset::set(size_t bit)
 {
-    if (bit >= m_size)
-    {
-        std::ostringstream ss;
-        ss << "Cannot get bit " << bit << " from a bitset of size " << m_size;
-        throw OutOfRangeException(ss.str().c_str());
-    }
+    check_in_range(bit);
 
-    size_t segment = bit / segment_bitwidth;
-    size_t pos = bit - (segment * segment_bitwidth);
-
-    m_segments[segment] |= BIT(pos);
+    m_segments[bit / segment_bitwidth] |= BitOps::bit_mask(bit);
 }
 
 /**
@@ -371,17 +349,35 @@ void DynamicBitset::reset_all()
  */
 void DynamicBitset::reset(size_t bit)
 {
-    if (bit >= m_size)
-    {
-        std::ostringstream ss;
-        ss << "Cannot get bit " << bit << " from a bitset of size " << m_size;
-        throw OutOfRangeException(ss.str().c_str());
-    }
+    check_in_range(bit);
 
-    size_t segment = bit / segment_bitwidth;
-    size_t pos = bit - (segment * segment_bitwidth);
+    m_segments[bit / segment_bitwidth] &= ~BitOps::bit_mask(bit);
+}
 
-    m_segments[segment] &= ~BIT(pos);
+/**
+ * Finds the position of the first set bit in the bitset.
+ * 
+ * @throws Parable::OutOfRangeException if no bits are set
+ */
+size_t DynamicBitset::find_first_set() const
+{
+    SetBitRange bits = set_bits();
+    if (bits.begin() != bits.end()) return *bits.begin();
+
+    throw OutOfRangeException("No set bits in the bitset, cannot find first set bit");
+}
+
+/**
+ * Finds the position of the first unset bit in the bitset.
+ * 
+ * @throws Parable::OutOfRangeException if all bits are set
+ */
+size_t DynamicBitset::find_first_unset() const
+{
+    UnsetBitRange bits = unset_bits();
+    if (bits.begin() != bits.end()) return *bits.begin();
+
+    throw OutOfRangeException("No unset bits in the bitset, cannot find first unset bit");
 }
 
 /**
@@ -392,10 +388,10 @@ std::string DynamicBitset::to_string()
     std::ostringstream ss;
     for(size_t i = 0; i < m_size; ++i)
     {
-        ss << (*this)[i] ? 1 : 0;
+        ss << ((*this)[i] ? 1 : 0);
     }
     return ss.str();
 }
 
 
-}
\ No newline at end of file
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BitOps.h"
+
 namespace Parable
 {
     class Allocator;
@@ -17,13 +19,18 @@ namespace Parable::Util
  * 
  *  Implements most of the functions from std::bitset, but size is set in ctor instead of by template.
  * 
+ * Bits are stored in 64 bit segments, bulk operations use the BitOps kernels.
+ * 
  * Invariant: any unused bits in the last segment will always be 0
  */
 class DynamicBitset
 {
-    using Segment = unsigned int;
+    using Segment = BitOps::Word;
 
 public:
+    using SetBitRange = BitOps::BitRange<true>;
+    using UnsetBitRange = BitOps::BitRange<false>;
+
     DynamicBitset(size_t size, Allocator& allocator);
     ~DynamicBitset();
 
@@ -50,6 +57,9 @@ public:
     bool is_subset_of(const DynamicBitset& other) const;
     bool is_superset_of(const DynamicBitset& other) const;
 
+    bool and_any(const DynamicBitset& other) const;
+    size_t and_count(const DynamicBitset& other) const;
+
     // modifiers
 
     DynamicBitset& operator&=(const DynamicBitset& other);
@@ -64,20 +74,35 @@ public:
     void reset_all();
     void reset(size_t bit);
 
+    // other
+
+    size_t find_first_set() const;
+    size_t find_first_unset() const;
+
+    /**
+     * Iterate the positions of the set bits, without allocating.
+     */
+    SetBitRange set_bits() const { return SetBitRange(m_segments, m_num_segments, BitOps::last_word_mask(m_size)); }
+    /**
+     * Iterate the positions of the unset bits, without allocating.
+     */
+    UnsetBitRange unset_bits() const { return UnsetBitRange(m_segments, m_num_segments, BitOps::last_word_mask(m_size)); }
+
     // debug
 
     std::string to_string();
 
 private:
-    static const size_t segment_bitwidth = sizeof(Segment) * 8;
+    static const size_t segment_bitwidth = BitOps::WORD_BITS;
+
+    void check_compatible(const DynamicBitset& other) const;
+    void check_in_range(size_t bit) const;
 
     size_t m_size;
 
     size_t m_num_segments;
     Segment* m_segments;
 
-    size_t m_last_segment_bits;
-
     Allocator& m_allocator;
 
 };
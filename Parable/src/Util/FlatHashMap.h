@@ -0,0 +1,613 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define PBL_FLAT_HASH_SSE2
+#endif
+
+#include "Hash.h"
+
+#include "Exception/LogicExceptions.h"
+#include "Memory/Allocator.h"
+
+namespace Parable::Util
+{
+
+
+namespace FlatHash
+{
+
+using Ctrl = int8_t;
+
+/**
+ * Control byte values. Full slots store the low 7 bits of their hash (0..127), so the sign
+ * bit alone says whether a slot is free.
+ */
+static constexpr Ctrl CTRL_EMPTY = -128;
+static constexpr Ctrl CTRL_DELETED = -2;
+
+static constexpr size_t GROUP_WIDTH = 16;
+
+/**
+ * GROUP_WIDTH control bytes, matched against a value in one go.
+ * 
+ * Each match returns a bitmask with bit i set if byte i matched.
+ */
+class Group
+{
+public:
+#if defined(PBL_FLAT_HASH_SSE2)
+    explicit Group(const Ctrl* ctrl) : m_ctrl(_mm_loadu_si128((const __m128i*)ctrl)) {}
+
+    uint32_t match(Ctrl h2) const { return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)); }
+    uint32_t match_empty() const { return match(CTRL_EMPTY); }
+    uint32_t match_free() const { return (uint32_t)_mm_movemask_epi8(m_ctrl); }
+
+private:
+    __m128i m_ctrl;
+#else
+    explicit Group(const Ctrl* ctrl) : m_ctrl(ctrl) {}
+
+    uint32_t match(Ctrl h2) const
+    {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_WIDTH; ++i) mask |= (uint32_t)(m_ctrl[i] == h2) << i;
+        return mask;
+    }
+    uint32_t match_empty() const { return match(CTRL_EMPTY); }
+    uint32_t match_free() const
+    {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_WIDTH; ++i) mask |= (uint32_t)(m_ctrl[i] < 0) << i;
+        return mask;
+    }
+
+private:
+    const Ctrl* m_ctrl;
+#endif
+};
+
+/**
+ * Picks the lookup argument type of a table.
+ * 
+ * A class specialisation rather than std::conditional, so that K stays deducible.
+ */
+template<bool Transparent>
+struct KeyArgSelect
+{
+    template<class K, class Key> using type = K;
+};
+
+template<>
+struct KeyArgSelect<false>
+{
+    template<class K, class Key> using type = Key;
+};
+
+}
+
+/**
+ * Open addressing hash table in the style of a Swiss table.
+ * 
+ * Slots live in one flat array alongside an array of one byte control tags. A lookup
+ * hashes once, uses the high bits to pick a starting group and compares the low 7 bits
+ * against a whole group of 16 tags with one SIMD compare, so only slots whose tag matches
+ * are ever compared by key. Probing moves between groups with triangular steps, and the
+ * table grows at 7/8 load.
+ * 
+ * Unlike node based containers, an insertion may move every element, so
+ * pointers, references and iterators into the table are invalidated by it.
+ * 
+ * Use through FlatHashMap and FlatHashSet.
+ * 
+ * @tparam Key the key type
+ * @tparam Mapped the mapped type, or void for a set
+ * @tparam HashT hasher, lookups by other types are allowed when both HashT and EqT are transparent
+ * @tparam EqT key equality
+ */
+template<class Key, class Mapped, class HashT, class EqT>
+class FlatHashTable
+{
+    using Ctrl = FlatHash::Ctrl;
+    using Group = FlatHash::Group;
+    static constexpr size_t GROUP_WIDTH = FlatHash::GROUP_WIDTH;
+
+    static constexpr bool IS_SET = std::is_void_v<Mapped>;
+    static constexpr bool IS_TRANSPARENT = requires { typename HashT::is_transparent; typename EqT::is_transparent; };
+
+    /**
+     * Lookups take any type when transparent, otherwise only Key.
+     */
+    template<class K>
+    using KeyArg = typename FlatHash::KeyArgSelect<IS_TRANSPARENT>::template type<K, Key>;
+
+public:
+    using key_type = Key;
+    using mapped_type = Mapped;
+    using value_type = std::conditional_t<IS_SET, Key, std::pair<const Key, std::conditional_t<IS_SET, int, Mapped>>>;
+
+    template<bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashTable::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using Table = std::conditional_t<Const, const FlatHashTable, FlatHashTable>;
+
+        Iterator() = default;
+        Iterator(Table* table, size_t index) : m_table(table), m_index(index) { skip_free(); }
+        // non-const to const
+        template<bool OtherConst> requires (Const && !OtherConst)
+        Iterator(const Iterator<OtherConst>& other) : m_table(other.m_table), m_index(other.m_index) {}
+
+        reference operator*() const { return m_table->m_slots[m_index]; }
+        pointer operator->() const { return &m_table->m_slots[m_index]; }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            skip_free();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        friend class FlatHashTable;
+        friend class Iterator<!Const>;
+
+        void skip_free()
+        {
+            while (m_index < m_table->m_capacity && m_table->m_ctrl[m_index] < 0) ++m_index;
+        }
+
+        Table* m_table = nullptr;
+        size_t m_index = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * @param allocator where to allocate the table from, or nullptr for the global heap
+     */
+    explicit FlatHashTable(Allocator* allocator = nullptr) : m_allocator(allocator) {}
+
+    FlatHashTable(const FlatHashTable& other) : FlatHashTable(other.m_allocator)
+    {
+        reserve(other.m_size);
+        for (const value_type& value : other) insert(value);
+    }
+
+    FlatHashTable(FlatHashTable&& other) :
+                                m_ctrl(std::exchange(other.m_ctrl, nullptr)),
+                                m_slots(std::exchange(other.m_slots, nullptr)),
+                                m_capacity(std::exchange(other.m_capacity, 0)),
+                                m_size(std::exchange(other.m_size, 0)),
+                                m_growth_left(std::exchange(other.m_growth_left, 0)),
+                                m_allocator(other.m_allocator)
+    {
+    }
+
+    ~FlatHashTable()
+    {
+        destroy_all();
+        free_storage();
+    }
+
+    FlatHashTable& operator=(const FlatHashTable& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.m_size);
+            for (const value_type& value : other) insert(value);
+        }
+        return *this;
+    }
+
+    FlatHashTable& operator=(FlatHashTable&& other)
+    {
+        if (this != &other)
+        {
+            destroy_all();
+            free_storage();
+
+            m_ctrl = std::exchange(other.m_ctrl, nullptr);
+            m_slots = std::exchange(other.m_slots, nullptr);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_size = std::exchange(other.m_size, 0);
+            m_growth_left = std::exchange(other.m_growth_left, 0);
+            m_allocator = other.m_allocator;
+        }
+        return *this;
+    }
+
+    // iteration
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_capacity); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_capacity); }
+
+    // capacity
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * Make room for at least count elements without growing again.
+     */
+    void reserve(size_t count)
+    {
+        size_t capacity = GROUP_WIDTH;
+        while (max_load(capacity) < count) capacity *= 2;
+
+        if (capacity > m_capacity) rehash(capacity);
+    }
+
+    // lookup
+
+    template<class K = Key>
+    iterator find(const KeyArg<K>& key)
+    {
+        return iterator(this, find_index(key));
+    }
+
+    template<class K = Key>
+    const_iterator find(const KeyArg<K>& key) const
+    {
+        return const_iterator(this, find_index(key));
+    }
+
+    template<class K = Key>
+    bool contains(const KeyArg<K>& key) const
+    {
+        return find_index(key) != m_capacity;
+    }
+
+    template<class K = Key>
+    size_t count(const KeyArg<K>& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * @throws Parable::OutOfRangeException if the key is not in the map
+     */
+    template<class K = Key, class M = Mapped> requires (!std::is_void_v<M>)
+    M& at(const KeyArg<K>& key)
+    {
+        size_t index = find_index(key);
+        if (index == m_capacity) throw OutOfRangeException("Key not found in FlatHashMap.");
+        return m_slots[index].second;
+    }
+
+    template<class K = Key, class M = Mapped> requires (!std::is_void_v<M>)
+    const M& at(const KeyArg<K>& key) const
+    {
+        size_t index = find_index(key);
+        if (index == m_capacity) throw OutOfRangeException("Key not found in FlatHashMap.");
+        return m_slots[index].second;
+    }
+
+    // modifiers
+
+    /**
+     * Insert a value if its key is not present.
+     * 
+     * @return the element with the key, and whether it was inserted
+     */
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return emplace_unique(key_of(value), value);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return emplace_unique(key_of(value), std::move(value));
+    }
+
+    /**
+     * Construct a mapped value from args if the key is not present, otherwise do nothing.
+     * 
+     * @return the element with the key, and whether it was inserted
+     */
+    template<class K, class... Args, class M = Mapped> requires (!std::is_void_v<M>)
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        return emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template<class M = Mapped> requires (!std::is_void_v<M>)
+    M& operator[](const Key& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    template<class M = Mapped> requires (!std::is_void_v<M>)
+    M& operator[](Key&& key)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    /**
+     * @return the number of elements erased (0 or 1)
+     */
+    template<class K = Key>
+    size_t erase(const KeyArg<K>& key)
+    {
+        size_t index = find_index(key);
+        if (index == m_capacity) return 0;
+
+        erase_index(index);
+        return 1;
+    }
+
+    void erase(const_iterator it)
+    {
+        erase_index(it.m_index);
+    }
+
+    /**
+     * Destroy all the elements, keeping the allocated capacity.
+     */
+    void clear()
+    {
+        destroy_all();
+        reset_ctrl();
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+    }
+
+private:
+    static constexpr size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+
+    static size_t h1(size_t hash) { return hash >> 7; }
+    static Ctrl h2(size_t hash) { return (Ctrl)(hash & 0x7F); }
+
+    static const Key& key_of(const value_type& value)
+    {
+        if constexpr (IS_SET) return value;
+        else return value.first;
+    }
+
+    template<class K>
+    size_t hash_of(const K& key) const { return (size_t)HashT{}(key); }
+
+    /**
+     * Index of the slot holding key, or m_capacity if it is not present.
+     */
+    template<class K>
+    size_t find_index(const K& key) const
+    {
+        if (m_size == 0) return m_capacity;
+
+        return find_index(key, hash_of(key));
+    }
+
+    template<class K>
+    size_t find_index(const K& key, size_t hash) const
+    {
+        size_t mask = m_capacity - 1;
+        size_t pos = h1(hash) & mask;
+
+        for (size_t step = GROUP_WIDTH; ; step += GROUP_WIDTH)
+        {
+            Group group(m_ctrl + pos);
+            for (uint32_t match = group.match(h2(hash)); match != 0; match &= match - 1)
+            {
+                size_t index = (pos + (size_t)std::countr_zero(match)) & mask;
+                if (EqT{}(key_of(m_slots[index]), key)) return index;
+            }
+
+            // an empty slot ends every probe sequence which passed through this group
+            if (group.match_empty() != 0) return m_capacity;
+
+            pos = (pos + step) & mask;
+        }
+    }
+
+    /**
+     * Index of the first empty or deleted slot on the probe sequence of hash.
+     * 
+     * There is always one, as the table grows before it fills.
+     */
+    size_t find_free_index(size_t hash) const
+    {
+        size_t mask = m_capacity - 1;
+        size_t pos = h1(hash) & mask;
+
+        for (size_t step = GROUP_WIDTH; ; step += GROUP_WIDTH)
+        {
+            uint32_t free = Group(m_ctrl + pos).match_free();
+            if (free != 0) return (pos + (size_t)std::countr_zero(free)) & mask;
+
+            pos = (pos + step) & mask;
+        }
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> emplace_unique(const K& key, Args&&... args)
+    {
+        size_t hash = hash_of(key);
+
+        if (m_size > 0)
+        {
+            size_t index = find_index(key, hash);
+            if (index != m_capacity) return { iterator(this, index), false };
+        }
+
+        if (m_growth_left == 0) grow();
+
+        size_t index = find_free_index(hash);
+
+        // reusing a tombstone does not use up any growth
+        if (m_ctrl[index] == FlatHash::CTRL_EMPTY) --m_growth_left;
+
+        new (&m_slots[index]) value_type(std::forward<Args>(args)...);
+        set_ctrl(index, h2(hash));
+        ++m_size;
+
+        return { iterator(this, index), true };
+    }
+
+    void erase_index(size_t index)
+    {
+        m_slots[index].~value_type();
+        set_ctrl(index, FlatHash::CTRL_DELETED);
+        --m_size;
+    }
+
+    /**
+     * Set a control byte, and its mirror past the end which lets groups read over the wrap.
+     */
+    void set_ctrl(size_t index, Ctrl value)
+    {
+        m_ctrl[index] = value;
+        if (index < GROUP_WIDTH) m_ctrl[m_capacity + index] = value;
+    }
+
+    void reset_ctrl()
+    {
+        if (m_ctrl != nullptr) std::memset(m_ctrl, (uint8_t)FlatHash::CTRL_EMPTY, m_capacity + GROUP_WIDTH);
+    }
+
+    void grow()
+    {
+        // mostly tombstones, clean them up without growing
+        if (m_capacity > 0 && m_size <= max_load(m_capacity) / 2)
+        {
+            rehash(m_capacity);
+        }
+        else
+        {
+            rehash(m_capacity == 0 ? GROUP_WIDTH : m_capacity * 2);
+        }
+    }
+
+    void rehash(size_t new_capacity)
+    {
+        Ctrl* old_ctrl = m_ctrl;
+        value_type* old_slots = m_slots;
+        size_t old_capacity = m_capacity;
+
+        allocate_storage(new_capacity);
+
+        for (size_t i = 0; i < old_capacity; ++i)
+        {
+            if (old_ctrl[i] < 0) continue;
+
+            value_type& value = old_slots[i];
+            size_t hash = hash_of(key_of(value));
+            size_t index = find_free_index(hash);
+
+            if constexpr (IS_SET)
+            {
+                new (&m_slots[index]) value_type(std::move(value));
+            }
+            else
+            {
+                // the old element is destroyed straight after, so its key can be moved from
+                new (&m_slots[index]) value_type(std::move(const_cast<Key&>(value.first)), std::move(value.second));
+            }
+            set_ctrl(index, h2(hash));
+
+            value.~value_type();
+        }
+
+        m_growth_left = max_load(m_capacity) - m_size;
+
+        if (old_ctrl != nullptr) deallocate(old_ctrl);
+    }
+
+    /**
+     * Control bytes and slots share one allocation, control bytes first.
+     */
+    static size_t slots_offset(size_t capacity)
+    {
+        size_t align = alignof(value_type);
+        return (capacity + GROUP_WIDTH + align - 1) / align * align;
+    }
+
+    void allocate_storage(size_t capacity)
+    {
+        size_t bytes = slots_offset(capacity) + capacity * sizeof(value_type);
+        size_t alignment = std::max<size_t>(alignof(value_type), GROUP_WIDTH);
+
+        void* memory = m_allocator != nullptr ? m_allocator->allocate(bytes, alignment) : ::operator new(bytes, std::align_val_t(alignment));
+        if (memory == nullptr) throw std::bad_alloc();
+
+        m_ctrl = (Ctrl*)memory;
+        m_slots = (value_type*)((char*)memory + slots_offset(capacity));
+        m_capacity = capacity;
+        reset_ctrl();
+    }
+
+    void deallocate(void* memory)
+    {
+        if (m_allocator != nullptr) m_allocator->deallocate(memory);
+        else ::operator delete(memory, std::align_val_t(std::max<size_t>(alignof(value_type), GROUP_WIDTH)));
+    }
+
+    void destroy_all()
+    {
+        if constexpr (!std::is_trivially_destructible_v<value_type>)
+        {
+            for (size_t i = 0; i < m_capacity; ++i)
+            {
+                if (m_ctrl[i] >= 0) m_slots[i].~value_type();
+            }
+        }
+    }
+
+    void free_storage()
+    {
+        if (m_ctrl != nullptr) deallocate(m_ctrl);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growth_left = 0;
+    }
+
+    Ctrl* m_ctrl = nullptr;
+    value_type* m_slots = nullptr;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+    /**
+     * Empty slots which can still be filled before the table must grow.
+     */
+    size_t m_growth_left = 0;
+
+    Allocator* m_allocator = nullptr;
+};
+
+template<class Key, class Mapped, class HashT = Hash<Key>, class EqT = std::equal_to<>>
+using FlatHashMap = FlatHashTable<Key, Mapped, HashT, EqT>;
+
+template<class Key, class HashT = Hash<Key>, class EqT = std::equal_to<>>
+using FlatHashSet = FlatHashTable<Key, void, HashT, EqT>;
+
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Parable::Util
+{
+
+
+/**
+ * Scramble all 64 bits of a value into each other (murmur3 finaliser).
+ * 
+ * Open addressing tables take their probe position and tag bits from different ends of
+ * the hash, so hashes which are not already well mixed (e.g. std::hash of an integer is
+ * the integer) must be passed through this first.
+ */
+constexpr uint64_t mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * Hash a run of bytes, 8 at a time.
+ */
+inline uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 0)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = seed ^ (size * 0x9e3779b97f4a7c15ULL);
+
+    for (; size >= 8; size -= 8, p += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = std::rotl(h ^ (word * 0x87c37b91114253d5ULL), 31) * 0x4cf5ad432745937fULL;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, size);
+    h ^= tail * 0x87c37b91114253d5ULL;
+
+    return mix(h);
+}
+
+/**
+ * 64-bit FNV-1a of a string.
+ * 
+ * Slower and weaker than hash_bytes, but a fixed published function which is constexpr, so
+ * hashes of names can be computed at compile time and stored in files which outlive a build.
+ */
+constexpr uint64_t fnv1a(std::string_view s)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (char c : s)
+    {
+        h ^= (unsigned char)c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/**
+ * Combine a hash into a running seed, for hashing the members of a struct.
+ */
+constexpr uint64_t hash_combine(uint64_t seed, uint64_t hash)
+{
+    return mix(seed ^ (hash + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+/**
+ * Default hasher for the flat hash containers.
+ * 
+ * Mixes integers, enums and pointers directly and falls back to a mixed std::hash otherwise.
+ */
+template<class T>
+struct Hash
+{
+    size_t operator()(const T& value) const
+    {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            return (size_t)mix((uint64_t)value);
+        }
+        else if constexpr (std::is_pointer_v<T>)
+        {
+            return (size_t)mix((uint64_t)(uintptr_t)value);
+        }
+        else
+        {
+            return (size_t)mix((uint64_t)std::hash<T>{}(value));
+        }
+    }
+};
+
+/**
+ * Strings hash their characters, and can be looked up by string_view or C string without a copy.
+ */
+template<>
+struct Hash<std::string>
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view s) const { return (size_t)hash_bytes(s.data(), s.size()); }
+};
+
+template<>
+struct Hash<std::string_view> : Hash<std::string> {};
+
+
+}
@@ -0,0 +1,412 @@
+#include "HierarchicalBitset.h"
+
+#include "pblpch.h"
+
+#include "Core/Base.h"
+
+#include "Exception/LogicExceptions.h"
+#include "Exception/MemoryExceptions.h"
+
+#include "Memory/Allocator.h"
+
+
+namespace Parable::Util
+{
+
+/**
+ * Constructs a bitset which holds size bits, and allocates space for it and its summaries with allocator
+ * 
+ * @param size the number of bits to store
+ * @param allocator Parable::Allocator to allocate space for the bits
+ * 
+ * @throws Parable::AllocationFailedException if the allocation for bits fails
+ */
+HierarchicalBitset::HierarchicalBitset(size_t size, Allocator& allocator) :
+                                                            m_size(size),
+                                                            m_allocator(allocator)
+{
+    PBL_CORE_ASSERT_MSG(size > 0, "Cannot create a HierarchicalBitset of size 0!")
+
+    // bits, then one summary level, then a second if the first is more than a word
+    m_level_words[0] = BitOps::words_for(size);
+    m_level_words[1] = BitOps::words_for(m_level_words[0]);
+    m_num_levels = 2;
+    if (m_level_words[1] > 1)
+    {
+        m_level_words[2] = BitOps::words_for(m_level_words[1]);
+        m_num_levels = 3;
+    }
+
+    m_total_words = 0;
+    for (size_t l = 0; l < m_num_levels; ++l) m_total_words += m_level_words[l];
+
+    m_words = allocator.allocate_array<Word>(m_total_words);
+
+    if (m_words == nullptr)
+    {
+        throw Parable::AllocationFailedException("Failed to allocate space for bitset.");
+    }
+
+    Word* p = m_words;
+    for (size_t l = 0; l < m_num_levels; ++l)
+    {
+        m_levels[l] = p;
+        p += m_level_words[l];
+    }
+
+    for (size_t i = 0; i < m_total_words; ++i) m_words[i] = 0;
+}
+
+HierarchicalBitset::~HierarchicalBitset()
+{
+    m_allocator.deallocate_array<Word>(m_words);
+}
+
+/**
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
+void HierarchicalBitset::check_compatible(const HierarchicalBitset& other) const
+{
+    if (m_size != other.get_size())
+    {
+        std::ostringstream ss;
+        ss << "Cannot compare a bitset of size " << m_size << " with a bitset of size " << other.get_size();
+        throw IncompatibleObjectException(ss.str().c_str());
+    }
+}
+
+/**
+ * @throws Parable::OutOfRangeException if bit >= size of the bitset
+ */
+void HierarchicalBitset::check_in_range(size_t bit) const
+{
+    if (bit >= m_size)
+    {
+        std::ostringstream ss;
+        ss << "Cannot get bit " << bit << " from a bitset of size " << m_size;
+        throw OutOfRangeException(ss.str().c_str());
+    }
+}
+
+void HierarchicalBitset::mark_word(size_t word)
+{
+    size_t index = word;
+    for (size_t l = 1; l < m_num_levels; ++l)
+    {
+        Word& w = level(l)[index / BitOps::WORD_BITS];
+        bool was_empty = w == 0;
+        w |= BitOps::bit_mask(index);
+
+        // the levels above already know about a non-zero word
+        if (!was_empty) return;
+
+        index /= BitOps::WORD_BITS;
+    }
+}
+
+void HierarchicalBitset::unmark_word(size_t word)
+{
+    size_t index = word;
+    for (size_t l = 1; l < m_num_levels; ++l)
+    {
+        Word& w = level(l)[index / BitOps::WORD_BITS];
+        w &= ~BitOps::bit_mask(index);
+
+        // the levels above only change if this word is now empty too
+        if (w != 0) return;
+
+        index /= BitOps::WORD_BITS;
+    }
+}
+
+// element access
+
+/**
+ * Return the value of a single bit.
+ * 
+ * @param bit the position of the bit to check
+ */
+bool HierarchicalBitset::operator[](size_t bit) const
+{
+    return level(0)[bit / BitOps::WORD_BITS] & BitOps::bit_mask(bit);
+}
+
+/**
+ * Return the value of a single bit with bounds checking.
+ * 
+ * @param bit the position of the bit to check
+ * 
+ * @throws Parable::OutOfRangeException if bit >= size of the bitset
+ */
+bool HierarchicalBitset::at(size_t bit) const
+{
+    check_in_range(bit);
+
+    return (*this)[bit];
+}
+
+/**
+ * Check if at least one of the bits are set.
+ * 
+ * Only checks the top summary level.
+ */
+bool HierarchicalBitset::any() const
+{
+    return BitOps::any(level(m_num_levels - 1), m_level_words[m_num_levels - 1]);
+}
+
+/**
+ * Check if none of the bits are set.
+ */
+bool HierarchicalBitset::none() const
+{
+    return !any();
+}
+
+/**
+ * Return the number of bits that are set.
+ */
+size_t HierarchicalBitset::count() const
+{
+    size_t count = 0;
+    for (size_t w : set_words())
+    {
+        count += (size_t)std::popcount(level(0)[w]);
+    }
+    return count;
+}
+
+/**
+ * Finds the position of the first set bit in the bitset.
+ * 
+ * @throws Parable::OutOfRangeException if no bits are set
+ */
+size_t HierarchicalBitset::find_first_set() const
+{
+    Iterator it(this, 0, false);
+    if (it != Iterator(this, 0, true)) return *it;
+
+    throw OutOfRangeException("No set bits in the bitset, cannot find first set bit");
+}
+
+// set operations
+
+/**
+ * Checks if this and another bitset have any set bits in common.
+ * 
+ * Only visits the non-zero words of this bitset.
+ * 
+ * @param other the other bitset to compare with
+ * 
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
+bool HierarchicalBitset::and_any(const HierarchicalBitset& other) const
+{
+    check_compatible(other);
+
+    for (size_t w : set_words())
+    {
+        if ((level(0)[w] & other.level(0)[w]) != 0) return true;
+    }
+    return false;
+}
+
+/**
+ * Counts the set bits this and another bitset have in common.
+ * 
+ * Only visits the non-zero words of this bitset.
+ * 
+ * @param other the other bitset to compare with
+ * 
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
+size_t HierarchicalBitset::and_count(const HierarchicalBitset& other) const
+{
+    check_compatible(other);
+
+    size_t count = 0;
+    for (size_t w : set_words())
+    {
+        count += (size_t)std::popcount(level(0)[w] & other.level(0)[w]);
+    }
+    return count;
+}
+
+/**
+ * Intersect with another bitset of the same size.
+ * 
+ * Only visits the non-zero words of this bitset.
+ * 
+ * @param other the other bitset to AND with
+ * 
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
+HierarchicalBitset& HierarchicalBitset::operator&=(const HierarchicalBitset& other)
+{
+    check_compatible(other);
+
+    // the iterator has already consumed the summary bits of words it has visited,
+    // so clearing them as words empty does not disturb it
+    for (size_t w : set_words())
+    {
+        Word& word = level(0)[w];
+        word &= other.level(0)[w];
+        if (word == 0) unmark_word(w);
+    }
+
+    return (*this);
+}
+
+/**
+ * Union with another bitset of the same size.
+ * 
+ * Only visits the non-zero words of the other bitset.
+ * 
+ * @param other the other bitset to OR with
+ * 
+ * @throws Parable::IncompatibleObjectException if the bitsets have different sizes
+ */
+HierarchicalBitset& HierarchicalBitset::operator|=(const HierarchicalBitset& other)
+{
+    check_compatible(other);
+
+    for (size_t w : other.set_words())
+    {
+        Word& word = level(0)[w];
+        bool was_empty = word == 0;
+        word |= other.level(0)[w];
+        if (was_empty) mark_word(w);
+    }
+
+    return (*this);
+}
+
+// modifiers
+
+/**
+ * Sets a specific bit in the bitset.
+ * 
+ * @param bit the bit to set
+ * 
+ * @throws Parable::OutOfRangeException if bit >= size of the bitset
+ */
+void HierarchicalBitset::set(size_t bit)
+{
+    check_in_range(bit);
+
+    Word& word = level(0)[bit / BitOps::WORD_BITS];
+    bool was_empty = word == 0;
+    word |= BitOps::bit_mask(bit);
+    if (was_empty) mark_word(bit / BitOps::WORD_BITS);
+}
+
+/**
+ * Resets a specific bit in the bitset.
+ * 
+ * @param bit the bit to reset
+ * 
+ * @throws Parable::OutOfRangeException if bit >= size of the bitset
+ */
+void HierarchicalBitset::reset(size_t bit)
+{
+    check_in_range(bit);
+
+    Word& word = level(0)[bit / BitOps::WORD_BITS];
+    if (word == 0) return;
+
+    word &= ~BitOps::bit_mask(bit);
+    if (word == 0) unmark_word(bit / BitOps::WORD_BITS);
+}
+
+/**
+ * Reset all the bits in the bitset.
+ * 
+ * Only the non-zero bit words are written, plus the (small) summary levels.
+ */
+void HierarchicalBitset::reset_all()
+{
+    for (size_t w : set_words()) level(0)[w] = 0;
+
+    for (size_t l = 1; l < m_num_levels; ++l)
+    {
+        for (size_t i = 0; i < m_level_words[l]; ++i) level(l)[i] = 0;
+    }
+}
+
+
+// ITERATOR
+
+/**
+ * Construct an iterator positioned at the first set bit of a level.
+ * 
+ * @param bitset the bitset to iterate
+ * @param target_level the level whose set bits are visited
+ * @param end whether to construct the end iterator
+ */
+HierarchicalBitset::Iterator::Iterator(const HierarchicalBitset* bitset, size_t target_level, bool end) :
+                                                                                m_bitset(bitset),
+                                                                                m_target(target_level),
+                                                                                m_end(end)
+{
+    if (m_end) return;
+
+    size_t top = m_bitset->m_num_levels - 1;
+    m_word[top] = 0;
+    m_mask[top] = m_bitset->level(top)[0];
+
+    settle();
+}
+
+HierarchicalBitset::Iterator& HierarchicalBitset::Iterator::operator++()
+{
+    m_mask[m_target] &= m_mask[m_target] - 1;
+    if (m_mask[m_target] == 0) settle();
+    return *this;
+}
+
+bool HierarchicalBitset::Iterator::operator==(const Iterator& other) const
+{
+    if (m_end || other.m_end) return m_end == other.m_end;
+    return m_word[m_target] == other.m_word[m_target] && m_mask[m_target] == other.m_mask[m_target];
+}
+
+/**
+ * Move to the next set bit at the target level, if the current word has none left.
+ * 
+ * Climbs until a level still has bits to visit, then descends along the lowest of them.
+ * Summary bits are cleared from the masks as they are descended through.
+ */
+void HierarchicalBitset::Iterator::settle()
+{
+    size_t top = m_bitset->m_num_levels - 1;
+
+    size_t l = m_target;
+    while (l < top && m_mask[l] == 0) ++l;
+
+    if (m_mask[l] == 0)
+    {
+        // l is the top level, scan for its next non-zero word
+        do
+        {
+            if (++m_word[top] >= m_bitset->m_level_words[top])
+            {
+                m_end = true;
+                return;
+            }
+            m_mask[top] = m_bitset->level(top)[m_word[top]];
+        } while (m_mask[top] == 0);
+    }
+
+    while (l > m_target)
+    {
+        size_t child = m_word[l] * BitOps::WORD_BITS + (size_t)std::countr_zero(m_mask[l]);
+        m_mask[l] &= m_mask[l] - 1;
+
+        --l;
+        m_word[l] = child;
+        m_mask[l] = m_bitset->level(l)[child];
+    }
+}
+
+
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+
+#include "BitOps.h"
+
+namespace Parable
+{
+    class Allocator;
+}
+
+namespace Parable::Util
+{
+
+
+/**
+ * A bitset for large, sparse sets, with summary layers to skip empty regions.
+ * 
+ * Level 0 holds the bits. Each level above holds one bit per word of the level below,
+ * set when that word is non-zero. A second summary level is added when the first has
+ * more than one word, so 10M bits need a scan of at most 39 top words.
+ * 
+ * Iteration, find_first_set, count and the set operations only visit non-zero words,
+ * so their cost follows the number of set bits rather than the size of the set.
+ * 
+ * Invariant: a summary bit is set if and only if the word it covers is non-zero.
+ */
+class HierarchicalBitset
+{
+    using Word = BitOps::Word;
+
+public:
+    static constexpr size_t MAX_LEVELS = 3;
+
+    /**
+     * Forward iterator over the set bits at one level.
+     * 
+     * At level 0 this visits set bits; at level 1 it visits the indices of non-zero bit words.
+     */
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const size_t*;
+        using reference = size_t;
+
+        Iterator() = default;
+        Iterator(const HierarchicalBitset* bitset, size_t target_level, bool end);
+
+        size_t operator*() const { return m_word[m_target] * BitOps::WORD_BITS + (size_t)std::countr_zero(m_mask[m_target]); }
+
+        Iterator& operator++();
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        void settle();
+
+        const HierarchicalBitset* m_bitset = nullptr;
+        size_t m_target = 0;
+        bool m_end = true;
+
+        /**
+         * Remaining bits to visit of the current word at each level.
+         */
+        std::array<Word, MAX_LEVELS> m_mask = {};
+        /**
+         * Index of the current word at each level.
+         */
+        std::array<size_t, MAX_LEVELS> m_word = {};
+    };
+
+    /**
+     * A range of Iterators, for use in range-for.
+     */
+    class Range
+    {
+    public:
+        Range(const HierarchicalBitset* bitset, size_t level) : m_bitset(bitset), m_level(level) {}
+
+        Iterator begin() const { return Iterator(m_bitset, m_level, false); }
+        Iterator end() const { return Iterator(m_bitset, m_level, true); }
+
+    private:
+        const HierarchicalBitset* m_bitset;
+        size_t m_level;
+    };
+
+    HierarchicalBitset(size_t size, Allocator& allocator);
+    HierarchicalBitset(const HierarchicalBitset&) = delete;
+    ~HierarchicalBitset();
+
+    HierarchicalBitset& operator=(const HierarchicalBitset&) = delete;
+
+    // element access
+
+    bool at(size_t bit) const;
+    bool operator[](size_t bit) const;
+
+    bool any() const;
+    bool none() const;
+    size_t count() const;
+
+    size_t find_first_set() const;
+
+    /**
+     * Iterate the positions of the set bits, skipping empty regions.
+     */
+    Range set_bits() const { return Range(this, 0); }
+    /**
+     * Iterate the indices of the non-zero words of bits.
+     */
+    Range set_words() const { return Range(this, 1); }
+
+    /**
+     * Return the number of boolean values stored
+     */
+    size_t get_size() const { return m_size; }
+    size_t get_num_levels() const { return m_num_levels; }
+
+    // set operations
+
+    bool and_any(const HierarchicalBitset& other) const;
+    size_t and_count(const HierarchicalBitset& other) const;
+
+    HierarchicalBitset& operator&=(const HierarchicalBitset& other);
+    HierarchicalBitset& operator|=(const HierarchicalBitset& other);
+
+    // modifiers
+
+    void set(size_t bit);
+    void reset(size_t bit);
+    void reset_all();
+
+private:
+    void check_compatible(const HierarchicalBitset& other) const;
+    void check_in_range(size_t bit) const;
+
+    /**
+     * Set the summary bits above a bit word which became non-zero.
+     */
+    void mark_word(size_t word);
+    /**
+     * Clear the summary bits above a bit word which became zero.
+     */
+    void unmark_word(size_t word);
+
+    Word* level(size_t l) const { return m_levels[l]; }
+
+    size_t m_size;
+
+    size_t m_num_levels;
+    std::array<Word*, MAX_LEVELS> m_levels = {};
+    std::array<size_t, MAX_LEVELS> m_level_words = {};
+
+    /**
+     * Single allocation holding every level.
+     */
+    Word* m_words;
+    size_t m_total_words;
+
+    Allocator& m_allocator;
+};
+
+
+}
@@ -0,0 +1,224 @@
+#include "LZ4.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace Parable::Util::LZ4
+{
+
+
+// limits from the block format: a match needs 4 bytes, may be at most 64KiB back, and the last
+// 5 bytes of a block are always literals, with the last match starting at least 12 bytes from the end
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_DISTANCE = 65535;
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MF_LIMIT = 12;
+
+constexpr uint32_t HASH_LOG = 12;
+
+static uint32_t read32(const uint8_t* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t hash_sequence(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+/**
+ * Write the 255-continued extra bytes of a length whose 4 bit token field was saturated.
+ */
+static uint8_t* write_length(uint8_t* op, size_t length)
+{
+    for (; length >= 255; length -= 255) *op++ = 255;
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+/**
+ * Emit a sequence of literals, then a match unless this is the final sequence.
+ *
+ * @return the new output position, or nullptr if it would not fit
+ */
+static uint8_t* write_sequence(uint8_t* op, const uint8_t* oend, const uint8_t* literals, size_t literal_length, size_t offset, size_t match_length, bool last)
+{
+    size_t worst_case = 1 + literal_length + literal_length / 255 + 1 + (last ? 0 : 2 + match_length / 255 + 1);
+    if ((size_t)(oend - op) < worst_case) return nullptr;
+
+    uint8_t* token = op++;
+    if (literal_length >= 15)
+    {
+        *token = 15 << 4;
+        op = write_length(op, literal_length - 15);
+    }
+    else
+    {
+        *token = (uint8_t)(literal_length << 4);
+    }
+
+    if (literal_length) std::memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    if (last) return op;
+
+    *op++ = (uint8_t)(offset & 0xff);
+    *op++ = (uint8_t)(offset >> 8);
+
+    match_length -= MIN_MATCH;
+    if (match_length >= 15)
+    {
+        *token |= 15;
+        op = write_length(op, match_length - 15);
+    }
+    else
+    {
+        *token |= (uint8_t)match_length;
+    }
+
+    return op;
+}
+
+/**
+ * Compress a block.
+ *
+ * @param src the data to compress
+ * @param dst the output, at least compress_bound(src.size()) to always fit
+ * @return the size of the compressed block, or 0 if it did not fit in dst
+ */
+size_t compress(std::span<const std::byte> src, std::span<std::byte> dst)
+{
+    const uint8_t* const in = reinterpret_cast<const uint8_t*>(src.data());
+    const uint8_t* const iend = in + src.size();
+    uint8_t* const out = reinterpret_cast<uint8_t*>(dst.data());
+    uint8_t* op = out;
+    const uint8_t* const oend = out + dst.size();
+
+    const uint8_t* anchor = in;
+
+    if (src.size() > MF_LIMIT)
+    {
+        // positions of the last sequence seen with each hash
+        uint32_t table[1 << HASH_LOG] = {};
+
+        const uint8_t* const mf_limit = iend - MF_LIMIT;
+        const uint8_t* const match_limit = iend - LAST_LITERALS;
+
+        const uint8_t* ip = in + 1;
+        while (ip < mf_limit)
+        {
+            uint32_t sequence = read32(ip);
+            uint32_t& slot = table[hash_sequence(sequence)];
+            const uint8_t* ref = in + slot;
+            slot = (uint32_t)(ip - in);
+
+            if (ref >= ip || (size_t)(ip - ref) > MAX_DISTANCE || read32(ref) != sequence)
+            {
+                ++ip;
+                continue;
+            }
+
+            // extend the match forwards, then backwards over any literals which also match
+            const uint8_t* match_end = ip + MIN_MATCH;
+            const uint8_t* ref_end = ref + MIN_MATCH;
+            while (match_end < match_limit && *match_end == *ref_end)
+            {
+                ++match_end;
+                ++ref_end;
+            }
+            while (ip > anchor && ref > in && ip[-1] == ref[-1])
+            {
+                --ip;
+                --ref;
+            }
+
+            op = write_sequence(op, oend, anchor, (size_t)(ip - anchor), (size_t)(ip - ref), (size_t)(match_end - ip), false);
+            if (!op) return 0;
+
+            ip = match_end;
+            anchor = ip;
+
+            // seed the table inside the match, so a following repeat is found
+            if (ip < mf_limit) table[hash_sequence(read32(ip - 2))] = (uint32_t)(ip - 2 - in);
+        }
+    }
+
+    op = write_sequence(op, oend, anchor, (size_t)(iend - anchor), 0, 0, true);
+    if (!op) return 0;
+
+    return (size_t)(op - out);
+}
+
+/**
+ * Decompress a block, checking every read and write is in bounds so corrupt input is safe.
+ *
+ * @param src the compressed block
+ * @param dst the output, exactly the size of the decompressed data
+ * @return true if the block decoded to exactly dst.size() bytes
+ */
+bool decompress(std::span<const std::byte> src, std::span<std::byte> dst)
+{
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(src.data());
+    const uint8_t* const iend = ip + src.size();
+    uint8_t* const out = reinterpret_cast<uint8_t*>(dst.data());
+    uint8_t* op = out;
+    uint8_t* const oend = out + dst.size();
+
+    auto read_length = [&ip, iend](size_t& length)
+    {
+        uint8_t byte;
+        do
+        {
+            if (ip >= iend) return false;
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (true)
+    {
+        if (ip >= iend) return false;
+        uint8_t token = *ip++;
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !read_length(literal_length)) return false;
+        if (literal_length > (size_t)(iend - ip) || literal_length > (size_t)(oend - op)) return false;
+
+        if (literal_length) std::memcpy(op, ip, literal_length);
+        op += literal_length;
+        ip += literal_length;
+
+        // the final sequence has no match
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return false;
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - out)) return false;
+
+        size_t match_length = token & 15;
+        if (match_length == 15 && !read_length(match_length)) return false;
+        match_length += MIN_MATCH;
+        if (match_length > (size_t)(oend - op)) return false;
+
+        const uint8_t* match = op - offset;
+        if (offset >= match_length)
+        {
+            std::memcpy(op, match, match_length);
+        }
+        else
+        {
+            // overlapping, so the match repeats the bytes being written
+            for (size_t i = 0; i < match_length; ++i) op[i] = match[i];
+        }
+        op += match_length;
+    }
+
+    return op == oend;
+}
+
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace Parable::Util::LZ4
+{
+
+
+/**
+ * An in-tree implementation of the LZ4 block format.
+ *
+ * Output is a raw LZ4 block (no frame header or checksums), so can be decoded by the reference
+ * library. The compressor is a single pass greedy matcher, which trades some ratio for speed;
+ * cooking time matters much less than decode speed, which is where LZ4 shines.
+ *
+ * Blocks carry no length, so callers store the decompressed size alongside the block.
+ */
+
+/**
+ * The largest a compressed block of an input size can be, for sizing the output buffer.
+ */
+constexpr size_t compress_bound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t compress(std::span<const std::byte> src, std::span<std::byte> dst);
+
+bool decompress(std::span<const std::byte> src, std::span<std::byte> dst);
+
+
+}
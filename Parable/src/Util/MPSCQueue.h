@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <span>
+#include <type_traits>
+
+#include "CacheLine.h"
+
+namespace Parable::Util
+{
+
+
+/**
+ * Bounded lock-free queue for any number of producer threads and one consumer thread.
+ * 
+ * Items are stored inline in a ring of cells. Each cell carries a sequence number which
+ * says whether it is free for the producer of a given position or ready for the consumer,
+ * so producers only contend on reserving positions, never on writing items.
+ * 
+ * @tparam T trivially copyable item type
+ * @tparam Capacity maximum number of items held, a power of 2
+ */
+template<typename T, size_t Capacity>
+class MPSCQueue
+{
+    static_assert(std::is_trivially_copyable_v<T>, "MPSCQueue items must be trivially copyable.");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "MPSCQueue capacity must be a power of 2.");
+
+public:
+    MPSCQueue()
+    {
+        for (size_t i = 0; i < Capacity; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    MPSCQueue(const MPSCQueue&) = delete;
+
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    /**
+     * Push an item, from any thread.
+     * 
+     * @return false if the queue is full
+     */
+    bool push(const T& item)
+    {
+        return push_batch(std::span<const T>(&item, 1)) == 1;
+    }
+
+    /**
+     * Push as many items as fit, from any thread.
+     * 
+     * Reserves a contiguous run of positions with a single CAS, so a batch is never
+     * interleaved with another producer's items.
+     * 
+     * @return the number of items pushed, from the front of items
+     */
+    size_t push_batch(std::span<const T> items)
+    {
+        if (items.empty()) return 0;
+
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t count;
+        do
+        {
+            // the consumer releases cells before publishing head, so every cell below head + Capacity is free
+            size_t head = m_head.load(std::memory_order_acquire);
+            size_t free = Capacity - (tail - head);
+            count = std::min(free, items.size());
+            if (count == 0) return 0;
+        } while (!m_tail.compare_exchange_weak(tail, tail + count, std::memory_order_relaxed));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Cell& cell = m_cells[(tail + i) & MASK];
+            cell.item = items[i];
+            cell.sequence.store(tail + i + 1, std::memory_order_release);
+        }
+
+        return count;
+    }
+
+    /**
+     * Pop the oldest item, consumer only.
+     * 
+     * @return false if the queue is empty, or the next item is reserved but not yet written
+     */
+    bool pop(T& item)
+    {
+        return pop_batch(std::span<T>(&item, 1)) == 1;
+    }
+
+    /**
+     * Pop up to out.size() items in order, consumer only.
+     * 
+     * Stops early at an item which a producer has reserved but not finished writing.
+     * 
+     * @return the number of items written to the front of out
+     */
+    size_t pop_batch(std::span<T> out)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+
+        size_t count = 0;
+        for (; count < out.size(); ++count)
+        {
+            Cell& cell = m_cells[(head + count) & MASK];
+            if (cell.sequence.load(std::memory_order_acquire) != head + count + 1) break;
+
+            out[count] = cell.item;
+            cell.sequence.store(head + count + Capacity, std::memory_order_release);
+        }
+
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Number of items reserved by producers and not yet popped, only exact when no thread is running.
+     */
+    size_t size_approx() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    bool empty_approx() const { return size_approx() == 0; }
+
+    static constexpr size_t get_capacity() { return Capacity; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<Cell, Capacity> m_cells;
+};
+
+
+}
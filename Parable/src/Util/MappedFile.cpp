@@ -0,0 +1,170 @@
+#include "MappedFile.h"
+
+#include "Core/Base.h"
+
+#include "Exception/IOExceptions.h"
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+namespace Parable::Util
+{
+
+
+/**
+ * Map a whole file read-only.
+ * 
+ * An empty file gives an empty view and no mapping.
+ * 
+ * @param path the file to map
+ * @param hint how the file will be read
+ * 
+ * @throws Parable::FileOpenException if the file cannot be opened or mapped
+ */
+MappedFile::MappedFile(const std::string& path, AccessHint hint) : m_path(path)
+{
+#if defined(PBL_PLATFORM_WINDOWS)
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (hint == AccessHint::Sequential || hint == AccessHint::WillNeed) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    else if (hint == AccessHint::Random) flags |= FILE_FLAG_RANDOM_ACCESS;
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        PBL_CORE_ERROR("Failed to open {} for mapping.", path);
+        throw FileOpenException("Failed to open file for mapping.");
+    }
+    m_file_handle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        unmap();
+        PBL_CORE_ERROR("Failed to get the size of {}.", path);
+        throw FileOpenException("Failed to get the size of a file for mapping.");
+    }
+    m_size = (size_t)size.QuadPart;
+
+    if (m_size == 0) return;
+
+    m_mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping_handle != nullptr) m_data = MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (m_data == nullptr)
+    {
+        unmap();
+        PBL_CORE_ERROR("Failed to map {}.", path);
+        throw FileOpenException("Failed to map file.");
+    }
+
+    if (hint == AccessHint::WillNeed)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range { const_cast<void*>(m_data), m_size };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        PBL_CORE_ERROR("Failed to open {} for mapping.", path);
+        throw FileOpenException("Failed to open file for mapping.");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        PBL_CORE_ERROR("Failed to get the size of {}.", path);
+        throw FileOpenException("Failed to get the size of a file for mapping.");
+    }
+    m_size = (size_t)st.st_size;
+
+    if (m_size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping holds its own reference to the file
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        m_size = 0;
+        PBL_CORE_ERROR("Failed to map {}.", path);
+        throw FileOpenException("Failed to map file.");
+    }
+    m_data = mapping;
+
+    int advice = MADV_NORMAL;
+    switch (hint)
+    {
+        case AccessHint::Normal: advice = MADV_NORMAL; break;
+        case AccessHint::Sequential: advice = MADV_SEQUENTIAL; break;
+        case AccessHint::WillNeed: advice = MADV_WILLNEED; break;
+        case AccessHint::Random: advice = MADV_RANDOM; break;
+    }
+    // a failed hint does not affect correctness
+    madvise(mapping, m_size, advice);
+    if (hint == AccessHint::WillNeed) madvise(mapping, m_size, MADV_SEQUENTIAL);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) :
+                            m_path(std::move(other.m_path)),
+                            m_data(std::exchange(other.m_data, nullptr)),
+                            m_size(std::exchange(other.m_size, 0))
+#if defined(PBL_PLATFORM_WINDOWS)
+                            ,
+                            m_file_handle(std::exchange(other.m_file_handle, nullptr)),
+                            m_mapping_handle(std::exchange(other.m_mapping_handle, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this == &other) return *this;
+
+    unmap();
+
+    m_path = std::move(other.m_path);
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+#if defined(PBL_PLATFORM_WINDOWS)
+    m_file_handle = std::exchange(other.m_file_handle, nullptr);
+    m_mapping_handle = std::exchange(other.m_mapping_handle, nullptr);
+#endif
+
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+void MappedFile::unmap()
+{
+#if defined(PBL_PLATFORM_WINDOWS)
+    if (m_data != nullptr) UnmapViewOfFile(m_data);
+    if (m_mapping_handle != nullptr) CloseHandle(m_mapping_handle);
+    if (m_file_handle != nullptr) CloseHandle(m_file_handle);
+    m_mapping_handle = nullptr;
+    m_file_handle = nullptr;
+#else
+    if (m_data != nullptr) munmap(const_cast<void*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "pblpch.h"
+
+#include <span>
+#include <string_view>
+
+namespace Parable::Util
+{
+
+
+/**
+ * How a MappedFile is expected to be read, passed to the OS as a paging hint.
+ * 
+ */
+enum class AccessHint
+{
+    /**
+     * No hint, default readahead.
+     */
+    Normal,
+    /**
+     * Read front to back once (MADV_SEQUENTIAL), aggressive readahead.
+     */
+    Sequential,
+    /**
+     * Read front to back, and start paging the whole file in now (MADV_WILLNEED).
+     */
+    WillNeed,
+    /**
+     * Scattered reads (MADV_RANDOM), readahead disabled.
+     */
+    Random
+};
+
+/**
+ * A read-only memory mapping of a whole file.
+ * 
+ * The contents are paged in from the page cache on access, so the file is never copied
+ * into a heap buffer. Views returned by data()/chars() are valid while the MappedFile lives.
+ * 
+ * The mapping is page aligned, so the data can be reinterpreted as any type with an
+ * alignment of at most the page size (e.g. SPIR-V words).
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const std::string& path, AccessHint hint = AccessHint::Sequential);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other);
+    ~MappedFile();
+
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& other);
+
+    std::span<const std::byte> data() const { return { (const std::byte*)m_data, m_size }; }
+    /**
+     * View the contents as text, e.g. for parsing json.
+     */
+    std::string_view chars() const { return { (const char*)m_data, m_size }; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const std::string& get_path() const { return m_path; }
+
+private:
+    void unmap();
+
+    std::string m_path;
+
+    const void* m_data = nullptr;
+    size_t m_size = 0;
+
+#if defined(PBL_PLATFORM_WINDOWS)
+    void* m_file_handle = nullptr;
+    void* m_mapping_handle = nullptr;
+#endif
+};
+
+
+}
@@ -1,30 +0,0 @@
-#pragma once
-
-#include "pblpch.h"
-#include <fstream>
-#include <format>
-
-namespace Parable::Util
-{
-
-
-static std::vector<char> read_file(const std::string& filename) {
-    std::ifstream file(filename, std::ios::ate | std::ios::binary);
-
-    if (!file.is_open()) {
-        throw std::runtime_error(std::format("Failed to open file {}", filename));
-    }
-
-    size_t fileSize = (size_t) file.tellg();
-    std::vector<char> buffer(fileSize);
-
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
-
-    file.close();
-
-    return buffer;
-}
-
-
-}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <span>
+#include <type_traits>
+
+#include "CacheLine.h"
+
+namespace Parable::Util
+{
+
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * 
+ * Items are stored inline in a ring, so pushing and popping never allocate. The producer
+ * and consumer indices sit on separate cache lines, and each side keeps a cached copy of
+ * the other's index so it only touches the shared line when the ring looks full/empty.
+ * 
+ * @tparam T trivially copyable item type
+ * @tparam Capacity maximum number of items held, a power of 2
+ */
+template<typename T, size_t Capacity>
+class SPSCQueue
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SPSCQueue items must be trivially copyable.");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of 2.");
+
+public:
+    SPSCQueue() = default;
+    SPSCQueue(const SPSCQueue&) = delete;
+
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /**
+     * Push an item, producer only.
+     * 
+     * @return false if the queue is full
+     */
+    bool push(const T& item)
+    {
+        return push_batch(std::span<const T>(&item, 1)) == 1;
+    }
+
+    /**
+     * Push as many items as fit, producer only.
+     * 
+     * The items become visible to the consumer together.
+     * 
+     * @return the number of items pushed, from the front of items
+     */
+    size_t push_batch(std::span<const T> items)
+    {
+        size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+
+        size_t free = Capacity - (tail - m_producer.cached_head);
+        if (free < items.size())
+        {
+            m_producer.cached_head = m_consumer.head.load(std::memory_order_acquire);
+            free = Capacity - (tail - m_producer.cached_head);
+        }
+
+        size_t count = std::min(free, items.size());
+        for (size_t i = 0; i < count; ++i) m_items[(tail + i) & MASK] = items[i];
+
+        m_producer.tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Pop the oldest item, consumer only.
+     * 
+     * @return false if the queue is empty
+     */
+    bool pop(T& item)
+    {
+        return pop_batch(std::span<T>(&item, 1)) == 1;
+    }
+
+    /**
+     * Pop up to out.size() items in order, consumer only.
+     * 
+     * @return the number of items written to the front of out
+     */
+    size_t pop_batch(std::span<T> out)
+    {
+        size_t head = m_consumer.head.load(std::memory_order_relaxed);
+
+        size_t available = m_consumer.cached_tail - head;
+        if (available < out.size())
+        {
+            m_consumer.cached_tail = m_producer.tail.load(std::memory_order_acquire);
+            available = m_consumer.cached_tail - head;
+        }
+
+        size_t count = std::min(available, out.size());
+        for (size_t i = 0; i < count; ++i) out[i] = m_items[(head + i) & MASK];
+
+        m_consumer.head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Number of items queued, only exact when neither side is running.
+     */
+    size_t size_approx() const
+    {
+        return m_producer.tail.load(std::memory_order_acquire) - m_consumer.head.load(std::memory_order_acquire);
+    }
+
+    bool empty_approx() const { return size_approx() == 0; }
+
+    static constexpr size_t get_capacity() { return Capacity; }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    struct alignas(CACHE_LINE_SIZE) Producer
+    {
+        std::atomic<size_t> tail = 0;
+        size_t cached_head = 0;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Consumer
+    {
+        std::atomic<size_t> head = 0;
+        size_t cached_tail = 0;
+    };
+
+    Producer m_producer;
+    Consumer m_consumer;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> m_items;
+};
+
+
+}
@@ -2,13 +2,15 @@
 
 #include <array>
 
+#include "BitOps.h"
+
 namespace Parable::Util
 {
 
 /** 
  *  Static size implementation of std::bitset.
  *
- *  Holds a set of boolean values in an array of 8 bit allocations.
+ *  Holds a set of boolean values in an array of 64 bit segments.
  * 
  *  Implements most of the functions from std::bitset, size set in template
  * 
@@ -19,9 +21,12 @@ namespace Parable::Util
 template<size_t size>
 class StaticBitset
 {
-    using Segment = unsigned int;
+    using Segment = BitOps::Word;
 
 public:
+    using SetBitRange = BitOps::BitRange<true>;
+    using UnsetBitRange = BitOps::BitRange<false>;
+
     StaticBitset();
     StaticBitset(const StaticBitset& other) = default;
     ~StaticBitset();
@@ -49,6 +54,9 @@ public:
     bool is_subset_of(const StaticBitset& other) const;
     bool is_superset_of(const StaticBitset& other) const;
 
+    bool and_any(const StaticBitset& other) const;
+    size_t and_count(const StaticBitset& other) const;
+
     // modifiers
 
     StaticBitset& operator&=(const StaticBitset& other);
@@ -65,20 +73,28 @@ public:
 
     // other
 
-    size_t find_first_set();
-    size_t find_first_unset();
+    size_t find_first_set() const;
+    size_t find_first_unset() const;
+
+    /**
+     * Iterate the positions of the set bits, without allocating.
+     */
+    SetBitRange set_bits() const { return SetBitRange(m_segments.data(), num_segments, BitOps::last_word_mask(size)); }
+    /**
+     * Iterate the positions of the unset bits, without allocating.
+     */
+    UnsetBitRange unset_bits() const { return UnsetBitRange(m_segments.data(), num_segments, BitOps::last_word_mask(size)); }
 
-    std::vector<size_t> get_set_bits();
-    std::vector<size_t> get_unset_bits();
+    std::vector<size_t> get_set_bits() const;
+    std::vector<size_t> get_unset_bits() const;
 
     // debug
 
     std::string to_string();
 
 private:
-    static const size_t segment_bitwidth = sizeof(Segment) * 8;
-    static const size_t last_segment_bits = size % segment_bitwidth;
-    static const size_t num_segments = size/segment_bitwidth + (last_segment_bits > 0 ? 1 : 0);
+    static const size_t segment_bitwidth = BitOps::WORD_BITS;
+    static const size_t num_segments = BitOps::words_for(size);
 
     std::array<Segment, num_segments> m_segments;
 };
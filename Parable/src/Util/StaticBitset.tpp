@@ -34,10 +34,7 @@ StaticBitset<size>::~StaticBitset()
 template<size_t size>
 bool StaticBitset<size>::operator[](size_t bit) const
 {
-    size_t segment = bit / segment_bitwidth;
-    size_t pos = bit - (segment * segment_bitwidth);
-
-    return m_segments[segment] & BIT(pos);
+    return m_segments[bit / segment_bitwidth] & BitOps::bit_mask(bit);
 }
 
 /**
@@ -66,23 +63,16 @@ bool StaticBitset<size>::at(size_t bit) const
 template<size_t size>
 bool StaticBitset<size>::all() const
 {
+    if constexpr (num_segments == 0) return true;
+
     for(size_t i = 0; i < num_segments-1; ++i)
     {
         if (~m_segments[i] != 0) return false;
     }
 
     // for last segment, check only the used bits
-    if (last_segment_bits > 0)
-    {
-        size_t mask = BITS(last_segment_bits);
-        if ((~m_segments[num_segments-1]) & mask != 0) return false;
-    }
-    else
-    {
-        if (~m_segments[num_segments-1] != 0) return false;
-    }
-
-    return true;
+    constexpr Segment mask = BitOps::last_word_mask(size);
+    return (m_segments[num_segments-1] & mask) == mask;
 }
 
 /**
@@ -91,12 +81,7 @@ bool StaticBitset<size>::all() const
 template<size_t size>
 bool StaticBitset<size>::any() const
 {
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        if (m_segments[i] != 0) return true;
-    }
-
-    return false;
+    return BitOps::any(m_segments.data(), num_segments);
 }
 
 /**
@@ -114,18 +99,7 @@ bool StaticBitset<size>::none() const
 template<size_t size>
 size_t StaticBitset<size>::count() const
 {
-    size_t count = 0;
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        // brian kernighans algorithm
-        Segment n = m_segments[i];
-        while (n)
-        {
-            n = n & (n - 1);    // clear the least significant bit set
-            ++count;
-        }
-    }
-    return count;
+    return BitOps::count(m_segments.data(), num_segments);
 }
 
 // comparison
@@ -136,11 +110,7 @@ size_t StaticBitset<size>::count() const
 template<size_t size>
 bool StaticBitset<size>::operator==(const StaticBitset<size>& rhs) const
 {
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        if (m_segments[i] != rhs.m_segments[i]) return false;
-    }
-    return true;
+    return BitOps::equal(m_segments.data(), rhs.m_segments.data(), num_segments);
 }
 
 /**
@@ -162,13 +132,7 @@ bool StaticBitset<size>::operator!=(const StaticBitset<size>& rhs) const
 template<size_t size>
 bool StaticBitset<size>::is_subset_of(const StaticBitset<size>& other) const
 {
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        Segment s = m_segments[i] & other.m_segments[i];
-        if (s != m_segments[i]) return false;
-    }
-
-    return true;
+    return BitOps::is_subset(m_segments.data(), other.m_segments.data(), num_segments);
 }
 
 /**
@@ -184,6 +148,32 @@ bool StaticBitset<size>::is_superset_of(const StaticBitset<size>& other) const
     return other.is_subset_of(*this);
 }
 
+/**
+ * Checks if this and another bitset have any set bits in common.
+ * 
+ * Equivalent to (this & other).any(), without modifying either bitset.
+ * 
+ * @param other the other bitset to compare with 
+ */
+template<size_t size>
+bool StaticBitset<size>::and_any(const StaticBitset<size>& other) const
+{
+    return BitOps::and_any(m_segments.data(), other.m_segments.data(), num_segments);
+}
+
+/**
+ * Counts the set bits this and another bitset have in common.
+ * 
+ * Equivalent to (this & other).count(), without modifying either bitset.
+ * 
+ * @param other the other bitset to compare with 
+ */
+template<size_t size>
+size_t StaticBitset<size>::and_count(const StaticBitset<size>& other) const
+{
+    return BitOps::and_count(m_segments.data(), other.m_segments.data(), num_segments);
+}
+
 
 // modifiers
 
@@ -195,10 +185,7 @@ bool StaticBitset<size>::is_superset_of(const StaticBitset<size>& other) const
 template<size_t size>
 StaticBitset<size>& StaticBitset<size>::operator&=(const StaticBitset<size>& other)
 {
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        m_segments[i] &= other.m_segments[i];
-    }
+    BitOps::and_assign(m_segments.data(), other.m_segments.data(), num_segments);
 
     return (*this);
 }
@@ -211,10 +198,7 @@ StaticBitset<size>& StaticBitset<size>::operator&=(const StaticBitset<size>& oth
 template<size_t size>
 StaticBitset<size>& StaticBitset<size>::operator|=(const StaticBitset<size>& other)
 {
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        m_segments[i] |= other.m_segments[i];
-    }
+    BitOps::or_assign(m_segments.data(), other.m_segments.data(), num_segments);
 
     return (*this);
 }
@@ -227,10 +211,7 @@ StaticBitset<size>& StaticBitset<size>::operator|=(const StaticBitset<size>& oth
 template<size_t size>
 StaticBitset<size>& StaticBitset<size>::operator^=(const StaticBitset<size>& other)
 {
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        m_segments[i] ^= other.m_segments[i];
-    }
+    BitOps::xor_assign(m_segments.data(), other.m_segments.data(), num_segments);
 
     return (*this);
 }
@@ -245,6 +226,9 @@ void StaticBitset<size>::flip_all()
     {
         m_segments[i] = ~m_segments[i];
     }
+
+    // keep the unused bits clear
+    if constexpr (num_segments > 0) m_segments[num_segments-1] &= BitOps::last_word_mask(size);
 }
 
 /**
@@ -264,10 +248,7 @@ void StaticBitset<size>::flip(size_t bit)
         throw OutOfRangeException(ss.str().c_str());
     }
 
-    size_t segment = bit / segment_bitwidth;
-    size_t pos = bit - (segment * segment_bitwidth);
-
-    m_segments[segment] ^= BIT(pos);
+    m_segments[bit / segment_bitwidth] ^= BitOps::bit_mask(bit);
 }
 
 /**
@@ -280,6 +261,9 @@ void StaticBitset<size>::set_all()
     {
         m_segments[i] = ~((Segment)0);
     }
+
+    // keep the unused bits clear
+    if constexpr (num_segments > 0) m_segments[num_segments-1] = BitOps::last_word_mask(size);
 }
 
 /**
@@ -299,10 +283,7 @@ void StaticBitset<size>::set(size_t bit)
         throw OutOfRangeException(ss.str().c_str());
     }
 
-    size_t segment = bit / segment_bitwidth;
-    size_t pos = bit - (segment * segment_bitwidth);
-
-    m_segments[segment] |= BIT(pos);
+    m_segments[bit / segment_bitwidth] |= BitOps::bit_mask(bit);
 }
 
 /**
@@ -334,10 +315,7 @@ void StaticBitset<size>::reset(size_t bit)
         throw OutOfRangeException(ss.str().c_str());
     }
 
-    size_t segment = bit / segment_bitwidth;
-    size_t pos = bit - (segment * segment_bitwidth);
-
-    m_segments[segment] &= ~BIT(pos);
+    m_segments[bit / segment_bitwidth] &= ~BitOps::bit_mask(bit);
 }
 
 /**
@@ -349,7 +327,7 @@ std::string StaticBitset<size>::to_string()
     std::ostringstream ss;
     for(size_t i = 0; i < size; ++i)
     {
-        ss << (*this)[i] ? 1 : 0;
+        ss << ((*this)[i] ? 1 : 0);
     }
     return ss.str();
 }
@@ -357,119 +335,54 @@ std::string StaticBitset<size>::to_string()
 
 /**
  * Finds the position of the first set bit in the bitset.
+ * 
+ * @throws Parable::OutOfRangeException if no bits are set
  */
 template<size_t size>
-size_t StaticBitset<size>::find_first_set()
+size_t StaticBitset<size>::find_first_set() const
 {
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        if (m_segments[i] != 0)
-        {
-            Segment s = (m_segments[i] & ~(m_segments[i]-1));
-            int pos = 0;
-            while (s >>= 1) ++pos;
-            return i * segment_bitwidth + pos;
-        }
-    }
+    SetBitRange bits = set_bits();
+    if (bits.begin() != bits.end()) return *bits.begin();
 
-    std::ostringstream ss;
-    ss << "No set bits in the bitset, cannot find first set bit";
-    throw OutOfRangeException(ss.str().c_str());
+    throw OutOfRangeException("No set bits in the bitset, cannot find first set bit");
 }
 
 /**
  * Finds the position of the first unset bit in the bitset.
+ * 
+ * @throws Parable::OutOfRangeException if all bits are set
  */
 template<size_t size>
-size_t StaticBitset<size>::find_first_unset()
+size_t StaticBitset<size>::find_first_unset() const
 {
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        if (m_segments[i] == 0) return i * segment_bitwidth;
-        Segment s = ~m_segments[i];
-        if (s != 0)
-        {
-            s = (s & ~(s-1));
-            int pos = 0;
-            while (s >>= 1) ++pos;
-            if (i == num_segments-1 && last_segment_bits > 0 && pos > last_segment_bits-1) break;
-            return i * segment_bitwidth + pos;
-        }
-    }
-    
-    std::ostringstream ss;
-    ss << "No unset bits in the bitset, cannot find first unset bit";
-    throw OutOfRangeException(ss.str().c_str());
+    UnsetBitRange bits = unset_bits();
+    if (bits.begin() != bits.end()) return *bits.begin();
+
+    throw OutOfRangeException("No unset bits in the bitset, cannot find first unset bit");
 }
 
 /**
  * Returns a list of the indices of the set bits.
+ * 
+ * Prefer iterating set_bits(), which does not allocate.
  */
 template<size_t size>
-std::vector<size_t> StaticBitset<size>::get_set_bits()
+std::vector<size_t> StaticBitset<size>::get_set_bits() const
 {
-    std::vector<size_t> out;
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        Segment s = m_segments[i];
-        size_t seg_offset = i * segment_bitwidth;
-        if (s != 0)
-        {
-            int pos = 0;
-            do
-            {
-                if (s & BIT(0)) out.push_back(pos + seg_offset);
-                ++pos;
-            } while(s >>= 1);
-        }
-    }
-
-    return std::move(out);
+    SetBitRange bits = set_bits();
+    return std::vector<size_t>(bits.begin(), bits.end());
 }
 
 /**
  * Returns a list of the indices of the unset bits.
+ * 
+ * Prefer iterating unset_bits(), which does not allocate.
  */
 template<size_t size>
-std::vector<size_t> StaticBitset<size>::get_unset_bits()
+std::vector<size_t> StaticBitset<size>::get_unset_bits() const
 {
-    std::vector<size_t> out;
-    for(size_t i = 0; i < num_segments; ++i)
-    {
-        Segment s = m_segments[i];
-        size_t seg_offset = i * segment_bitwidth;
-        if (s != 0)
-        {
-            int pos = 0;
-            do
-            {
-                if (!(s & BIT(0))) out.push_back(pos + seg_offset);
-                ++pos;
-            } while(s >>= 1);
-
-            if (i == num_segments-1 && last_segment_bits != 0)
-            {
-                if(pos < last_segment_bits-1)
-                {
-                    while(pos < last_segment_bits)
-                    {
-                        out.push_back(pos + seg_offset);
-                        ++pos;
-                    }
-                }
-            }
-            else if(pos != segment_bitwidth-1)
-            {
-                while(pos < segment_bitwidth)
-                {
-                    out.push_back(pos + seg_offset);
-                    ++pos;
-                }
-            }
-        }
-    }
-
-    return std::move(out);
+    UnsetBitRange bits = unset_bits();
+    return std::vector<size_t>(bits.begin(), bits.end());
 }
 
 
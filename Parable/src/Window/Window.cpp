@@ -50,8 +50,7 @@ Window::Window(int width, int height, std::string name, bool fullscreen)
     glfwSetWindowCloseCallback(m_glfw_window, [](GLFWwindow* window)
     {
         WindowData& window_data = *(WindowData*)glfwGetWindowUserPointer(window);
-        Event::EventUPtr event = std::make_unique<WindowCloseEvent>();
-        window_data.event_callback(std::move(event));
+        window_data.event_buffer->push<WindowCloseEvent>();
     });
 
     glfwSetWindowSizeCallback(m_glfw_window, [](GLFWwindow* window, int width, int height)
@@ -60,80 +59,74 @@ Window::Window(int width, int height, std::string name, bool fullscreen)
         window_data.width = width;
         window_data.height = height;
 
-        Event::EventUPtr event = std::make_unique<WindowResizeEvent>(width, height);
-        window_data.event_callback(std::move(event));
+        window_data.event_buffer->push<WindowResizeEvent>(width, height);
     });
 
     glfwSetKeyCallback(m_glfw_window, [](GLFWwindow* window, int key, int scancode, int action, int mods)
     {
         WindowData& window_data = *(WindowData*)glfwGetWindowUserPointer(window);
 
-        Event::EventUPtr event;
         switch(action)
         {
             case GLFW_PRESS:
-                event = std::make_unique<KeyPressedEvent>(key);
+                window_data.event_buffer->push<KeyPressedEvent>(key);
                 break;
             case GLFW_REPEAT:
-                event = std::make_unique<KeyRepeatedEvent>(key);
+                window_data.event_buffer->push<KeyRepeatedEvent>(key);
                 break;
             case GLFW_RELEASE:
-                event = std::make_unique<KeyReleasedEvent>(key);
+                window_data.event_buffer->push<KeyReleasedEvent>(key);
                 break;
         }
-        window_data.event_callback(std::move(event));
     });
 
+    // seed the last position with the current one, so the first move has a real delta rather than one from the origin
+    glfwGetCursorPos(m_glfw_window, &m_window_data.cursor_x, &m_window_data.cursor_y);
+
     glfwSetCursorPosCallback(m_glfw_window, [](GLFWwindow* window, double xpos, double ypos)
     {
         WindowData& window_data = *(WindowData*)glfwGetWindowUserPointer(window);
 
-        Event::EventUPtr event = std::make_unique<MouseMovedEvent>(xpos, ypos);
-        window_data.event_callback(std::move(event));
+        window_data.event_buffer->push<MouseMovedEvent>(xpos, ypos, xpos - window_data.cursor_x, ypos - window_data.cursor_y);
+        window_data.cursor_x = xpos;
+        window_data.cursor_y = ypos;
     });
 
     glfwSetCursorEnterCallback(m_glfw_window, [](GLFWwindow* window, int entered)
     {
         WindowData& window_data = *(WindowData*)glfwGetWindowUserPointer(window);
 
-        Event::EventUPtr event;
         if (entered)
         {
-            event = std::make_unique<MouseEnterEvent>();
+            window_data.event_buffer->push<MouseEnterEvent>();
         } 
         else 
         {
-            event = std::make_unique<MouseExitEvent>();
+            window_data.event_buffer->push<MouseExitEvent>();
         }
-
-        window_data.event_callback(std::move(event));
     });
 
     glfwSetMouseButtonCallback(m_glfw_window, [](GLFWwindow* window, int button, int action, int mods)
     {
         WindowData& window_data = *(WindowData*)glfwGetWindowUserPointer(window);
 
-        Event::EventUPtr event;
         if (action == GLFW_PRESS)
         {
             // add one to button as our input implementation uses the button codes offset by +1
-            event = std::make_unique<MouseBtnPressedEvent>(button+1);
+            window_data.event_buffer->push<MouseBtnPressedEvent>(button+1);
         } 
         else 
         {
             // add one to button as our input implementation uses the button codes offset by +1
-            event = std::make_unique<MouseBtnReleasedEvent>(button+1);
+            window_data.event_buffer->push<MouseBtnReleasedEvent>(button+1);
         }
-
-        window_data.event_callback(std::move(event));
     });
 
     glfwSetScrollCallback(m_glfw_window, [](GLFWwindow* window, double xoffset, double yoffset)
     {
         WindowData& window_data = *(WindowData*)glfwGetWindowUserPointer(window);
 
-        Event::EventUPtr event = std::make_unique<MouseScrolledEvent>(yoffset);
-        window_data.event_callback(std::move(event));
+        window_data.event_buffer->push<MouseScrolledEvent>(yoffset);
     });
 
     glfwSetWindowFocusCallback(m_glfw_window, [](GLFWwindow* window, int focused)
@@ -143,8 +136,7 @@ Window::Window(int width, int height, std::string name, bool fullscreen)
         WindowData& window_data = *(WindowData*)glfwGetWindowUserPointer(window);
         window_data.focused = f;
 
-        Event::EventUPtr event = std::make_unique<WindowFocusEvent>(f);
-        window_data.event_callback(std::move(event));
+        window_data.event_buffer->push<WindowFocusEvent>(f);
     });
 
     glfwSetWindowIconifyCallback(m_glfw_window, [](GLFWwindow* window, int iconified)
@@ -154,8 +146,7 @@ Window::Window(int width, int height, std::string name, bool fullscreen)
         WindowData& window_data = *(WindowData*)glfwGetWindowUserPointer(window);
         window_data.minimised = m;
         
-        Event::EventUPtr event = std::make_unique<WindowMinimiseEvent>(m);
-        window_data.event_callback(std::move(event));
+        window_data.event_buffer->push<WindowMinimiseEvent>(m);
     });
 
 }
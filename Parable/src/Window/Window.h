@@ -2,15 +2,13 @@
 
 #include "Core/Base.h"
 #include "Events/Event.h"
+#include "Events/EventBuffer.h"
 
 class GLFWwindow;
 
 namespace Parable
 {
 
-// may be more efficient as pure lambda, but this is easy
-using EventCallbackFn = std::function<void(Event::EventUPtr)>;
-
 /**
  * Holds data about a glfw window.
  * 
@@ -23,7 +21,15 @@ struct WindowData
     bool fullscreen;
     bool focused;
     bool minimised;
-    EventCallbackFn event_callback;
+    /**
+     * The last cursor position, to give mouse moves a delta. Seeded when the window is created.
+     */
+    double cursor_x = 0.0;
+    double cursor_y = 0.0;
+    /**
+     * The buffer window events are constructed into, set by the application.
+     */
+    EventBuffer* event_buffer = nullptr;
 };
 
 /**
@@ -44,7 +50,7 @@ public:
 
     void on_update();
 
-    void set_app_event_callback(EventCallbackFn callback) { m_window_data.event_callback = std::move(callback); }
+    void set_event_buffer(EventBuffer& buffer) { m_window_data.event_buffer = &buffer; }
 
     static void glfw_error_callback(int error, const char* description);
 };
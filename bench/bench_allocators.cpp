@@ -0,0 +1,481 @@
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <memory>
+
+#if defined(__linux__)
+    #include <malloc.h>
+#endif
+
+#include "bench_common.h"
+
+#include <Core/Log.h>
+#include <Memory/VirtualArena.h>
+#include <Memory/LinearAllocator.h>
+#include <Memory/PoolAllocator.h>
+#include <Memory/SlabAllocator.h>
+
+//
+//  Compares the engine allocators against the system malloc over a few allocation traces.
+//
+//  Each trace runs twice per allocator: once untimed per operation to measure throughput,
+//  and once timing every allocation to measure the latency distribution.
+//
+//  Built once per available malloc implementation (glibc, jemalloc, mimalloc), the name
+//  of which is passed in as BENCH_MALLOC_NAME.
+//
+
+#ifndef BENCH_MALLOC_NAME
+    #define BENCH_MALLOC_NAME "malloc"
+#endif
+
+
+// all traces stay within SlabAllocator::MAX_SIZE so every allocator can serve them
+static constexpr size_t MAX_ALLOC_SIZE = 256;
+
+static constexpr size_t ENGINE_HEAP_SIZE = (size_t)64 << 20;
+
+/**
+ * Pick an allocation size, weighted towards small sizes as seen in the engine.
+ */
+static size_t pick_size(Bench::Rng& rng)
+{
+    uint64_t r = rng.range(0, 99);
+    if (r < 60) return rng.range(8, 64);
+    if (r < 90) return rng.range(65, 128);
+    return rng.range(129, MAX_ALLOC_SIZE);
+}
+
+
+// ALLOCATOR ADAPTERS
+// uniform interface over each allocator for the traces
+
+struct MallocAdapter
+{
+    static constexpr bool can_free = true;
+    static constexpr bool thread_safe = true;
+
+    const char* name() const { return BENCH_MALLOC_NAME; }
+
+    void* allocate(size_t size) { return malloc(size); }
+    void deallocate(void* p, size_t) { free(p); }
+    void free_all(std::vector<void*>& ptrs) { for (void* p : ptrs) free(p); }
+
+    /**
+     * Bytes actually reserved for an allocation, used for internal fragmentation.
+     */
+    size_t usable_size(void* p, size_t size)
+    {
+#if defined(__linux__)
+        return malloc_usable_size(p);
+#else
+        return size;
+#endif
+    }
+};
+
+struct LinearAdapter
+{
+    static constexpr bool can_free = false;
+    static constexpr bool thread_safe = false;
+
+    LinearAdapter(Parable::VirtualArena& arena) : alloc(ENGINE_HEAP_SIZE, arena.commit_block(ENGINE_HEAP_SIZE)) {}
+    ~LinearAdapter() { alloc.clear(); }
+
+    const char* name() const { return "LinearAllocator"; }
+
+    void* allocate(size_t size) { return alloc.allocate(size, 8); }
+    void deallocate(void*, size_t) {}
+    void free_all(std::vector<void*>&) { alloc.clear(); }
+    size_t usable_size(void*, size_t size) { return size; }
+
+    Parable::LinearAllocator alloc;
+};
+
+struct PoolAdapter
+{
+    static constexpr bool can_free = true;
+    static constexpr bool thread_safe = false;
+
+    // one pool serves every size, so each object takes the largest slot
+    PoolAdapter(Parable::VirtualArena& arena) : alloc(MAX_ALLOC_SIZE, 8, ENGINE_HEAP_SIZE, arena.commit_block(ENGINE_HEAP_SIZE)) {}
+
+    const char* name() const { return "PoolAllocator"; }
+
+    void* allocate(size_t) { return alloc.allocate(MAX_ALLOC_SIZE, 8); }
+    void deallocate(void* p, size_t) { alloc.deallocate(p); }
+    void free_all(std::vector<void*>& ptrs) { for (void* p : ptrs) alloc.deallocate(p); }
+    size_t usable_size(void*, size_t) { return MAX_ALLOC_SIZE; }
+
+    Parable::PoolAllocator alloc;
+};
+
+struct SlabAdapter
+{
+    static constexpr bool can_free = true;
+    static constexpr bool thread_safe = false;
+
+    SlabAdapter(Parable::VirtualArena& arena) : alloc(ENGINE_HEAP_SIZE, arena.commit_block(ENGINE_HEAP_SIZE, Parable::SlabAllocator::SLAB_SIZE)) {}
+
+    const char* name() const { return "SlabAllocator"; }
+
+    void* allocate(size_t size) { return alloc.allocate(size, 8); }
+    void deallocate(void* p, size_t) { alloc.deallocate(p); }
+    void free_all(std::vector<void*>& ptrs) { alloc.deallocate_batch(ptrs.data(), ptrs.size()); }
+    size_t usable_size(void*, size_t size) { return Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(size, 8)); }
+
+    Parable::SlabAllocator alloc;
+};
+
+/**
+ * Wraps a single-threaded adapter in a mutex so it can be shared between threads.
+ *
+ */
+template<class A>
+struct LockedAdapter
+{
+    static constexpr bool can_free = A::can_free;
+    static constexpr bool thread_safe = true;
+
+    LockedAdapter(Parable::VirtualArena& arena) : inner(arena), label(std::string(inner.name()) + "+mutex") {}
+
+    const char* name() const { return label.c_str(); }
+
+    void* allocate(size_t size) { std::lock_guard lock(mutex); return inner.allocate(size); }
+    void deallocate(void* p, size_t size) { std::lock_guard lock(mutex); inner.deallocate(p, size); }
+
+    A inner;
+    std::string label;
+    std::mutex mutex;
+};
+
+
+// RESULTS
+
+struct TraceResult
+{
+    const char* trace;
+    std::string allocator;
+    bool supported = true;
+
+    double ops_per_sec = 0.0;
+    Bench::LatencyRecorder latency;
+
+    /**
+     * Bytes reserved by the allocator over bytes requested, for the live set at the end of the trace.
+     * Negative when the trace does not measure it.
+     */
+    double overhead = -1.0;
+    /**
+     * Growth of the resident set over the trace.
+     */
+    size_t rss_growth = 0;
+};
+
+static void print_header()
+{
+    std::printf("%-18s %-22s %14s %9s %9s %9s %9s %10s\n",
+                "trace", "allocator", "ops/s", "p50 ns", "p99 ns", "p999 ns", "max ns", "overhead");
+}
+
+static void print_result(TraceResult& r)
+{
+    if (!r.supported)
+    {
+        std::printf("%-18s %-22s %14s\n", r.trace, r.allocator.c_str(), "n/a");
+        return;
+    }
+
+    std::printf("%-18s %-22s %14.0f %9llu %9llu %9llu %9llu",
+                r.trace, r.allocator.c_str(), r.ops_per_sec,
+                (unsigned long long)r.latency.percentile(0.5),
+                (unsigned long long)r.latency.percentile(0.99),
+                (unsigned long long)r.latency.percentile(0.999),
+                (unsigned long long)r.latency.percentile(1.0));
+    if (r.overhead >= 0.0) std::printf(" %9.1f%%", r.overhead * 100.0);
+    else std::printf(" %10s", "-");
+    if (r.rss_growth > 0) std::printf("  rss +%zu KiB", r.rss_growth / 1024);
+    std::printf("\n");
+}
+
+
+// TRACES
+
+/**
+ * Frame churn: many short-lived allocations which are all freed at the end of each frame.
+ *
+ */
+template<class A>
+static TraceResult frame_churn(A& a)
+{
+    static constexpr size_t FRAMES = 500;
+    static constexpr size_t ALLOCS_PER_FRAME = 4000;
+
+    TraceResult result{ "frame-churn", a.name() };
+    std::vector<void*> frame;
+    frame.reserve(ALLOCS_PER_FRAME);
+
+    // throughput pass
+    Bench::Rng rng(1);
+    auto start = Bench::Clock::now();
+    for (size_t f = 0; f < FRAMES; ++f)
+    {
+        for (size_t i = 0; i < ALLOCS_PER_FRAME; ++i)
+        {
+            void* p = a.allocate(pick_size(rng));
+            Bench::do_not_optimise(p);
+            frame.push_back(p);
+        }
+        a.free_all(frame);
+        frame.clear();
+    }
+    result.ops_per_sec = (double)(FRAMES * ALLOCS_PER_FRAME) / (Bench::elapsed_ns(start, Bench::Clock::now()) * 1e-9);
+
+    // latency pass
+    rng = Bench::Rng(1);
+    result.latency.reserve(FRAMES * ALLOCS_PER_FRAME);
+    for (size_t f = 0; f < FRAMES; ++f)
+    {
+        for (size_t i = 0; i < ALLOCS_PER_FRAME; ++i)
+        {
+            size_t size = pick_size(rng);
+            auto t0 = Bench::Clock::now();
+            void* p = a.allocate(size);
+            auto t1 = Bench::Clock::now();
+            result.latency.add(Bench::elapsed_ns(t0, t1));
+            frame.push_back(p);
+        }
+        a.free_all(frame);
+        frame.clear();
+    }
+
+    return result;
+}
+
+/**
+ * Long-lived mixed sizes: a large live set where random objects are replaced,
+ * which is what fragments general purpose heaps.
+ *
+ */
+template<class A>
+static TraceResult long_lived(A& a)
+{
+    static constexpr size_t LIVE_OBJECTS = 50000;
+    static constexpr size_t REPLACEMENTS = 2000000;
+
+    TraceResult result{ "long-lived-mixed", a.name() };
+    if constexpr (!A::can_free)
+    {
+        result.supported = false;
+        return result;
+    }
+    else
+    {
+        struct Live { void* p; size_t size; };
+        std::vector<Live> live(LIVE_OBJECTS);
+
+        size_t rss_start = Bench::resident_bytes();
+
+        Bench::Rng rng(2);
+        for (Live& l : live)
+        {
+            l.size = pick_size(rng);
+            l.p = a.allocate(l.size);
+        }
+
+        // throughput pass, each replacement is one free and one allocation
+        auto start = Bench::Clock::now();
+        for (size_t i = 0; i < REPLACEMENTS; ++i)
+        {
+            Live& l = live[rng.range(0, LIVE_OBJECTS - 1)];
+            a.deallocate(l.p, l.size);
+            l.size = pick_size(rng);
+            l.p = a.allocate(l.size);
+            Bench::do_not_optimise(l.p);
+        }
+        result.ops_per_sec = (double)(REPLACEMENTS * 2) / (Bench::elapsed_ns(start, Bench::Clock::now()) * 1e-9);
+
+        // latency pass
+        result.latency.reserve(REPLACEMENTS);
+        for (size_t i = 0; i < REPLACEMENTS; ++i)
+        {
+            Live& l = live[rng.range(0, LIVE_OBJECTS - 1)];
+            a.deallocate(l.p, l.size);
+            l.size = pick_size(rng);
+            auto t0 = Bench::Clock::now();
+            l.p = a.allocate(l.size);
+            auto t1 = Bench::Clock::now();
+            result.latency.add(Bench::elapsed_ns(t0, t1));
+        }
+
+        size_t requested = 0;
+        size_t reserved = 0;
+        for (Live& l : live)
+        {
+            requested += l.size;
+            reserved += a.usable_size(l.p, l.size);
+        }
+        result.overhead = (double)(reserved - requested) / (double)requested;
+
+        size_t rss_end = Bench::resident_bytes();
+        result.rss_growth = rss_end > rss_start ? rss_end - rss_start : 0;
+
+        for (Live& l : live) a.deallocate(l.p, l.size);
+
+        return result;
+    }
+}
+
+/**
+ * Single-producer/single-consumer ring of pointers, for handing allocations between threads.
+ *
+ */
+class PointerRing
+{
+public:
+    static constexpr size_t CAPACITY = 1024;
+
+    bool push(void* p)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == CAPACITY) return false;
+        m_slots[head % CAPACITY] = p;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(void*& p)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+        p = m_slots[tail % CAPACITY];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<void*, CAPACITY> m_slots;
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+/**
+ * Producer/consumer: pairs of threads where one allocates and the other frees,
+ * as in job results or events handed across threads.
+ *
+ */
+template<class A>
+static TraceResult producer_consumer(A& a)
+{
+    static constexpr size_t ALLOCS_PER_PRODUCER = 500000;
+
+    TraceResult result{ "producer-consumer", a.name() };
+    if constexpr (!A::thread_safe || !A::can_free)
+    {
+        result.supported = false;
+        return result;
+    }
+    else
+    {
+        size_t pairs = std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 1, 4);
+
+        std::vector<std::unique_ptr<PointerRing>> rings;
+        std::vector<Bench::LatencyRecorder> latencies(pairs);
+        for (size_t i = 0; i < pairs; ++i) rings.push_back(std::make_unique<PointerRing>());
+
+        std::vector<std::thread> threads;
+        auto start = Bench::Clock::now();
+        for (size_t i = 0; i < pairs; ++i)
+        {
+            threads.emplace_back([&a, &ring = *rings[i], &latency = latencies[i], i]() {
+                Bench::Rng rng(3 + i);
+                latency.reserve(ALLOCS_PER_PRODUCER);
+                for (size_t n = 0; n < ALLOCS_PER_PRODUCER; ++n)
+                {
+                    size_t size = pick_size(rng);
+                    auto t0 = Bench::Clock::now();
+                    void* p = a.allocate(size);
+                    auto t1 = Bench::Clock::now();
+                    latency.add(Bench::elapsed_ns(t0, t1));
+
+                    // stash the size in the allocation so the consumer can free it
+                    *(size_t*)p = size;
+                    while (!ring.push(p)) std::this_thread::yield();
+                }
+            });
+            threads.emplace_back([&a, &ring = *rings[i]]() {
+                for (size_t n = 0; n < ALLOCS_PER_PRODUCER; ++n)
+                {
+                    void* p;
+                    while (!ring.pop(p)) std::this_thread::yield();
+                    a.deallocate(p, *(size_t*)p);
+                }
+            });
+        }
+        for (std::thread& t : threads) t.join();
+
+        result.ops_per_sec = (double)(pairs * ALLOCS_PER_PRODUCER * 2) / (Bench::elapsed_ns(start, Bench::Clock::now()) * 1e-9);
+        for (Bench::LatencyRecorder& l : latencies) result.latency.merge(l);
+
+        return result;
+    }
+}
+
+template<class A>
+static void run_all(A& a)
+{
+    TraceResult churn = frame_churn(a);
+    print_result(churn);
+    TraceResult lived = long_lived(a);
+    print_result(lived);
+}
+
+int main(int argc, char** argv)
+{
+    Parable::Log::init();
+
+    Parable::VirtualArena arena((size_t)1 << 30, Parable::HugePageMode::Transparent);
+
+    std::printf("Allocator benchmark, system allocator: %s\n\n", BENCH_MALLOC_NAME);
+    print_header();
+
+    {
+        MallocAdapter a;
+        run_all(a);
+    }
+    {
+        LinearAdapter a(arena);
+        run_all(a);
+    }
+    {
+        PoolAdapter a(arena);
+        run_all(a);
+    }
+    {
+        SlabAdapter a(arena);
+        run_all(a);
+    }
+
+    std::printf("\n");
+    print_header();
+    {
+        MallocAdapter a;
+        TraceResult r = producer_consumer(a);
+        print_result(r);
+    }
+    {
+        LockedAdapter<PoolAdapter> a(arena);
+        TraceResult r = producer_consumer(a);
+        print_result(r);
+    }
+    {
+        LockedAdapter<SlabAdapter> a(arena);
+        TraceResult r = producer_consumer(a);
+        print_result(r);
+    }
+
+    return 0;
+}
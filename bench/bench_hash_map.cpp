@@ -0,0 +1,227 @@
+#include <map>
+#include <unordered_map>
+#include <array>
+#include <string>
+
+#include "bench_common.h"
+
+#include <Util/FlatHashMap.h>
+
+//
+//  Compares FlatHashMap against std::map and std::unordered_map on the lookups the engine
+//  does: integer descriptors (AssetRegistry, ResourceStore), string keys, and vertex
+//  deduplication while loading meshes (a 32 byte key with many repeats).
+//
+//  Reports the mean time per operation of each phase.
+//
+
+
+static constexpr size_t NUM_KEYS = 1 << 18;
+static constexpr size_t NUM_LOOKUPS = 1 << 21;
+
+/**
+ * Stand in for Vulkan::Vertex, which needs glm.
+ */
+struct BenchVertex
+{
+    std::array<float, 8> components;
+
+    bool operator==(const BenchVertex& other) const { return components == other.components; }
+};
+
+struct BenchVertexHash
+{
+    size_t operator()(const BenchVertex& v) const { return (size_t)Parable::Util::hash_bytes(v.components.data(), sizeof(v.components)); }
+};
+
+/**
+ * The old vertex hash, combining per-component std::hash with xor and shifts.
+ */
+struct XorShiftVertexHash
+{
+    size_t operator()(const BenchVertex& v) const
+    {
+        size_t h = 0;
+        for (float c : v.components) h = (h ^ (std::hash<float>()(c) << 1)) >> 1;
+        return h;
+    }
+};
+
+template<> struct std::hash<BenchVertex> : XorShiftVertexHash {};
+
+
+// CONTAINER ADAPTERS
+
+template<class Map>
+struct StdAdapter
+{
+    Map map;
+
+    template<class K, class V>
+    bool insert(const K& key, V value) { return map.try_emplace(key, value).second; }
+
+    template<class K>
+    bool contains(const K& key) const { return map.find(key) != map.end(); }
+
+    template<class K, class V>
+    V find_or_insert(const K& key, V value) { return map.try_emplace(key, value).first->second; }
+};
+
+template<class Map>
+struct FlatAdapter
+{
+    Map map;
+
+    template<class K, class V>
+    bool insert(const K& key, V value) { return map.try_emplace(key, value).second; }
+
+    template<class K>
+    bool contains(const K& key) const { return map.contains(key); }
+
+    template<class K, class V>
+    V find_or_insert(const K& key, V value) { return map.try_emplace(key, value).first->second; }
+};
+
+
+// TRACES
+
+struct PhaseTimes
+{
+    double insert_ns = 0;
+    double hit_ns = 0;
+    double miss_ns = 0;
+};
+
+static void print_header(const char* title)
+{
+    std::printf("\n%s\n", title);
+    std::printf("%-28s %12s %12s %12s\n", "container", "insert ns", "hit ns", "miss ns");
+}
+
+static void print_result(const char* name, const PhaseTimes& t)
+{
+    std::printf("%-28s %12.1f %12.1f %12.1f\n", name, t.insert_ns, t.hit_ns, t.miss_ns);
+}
+
+/**
+ * Insert keys, then look up random present keys and random absent keys.
+ */
+template<class Adapter, class Key>
+static PhaseTimes run_lookups(const std::vector<Key>& keys, const std::vector<Key>& absent)
+{
+    Adapter a;
+    PhaseTimes t;
+    Bench::Rng rng(42);
+
+    auto start = Bench::Clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) a.insert(keys[i], (uint32_t)i);
+    t.insert_ns = (double)Bench::elapsed_ns(start, Bench::Clock::now()) / (double)keys.size();
+
+    size_t found = 0;
+    start = Bench::Clock::now();
+    for (size_t i = 0; i < NUM_LOOKUPS; ++i) found += a.contains(keys[rng.next() % keys.size()]);
+    t.hit_ns = (double)Bench::elapsed_ns(start, Bench::Clock::now()) / (double)NUM_LOOKUPS;
+
+    start = Bench::Clock::now();
+    for (size_t i = 0; i < NUM_LOOKUPS; ++i) found += a.contains(absent[rng.next() % absent.size()]);
+    t.miss_ns = (double)Bench::elapsed_ns(start, Bench::Clock::now()) / (double)NUM_LOOKUPS;
+
+    Bench::do_not_optimise(found);
+    return t;
+}
+
+/**
+ * Deduplicate a stream of vertices where most repeat, as MeshData::from_obj does.
+ */
+template<class Adapter>
+static double run_dedup(const std::vector<BenchVertex>& stream)
+{
+    Adapter a;
+    uint32_t next = 0;
+    uint64_t checksum = 0;
+
+    auto start = Bench::Clock::now();
+    for (const BenchVertex& v : stream)
+    {
+        uint32_t index = a.find_or_insert(v, next);
+        if (index == next) ++next;
+        checksum += index;
+    }
+    double ns = (double)Bench::elapsed_ns(start, Bench::Clock::now()) / (double)stream.size();
+
+    Bench::do_not_optimise(checksum);
+    return ns;
+}
+
+int main(int argc, char** argv)
+{
+    Bench::Rng rng(7);
+
+    std::printf("Hash map benchmark, %zu keys, %zu lookups per phase\n", NUM_KEYS, NUM_LOOKUPS);
+
+    // asset descriptors: 64 bit ids
+    {
+        std::vector<uint64_t> keys(NUM_KEYS), absent(NUM_KEYS);
+        for (size_t i = 0; i < NUM_KEYS; ++i)
+        {
+            keys[i] = rng.next() | 1;
+            absent[i] = rng.next() & ~(uint64_t)1;
+        }
+
+        print_header("uint64_t keys");
+        print_result("std::map", run_lookups<StdAdapter<std::map<uint64_t, uint32_t>>>(keys, absent));
+        print_result("std::unordered_map", run_lookups<StdAdapter<std::unordered_map<uint64_t, uint32_t>>>(keys, absent));
+        print_result("Util::FlatHashMap", run_lookups<FlatAdapter<Parable::Util::FlatHashMap<uint64_t, uint32_t>>>(keys, absent));
+    }
+
+    // sequential descriptors, as assigned by the json registry
+    {
+        std::vector<uint64_t> keys(NUM_KEYS), absent(NUM_KEYS);
+        for (size_t i = 0; i < NUM_KEYS; ++i)
+        {
+            keys[i] = i;
+            absent[i] = NUM_KEYS + i;
+        }
+
+        print_header("sequential uint64_t keys");
+        print_result("std::map", run_lookups<StdAdapter<std::map<uint64_t, uint32_t>>>(keys, absent));
+        print_result("std::unordered_map", run_lookups<StdAdapter<std::unordered_map<uint64_t, uint32_t>>>(keys, absent));
+        print_result("Util::FlatHashMap", run_lookups<FlatAdapter<Parable::Util::FlatHashMap<uint64_t, uint32_t>>>(keys, absent));
+    }
+
+    // asset paths
+    {
+        std::vector<std::string> keys(NUM_KEYS / 4), absent(NUM_KEYS / 4);
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            keys[i] = "assets/meshes/props/mesh_" + std::to_string(rng.next()) + ".obj";
+            absent[i] = "assets/textures/props/tex_" + std::to_string(rng.next()) + ".png";
+        }
+
+        print_header("std::string keys");
+        print_result("std::map", run_lookups<StdAdapter<std::map<std::string, uint32_t, std::less<>>>>(keys, absent));
+        print_result("std::unordered_map", run_lookups<StdAdapter<std::unordered_map<std::string, uint32_t>>>(keys, absent));
+        print_result("Util::FlatHashMap", run_lookups<FlatAdapter<Parable::Util::FlatHashMap<std::string, uint32_t>>>(keys, absent));
+    }
+
+    // vertex deduplication, each unique vertex is referenced ~6 times as in a closed triangle mesh
+    {
+        std::vector<BenchVertex> unique(NUM_KEYS / 2);
+        for (BenchVertex& v : unique)
+        {
+            // grid positions and shared tex coords, like real meshes, so the components are far from random
+            for (size_t c = 0; c < 8; ++c) v.components[c] = (float)rng.range(0, 255) * 0.25f;
+        }
+
+        std::vector<BenchVertex> stream(unique.size() * 6);
+        for (BenchVertex& v : stream) v = unique[rng.next() % unique.size()];
+
+        std::printf("\nvertex dedup\n%-28s %12s\n", "container", "ns/vertex");
+        std::printf("%-28s %12.1f\n", "std::unordered_map (xor)", run_dedup<StdAdapter<std::unordered_map<BenchVertex, uint32_t>>>(stream));
+        std::printf("%-28s %12.1f\n", "std::unordered_map", run_dedup<StdAdapter<std::unordered_map<BenchVertex, uint32_t, BenchVertexHash>>>(stream));
+        std::printf("%-28s %12.1f\n", "Util::FlatHashMap", run_dedup<FlatAdapter<Parable::Util::FlatHashMap<BenchVertex, uint32_t, BenchVertexHash>>>(stream));
+    }
+
+    std::printf("\n");
+    return 0;
+}
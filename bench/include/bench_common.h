@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+
+#if defined(__linux__)
+    #include <unistd.h>
+#endif
+
+//
+//  Shared timing and reporting helpers for the benchmark executables.
+//
+
+
+namespace Bench
+{
+
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Elapsed nanoseconds between two clock samples.
+ */
+inline uint64_t elapsed_ns(Clock::time_point start, Clock::time_point end)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * Collects per-operation latencies and reports percentiles.
+ *
+ */
+class LatencyRecorder
+{
+public:
+    void reserve(size_t n) { m_samples.reserve(n); }
+    void add(uint64_t ns) { m_samples.push_back(ns); }
+    void merge(const LatencyRecorder& other) { m_samples.insert(m_samples.end(), other.m_samples.begin(), other.m_samples.end()); }
+
+    size_t count() const { return m_samples.size(); }
+
+    /**
+     * Get a percentile, sorting the samples on first use.
+     *
+     * @param p the percentile in [0, 1]
+     * @return uint64_t the latency in nanoseconds
+     */
+    uint64_t percentile(double p)
+    {
+        if (m_samples.empty()) return 0;
+        if (!m_sorted)
+        {
+            std::sort(m_samples.begin(), m_samples.end());
+            m_sorted = true;
+        }
+        size_t i = std::min(m_samples.size() - 1, (size_t)(p * (double)m_samples.size()));
+        return m_samples[i];
+    }
+
+private:
+    std::vector<uint64_t> m_samples;
+    bool m_sorted = false;
+};
+
+/**
+ * Resident set size of the process in bytes, or 0 if unavailable.
+ */
+inline size_t resident_bytes()
+{
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    size_t pages_total = 0, pages_resident = 0;
+    if (statm >> pages_total >> pages_resident) return pages_resident * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    return 0;
+}
+
+/**
+ * Small, fast, deterministic PRNG so traces are identical for every allocator.
+ *
+ */
+class Rng
+{
+public:
+    Rng(uint64_t seed) : m_state(seed ? seed : 1) {}
+
+    uint64_t next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return m_state;
+    }
+
+    uint64_t range(uint64_t lo, uint64_t hi) { return lo + next() % (hi - lo + 1); }
+
+private:
+    uint64_t m_state;
+};
+
+/**
+ * Prevent the compiler from optimising away a value.
+ */
+template<class T>
+inline void do_not_optimise(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+
+}
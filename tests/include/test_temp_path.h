@@ -0,0 +1,12 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+/**
+ * Get the path of a file in the system temp directory, for tests which write files.
+ */
+inline std::string temp_path(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
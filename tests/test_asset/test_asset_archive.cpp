@@ -0,0 +1,327 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "test_temp_path.h"
+
+// engine includes
+#include <Asset/AssetArchive.h>
+#include <Asset/CookedMesh.h>
+#include <Exception/IOExceptions.h>
+#include <IO/IOService.h>
+#include <Jobs/JobSystem.h>
+
+
+using namespace Parable;
+
+static std::vector<std::byte> make_data(size_t size, uint8_t seed)
+{
+    std::vector<std::byte> data(size);
+    for (size_t i = 0; i < size; ++i) data[i] = (std::byte)(seed + i);
+    return data;
+}
+
+TEST(TestAssetArchive, WriteAndFind)
+{
+    std::string path = temp_path("pbl_test_archive.pblpak");
+    std::string loose_path = temp_path("pbl_test_archive_loose.bin");
+
+    {
+        std::vector<std::byte> loose = make_data(5000, 7);
+        std::ofstream file(loose_path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(loose.data()), (std::streamsize)loose.size());
+    }
+
+    AssetArchiveWriter writer;
+    for (uint64_t key = 0; key < 100; ++key)
+    {
+        writer.add(key * 3, make_data(key * 37, (uint8_t)key));
+    }
+    writer.add(1000, loose_path);
+    writer.write(path);
+
+    {
+        AssetArchive archive(path);
+        EXPECT_EQ(archive.get_entry_count(), 101);
+
+        for (uint64_t key = 0; key < 100; ++key)
+        {
+            const ArchiveFormat::TocEntry* entry = archive.find(key * 3);
+            ASSERT_NE(entry, nullptr);
+            EXPECT_EQ(entry->offset % ArchiveFormat::ENTRY_ALIGNMENT, 0);
+            EXPECT_TRUE(archive.verify(*entry));
+
+            std::span<const std::byte> data = archive.get_data(*entry);
+            std::vector<std::byte> expected = make_data(key * 37, (uint8_t)key);
+            EXPECT_TRUE(std::ranges::equal(data, expected));
+        }
+
+        // keys which were never added are not found
+        EXPECT_EQ(archive.find(1), nullptr);
+        EXPECT_EQ(archive.find(299), nullptr);
+
+        const ArchiveFormat::TocEntry* loose = archive.find(1000);
+        ASSERT_NE(loose, nullptr);
+        EXPECT_EQ(loose->size, 5000);
+        EXPECT_EQ(archive.get_data(*loose)[4999], (std::byte)(uint8_t)(7 + 4999));
+    }
+
+    std::remove(path.c_str());
+    std::remove(loose_path.c_str());
+}
+
+TEST(TestAssetArchive, CookedMeshInPlace)
+{
+    std::string mesh_path = temp_path("pbl_test_archive_mesh.pblmesh");
+    std::string path = temp_path("pbl_test_archive_mesh.pblpak");
+
+    std::vector<float> positions { 0, 0, 0, 1, 0, 0, 0, 1, 0 };
+    std::vector<uint32_t> indices { 0, 1, 2 };
+
+    CookedMeshData data;
+    data.vertex_stride = 3 * sizeof(float);
+    data.attributes = { { MeshFormat::VertexSemantic::Position, MeshFormat::AttributeFormat::Float3, 0 } };
+    data.vertices = std::as_bytes(std::span(positions));
+    data.indices = indices;
+    CookedMesh::write(mesh_path, data);
+
+    AssetArchiveWriter writer;
+    writer.add(42, mesh_path);
+    writer.write(path);
+
+    {
+        AssetArchive archive(path);
+        const ArchiveFormat::TocEntry* entry = archive.find(42);
+        ASSERT_NE(entry, nullptr);
+
+        // entries are page aligned, so the mesh blobs keep their alignment in place
+        CookedMesh mesh(archive.get_data(*entry), "packed mesh");
+        EXPECT_EQ(mesh.get_vertex_count(), 3);
+        EXPECT_EQ(mesh.get_index_count(), 3);
+        EXPECT_EQ((uintptr_t)mesh.get_vertex_data().data() % MeshFormat::BLOB_ALIGNMENT, 0);
+    }
+
+    std::remove(path.c_str());
+    std::remove(mesh_path.c_str());
+}
+
+TEST(TestAssetArchive, DetectsCorruption)
+{
+    std::string path = temp_path("pbl_test_archive_corrupt.pblpak");
+
+    AssetArchiveWriter writer;
+    writer.add(5, make_data(100, 0));
+    writer.write(path);
+
+    // flip a byte of the entry data, which starts on the second page
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(ArchiveFormat::ENTRY_ALIGNMENT + 10);
+        file.put('X');
+    }
+
+    {
+        AssetArchive archive(path);
+        const ArchiveFormat::TocEntry* entry = archive.find(5);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_FALSE(archive.verify(*entry));
+    }
+
+    // a table of contents beyond the end of the file
+    std::filesystem::resize_file(path, ArchiveFormat::ENTRY_ALIGNMENT + 100);
+    EXPECT_THROW(AssetArchive archive(path), FileFormatException);
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not an archive at all";
+    }
+    EXPECT_THROW(AssetArchive archive(path), FileFormatException);
+
+    std::remove(path.c_str());
+}
+
+TEST(TestAssetArchive, RejectsFullTable)
+{
+    std::string path = temp_path("pbl_test_archive_full.pblpak");
+
+    AssetArchiveWriter writer;
+    writer.add(5, make_data(100, 0));
+    writer.write(path);
+
+    // fill the table's one empty slot, so a probe for a missing key would never end
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+
+        ArchiveFormat::Header header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        ASSERT_EQ(header.slot_count, 2);
+
+        ArchiveFormat::TocEntry toc[2];
+        file.seekg((std::streamoff)header.toc_offset);
+        file.read(reinterpret_cast<char*>(toc), sizeof(toc));
+
+        ArchiveFormat::TocEntry& empty = toc[0].offset == 0 ? toc[0] : toc[1];
+        empty = toc[0].offset == 0 ? toc[1] : toc[0];
+        empty.key = 6;
+        header.entry_count = 2;
+
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.seekp((std::streamoff)header.toc_offset);
+        file.write(reinterpret_cast<const char*>(toc), sizeof(toc));
+    }
+
+    EXPECT_THROW(AssetArchive archive(path), FileFormatException);
+
+    std::remove(path.c_str());
+}
+
+TEST(TestAssetArchive, Compressed)
+{
+    std::string path = temp_path("pbl_test_archive_compressed.pblpak");
+
+    // compressible entries spanning several blocks, one block, and a short last block
+    auto make_compressible = [](size_t size)
+    {
+        std::vector<std::byte> data(size);
+        for (size_t i = 0; i < size; ++i) data[i] = (std::byte)((i / 64) % 7);
+        return data;
+    };
+    std::vector<size_t> sizes { ArchiveFormat::BLOCK_SIZE * 3 + 1000, ArchiveFormat::BLOCK_SIZE, 100, 0 };
+
+    AssetArchiveWriter writer;
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        writer.add(i, make_compressible(sizes[i]), ArchiveFormat::Compression::LZ4);
+    }
+    // random data does not shrink, so is stored as is
+    std::vector<std::byte> noise(5000);
+    std::mt19937 rng(5);
+    for (std::byte& b : noise) b = (std::byte)rng();
+    writer.add(10, noise, ArchiveFormat::Compression::LZ4);
+    writer.write(path);
+
+    {
+        AssetArchive archive(path);
+        JobSystem jobs(3);
+
+        for (size_t i = 0; i < sizes.size(); ++i)
+        {
+            const ArchiveFormat::TocEntry* entry = archive.find(i);
+            ASSERT_NE(entry, nullptr);
+            EXPECT_TRUE(archive.verify(*entry));
+            EXPECT_EQ(archive.get_uncompressed_size(*entry), sizes[i]);
+            if (sizes[i] > 0)
+            {
+                EXPECT_TRUE(archive.is_compressed(*entry));
+                EXPECT_LT(entry->size, sizes[i]);
+            }
+
+            std::vector<std::byte> expected = make_compressible(sizes[i]);
+
+            std::vector<std::byte> serial(sizes[i]);
+            archive.read(*entry, serial);
+            EXPECT_EQ(serial, expected);
+
+            std::vector<std::byte> parallel(sizes[i]);
+            archive.read(*entry, parallel, &jobs);
+            EXPECT_EQ(parallel, expected);
+        }
+
+        const ArchiveFormat::TocEntry* stored = archive.find(10);
+        ASSERT_NE(stored, nullptr);
+        EXPECT_FALSE(archive.is_compressed(*stored));
+        std::vector<std::byte> out(noise.size());
+        archive.read(*stored, out, &jobs);
+        EXPECT_EQ(out, noise);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestAssetArchive, DecodeReadThroughIOService)
+{
+    std::string path = temp_path("pbl_test_archive_io.pblpak");
+
+    std::vector<std::byte> data(ArchiveFormat::BLOCK_SIZE * 2 + 300);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (std::byte)((i / 32) % 5);
+
+    AssetArchiveWriter writer;
+    writer.add(1, data, ArchiveFormat::Compression::LZ4);
+    writer.add(2, make_data(100, 3));
+    writer.write(path);
+
+    {
+        AssetArchive archive(path);
+        IO::IOService io_service;
+
+        for (uint64_t key : { 1, 2 })
+        {
+            const ArchiveFormat::TocEntry* entry = archive.find(key);
+            ASSERT_NE(entry, nullptr);
+
+            // the stored data is fetched without the mapping, as the loader does
+            std::vector<std::byte> stored(entry->size);
+            std::future<IO::ReadResult> result = io_service.read(archive.get_file(), stored, entry->offset);
+            io_service.wait_all();
+            ASSERT_TRUE(result.get().ok());
+            EXPECT_TRUE(std::ranges::equal(stored, archive.get_data(*entry)));
+
+            std::vector<std::byte> out(archive.get_uncompressed_size(*entry));
+            archive.decode(*entry, stored, out);
+            EXPECT_EQ(out, key == 1 ? data : make_data(100, 3));
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestAssetArchive, CorruptCompressedBlock)
+{
+    std::string path = temp_path("pbl_test_archive_compressed_corrupt.pblpak");
+
+    std::vector<std::byte> data(ArchiveFormat::BLOCK_SIZE * 2);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (std::byte)(i % 13);
+
+    AssetArchiveWriter writer;
+    writer.add(1, data, ArchiveFormat::Compression::LZ4);
+    writer.write(path);
+
+    // damage the block table, which starts the entry
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(ArchiveFormat::ENTRY_ALIGNMENT + sizeof(uint64_t));
+        uint64_t bad_offset = 5;
+        file.write(reinterpret_cast<const char*>(&bad_offset), sizeof(bad_offset));
+    }
+
+    {
+        AssetArchive archive(path);
+        const ArchiveFormat::TocEntry* entry = archive.find(1);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_FALSE(archive.verify(*entry));
+
+        std::vector<std::byte> out(data.size());
+        EXPECT_THROW(archive.read(*entry, out), FileFormatException);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestAssetArchive, Empty)
+{
+    std::string path = temp_path("pbl_test_archive_empty.pblpak");
+
+    AssetArchiveWriter().write(path);
+
+    {
+        AssetArchive archive(path);
+        EXPECT_EQ(archive.get_entry_count(), 0);
+        EXPECT_EQ(archive.find(0), nullptr);
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "test_temp_path.h"
+
+// engine includes
+#include <Asset/CookedMesh.h>
+#include <Exception/IOExceptions.h>
+
+
+using namespace Parable;
+
+struct TestVertex
+{
+    float pos[3];
+    float uv[2];
+};
+
+static const std::vector<MeshFormat::VertexAttribute> TEST_ATTRIBUTES {
+    { MeshFormat::VertexSemantic::Position, MeshFormat::AttributeFormat::Float3, offsetof(TestVertex, pos) },
+    { MeshFormat::VertexSemantic::TexCoord, MeshFormat::AttributeFormat::Float2, offsetof(TestVertex, uv) }
+};
+
+static void write_test_mesh(const std::string& path)
+{
+    std::vector<TestVertex> vertices {
+        { { 0, 0, 0 }, { 0, 0 } },
+        { { 1, 0, 0 }, { 1, 0 } },
+        { { 1, 1, -2 }, { 1, 1 } },
+        { { 0, 1, 0 }, { 0, 1 } }
+    };
+    std::vector<uint32_t> indices { 0, 1, 2, 2, 3, 0, 0, 1, 2 };
+
+    CookedMeshData data;
+    data.vertex_stride = sizeof(TestVertex);
+    data.attributes = TEST_ATTRIBUTES;
+    data.vertices = std::as_bytes(std::span(vertices));
+    data.indices = indices;
+    data.bounds_min = { 0, 0, -2 };
+    data.bounds_max = { 1, 1, 0 };
+    data.lods = {
+        { .first_index = 0, .index_count = 6, .max_distance = 10.0f },
+        { .first_index = 6, .index_count = 3, .max_distance = 100.0f }
+    };
+
+    CookedMesh::write(path, data);
+}
+
+TEST(TestCookedMesh, WriteAndRead)
+{
+    std::string path = temp_path("pbl_test_cooked_mesh.pblmesh");
+    write_test_mesh(path);
+
+    {
+        CookedMesh mesh(path);
+
+        EXPECT_EQ(mesh.get_vertex_stride(), sizeof(TestVertex));
+        EXPECT_EQ(mesh.get_vertex_count(), 4);
+        EXPECT_EQ(mesh.get_index_count(), 9);
+        EXPECT_EQ(mesh.get_index_size(), sizeof(uint32_t));
+        EXPECT_TRUE(mesh.has_layout(sizeof(TestVertex), TEST_ATTRIBUTES));
+        EXPECT_FALSE(mesh.has_layout(sizeof(TestVertex) + 4, TEST_ATTRIBUTES));
+        EXPECT_FALSE(mesh.has_layout(sizeof(TestVertex), std::span(TEST_ATTRIBUTES).first(1)));
+
+        // blobs are aligned for direct copies
+        EXPECT_EQ((uintptr_t)mesh.get_vertex_data().data() % MeshFormat::BLOB_ALIGNMENT, 0);
+        EXPECT_EQ((uintptr_t)mesh.get_index_data().data() % MeshFormat::BLOB_ALIGNMENT, 0);
+
+        TestVertex third;
+        std::memcpy(&third, mesh.get_vertex_data().data() + 2 * sizeof(TestVertex), sizeof(TestVertex));
+        EXPECT_EQ(third.pos[2], -2.0f);
+        EXPECT_EQ(third.uv[1], 1.0f);
+
+        uint32_t index;
+        std::memcpy(&index, mesh.get_index_data().data() + 4 * sizeof(uint32_t), sizeof(uint32_t));
+        EXPECT_EQ(index, 3);
+
+        EXPECT_EQ(mesh.get_bounds_min()[2], -2.0f);
+        EXPECT_EQ(mesh.get_bounds_max()[0], 1.0f);
+
+        ASSERT_EQ(mesh.get_lods().size(), 2);
+        EXPECT_EQ(mesh.get_lods()[1].first_index, 6);
+        EXPECT_EQ(mesh.get_lods()[1].index_count, 3);
+        EXPECT_EQ(mesh.get_lods()[0].max_distance, 10.0f);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestCookedMesh, RejectsInvalidFiles)
+{
+    std::string path = temp_path("pbl_test_cooked_mesh_invalid.pblmesh");
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a mesh";
+    }
+    EXPECT_THROW(CookedMesh mesh(path), FileFormatException);
+
+    // a truncated file has blobs beyond its end
+    write_test_mesh(path);
+    std::filesystem::resize_file(path, sizeof(MeshFormat::Header) + 8);
+    EXPECT_THROW(CookedMesh mesh(path), FileFormatException);
+
+    // a bad magic
+    write_test_mesh(path);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.write("XXXX", 4);
+    }
+    EXPECT_THROW(CookedMesh mesh(path), FileFormatException);
+
+    std::remove(path.c_str());
+
+    EXPECT_THROW(CookedMesh mesh(temp_path("pbl_test_cooked_mesh_missing.pblmesh")), FileOpenException);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "test_temp_path.h"
+
+// engine includes
+#include <Asset/AssetDescriptor.h>
+#include <Asset/CookedRegistry.h>
+#include <Exception/IOExceptions.h>
+
+
+using namespace Parable;
+using namespace Parable::AssetLiterals;
+
+// the published FNV-1a test vectors, checked at compile time
+static_assert(Util::fnv1a("") == 0xcbf29ce484222325ULL);
+static_assert(Util::fnv1a("a") == 0xaf63dc4c8601ec8cULL);
+static_assert(Util::fnv1a("foobar") == 0x85944171f73967e8ULL);
+static_assert("foobar"_asset == descriptor_from_name("foobar"));
+
+TEST(TestCookedRegistry, WriteAndFind)
+{
+    std::string path = temp_path("pbl_test_registry.pblreg");
+
+    CookedRegistryWriter writer;
+    writer.add("meshes/cube"_asset, AssetType::Mesh, "meshes/cube", "", "cooked/cube.pblmesh");
+    writer.add("textures/brick"_asset, AssetType::Texture, "textures/brick", "brick.png", "");
+    writer.add(3, AssetType::Material, "", "", "", R"({"type":"material"})");
+    writer.write(path);
+
+    {
+        CookedRegistry registry(path);
+        EXPECT_EQ(registry.get_entry_count(), 3);
+
+        const RegistryFormat::Record* cube = registry.find(descriptor_from_name("meshes/cube"));
+        ASSERT_NE(cube, nullptr);
+        EXPECT_EQ(cube->type, AssetType::Mesh);
+        EXPECT_EQ(registry.get_string(cube->name), "meshes/cube");
+        EXPECT_EQ(registry.get_string(cube->source_path), "");
+        EXPECT_EQ(registry.get_string(cube->cooked_path), "cooked/cube.pblmesh");
+
+        const RegistryFormat::Record* brick = registry.find("textures/brick"_asset);
+        ASSERT_NE(brick, nullptr);
+        EXPECT_EQ(brick->type, AssetType::Texture);
+        EXPECT_EQ(registry.get_string(brick->source_path), "brick.png");
+
+        const RegistryFormat::Record* material = registry.find(3);
+        ASSERT_NE(material, nullptr);
+        EXPECT_EQ(registry.get_string(material->definition), R"({"type":"material"})");
+
+        // slots index side tables, so are distinct and in range
+        EXPECT_NE(registry.get_slot(*cube), registry.get_slot(*brick));
+        EXPECT_LT(registry.get_slot(*material), registry.get_slot_count());
+
+        EXPECT_EQ(registry.find("textures/stone"_asset), nullptr);
+        EXPECT_EQ(registry.find(0), nullptr);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestCookedRegistry, ManyEntries)
+{
+    std::string path = temp_path("pbl_test_registry_many.pblreg");
+    constexpr int count = 100000;
+
+    CookedRegistryWriter writer;
+    for (int i = 0; i < count; ++i)
+    {
+        std::string name = "asset/" + std::to_string(i);
+        writer.add(descriptor_from_name(name), i % 2 ? AssetType::Mesh : AssetType::Texture, name, "", name + ".cooked");
+    }
+    writer.write(path);
+
+    {
+        CookedRegistry registry(path);
+        EXPECT_EQ(registry.get_entry_count(), count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            std::string name = "asset/" + std::to_string(i);
+            const RegistryFormat::Record* record = registry.find(descriptor_from_name(name));
+            ASSERT_NE(record, nullptr) << "Missing " << name;
+            EXPECT_EQ(registry.get_string(record->name), name);
+        }
+
+        EXPECT_EQ(registry.find(descriptor_from_name("asset/" + std::to_string(count))), nullptr);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestCookedRegistry, RejectsInvalid)
+{
+    std::string path = temp_path("pbl_test_registry_invalid.pblreg");
+
+    CookedRegistryWriter writer;
+    writer.add(1, AssetType::Shader, "", "shader.spv", "");
+    writer.write(path);
+
+    // cut off part way through the table
+    std::filesystem::resize_file(path, sizeof(RegistryFormat::Header) + 20);
+    EXPECT_THROW(CookedRegistry registry(path), FileFormatException);
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not a registry at all, but long enough for a header";
+    }
+    EXPECT_THROW(CookedRegistry registry(path), FileFormatException);
+
+    // strings are checked as they are read
+    writer.write(path);
+    {
+        CookedRegistry registry(path);
+        const RegistryFormat::Record* record = registry.find(1);
+        ASSERT_NE(record, nullptr);
+        EXPECT_THROW(registry.get_string({ 0, 1000 }), FileFormatException);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestCookedRegistry, Empty)
+{
+    std::string path = temp_path("pbl_test_registry_empty.pblreg");
+
+    CookedRegistryWriter().write(path);
+
+    {
+        CookedRegistry registry(path);
+        EXPECT_EQ(registry.get_entry_count(), 0);
+        EXPECT_EQ(registry.find(0), nullptr);
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "test_temp_path.h"
+
+// engine includes
+#include <Asset/CookedTexture.h>
+#include <Exception/IOExceptions.h>
+
+
+using namespace Parable;
+
+TEST(TestCookedTexture, WriteAndRead)
+{
+    std::string path = temp_path("pbl_test_cooked_texture.pbltex");
+
+    // a 4x2 texture with two mips, each pixel holding its level in the red channel
+    std::vector<std::byte> level0(4 * 2 * 4, (std::byte)0);
+    std::vector<std::byte> level1(2 * 1 * 4, (std::byte)1);
+    std::vector<std::byte> level2(1 * 1 * 4, (std::byte)2);
+
+    CookedTextureData data;
+    data.width = 4;
+    data.height = 2;
+    data.mips = { level0, level1, level2 };
+    CookedTexture::write(path, data);
+
+    {
+        CookedTexture texture(path);
+
+        EXPECT_EQ(texture.get_width(), 4);
+        EXPECT_EQ(texture.get_height(), 2);
+        EXPECT_EQ(texture.get_format(), TextureFormat::PixelFormat::RGBA8Srgb);
+        ASSERT_EQ(texture.get_mip_count(), 3);
+
+        // mip dimensions never fall below 1
+        EXPECT_EQ(texture.get_mip_level(1).width, 2);
+        EXPECT_EQ(texture.get_mip_level(2).width, 1);
+        EXPECT_EQ(texture.get_mip_level(2).height, 1);
+
+        for (uint32_t mip = 0; mip < 3; ++mip)
+        {
+            std::span<const std::byte> pixels = texture.get_mip_data(mip);
+            EXPECT_EQ((uintptr_t)pixels.data() % TextureFormat::BLOB_ALIGNMENT, 0);
+            EXPECT_EQ(pixels.size(), data.mips[mip].size());
+            EXPECT_EQ(pixels[0], (std::byte)mip);
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestCookedTexture, RejectsInvalidFiles)
+{
+    std::string path = temp_path("pbl_test_cooked_texture_invalid.pbltex");
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a texture";
+    }
+    EXPECT_THROW(CookedTexture texture(path), FileFormatException);
+
+    // a truncated file has pixels beyond its end
+    std::vector<std::byte> pixels(16 * 16 * 4);
+    CookedTextureData data;
+    data.width = 16;
+    data.height = 16;
+    data.mips = { pixels };
+    CookedTexture::write(path, data);
+    std::filesystem::resize_file(path, sizeof(TextureFormat::Header) + 64);
+    EXPECT_THROW(CookedTexture texture(path), FileFormatException);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <deque>
+
+// engine includes
+#include <Core/Base.h>
+#include <Asset/ResourceState.h>
+#include <Asset/Handle.h>
+
+
+using namespace Parable;
+
+/**
+ * Blocks tracked by one residency list, each holding 100 bytes once loaded.
+ */
+class TestResidency : public testing::Test
+{
+protected:
+    ResidencyList residency { 250 };
+    std::deque<ResourceStorageBlock<int>> blocks;
+
+    void SetUp() override
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            ResourceStorageBlock<int>& block = blocks.emplace_back(std::make_unique<int>(i));
+            block.set_residency(&residency);
+            block.set_resident_size(100);
+        }
+    }
+
+    void load(int i)
+    {
+        blocks[i].set_load_state(ResourceLoadState::Loading);
+        blocks[i].set_load_state(ResourceLoadState::Loaded);
+    }
+
+    /**
+     * Evict every candidate, as a store would, returning the indices in eviction order.
+     */
+    std::vector<int> evict()
+    {
+        std::vector<int> evicted;
+        while (ResourceState* state = residency.pop_eviction_candidate())
+        {
+            ResourceStorageBlock<int>& block = static_cast<ResourceStorageBlock<int>&>(*state);
+            evicted.push_back(*block.take_resource());
+            block.set_load_state(ResourceLoadState::Unloaded);
+        }
+        return evicted;
+    }
+};
+
+TEST_F(TestResidency, WithinBudgetKeepsResources)
+{
+    load(0);
+    load(1);
+
+    EXPECT_EQ(residency.get_resident_size(), 200);
+    EXPECT_TRUE(evict().empty());
+    EXPECT_EQ(blocks[0].get_load_state(), ResourceLoadState::Loaded);
+}
+
+TEST_F(TestResidency, EvictsLeastRecentlyReleased)
+{
+    std::vector<Handle<int>> handles;
+    for (int i = 0; i < 4; ++i)
+    {
+        handles.emplace_back(blocks[i]);
+        load(i);
+    }
+
+    // nothing can be evicted while every resource is referenced
+    EXPECT_EQ(residency.get_resident_size(), 400);
+    EXPECT_TRUE(evict().empty());
+
+    // release in the order 2, 0, 3, 1
+    for (int i : { 2, 0, 3, 1 }) handles[i] = Handle<int>();
+
+    EXPECT_EQ(evict(), (std::vector<int> { 2, 0 }));
+    EXPECT_EQ(residency.get_resident_size(), 200);
+    EXPECT_EQ(blocks[2].get_load_state(), ResourceLoadState::Unloaded);
+    EXPECT_EQ(blocks[3].get_load_state(), ResourceLoadState::Loaded);
+}
+
+TEST_F(TestResidency, ReferencingAgainKeepsResource)
+{
+    for (int i = 0; i < 4; ++i) load(i);
+
+    // loaded with no handles, so all are candidates, in the order they loaded
+    Handle<int> handle(blocks[0]);
+    EXPECT_EQ(blocks[0].get_ref_count(), 1);
+
+    EXPECT_EQ(evict(), (std::vector<int> { 1, 2 }));
+    EXPECT_EQ(blocks[0].get_load_state(), ResourceLoadState::Loaded);
+
+    // releasing it again makes it the most recently released
+    handle = Handle<int>();
+    residency.set_budget(0);
+    EXPECT_EQ(evict(), (std::vector<int> { 3, 0 }));
+    EXPECT_EQ(residency.get_resident_size(), 0);
+}
+
+TEST_F(TestResidency, PopLeastRecentIgnoresBudget)
+{
+    Handle<int> handle(blocks[0]);
+    load(0);
+    load(1);
+    load(2);
+    handle = Handle<int>();
+
+    // over budget evicts one, then a store short of space still takes unreferenced resources in order
+    EXPECT_EQ(evict(), (std::vector<int> { 1 }));
+    EXPECT_EQ(residency.pop_least_recent(), &blocks[2]);
+    EXPECT_EQ(residency.pop_least_recent(), &blocks[0]);
+    EXPECT_EQ(residency.pop_least_recent(), nullptr);
+}
+
+TEST_F(TestResidency, ReloadAfterEviction)
+{
+    for (int i = 0; i < 3; ++i) load(i);
+    EXPECT_EQ(evict(), (std::vector<int> { 0 }));
+
+    // a store reloads into the same block, which handles kept to it still point at
+    Handle<int> handle(blocks[0]);
+    blocks[0].set_resource(std::make_unique<int>(0));
+    load(0);
+
+    EXPECT_TRUE(handle.is_loaded());
+    EXPECT_EQ(residency.get_resident_size(), 300);
+    EXPECT_EQ(evict(), (std::vector<int> { 1 }));
+}
+
+TEST_F(TestResidency, HandleReferenceCounts)
+{
+    Handle<int> a(blocks[0]);
+    Handle<int> b(blocks[1]);
+
+    // assignment releases the reference held before
+    a = b;
+    EXPECT_EQ(blocks[0].get_ref_count(), 0);
+    EXPECT_EQ(blocks[1].get_ref_count(), 2);
+
+    a = a;
+    EXPECT_EQ(blocks[1].get_ref_count(), 2);
+
+    Handle<int> c(blocks[2]);
+    c = std::move(a);
+    EXPECT_EQ(blocks[2].get_ref_count(), 0);
+    EXPECT_EQ(blocks[1].get_ref_count(), 2);
+    EXPECT_FALSE(a);
+
+    {
+        Handle<int> d = c;
+        EXPECT_EQ(blocks[1].get_ref_count(), 3);
+    }
+    EXPECT_EQ(blocks[1].get_ref_count(), 2);
+}
@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+// engine includes
+#include <Asset/TextureEncoder.h>
+
+
+using namespace Parable;
+
+// reference decoders, written from the block format descriptions, so encoder output is checked
+// against the formats rather than against the encoder's own idea of them
+
+static void decode_bc1(const uint8_t* block, uint8_t* out, bool four_colour_only)
+{
+    uint16_t c0 = block[0] | (block[1] << 8);
+    uint16_t c1 = block[2] | (block[3] << 8);
+    uint32_t bits = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint32_t)block[7] << 24);
+
+    auto expand = [](uint16_t c, int* rgb)
+    {
+        int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    };
+
+    int palette[4][3];
+    expand(c0, palette[0]);
+    expand(c1, palette[1]);
+    for (int i = 0; i < 3; ++i)
+    {
+        if (c0 > c1 || four_colour_only)
+        {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        }
+        else
+        {
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+            palette[3][i] = 0;
+        }
+    }
+
+    for (int t = 0; t < 16; ++t)
+    {
+        int index = (bits >> (2 * t)) & 3;
+        for (int i = 0; i < 3; ++i) out[t * 4 + i] = (uint8_t)palette[index][i];
+    }
+}
+
+static void decode_bc4(const uint8_t* block, uint8_t* out, int stride)
+{
+    int a0 = block[0], a1 = block[1];
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; ++i) bits |= (uint64_t)block[2 + i] << (8 * i);
+
+    int palette[8] = { a0, a1 };
+    for (int i = 2; i < 8; ++i)
+    {
+        if (a0 > a1) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        else palette[i] = i == 6 ? 0 : i == 7 ? 255 : ((6 - i) * a0 + (i - 1) * a1) / 5;
+    }
+
+    for (int t = 0; t < 16; ++t) out[t * stride] = (uint8_t)palette[(bits >> (3 * t)) & 7];
+}
+
+/**
+ * Decode the BC7 modes the encoder uses, 5 and 6.
+ */
+static void decode_bc7(const uint8_t* block, uint8_t* out)
+{
+    size_t position = 0;
+    auto get = [block, &position](int bits)
+    {
+        uint32_t value = 0;
+        for (int bit = 0; bit < bits; ++bit, ++position) value |= ((block[position / 8] >> (position % 8)) & 1) << bit;
+        return value;
+    };
+
+    if (block[0] == 1 << 5)
+    {
+        get(6);
+        ASSERT_EQ(get(2), 0u) << "Unexpected channel rotation.";
+
+        int colour[2][3];
+        for (int i = 0; i < 3; ++i)
+        {
+            colour[0][i] = get(7);
+            colour[1][i] = get(7);
+            colour[0][i] = (colour[0][i] << 1) | (colour[0][i] >> 6);
+            colour[1][i] = (colour[1][i] << 1) | (colour[1][i] >> 6);
+        }
+        int alpha[2];
+        alpha[0] = get(8);
+        alpha[1] = get(8);
+
+        static constexpr int weights[4] = { 0, 21, 43, 64 };
+        for (int t = 0; t < 16; ++t)
+        {
+            int index = get(t == 0 ? 1 : 2);
+            for (int i = 0; i < 3; ++i) out[t * 4 + i] = (uint8_t)(((64 - weights[index]) * colour[0][i] + weights[index] * colour[1][i] + 32) >> 6);
+        }
+        for (int t = 0; t < 16; ++t)
+        {
+            int index = get(t == 0 ? 1 : 2);
+            out[t * 4 + 3] = (uint8_t)(((64 - weights[index]) * alpha[0] + weights[index] * alpha[1] + 32) >> 6);
+        }
+        return;
+    }
+
+    ASSERT_EQ(get(7), 1u << 6) << "Not a mode 5 or 6 block.";
+
+    int endpoints[2][4];
+    for (int i = 0; i < 4; ++i)
+    {
+        endpoints[0][i] = get(7);
+        endpoints[1][i] = get(7);
+    }
+    int p0 = get(1), p1 = get(1);
+    for (int i = 0; i < 4; ++i)
+    {
+        endpoints[0][i] = (endpoints[0][i] << 1) | p0;
+        endpoints[1][i] = (endpoints[1][i] << 1) | p1;
+    }
+
+    static constexpr int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+    for (int t = 0; t < 16; ++t)
+    {
+        int index = get(t == 0 ? 3 : 4);
+        for (int i = 0; i < 4; ++i) out[t * 4 + i] = (uint8_t)(((64 - weights[index]) * endpoints[0][i] + weights[index] * endpoints[1][i] + 32) >> 6);
+    }
+}
+
+/**
+ * Decode a whole level back to RGBA8, filling channels the format lacks from the source.
+ */
+static std::vector<uint8_t> decode(TextureFormat::PixelFormat format, std::span<const std::byte> data, const std::vector<uint8_t>& source, uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> out = source;
+    size_t block_size = TextureFormat::get_level_size(format, 4, 4);
+    uint32_t blocks_x = (width + 3) / 4;
+
+    for (uint32_t block_y = 0; block_y < (height + 3) / 4; ++block_y)
+    {
+        for (uint32_t block_x = 0; block_x < blocks_x; ++block_x)
+        {
+            const uint8_t* block = reinterpret_cast<const uint8_t*>(data.data()) + (block_y * blocks_x + block_x) * block_size;
+
+            uint8_t texels[64];
+            for (int t = 0; t < 16; ++t)
+            {
+                uint32_t x = std::min(block_x * 4 + t % 4, width - 1), y = std::min(block_y * 4 + t / 4, height - 1);
+                for (int i = 0; i < 4; ++i) texels[t * 4 + i] = source[(y * width + x) * 4 + i];
+            }
+
+            switch (format)
+            {
+                case TextureFormat::PixelFormat::BC1RgbSrgb: decode_bc1(block, texels, false); break;
+                case TextureFormat::PixelFormat::BC3Srgb: decode_bc4(block, texels + 3, 4); decode_bc1(block + 8, texels, true); break;
+                case TextureFormat::PixelFormat::BC5Unorm: decode_bc4(block, texels, 4); decode_bc4(block + 8, texels + 1, 4); break;
+                case TextureFormat::PixelFormat::BC7Srgb: decode_bc7(block, texels); break;
+                default: break;
+            }
+
+            for (int t = 0; t < 16; ++t)
+            {
+                uint32_t x = block_x * 4 + t % 4, y = block_y * 4 + t / 4;
+                if (x >= width || y >= height) continue;
+                for (int i = 0; i < 4; ++i) out[(y * width + x) * 4 + i] = texels[t * 4 + i];
+            }
+        }
+    }
+
+    return out;
+}
+
+static double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b)
+{
+    double error = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) error += (a[i] - b[i]) * (a[i] - b[i]);
+    error /= a.size();
+    return error == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 / error);
+}
+
+/**
+ * A smooth image with some edges and an alpha gradient, roughly like real texture content.
+ */
+static std::vector<uint8_t> make_image(uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> image(width * height * 4);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            uint8_t* texel = &image[(y * width + x) * 4];
+            texel[0] = (uint8_t)(128 + 100 * std::sin(x * 0.1));
+            texel[1] = (uint8_t)(y * 255 / height);
+            texel[2] = ((x / 8 + y / 8) % 2) ? 200 : 40;
+            texel[3] = (uint8_t)(x * 255 / width);
+        }
+    }
+    return image;
+}
+
+TEST(TestTextureEncoder, BlockFormatsDecode)
+{
+    // a size which is not a whole number of blocks, to cover the edges
+    uint32_t width = 37, height = 22;
+    std::vector<uint8_t> image = make_image(width, height);
+    std::span<const std::byte> rgba = std::as_bytes(std::span(image));
+
+    struct Case { TextureFormat::PixelFormat format; double min_psnr; };
+    for (Case test : { Case { TextureFormat::PixelFormat::BC1RgbSrgb, 30.0 }, Case { TextureFormat::PixelFormat::BC3Srgb, 30.0 }, Case { TextureFormat::PixelFormat::BC5Unorm, 38.0 }, Case { TextureFormat::PixelFormat::BC7Srgb, 34.0 } })
+    {
+        std::vector<std::byte> encoded = TextureEncoder::encode(test.format, rgba, width, height);
+        ASSERT_EQ(encoded.size(), TextureFormat::get_level_size(test.format, width, height));
+
+        std::vector<uint8_t> decoded = decode(test.format, encoded, image, width, height);
+        EXPECT_GT(psnr(image, decoded), test.min_psnr) << "Poor quality for format " << (int)test.format;
+    }
+}
+
+TEST(TestTextureEncoder, FlatBlocksAreExact)
+{
+    std::vector<uint8_t> image(8 * 8 * 4);
+    for (size_t i = 0; i < image.size(); i += 4)
+    {
+        image[i] = 255;
+        image[i + 1] = 0;
+        image[i + 2] = 0;
+        image[i + 3] = 255;
+    }
+    std::span<const std::byte> rgba = std::as_bytes(std::span(image));
+
+    for (TextureFormat::PixelFormat format : { TextureFormat::PixelFormat::BC1RgbSrgb, TextureFormat::PixelFormat::BC3Srgb, TextureFormat::PixelFormat::BC7Srgb })
+    {
+        std::vector<uint8_t> decoded = decode(format, TextureEncoder::encode(format, rgba, 8, 8), image, 8, 8);
+        EXPECT_EQ(decoded, image) << "Flat colour changed for format " << (int)format;
+    }
+}
+
+TEST(TestTextureEncoder, DownsampleIsGammaCorrect)
+{
+    // a black and white checker averages to half the light, which is not half the sRGB value
+    std::vector<uint8_t> image { 0, 0, 0, 0,  255, 255, 255, 255,
+                                 255, 255, 255, 255,  0, 0, 0, 0 };
+
+    std::vector<std::byte> srgb = TextureEncoder::downsample(std::as_bytes(std::span(image)), 2, 2, true);
+    ASSERT_EQ(srgb.size(), 4);
+    EXPECT_NEAR((int)srgb[0], 188, 1);
+    EXPECT_NEAR((int)srgb[3], 128, 1) << "Alpha should average linearly.";
+
+    std::vector<std::byte> linear = TextureEncoder::downsample(std::as_bytes(std::span(image)), 2, 2, false);
+    EXPECT_NEAR((int)linear[0], 128, 1);
+
+    // a 3x1 image halves to 1x1
+    std::vector<uint8_t> row(3 * 4, 100);
+    EXPECT_EQ(TextureEncoder::downsample(std::as_bytes(std::span(row)), 3, 1, true).size(), 4);
+}
+
+TEST(TestTextureEncoder, MipCount)
+{
+    EXPECT_EQ(TextureFormat::get_full_mip_count(1, 1), 1);
+    EXPECT_EQ(TextureFormat::get_full_mip_count(256, 256), 9);
+    EXPECT_EQ(TextureFormat::get_full_mip_count(300, 17), 9);
+    EXPECT_EQ(TextureFormat::get_full_mip_count(1u << 20, 1), TextureFormat::MAX_MIPS);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+// engine includes
+#include <Asset/AssetLoadInfo.h>
+#include <Asset/ResourceState.h>
+#include <Renderer/Texture.h>
+#include <Platform/Vulkan/Texture/TextureLoadTask.h>
+
+
+using namespace Parable;
+
+TEST(TestTextureLoadTask, FailedLoadReleasesDescriptorSet)
+{
+    // stands in for the store's descriptor pool, which has room for 100 sets
+    std::vector<vk::DescriptorSet> pool;
+    for (uintptr_t i = 1; i <= 100; ++i) pool.emplace_back((VkDescriptorSet)i);
+
+    TextureLoadInfo load_info("missing.png", "");
+    ResourceStorageBlock<Texture> block;
+
+    // each failed load is retried with a new task, and so a new set
+    for (int attempt = 0; attempt < 250; ++attempt)
+    {
+        ASSERT_FALSE(pool.empty()) << "Descriptor pool ran out after " << attempt << " failed loads.";
+        vk::DescriptorSet set = pool.back();
+        pool.pop_back();
+
+        Vulkan::TextureLoadTask task(load_info, {}, block, set, [&pool](vk::DescriptorSet released) { pool.push_back(released); });
+
+        block.set_load_state(ResourceLoadState::Loading);
+        task.on_load_failed();
+
+        EXPECT_EQ(block.get_load_state(), ResourceLoadState::Unloaded);
+        EXPECT_EQ(pool.size(), 100);
+    }
+}
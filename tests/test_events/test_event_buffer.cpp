@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+// engine includes
+#include <Events/EventBuffer.h>
+#include <Events/InputEvent.h>
+#include <Events/WindowEvent.h>
+
+
+using namespace Parable;
+
+
+/**
+ * Event which counts its destructions, to check the buffer destroys what it stores.
+ */
+class CountedEvent : public Event
+{
+public:
+    EVENT_CLASS_CATEGORY(None)
+    EVENT_CLASS_TYPE(None)
+
+    CountedEvent(int* destroyed) : m_destroyed(destroyed) {}
+    ~CountedEvent() { ++(*m_destroyed); }
+
+private:
+    int* m_destroyed;
+};
+
+TEST(TestEventBuffer, PushAndIterate)
+{
+    EventBuffer buffer;
+    EXPECT_TRUE(buffer.is_empty());
+
+    buffer.push<KeyPressedEvent>(Input::KeyCode::A);
+    buffer.push<MouseMovedEvent>(1.5, 2.5);
+    buffer.push<WindowResizeEvent>(800, 600);
+
+    ASSERT_EQ(buffer.size(), 3);
+
+    EXPECT_EQ(buffer[0]->get_event_type(), EventType::KeyPressed);
+    EXPECT_EQ(static_cast<KeyPressedEvent*>(buffer[0])->get_key_code(), Input::KeyCode::A);
+
+    auto* moved = static_cast<MouseMovedEvent*>(buffer[1]);
+    EXPECT_EQ(moved->get_x(), 1.5);
+    EXPECT_EQ(moved->get_y(), 2.5);
+
+    auto* resized = static_cast<WindowResizeEvent*>(buffer[2]);
+    EXPECT_EQ(resized->get_width(), 800);
+    EXPECT_EQ(resized->get_height(), 600);
+
+    size_t visited = 0;
+    for (Event* e : buffer)
+    {
+        EXPECT_FALSE(e->handled);
+        ++visited;
+    }
+    EXPECT_EQ(visited, 3);
+}
+
+TEST(TestEventBuffer, RecyclesBlocks)
+{
+    // enough mouse events to span several blocks, as a frame of fast mouse movement would
+    static constexpr size_t NUM_EVENTS = 3 * EventBuffer::BLOCK_SIZE / sizeof(MouseMovedEvent);
+
+    EventBuffer buffer;
+
+    for (size_t i = 0; i < NUM_EVENTS; ++i) buffer.push<MouseMovedEvent>((double)i, 0.0);
+    size_t blocks = buffer.get_num_blocks();
+    EXPECT_GT(blocks, 1);
+
+    for (size_t i = 0; i < NUM_EVENTS; ++i)
+    {
+        ASSERT_EQ(static_cast<MouseMovedEvent*>(buffer[i])->get_x(), (double)i) << "Event overwritten at " << i;
+    }
+
+    // later frames reuse the same storage
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        buffer.clear();
+        EXPECT_TRUE(buffer.is_empty());
+
+        for (size_t i = 0; i < NUM_EVENTS; ++i) buffer.push<MouseMovedEvent>((double)i, 0.0);
+        EXPECT_EQ(buffer.get_num_blocks(), blocks);
+    }
+}
+
+TEST(TestEventBuffer, DestroysEvents)
+{
+    int destroyed = 0;
+    {
+        EventBuffer buffer;
+        for (int i = 0; i < 5; ++i) buffer.push<CountedEvent>(&destroyed);
+
+        buffer.clear();
+        EXPECT_EQ(destroyed, 5);
+
+        for (int i = 0; i < 3; ++i) buffer.push<CountedEvent>(&destroyed);
+    }
+    EXPECT_EQ(destroyed, 8) << "Events left in the buffer were not destroyed with it.";
+}
+
+TEST(TestEventBuffer, CoalescesHighRateInput)
+{
+    EventBuffer buffer;
+    buffer.set_coalescing(true);
+
+    for (int i = 1; i <= 10; ++i) buffer.push<MouseMovedEvent>((double)i, 0.0, 1.0, 0.0);
+    buffer.push<MouseScrolledEvent>(1.0);
+    buffer.push<MouseScrolledEvent>(2.0);
+    buffer.push<KeyRepeatedEvent>(Input::KeyCode::A);
+    buffer.push<KeyRepeatedEvent>(Input::KeyCode::A);
+    buffer.push<KeyRepeatedEvent>(Input::KeyCode::B);
+    buffer.push<MouseMovedEvent>(20.0, 5.0, 10.0, 5.0);
+
+    ASSERT_EQ(buffer.size(), 5);
+
+    auto* moved = static_cast<MouseMovedEvent*>(buffer[0]);
+    EXPECT_EQ(moved->get_x(), 10.0);
+    EXPECT_EQ(moved->get_delta_x(), 10.0);
+
+    EXPECT_EQ(static_cast<MouseScrolledEvent*>(buffer[1])->get_scroll_amt(), 3.0);
+
+    auto* repeat_a = static_cast<KeyRepeatedEvent*>(buffer[2]);
+    EXPECT_EQ(repeat_a->get_key_code(), Input::KeyCode::A);
+    EXPECT_EQ(repeat_a->get_repeat_count(), 2);
+    EXPECT_EQ(static_cast<KeyRepeatedEvent*>(buffer[3])->get_key_code(), Input::KeyCode::B) << "Repeats of different keys were merged.";
+
+    // a move after other events starts a new coalesced move, to keep ordering
+    EXPECT_EQ(static_cast<MouseMovedEvent*>(buffer[4])->get_delta_y(), 5.0);
+
+    // the raw stream keeps every sample unmerged
+    const auto& raw = buffer.get_raw_events();
+    ASSERT_EQ(raw.size(), 16);
+    EXPECT_EQ(static_cast<MouseMovedEvent*>(raw[0])->get_x(), 1.0);
+    EXPECT_EQ(static_cast<MouseMovedEvent*>(raw[0])->get_delta_x(), 1.0);
+}
+
+TEST(TestEventBuffer, DropsSupersededResizes)
+{
+    EventBuffer buffer;
+    buffer.set_coalescing(true);
+
+    buffer.push<WindowResizeEvent>(100, 100);
+    buffer.push<KeyPressedEvent>(Input::KeyCode::A);
+    buffer.push<WindowResizeEvent>(200, 200);
+
+    ASSERT_EQ(buffer.size(), 2);
+    EXPECT_EQ(buffer[0]->get_event_type(), EventType::KeyPressed);
+    EXPECT_EQ(static_cast<WindowResizeEvent*>(buffer[1])->get_width(), 200);
+
+    // events already being dispatched are left alone
+    buffer.freeze();
+    buffer.push<WindowResizeEvent>(300, 300);
+    buffer.push<MouseMovedEvent>(1.0, 1.0, 1.0, 1.0);
+
+    ASSERT_EQ(buffer.size(), 4);
+    EXPECT_EQ(static_cast<WindowResizeEvent*>(buffer[1])->get_width(), 200);
+    EXPECT_EQ(static_cast<WindowResizeEvent*>(buffer[2])->get_width(), 300);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "test_temp_path.h"
+
+// engine includes
+#include <Events/EventLog.h>
+#include <Events/InputEvent.h>
+#include <Events/WindowEvent.h>
+#include <Events/ResourceEvent.h>
+#include <Exception/IOExceptions.h>
+
+
+using namespace Parable;
+
+TEST(TestEventLog, RecordAndReplay)
+{
+    std::string path = temp_path("pbl_test_event_log.pblevents");
+
+    {
+        EventRecorder recorder(path);
+        EventBuffer frame;
+
+        // frame 0
+        frame.push<KeyPressedEvent>(Input::KeyCode::A);
+        frame.push<MouseMovedEvent>(1.0, 2.0, 1.0, 2.0);
+        recorder.record_frame(0, frame.get_raw_events());
+        frame.clear();
+
+        // frame 1 has no input, frame 2 also has an engine event which is not recorded
+        recorder.record_frame(1, frame.get_raw_events());
+        frame.push<WindowResizeEvent>(640, 480);
+        frame.push<ResourceLoadedEvent>((AssetDescriptor)3);
+        frame.push<MouseBtnPressedEvent>(2);
+        frame.push<MouseScrolledEvent>(-1.5);
+        frame.push<WindowFocusEvent>(true);
+        recorder.record_frame(2, frame.get_raw_events());
+
+        EXPECT_EQ(recorder.get_num_recorded(), 6);
+    }
+
+    EventReplayer replayer(path);
+    EventBuffer buffer;
+
+    ASSERT_EQ(replayer.replay_frame(0, buffer), 2);
+    EXPECT_EQ(static_cast<KeyPressedEvent*>(buffer[0])->get_key_code(), Input::KeyCode::A);
+    auto* moved = static_cast<MouseMovedEvent*>(buffer[1]);
+    EXPECT_EQ(moved->get_x(), 1.0);
+    EXPECT_EQ(moved->get_delta_y(), 2.0);
+    buffer.clear();
+
+    EXPECT_EQ(replayer.replay_frame(1, buffer), 0);
+    EXPECT_FALSE(replayer.is_finished());
+
+    ASSERT_EQ(replayer.replay_frame(2, buffer), 4);
+    EXPECT_EQ(static_cast<WindowResizeEvent*>(buffer[0])->get_width(), 640);
+    EXPECT_EQ(static_cast<WindowResizeEvent*>(buffer[0])->get_height(), 480);
+    EXPECT_EQ(static_cast<MouseBtnPressedEvent*>(buffer[1])->get_button(), (Input::MouseButton)2);
+    EXPECT_EQ(static_cast<MouseScrolledEvent*>(buffer[2])->get_scroll_amt(), -1.5);
+    EXPECT_TRUE(static_cast<WindowFocusEvent*>(buffer[3])->focused);
+
+    EXPECT_TRUE(replayer.is_finished());
+
+    std::remove(path.c_str());
+}
+
+TEST(TestEventLog, LateReplayCatchesUp)
+{
+    std::string path = temp_path("pbl_test_event_log_late.pblevents");
+
+    {
+        EventRecorder recorder(path);
+        EventBuffer frame;
+        for (uint64_t f = 0; f < 3; ++f)
+        {
+            frame.push<KeyPressedEvent>((int)f);
+            recorder.record_frame(f, frame.get_raw_events());
+            frame.clear();
+        }
+    }
+
+    EventReplayer replayer(path);
+    EventBuffer buffer;
+
+    EXPECT_EQ(replayer.replay_frame(1, buffer), 2) << "Earlier frames were not replayed.";
+    EXPECT_EQ(replayer.replay_frame(5, buffer), 1);
+    EXPECT_TRUE(replayer.is_finished());
+
+    std::remove(path.c_str());
+}
+
+TEST(TestEventLog, RejectsInvalidLogs)
+{
+    std::string path = temp_path("pbl_test_event_log_invalid.pblevents");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "NOTALOG!";
+    }
+    EXPECT_THROW(EventReplayer replayer(path), FileFormatException);
+
+    // a valid header with a truncated frame
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(EventLog::MAGIC, sizeof(EventLog::MAGIC));
+        out.write(reinterpret_cast<const char*>(&EventLog::VERSION), sizeof(EventLog::VERSION));
+        out << "abc";
+    }
+    EXPECT_THROW(EventReplayer replayer(path), FileFormatException);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+// engine includes
+#include <Events/EventQueue.h>
+#include <Events/InputEvent.h>
+#include <Events/ResourceEvent.h>
+
+
+using namespace Parable;
+
+TEST(TestEventQueue, PostAndDrain)
+{
+    EventQueue queue;
+    EventBuffer buffer;
+
+    EXPECT_TRUE(queue.post<ResourceLoadedEvent>((AssetDescriptor)7));
+    EXPECT_TRUE(queue.post<MouseMovedEvent>(1.0, 2.0, 3.0, 4.0));
+    EXPECT_TRUE(queue.post<MouseEnterEvent>());
+
+    EXPECT_EQ(queue.drain(buffer), 3);
+    ASSERT_EQ(buffer.size(), 3);
+
+    EXPECT_EQ(static_cast<ResourceLoadedEvent*>(buffer[0])->get_descriptor(), 7);
+
+    auto* moved = static_cast<MouseMovedEvent*>(buffer[1]);
+    EXPECT_EQ(moved->get_x(), 1.0);
+    EXPECT_EQ(moved->get_y(), 2.0);
+    EXPECT_EQ(moved->get_delta_x(), 3.0);
+    EXPECT_EQ(moved->get_delta_y(), 4.0);
+
+    EXPECT_EQ(buffer[2]->get_event_type(), EventType::MouseEnter);
+
+    EXPECT_EQ(queue.drain(buffer), 0);
+}
+
+TEST(TestEventQueue, ThreadedProducers)
+{
+    static constexpr uint64_t NUM_PRODUCERS = 4;
+    static constexpr uint64_t EVENTS_PER_PRODUCER = 20000;
+
+    EventQueue queue;
+    EventBuffer buffer;
+
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < NUM_PRODUCERS; ++p)
+    {
+        producers.emplace_back([&queue, p]()
+        {
+            for (uint64_t i = 0; i < EVENTS_PER_PRODUCER; ++i)
+            {
+                // producer in the high bits, sequence in the low
+                while (!queue.post<ResourceLoadedEvent>((p << 32) | i)) std::this_thread::yield();
+            }
+        });
+    }
+
+    // the main thread drains each "frame" while the producers run
+    std::vector<uint64_t> next(NUM_PRODUCERS, 0);
+    uint64_t received = 0;
+    while (received < NUM_PRODUCERS * EVENTS_PER_PRODUCER)
+    {
+        queue.drain(buffer);
+        for (Event* e : buffer)
+        {
+            AssetDescriptor d = static_cast<ResourceLoadedEvent*>(e)->get_descriptor();
+            uint64_t p = d >> 32;
+            ASSERT_EQ(d & 0xFFFFFFFF, next[p]) << "Events from producer " << p << " out of order.";
+            ++next[p];
+            ++received;
+        }
+        buffer.clear();
+    }
+
+    for (std::thread& t : producers) t.join();
+
+    EXPECT_EQ(queue.drain(buffer), 0);
+}
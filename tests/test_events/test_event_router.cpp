@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+// engine includes
+#include <Events/EventRouter.h>
+#include <Events/InputEvent.h>
+#include <Events/WindowEvent.h>
+
+
+using namespace Parable;
+
+/**
+ * Records the handlers invoked, in order, and whether each handles its event.
+ */
+class RecordingSubscriber
+{
+public:
+    RecordingSubscriber(std::string name, std::vector<std::string>& log, bool handles = false) :
+                                                                                m_name(std::move(name)),
+                                                                                m_log(log),
+                                                                                m_handles(handles)
+                                                                                {}
+
+    bool on_key_pressed(KeyPressedEvent& e) { m_log.push_back(m_name + ":key"); return m_handles; }
+    bool on_resize(WindowResizeEvent& e) { m_log.push_back(m_name + ":resize"); return m_handles; }
+    bool on_any(Event& e) { m_log.push_back(m_name + ":" + e.get_name()); return m_handles; }
+
+private:
+    std::string m_name;
+    std::vector<std::string>& m_log;
+    bool m_handles;
+};
+
+TEST(TestEventRouter, RoutesOnlyToSubscribers)
+{
+    std::vector<std::string> log;
+    RecordingSubscriber keys("keys", log);
+    RecordingSubscriber window("window", log);
+
+    EventRouter router;
+    router.subscribe<&RecordingSubscriber::on_key_pressed>(&keys);
+    router.subscribe<&RecordingSubscriber::on_resize>(&window);
+
+    KeyPressedEvent pressed(Input::KeyCode::A);
+    WindowResizeEvent resized(800, 600);
+    MouseMovedEvent moved(1.0, 2.0);
+
+    router.dispatch(pressed);
+    router.dispatch(resized);
+    router.dispatch(moved);
+
+    EXPECT_EQ(log, std::vector<std::string>({"keys:key", "window:resize"}));
+    EXPECT_FALSE(pressed.handled);
+}
+
+TEST(TestEventRouter, PriorityAndHandling)
+{
+    std::vector<std::string> log;
+    RecordingSubscriber bottom("bottom", log);
+    RecordingSubscriber middle("middle", log, true);
+    RecordingSubscriber top("top", log);
+
+    // subscribe out of priority order, as layers pushed later sit above earlier ones
+    EventRouter router;
+    router.set_priority(1);
+    router.subscribe<&RecordingSubscriber::on_key_pressed>(&middle);
+    router.set_priority(0);
+    router.subscribe<&RecordingSubscriber::on_key_pressed>(&bottom);
+    router.set_priority(2);
+    router.subscribe<&RecordingSubscriber::on_key_pressed>(&top);
+
+    KeyPressedEvent pressed(Input::KeyCode::A);
+    router.dispatch(pressed);
+
+    EXPECT_EQ(log, std::vector<std::string>({"top:key", "middle:key"})) << "Handled event propagated past its handler.";
+    EXPECT_TRUE(pressed.handled);
+}
+
+TEST(TestEventRouter, CategorySubscriptions)
+{
+    std::vector<std::string> log;
+    RecordingSubscriber keys("keys", log);
+    RecordingSubscriber mouse("mouse", log);
+    RecordingSubscriber all("all", log);
+
+    EventRouter router;
+    router.subscribe<&RecordingSubscriber::on_key_pressed>(&keys);
+    router.subscribe_category<&RecordingSubscriber::on_any>(EventCategoryMouse, &mouse);
+
+    KeyPressedEvent pressed(Input::KeyCode::A);
+    MouseMovedEvent moved(1.0, 2.0);
+    router.dispatch(pressed);
+    router.dispatch(moved);
+
+    EXPECT_EQ(log, std::vector<std::string>({"keys:key", "mouse:MouseMoved"}));
+
+    // subscribing after events have been routed re-resolves the routes
+    log.clear();
+    router.set_priority(1);
+    router.subscribe_category<&RecordingSubscriber::on_any>(EventRouter::ALL_CATEGORIES, &all);
+
+    router.dispatch(pressed);
+    router.dispatch(moved);
+
+    EXPECT_EQ(log, std::vector<std::string>({"all:KeyPressed", "keys:key", "all:MouseMoved", "mouse:MouseMoved"}));
+
+    log.clear();
+    router.unsubscribe(&all);
+    router.dispatch(pressed);
+
+    EXPECT_EQ(log, std::vector<std::string>({"keys:key"}));
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+// engine includes
+#include <IO/IOService.h>
+#include <IO/File.h>
+#include <Exception/IOExceptions.h>
+
+
+#define IO_TEST_FILE_SIZE (1 << 20)
+
+class TestIOService : public testing::TestWithParam<Parable::IO::IOBackendType>
+{
+public:
+    TestIOService() : service(Parable::IO::IOServiceConfig{ .backend = GetParam() })
+    {
+        path = (std::filesystem::temp_directory_path() / "pbl_test_io_service").string();
+
+        std::vector<char> contents(IO_TEST_FILE_SIZE);
+        for (size_t i = 0; i < contents.size(); ++i) contents[i] = (char)(i * 31 + 7);
+
+        std::ofstream out(path, std::ios::binary);
+        out.write(contents.data(), contents.size());
+        out.close();
+
+        file = Parable::IO::File(path);
+    }
+
+    ~TestIOService()
+    {
+        service.wait_all();
+        file = Parable::IO::File();
+        std::remove(path.c_str());
+    }
+
+    void SetUp() override
+    {
+        if (GetParam() == Parable::IO::IOBackendType::IoUring && service.get_backend_type() != Parable::IO::IOBackendType::IoUring)
+        {
+            GTEST_SKIP() << "io_uring is not available.";
+        }
+    }
+
+    static bool matches(std::span<const std::byte> data, uint64_t offset)
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            if (data[i] != (std::byte)((offset + i) * 31 + 7)) return false;
+        }
+        return true;
+    }
+
+    std::string path;
+    Parable::IO::File file;
+    Parable::IO::IOService service;
+};
+
+TEST_P(TestIOService, BatchedReads)
+{
+    const size_t chunk = 4096;
+    const size_t num_chunks = IO_TEST_FILE_SIZE / chunk;
+
+    std::vector<std::byte> buffer(IO_TEST_FILE_SIZE);
+    size_t completed = 0;
+    size_t bytes = 0;
+
+    // more reads than the default queue depth, so some wait for free slots
+    for (size_t i = 0; i < num_chunks; ++i)
+    {
+        service.read(file, std::span(buffer).subspan(i * chunk, chunk), i * chunk, [&](const Parable::IO::ReadResult& result)
+        {
+            EXPECT_TRUE(result.ok());
+            ++completed;
+            bytes += result.bytes;
+        });
+    }
+    EXPECT_EQ(service.get_in_flight(), num_chunks);
+    EXPECT_EQ(completed, 0) << "Callbacks must only run from poll or wait_all.";
+
+    service.wait_all();
+
+    EXPECT_EQ(completed, num_chunks);
+    EXPECT_EQ(bytes, IO_TEST_FILE_SIZE);
+    EXPECT_EQ(service.get_in_flight(), 0);
+    EXPECT_TRUE(matches(buffer, 0));
+}
+
+TEST_P(TestIOService, FutureAndEndOfFile)
+{
+    std::vector<std::byte> buffer(8192);
+
+    std::future<Parable::IO::ReadResult> future = service.read(file, buffer, IO_TEST_FILE_SIZE - 100);
+    service.wait_all();
+
+    Parable::IO::ReadResult result = future.get();
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(result.bytes, 100) << "Read past the end of the file should stop at the end.";
+    EXPECT_TRUE(matches(std::span(buffer).first(100), IO_TEST_FILE_SIZE - 100));
+}
+
+TEST_P(TestIOService, RegisteredBuffers)
+{
+    std::vector<std::byte> staging(65536);
+    std::span<std::byte> buffers[] = { staging };
+    service.register_buffers(buffers);
+
+    size_t completed = 0;
+    service.read(file, std::span(staging).subspan(0, 32768), 12345, [&](const Parable::IO::ReadResult& result) { completed += result.bytes; });
+    // partly outside the registered buffer
+    std::vector<std::byte> other(100);
+    service.read(file, other, 0, [&](const Parable::IO::ReadResult& result) { completed += result.bytes; });
+
+    while (service.get_in_flight() > 0) service.poll();
+
+    EXPECT_EQ(completed, 32768 + 100);
+    EXPECT_TRUE(matches(std::span(staging).first(32768), 12345));
+    EXPECT_TRUE(matches(other, 0));
+}
+
+TEST_P(TestIOService, CallbackQueuesRead)
+{
+    std::vector<std::byte> header(16);
+    std::vector<std::byte> body(1024);
+    bool body_done = false;
+
+    // e.g. reading a header to find where the payload is
+    service.read(file, header, 0, [&](const Parable::IO::ReadResult& result)
+    {
+        service.read(file, body, 2048, [&](const Parable::IO::ReadResult& result) { body_done = result.ok(); });
+    });
+
+    service.wait_all();
+
+    EXPECT_TRUE(body_done);
+    EXPECT_TRUE(matches(body, 2048));
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, TestIOService, testing::Values(Parable::IO::IOBackendType::IoUring, Parable::IO::IOBackendType::ThreadPool));
+
+TEST(TestFile, MissingFileThrows)
+{
+    EXPECT_THROW(Parable::IO::File("pbl_file_which_does_not_exist"), Parable::FileOpenException);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+
+// engine includes
+#include <Jobs/JobSystem.h>
+
+
+using namespace Parable;
+
+TEST(TestJobSystem, RunAndWait)
+{
+    JobSystem jobs(3);
+    EXPECT_EQ(jobs.get_thread_count(), 3);
+
+    std::atomic<int> sum = 0;
+    JobCounter counter;
+    for (int i = 1; i <= 100; ++i)
+    {
+        jobs.run([&sum, i]() { sum += i; }, counter);
+    }
+    jobs.wait(counter);
+
+    EXPECT_TRUE(counter.is_done());
+    EXPECT_EQ(sum, 5050);
+
+    // waiting on a finished counter returns straight away
+    jobs.wait(counter);
+}
+
+TEST(TestJobSystem, ParallelFor)
+{
+    JobSystem jobs(4);
+
+    std::vector<int> out(1000, 0);
+    jobs.parallel_for(out.size(), [&out](size_t i) { out[i] = (int)i * 2; });
+
+    for (size_t i = 0; i < out.size(); ++i) EXPECT_EQ(out[i], (int)i * 2);
+
+    // nothing to do
+    jobs.parallel_for(0, [](size_t) { FAIL() << "Ran a job for an empty range."; });
+}
+
+TEST(TestJobSystem, NestedWait)
+{
+    // every worker waiting on an inner batch must not deadlock, as waiters run queued jobs
+    JobSystem jobs(2);
+
+    std::atomic<int> count = 0;
+    jobs.parallel_for(8, [&jobs, &count](size_t) {
+        jobs.parallel_for(8, [&count](size_t) { ++count; });
+    });
+
+    EXPECT_EQ(count, 64);
+}
+
+TEST(TestJobSystem, ParallelForThrows)
+{
+    // a throw on any index still waits for the rest of the batch before reaching the caller
+    JobSystem jobs(4);
+
+    std::atomic<int> count = 0;
+    EXPECT_THROW(jobs.parallel_for(100, [&count](size_t i) {
+        ++count;
+        if (i == 0 || i == 50) throw std::runtime_error("job failed");
+    }), std::runtime_error);
+
+    EXPECT_EQ(count, 100);
+}
@@ -1,10 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <set>
+#include <vector>
+
 #include "test_allocators.h"
 
 // engine includes
 #include <Memory/LinearAllocator.h>
 #include <Memory/PoolAllocator.h>
+#include <Memory/SlabAllocator.h>
+#include <Memory/RingAllocator.h>
 
 
 // NOTE: we dont test deallocation here as LinearAllocator doesnt dealloc, only clear
@@ -43,4 +48,151 @@ TEST_F(TestPoolAllocator, SingleAllocation)
     alloc.deallocate_delete(*x);
     EXPECT_EQ(alloc.get_used(), 0) << "Used memory is not 0.";
     EXPECT_EQ(alloc.get_allocations(), 0) << "Not all allocations have been deallocated.";
-}
\ No newline at end of file
+}
+
+
+TEST(TestSlabSizeClasses, RoundsUp)
+{
+    EXPECT_EQ(Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(1)), 8);
+    EXPECT_EQ(Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(8)), 8);
+    EXPECT_EQ(Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(33)), 40);
+    EXPECT_EQ(Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(65)), 80);
+    EXPECT_EQ(Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(200)), 224);
+    EXPECT_EQ(Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(256)), 256);
+
+    // alignment moves up to a class which is a multiple of it
+    EXPECT_EQ(Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(40, 16)), 48);
+    EXPECT_EQ(Parable::SlabAllocator::class_size(Parable::SlabAllocator::size_class(8, 64)), 64);
+}
+
+TEST_F(TestSlabAllocator, MixedSizes)
+{
+    int* x = alloc.allocate_new<int>();
+    ASSERT_NE(x, nullptr);
+    *x = 1;
+
+    struct Big { char data[200]; };
+    Big* big = alloc.allocate_new<Big>();
+    ASSERT_NE(big, nullptr);
+    big->data[199] = 1;
+
+    struct alignas(64) Aligned { char data[8]; };
+    Aligned* aligned = alloc.allocate_new<Aligned>();
+    ASSERT_NE(aligned, nullptr);
+    EXPECT_EQ((uintptr_t)aligned % 64, 0) << "Allocation is not aligned.";
+
+    EXPECT_EQ(alloc.get_allocations(), 3);
+
+    alloc.deallocate_delete(*x);
+    alloc.deallocate_delete(*big);
+    alloc.deallocate_delete(*aligned);
+
+    EXPECT_EQ(alloc.get_used(), 0) << "Used memory is not 0.";
+    EXPECT_EQ(alloc.get_allocations(), 0) << "Not all allocations have been deallocated.";
+}
+
+TEST_F(TestSlabAllocator, ReusesFreedSlots)
+{
+    void* a = alloc.allocate(24, 8);
+    void* b = alloc.allocate(24, 8);
+    alloc.deallocate(a);
+
+    EXPECT_EQ(alloc.allocate(24, 8), a) << "Freed slot was not reused.";
+
+    alloc.deallocate(a);
+    alloc.deallocate(b);
+}
+
+TEST_F(TestSlabAllocator, EmptySlabsAreShared)
+{
+    // how many slabs fit depends on where the backing memory falls, so compare the slabs each fill used
+    auto fill = [this](size_t size, std::vector<void*>& ptrs)
+    {
+        std::set<uintptr_t> slabs;
+        while (void* p = alloc.allocate(size, 8))
+        {
+            ptrs.push_back(p);
+            slabs.insert((uintptr_t)p & ~(uintptr_t)(Parable::SlabAllocator::SLAB_SIZE - 1));
+        }
+        return slabs;
+    };
+
+    // fill every slab with one class, free it all, then fill every slab with another
+    std::vector<void*> ptrs;
+    std::set<uintptr_t> large_slabs = fill(256, ptrs);
+    ASSERT_FALSE(large_slabs.empty());
+
+    alloc.deallocate_batch(ptrs.data(), ptrs.size());
+    EXPECT_EQ(alloc.get_used(), 0);
+    EXPECT_EQ(alloc.get_allocations(), 0);
+
+    ptrs.clear();
+    std::set<uintptr_t> small_slabs = fill(8, ptrs);
+    EXPECT_EQ(small_slabs, large_slabs) << "Freed slabs were not reused by another size class.";
+
+    alloc.deallocate_batch(ptrs.data(), ptrs.size());
+    EXPECT_EQ(alloc.get_allocations(), 0);
+
+    // and back again, without the slabs growing
+    ptrs.clear();
+    EXPECT_EQ(fill(256, ptrs), large_slabs);
+
+    alloc.deallocate_batch(ptrs.data(), ptrs.size());
+    EXPECT_EQ(alloc.get_allocations(), 0);
+}
+
+
+TEST_F(TestRingAllocator, WrapsAround)
+{
+    void* a = alloc.allocate(48, 8);
+    void* b = alloc.allocate(48, 8);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+
+    // 32 bytes left at the end, and the oldest allocation blocks the start
+    EXPECT_EQ(alloc.allocate(48, 8), nullptr);
+
+    alloc.deallocate(a);
+    void* c = alloc.allocate(48, 8);
+    EXPECT_EQ(c, mem) << "Allocation did not wrap to the start.";
+
+    // wrapped, so the only space is between the newest and the oldest, which is none
+    EXPECT_EQ(alloc.allocate(8, 8), nullptr);
+
+    alloc.deallocate(b);
+    void* d = alloc.allocate(64, 8);
+    EXPECT_NE(d, nullptr) << "Space after the newest allocation was not reclaimed.";
+
+    alloc.deallocate(c);
+    alloc.deallocate(d);
+}
+
+TEST_F(TestRingAllocator, OutOfOrderFree)
+{
+    void* a = alloc.allocate(64, 8);
+    void* b = alloc.allocate(64, 8);
+
+    // freeing the newer allocation reclaims nothing while the older one lives
+    alloc.deallocate(b);
+    EXPECT_EQ(alloc.allocate(8, 8), nullptr);
+    EXPECT_EQ(alloc.get_allocations(), 1);
+
+    alloc.deallocate(a);
+    EXPECT_EQ(alloc.get_used(), 0) << "Used memory is not 0.";
+    EXPECT_EQ(alloc.get_allocations(), 0) << "Not all allocations have been deallocated.";
+
+    void* whole = alloc.allocate(128, 8);
+    EXPECT_EQ(whole, mem);
+    alloc.deallocate(whole);
+}
+
+TEST_F(TestRingAllocator, Alignment)
+{
+    void* a = alloc.allocate(1, 1);
+    void* b = alloc.allocate(8, 16);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ((uintptr_t)b % 16, 0) << "Allocation is not aligned.";
+
+    alloc.deallocate(a);
+    alloc.deallocate(b);
+}
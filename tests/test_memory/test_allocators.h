@@ -5,6 +5,8 @@
 // engine includes
 #include <Memory/LinearAllocator.h>
 #include <Memory/PoolAllocator.h>
+#include <Memory/SlabAllocator.h>
+#include <Memory/RingAllocator.h>
 
 
 class TestLinearAllocator : public MallocWrapper<128>
@@ -26,4 +28,27 @@ public:
 protected:
 
     Parable::PoolAllocator alloc;
-};
\ No newline at end of file
+};
+
+#define SLAB_TEST_SLABS 4
+
+class TestSlabAllocator : public MallocWrapper<Parable::SlabAllocator::SLAB_SIZE * (SLAB_TEST_SLABS + 1)>
+{
+public:
+// one extra slab of memory as the allocator aligns its start to a slab boundary
+    TestSlabAllocator() : alloc(Parable::SlabAllocator::SLAB_SIZE * (SLAB_TEST_SLABS + 1), mem) {}
+
+protected:
+
+    Parable::SlabAllocator alloc;
+};
+
+class TestRingAllocator : public MallocWrapper<128>
+{
+public:
+    TestRingAllocator() : alloc(128, mem) {}
+
+protected:
+
+    Parable::RingAllocator alloc;
+};
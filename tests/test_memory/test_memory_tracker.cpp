@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+// engine includes
+#include <Memory/MemoryTracker.h>
+#include <Memory/LinearAllocator.h>
+
+
+// the tracker is global, so each test uses its own tags
+
+static const Parable::MemoryTagStats& find_tag(const Parable::MemorySnapshot& snapshot, Parable::MemoryTag tag)
+{
+    return snapshot.tags.at(tag);
+}
+
+TEST(TestMemoryTracker, RegisterTag)
+{
+    Parable::MemoryTag parent = Parable::MemoryTracker::register_tag("RegisterTag");
+    Parable::MemoryTag child = Parable::MemoryTracker::register_tag("RegisterTag/Child", parent);
+
+    EXPECT_NE(parent, Parable::MemoryTracker::ROOT_TAG);
+    EXPECT_NE(parent, child);
+    EXPECT_EQ(Parable::MemoryTracker::register_tag("RegisterTag"), parent) << "Re-registering a name should return the same tag.";
+    EXPECT_EQ(Parable::MemoryTracker::get_tag_parent(child), parent);
+    EXPECT_EQ(Parable::MemoryTracker::get_tag_name(child), "RegisterTag/Child");
+}
+
+TEST(TestMemoryTracker, RecordAllocations)
+{
+    Parable::MemoryTag tag = Parable::MemoryTracker::register_tag("RecordAllocations");
+
+    Parable::MemoryTracker::record_allocation(tag, 8);
+    Parable::MemoryTracker::record_allocation(tag, 100);
+    Parable::MemoryTracker::record_deallocation(tag, 100);
+    Parable::MemoryTracker::record_allocation(tag, 40);
+
+    Parable::MemorySnapshot snapshot = Parable::MemoryTracker::snapshot();
+    const Parable::MemoryTagStats& stats = find_tag(snapshot, tag);
+
+    EXPECT_EQ(stats.allocations, 3);
+    EXPECT_EQ(stats.deallocations, 1);
+    EXPECT_EQ(stats.current_bytes, 48);
+    EXPECT_EQ(stats.peak_bytes, 108);
+    EXPECT_EQ(stats.bytes_allocated, 148);
+
+    EXPECT_EQ(stats.size_histogram[Parable::MemoryTracker::size_bucket(8)], 1);
+    EXPECT_EQ(stats.size_histogram[Parable::MemoryTracker::size_bucket(40)], 1);
+    EXPECT_EQ(stats.size_histogram[Parable::MemoryTracker::size_bucket(100)], 1);
+}
+
+TEST(TestMemoryTracker, SizeBuckets)
+{
+    EXPECT_EQ(Parable::MemoryTracker::size_bucket(1), 0);
+    EXPECT_EQ(Parable::MemoryTracker::size_bucket(16), 0);
+    EXPECT_EQ(Parable::MemoryTracker::size_bucket(17), 1);
+    EXPECT_EQ(Parable::MemoryTracker::size_bucket(32), 1);
+    EXPECT_EQ(Parable::MemoryTracker::size_bucket(SIZE_MAX), Parable::MemoryTagStats::NUM_SIZE_BUCKETS - 1);
+}
+
+TEST(TestMemoryTracker, MergesThreads)
+{
+    Parable::MemoryTag tag = Parable::MemoryTracker::register_tag("MergesThreads");
+
+    Parable::MemoryTracker::record_allocation(tag, 64);
+
+    std::thread other([tag](){
+        Parable::MemoryTracker::record_allocation(tag, 32);
+        Parable::MemoryTracker::record_allocation(tag, 32);
+    });
+    other.join();
+
+    Parable::MemorySnapshot snapshot = Parable::MemoryTracker::snapshot();
+    const Parable::MemoryTagStats& stats = find_tag(snapshot, tag);
+
+    EXPECT_EQ(stats.allocations, 3) << "Counters of an exited thread were lost.";
+    EXPECT_EQ(stats.current_bytes, 128);
+    EXPECT_GE(stats.peak_bytes, 128);
+}
+
+TEST(TestMemoryTracker, SnapshotJson)
+{
+    Parable::MemoryTag tag = Parable::MemoryTracker::register_tag("SnapshotJson");
+    Parable::MemoryTracker::record_allocation(tag, 24);
+
+    std::string json = Parable::MemoryTracker::snapshot().to_json();
+
+    EXPECT_NE(json.find("\"name\":\"SnapshotJson\""), std::string::npos);
+    EXPECT_NE(json.find("\"current_bytes\":24"), std::string::npos);
+}
+
+#ifdef PBL_MEMORY_TRACKING
+TEST(TestMemoryTracker, AllocatorReportsToTag)
+{
+    alignas(8) char mem[64];
+    Parable::LinearAllocator alloc(64, mem, "AllocatorReportsToTag");
+
+    alloc.allocate(16, 8);
+    EXPECT_EQ(find_tag(Parable::MemoryTracker::snapshot(), alloc.get_tag()).current_bytes, 16);
+
+    alloc.clear();
+    EXPECT_EQ(find_tag(Parable::MemoryTracker::snapshot(), alloc.get_tag()).current_bytes, 0);
+}
+#endif
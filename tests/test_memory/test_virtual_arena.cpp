@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+// engine includes
+#include <Memory/VirtualArena.h>
+#include <Memory/LinearAllocator.h>
+#include <Memory/PoolAllocator.h>
+#include <Exception/MemoryExceptions.h>
+
+
+TEST(TestVirtualArena, ReserveDoesNotCommit)
+{
+    Parable::VirtualArena arena(64 * Parable::VirtualArena::COMMIT_STEP, Parable::HugePageMode::None);
+
+    EXPECT_NE(arena.get_start(), nullptr);
+    EXPECT_EQ((uintptr_t)arena.get_start() % Parable::VirtualArena::COMMIT_STEP, 0) << "Arena start is not huge page aligned.";
+    EXPECT_EQ(arena.get_reserved(), 64 * Parable::VirtualArena::COMMIT_STEP);
+    EXPECT_EQ(arena.get_committed(), 0);
+}
+
+TEST(TestVirtualArena, CommitsInSteps)
+{
+    Parable::VirtualArena arena(8 * Parable::VirtualArena::COMMIT_STEP);
+
+    char* a = (char*)arena.commit_block(100);
+    EXPECT_EQ(arena.get_committed(), Parable::VirtualArena::COMMIT_STEP);
+
+    char* b = (char*)arena.commit_block(Parable::VirtualArena::COMMIT_STEP);
+    EXPECT_EQ(arena.get_committed(), 2 * Parable::VirtualArena::COMMIT_STEP);
+    EXPECT_GE(b, a + 100);
+
+    // touch both ends of the committed memory to proc any hidden segfaults
+    a[0] = 1;
+    b[Parable::VirtualArena::COMMIT_STEP - 1] = 1;
+
+    arena.reset();
+    EXPECT_EQ(arena.get_committed(), 0);
+    EXPECT_EQ(arena.get_used(), 0);
+}
+
+TEST(TestVirtualArena, ExceedReserveThrows)
+{
+    Parable::VirtualArena arena(Parable::VirtualArena::COMMIT_STEP, Parable::HugePageMode::None);
+
+    EXPECT_THROW(arena.commit_block(Parable::VirtualArena::COMMIT_STEP + 1), Parable::OutOfMemoryException);
+}
+
+TEST(TestVirtualArena, BacksAllocators)
+{
+    Parable::VirtualArena arena(4 * Parable::VirtualArena::COMMIT_STEP);
+
+    Parable::LinearAllocator linear(1024, arena.commit_block(1024));
+    int* x = linear.allocate_new<int>();
+    ASSERT_NE(x, nullptr);
+    *x = 1;
+    EXPECT_TRUE(arena.contains(x));
+    linear.clear();
+
+    Parable::PoolAllocator pool = Parable::PoolAllocator::create<size_t>(sizeof(size_t) * 64, arena.commit_block(sizeof(size_t) * 64));
+    size_t* y = pool.allocate_new<size_t>();
+    ASSERT_NE(y, nullptr);
+    *y = 1;
+    EXPECT_TRUE(arena.contains(y));
+    pool.deallocate_delete(*y);
+}
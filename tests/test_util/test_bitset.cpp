@@ -75,6 +75,71 @@ TEST_F(TestTwoDynamicBitset, BitwiseXOR)
     EXPECT_FALSE(a.at(0));
 }
 
+TEST_F(TestTwoDynamicBitset, FusedAnd)
+{
+    a.set(0); a.set(2); a.set(4);
+    b.set(1); b.set(3);
+
+    EXPECT_FALSE(a.and_any(b));
+    EXPECT_EQ(a.and_count(b), 0);
+
+    b.set(4);
+    EXPECT_TRUE(a.and_any(b));
+    EXPECT_EQ(a.and_count(b), 1);
+
+    // neither bitset is modified
+    EXPECT_EQ(a.count(), 3);
+    EXPECT_EQ(b.count(), 3);
+}
+
+TEST_F(TestLargeDynamicBitset, Iteration)
+{
+    std::vector<size_t> expected ({0, 63, 64, 255, 256, 511, 700, LARGE_BITSET_SIZE - 1});
+    for (size_t i : expected) a.set(i);
+
+    std::vector<size_t> found;
+    for (size_t i : a.set_bits()) found.push_back(i);
+    EXPECT_EQ(found, expected);
+
+    size_t unset = 0;
+    for (size_t i : a.unset_bits())
+    {
+        EXPECT_FALSE(a[i]) << "Unset iteration visited set bit " << i;
+        ++unset;
+    }
+    EXPECT_EQ(unset, LARGE_BITSET_SIZE - expected.size()) << "Unset iteration visited bits past the end.";
+
+    EXPECT_EQ(a.find_first_set(), 0);
+    EXPECT_EQ(a.find_first_unset(), 1);
+}
+
+TEST_F(TestLargeDynamicBitset, BulkOperations)
+{
+    for (size_t i = 0; i < LARGE_BITSET_SIZE; i += 3) a.set(i);
+    for (size_t i = 0; i < LARGE_BITSET_SIZE; i += 6) b.set(i);
+
+    EXPECT_TRUE(b.is_subset_of(a));
+    EXPECT_FALSE(a.is_subset_of(b));
+    EXPECT_TRUE(a.and_any(b));
+    EXPECT_EQ(a.and_count(b), b.count());
+
+    a ^= b;
+    EXPECT_FALSE(a.and_any(b));
+
+    a |= b;
+    EXPECT_EQ(a.count(), (LARGE_BITSET_SIZE + 2) / 3);
+
+    a &= b;
+    EXPECT_EQ(a, b);
+
+    a.flip_all();
+    EXPECT_EQ(a.count(), LARGE_BITSET_SIZE - b.count()) << "flip_all() set bits past the end.";
+
+    a.set_all();
+    EXPECT_TRUE(a.all());
+    EXPECT_EQ(a.count(), LARGE_BITSET_SIZE) << "set_all() set bits past the end.";
+}
+
 
 // STATIC BITSET
 #include <Util/StaticBitset.tpp>
@@ -166,4 +231,29 @@ TEST_F(TestTwoStaticBitset, BitwiseXOR)
     a ^= b;
     EXPECT_EQ(a.count(), 4);
     EXPECT_FALSE(a.at(0));
+}
+
+TEST_F(TestTwoStaticBitset, FusedAnd)
+{
+    a.set(0); a.set(2); a.set(4);
+    b.set(1); b.set(3);
+
+    EXPECT_FALSE(a.and_any(b));
+
+    b.set(2); b.set(4);
+    EXPECT_TRUE(a.and_any(b));
+    EXPECT_EQ(a.and_count(b), 2);
+}
+
+TEST_F(TestStaticBitset, Iteration)
+{
+    bitset.set(1); bitset.set(9);
+
+    std::vector<size_t> found;
+    for (size_t i : bitset.set_bits()) found.push_back(i);
+    EXPECT_EQ(found, std::vector<size_t>({1, 9}));
+
+    bitset.set_all();
+    EXPECT_EQ(bitset.count(), 10) << "set_all() set bits past the end.";
+    EXPECT_TRUE(bitset.unset_bits().begin() == bitset.unset_bits().end());
 }
\ No newline at end of file
@@ -37,6 +37,25 @@ public:
     Parable::Util::DynamicBitset b;
 };
 
+// spans several 256 bit blocks plus a partial word, to cover both the SIMD and scalar paths
+#define LARGE_BITSET_SIZE 1000
+
+class TestLargeDynamicBitset : public MallocWrapper<1024>
+{
+public:
+    TestLargeDynamicBitset() : alloc(Parable::LinearAllocator(1024, mem)),
+                                a(Parable::Util::DynamicBitset(LARGE_BITSET_SIZE, alloc)),
+                                b(Parable::Util::DynamicBitset(LARGE_BITSET_SIZE, alloc)) {}
+
+    ~TestLargeDynamicBitset()
+    {
+        alloc.clear();
+    }
+    Parable::LinearAllocator alloc;
+    Parable::Util::DynamicBitset a;
+    Parable::Util::DynamicBitset b;
+};
+
 class TestStaticBitset : public ::testing::Test
 {
 public:
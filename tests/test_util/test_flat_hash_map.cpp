@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include "test_with_malloc.h"
+
+// engine includes
+#include <Util/FlatHashMap.h>
+#include <Memory/LinearAllocator.h>
+#include <Exception/LogicExceptions.h>
+
+
+TEST(TestFlatHashMap, InsertFindErase)
+{
+    Parable::Util::FlatHashMap<uint64_t, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+
+    EXPECT_TRUE(map.insert({1, 10}).second);
+    EXPECT_FALSE(map.insert({1, 20}).second) << "Inserted a duplicate key.";
+    EXPECT_EQ(map.at(1), 10);
+
+    map[2] = 20;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_TRUE(map.contains(2));
+    EXPECT_THROW(map.at(3), Parable::OutOfRangeException);
+
+    EXPECT_EQ(map.erase(1), 1);
+    EXPECT_EQ(map.erase(1), 0);
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(TestFlatHashMap, MatchesStdMap)
+{
+    // random inserts and erases across several growths, checked against std::map
+    Parable::Util::FlatHashMap<uint64_t, uint64_t> map;
+    std::map<uint64_t, uint64_t> reference;
+
+    uint64_t state = 12345;
+    for (int i = 0; i < 50000; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t key = (state >> 33) % 4096;
+
+        if ((state & 3) == 0)
+        {
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+        }
+        else
+        {
+            map[key] = (uint64_t)i;
+            reference[key] = (uint64_t)i;
+        }
+    }
+
+    ASSERT_EQ(map.size(), reference.size());
+    for (auto& [key, value] : reference) EXPECT_EQ(map.at(key), value);
+
+    size_t iterated = 0;
+    for (auto& [key, value] : map)
+    {
+        EXPECT_EQ(reference.at(key), value);
+        ++iterated;
+    }
+    EXPECT_EQ(iterated, reference.size());
+}
+
+TEST(TestFlatHashMap, HeterogeneousLookup)
+{
+    Parable::Util::FlatHashMap<std::string, int> map;
+    map.try_emplace("mesh", 1);
+    map.try_emplace(std::string("texture"), 2);
+
+    std::string_view view = "texture";
+    EXPECT_EQ(map.at(view), 2);
+    EXPECT_TRUE(map.contains("mesh"));
+    EXPECT_FALSE(map.contains(std::string_view("shader")));
+}
+
+TEST(TestFlatHashMap, CopyAndMove)
+{
+    Parable::Util::FlatHashMap<std::string, std::string> map;
+    for (int i = 0; i < 100; ++i) map[std::to_string(i)] = std::string(40, 'a' + i % 26);
+
+    Parable::Util::FlatHashMap<std::string, std::string> copy(map);
+    EXPECT_EQ(copy.size(), 100);
+    EXPECT_EQ(copy.at("42"), map.at("42"));
+
+    Parable::Util::FlatHashMap<std::string, std::string> moved(std::move(map));
+    EXPECT_EQ(moved.size(), 100);
+    EXPECT_TRUE(map.empty());
+
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(moved.begin(), moved.end());
+}
+
+TEST(TestFlatHashSet, InsertContains)
+{
+    Parable::Util::FlatHashSet<uint32_t> set;
+    set.reserve(1000);
+    size_t capacity = set.capacity();
+
+    for (uint32_t i = 0; i < 1000; ++i) EXPECT_TRUE(set.insert(i * 7).second);
+    EXPECT_EQ(set.capacity(), capacity) << "Grew after reserving.";
+
+    for (uint32_t i = 0; i < 7000; ++i) EXPECT_EQ(set.contains(i), i % 7 == 0);
+}
+
+class TestFlatHashMapAllocator : public MallocWrapper<1 << 16> {};
+
+TEST_F(TestFlatHashMapAllocator, UsesAllocator)
+{
+    Parable::LinearAllocator alloc(1 << 16, mem);
+    {
+        Parable::Util::FlatHashMap<uint32_t, uint32_t> map(&alloc);
+        // reserve up front, a LinearAllocator cannot free the smaller tables of each growth
+        map.reserve(100);
+        for (uint32_t i = 0; i < 100; ++i) map[i] = i;
+
+        EXPECT_GT(alloc.get_used(), 0) << "Table not allocated from the given allocator.";
+        EXPECT_EQ(map.at(99), 99);
+    }
+    alloc.clear();
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "test_hierarchical_bitset.h"
+
+#include <Util/HierarchicalBitset.h>
+#include <Exception/LogicExceptions.h>
+
+
+TEST_F(TestHierarchicalBitset, SetAndGet)
+{
+    EXPECT_EQ(a.get_num_levels(), 3);
+    ASSERT_TRUE(a.none()) << "Bitset not initialised with 0's";
+    EXPECT_THROW(a.find_first_set(), Parable::OutOfRangeException);
+
+    a.set(123456);
+    EXPECT_TRUE(a.at(123456));
+    EXPECT_TRUE(a.any());
+    EXPECT_EQ(a.count(), 1);
+    EXPECT_EQ(a.find_first_set(), 123456);
+
+    a.set(70);
+    EXPECT_EQ(a.find_first_set(), 70);
+
+    a.reset(70);
+    a.reset(123456);
+    EXPECT_TRUE(a.none()) << "Summary levels not cleared when their words emptied.";
+
+    EXPECT_THROW(a.set(HIERARCHICAL_BITSET_SIZE), Parable::OutOfRangeException);
+}
+
+TEST_F(TestHierarchicalBitset, SparseIteration)
+{
+    std::vector<size_t> expected ({0, 1, 63, 64, 4095, 4096, 262143, 262144, 500000, HIERARCHICAL_BITSET_SIZE - 1});
+    for (size_t i : expected) a.set(i);
+
+    std::vector<size_t> found;
+    for (size_t i : a.set_bits()) found.push_back(i);
+    EXPECT_EQ(found, expected);
+    EXPECT_EQ(a.count(), expected.size());
+
+    size_t words = 0;
+    for (size_t w : a.set_words())
+    {
+        EXPECT_LT(w, Parable::Util::BitOps::words_for(HIERARCHICAL_BITSET_SIZE));
+        ++words;
+    }
+    EXPECT_EQ(words, 8) << "0, 1 and 63 share a word, every other bit has its own.";
+
+    a.reset_all();
+    EXPECT_TRUE(a.none());
+    EXPECT_TRUE(a.set_bits().begin() == a.set_bits().end());
+}
+
+TEST_F(TestHierarchicalBitset, SetOperations)
+{
+    for (size_t i = 0; i < HIERARCHICAL_BITSET_SIZE; i += 10007) a.set(i);
+    for (size_t i = 0; i < HIERARCHICAL_BITSET_SIZE; i += 20014) b.set(i);
+    b.set(5);
+
+    EXPECT_TRUE(a.and_any(b));
+    EXPECT_EQ(a.and_count(b), b.count() - 1);
+
+    a &= b;
+    EXPECT_EQ(a.count(), b.count() - 1);
+    EXPECT_FALSE(a[5]);
+    for (size_t i : a.set_bits()) EXPECT_TRUE(b[i]) << "Bit " << i << " survived intersection.";
+
+    a |= b;
+    EXPECT_EQ(a.count(), b.count());
+    EXPECT_TRUE(a[5]);
+
+    b.reset_all();
+    EXPECT_FALSE(a.and_any(b));
+    a &= b;
+    EXPECT_TRUE(a.none()) << "Summary levels not cleared by intersection.";
+}
@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+
+#include "test_with_malloc.h"
+
+#include <Util/HierarchicalBitset.h>
+#include <Memory/LinearAllocator.h>
+
+// large enough to need both summary levels
+#define HIERARCHICAL_BITSET_SIZE 1000000
+#define HIERARCHICAL_ALLOC_SIZE (2 * (HIERARCHICAL_BITSET_SIZE / 8 + 4096))
+
+class TestHierarchicalBitset : public MallocWrapper<HIERARCHICAL_ALLOC_SIZE>
+{
+public:
+    TestHierarchicalBitset() : alloc(HIERARCHICAL_ALLOC_SIZE, mem),
+                                a(HIERARCHICAL_BITSET_SIZE, alloc),
+                                b(HIERARCHICAL_BITSET_SIZE, alloc) {}
+
+    ~TestHierarchicalBitset()
+    {
+        alloc.clear();
+    }
+
+    Parable::LinearAllocator alloc;
+    Parable::Util::HierarchicalBitset a;
+    Parable::Util::HierarchicalBitset b;
+};
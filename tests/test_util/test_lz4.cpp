@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+// engine includes
+#include <Util/LZ4.h>
+
+
+using namespace Parable::Util;
+
+static std::vector<std::byte> round_trip(std::span<const std::byte> src)
+{
+    std::vector<std::byte> compressed(LZ4::compress_bound(src.size()));
+    size_t size = LZ4::compress(src, compressed);
+    EXPECT_GT(size, 0);
+    compressed.resize(size);
+
+    std::vector<std::byte> out(src.size());
+    EXPECT_TRUE(LZ4::decompress(compressed, out));
+    return out;
+}
+
+TEST(TestLZ4, RoundTrip)
+{
+    std::mt19937 rng(3);
+
+    // repetitive text-like data, which should compress well
+    std::vector<std::byte> text;
+    const char* words[] = { "vertex ", "index ", "texture ", "mesh ", "normal ", "uv " };
+    while (text.size() < 100000)
+    {
+        for (char c : std::string_view(words[rng() % 6])) text.push_back((std::byte)c);
+    }
+
+    std::vector<std::byte> compressed(LZ4::compress_bound(text.size()));
+    size_t size = LZ4::compress(text, compressed);
+    EXPECT_LT(size, text.size() / 2) << "Repetitive data did not compress.";
+    EXPECT_EQ(round_trip(text), text);
+
+    // random data, which can not compress
+    std::vector<std::byte> noise(70000);
+    for (std::byte& b : noise) b = (std::byte)rng();
+    EXPECT_EQ(round_trip(noise), noise);
+
+    // long runs, which decode as overlapping matches
+    std::vector<std::byte> runs(50000, (std::byte)0);
+    for (size_t i = 20000; i < 20003; ++i) runs[i] = (std::byte)1;
+    EXPECT_EQ(round_trip(runs), runs);
+}
+
+TEST(TestLZ4, SmallInputs)
+{
+    // inputs too short to hold a match are stored as literals
+    for (size_t size = 0; size < 32; ++size)
+    {
+        std::vector<std::byte> data(size, (std::byte)'a');
+        EXPECT_EQ(round_trip(data), data) << "Failed at size " << size;
+    }
+}
+
+TEST(TestLZ4, OutputTooSmall)
+{
+    std::vector<std::byte> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (std::byte)(i * 7919 >> 3);
+
+    std::vector<std::byte> compressed(10);
+    EXPECT_EQ(LZ4::compress(data, compressed), 0);
+}
+
+TEST(TestLZ4, RejectsCorruptInput)
+{
+    std::vector<std::byte> data(4000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (std::byte)(i % 61);
+
+    std::vector<std::byte> compressed(LZ4::compress_bound(data.size()));
+    compressed.resize(LZ4::compress(data, compressed));
+
+    std::vector<std::byte> out(data.size());
+
+    // the wrong decompressed size
+    std::vector<std::byte> short_out(data.size() - 1);
+    EXPECT_FALSE(LZ4::decompress(compressed, short_out));
+
+    // truncated input
+    EXPECT_FALSE(LZ4::decompress(std::span(compressed).first(compressed.size() / 2), out));
+    EXPECT_FALSE(LZ4::decompress({}, out));
+
+    // random damage must never read or write out of bounds, whether or not it is detected
+    std::mt19937 rng(11);
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::vector<std::byte> damaged = compressed;
+        damaged[rng() % damaged.size()] = (std::byte)rng();
+        LZ4::decompress(damaged, out);
+    }
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+// engine includes
+#include <Util/MappedFile.h>
+#include <Exception/IOExceptions.h>
+
+
+static std::string write_temp_file(const std::string& name, const std::string& contents)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+    return path.string();
+}
+
+TEST(TestMappedFile, MapsContents)
+{
+    std::string contents = "{ \"context\": { \"name\": \"test\" } }";
+    std::string path = write_temp_file("pbl_test_mapped_file.json", contents);
+
+    {
+        Parable::Util::MappedFile file(path);
+        EXPECT_EQ(file.size(), contents.size());
+        EXPECT_EQ(file.chars(), contents);
+        EXPECT_EQ((uintptr_t)file.data().data() % 4, 0) << "Mapping is not word aligned.";
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestMappedFile, EmptyFile)
+{
+    std::string path = write_temp_file("pbl_test_mapped_file_empty", "");
+
+    {
+        Parable::Util::MappedFile file(path, Parable::Util::AccessHint::WillNeed);
+        EXPECT_TRUE(file.empty());
+        EXPECT_TRUE(file.data().empty());
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(TestMappedFile, MissingFileThrows)
+{
+    EXPECT_THROW(Parable::Util::MappedFile("pbl_file_which_does_not_exist"), Parable::FileOpenException);
+}
+
+TEST(TestMappedFile, MoveTransfersMapping)
+{
+    std::string path = write_temp_file("pbl_test_mapped_file_move", "parable");
+
+    {
+        Parable::Util::MappedFile a(path, Parable::Util::AccessHint::Random);
+        Parable::Util::MappedFile b(std::move(a));
+        EXPECT_TRUE(a.empty());
+        EXPECT_EQ(b.chars(), "parable");
+
+        Parable::Util::MappedFile c;
+        c = std::move(b);
+        EXPECT_TRUE(b.empty());
+        EXPECT_EQ(c.chars(), "parable");
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+// engine includes
+#include <Util/SPSCQueue.h>
+#include <Util/MPSCQueue.h>
+
+
+struct QueueItem
+{
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+TEST(TestSPSCQueue, PushPop)
+{
+    Parable::Util::SPSCQueue<int, 4> queue;
+
+    int out;
+    EXPECT_FALSE(queue.pop(out));
+
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.push(i));
+    EXPECT_FALSE(queue.push(4)) << "Pushed to a full queue.";
+
+    // wrap around the ring a few times
+    for (int i = 4; i < 20; ++i)
+    {
+        ASSERT_TRUE(queue.pop(out));
+        EXPECT_EQ(out, i - 4);
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_EQ(queue.size_approx(), 4);
+}
+
+TEST(TestSPSCQueue, Batches)
+{
+    Parable::Util::SPSCQueue<int, 8> queue;
+
+    std::vector<int> in = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(queue.push_batch(in), 8) << "Batch push should stop when full.";
+
+    std::vector<int> out(5);
+    EXPECT_EQ(queue.pop_batch(out), 5);
+    EXPECT_EQ(out, std::vector<int>({0, 1, 2, 3, 4}));
+
+    EXPECT_EQ(queue.push_batch(std::span(in).subspan(8)), 2);
+
+    EXPECT_EQ(queue.pop_batch(out), 5);
+    EXPECT_EQ(out, std::vector<int>({5, 6, 7, 8, 9}));
+    EXPECT_TRUE(queue.empty_approx());
+}
+
+TEST(TestSPSCQueue, Threaded)
+{
+    static constexpr uint32_t NUM_ITEMS = 200000;
+    Parable::Util::SPSCQueue<uint32_t, 256> queue;
+
+    std::thread producer([&]()
+    {
+        for (uint32_t i = 0; i < NUM_ITEMS; ++i)
+        {
+            while (!queue.push(i)) std::this_thread::yield();
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t out[32];
+    while (expected < NUM_ITEMS)
+    {
+        size_t n = queue.pop_batch(out);
+        if (n == 0) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i) ASSERT_EQ(out[i], expected++);
+    }
+
+    producer.join();
+}
+
+TEST(TestMPSCQueue, PushPop)
+{
+    Parable::Util::MPSCQueue<QueueItem, 4> queue;
+
+    QueueItem out;
+    EXPECT_FALSE(queue.pop(out));
+
+    for (uint32_t i = 0; i < 4; ++i) EXPECT_TRUE(queue.push({0, i}));
+    EXPECT_FALSE(queue.push({0, 4})) << "Pushed to a full queue.";
+
+    for (uint32_t i = 4; i < 20; ++i)
+    {
+        ASSERT_TRUE(queue.pop(out));
+        EXPECT_EQ(out.sequence, i - 4);
+        EXPECT_TRUE(queue.push({0, i}));
+    }
+
+    QueueItem batch[8];
+    EXPECT_EQ(queue.pop_batch(batch), 4);
+    EXPECT_EQ(batch[3].sequence, 19);
+    EXPECT_TRUE(queue.empty_approx());
+}
+
+TEST(TestMPSCQueue, Threaded)
+{
+    static constexpr uint32_t NUM_PRODUCERS = 4;
+    static constexpr uint32_t ITEMS_PER_PRODUCER = 50000;
+    Parable::Util::MPSCQueue<QueueItem, 1024> queue;
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < NUM_PRODUCERS; ++p)
+    {
+        producers.emplace_back([&queue, p]()
+        {
+            // mix single and batched pushes
+            for (uint32_t i = 0; i < ITEMS_PER_PRODUCER;)
+            {
+                QueueItem batch[3] = { {p, i}, {p, i + 1}, {p, i + 2} };
+                size_t n = std::min<size_t>(3, ITEMS_PER_PRODUCER - i);
+                size_t pushed = queue.push_batch(std::span<const QueueItem>(batch, n));
+                if (pushed == 0) std::this_thread::yield();
+                i += (uint32_t)pushed;
+            }
+        });
+    }
+
+    // items from each producer must arrive in that producer's order
+    std::vector<uint32_t> next(NUM_PRODUCERS, 0);
+    size_t received = 0;
+    QueueItem out[64];
+    while (received < NUM_PRODUCERS * ITEMS_PER_PRODUCER)
+    {
+        size_t n = queue.pop_batch(out);
+        if (n == 0) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i)
+        {
+            ASSERT_EQ(out[i].sequence, next[out[i].producer]++);
+        }
+        received += n;
+    }
+
+    for (std::thread& t : producers) t.join();
+    EXPECT_TRUE(queue.empty_approx());
+}